@@ -24,6 +24,19 @@ CREATE TABLE `memused` (
   `MB` int(20) NOT NULL
 );
 
+DROP TABLE IF EXISTS `inprocsched`;
+CREATE TABLE `inprocsched` (
+  `simplifications` bigint(20) NOT NULL,
+  `conflicts` bigint(20) NOT NULL,
+  `runtime` float NOT NULL,
+  `unit` varchar(200) NOT NULL,
+  `decision` varchar(20) NOT NULL,
+  `cost` float NOT NULL,
+  `gain` float NOT NULL,
+  `utility` float NOT NULL,
+  `boost` float NOT NULL
+);
+
 DROP TABLE IF EXISTS `solverRun`;
 CREATE TABLE `solverRun` (
   `runtime` float NOT NULL,
@@ -477,10 +477,9 @@ static PyObject* add_xor_clause(Solver *self, PyObject *args, PyObject *kwds)
     return Py_None;
 }
 
-static PyObject* get_solution(SATSolver *cmsat)
+static PyObject* model_to_tuple(const std::vector<lbool>& model, unsigned max_idx)
 {
     // Create tuple with the size of number of variables in model
-    unsigned max_idx = cmsat->nVars();
     PyObject *tuple = PyTuple_New((Py_ssize_t) max_idx+1);
     if (tuple == NULL) {
         PyErr_SetString(PyExc_SystemError, "failed to create a tuple");
@@ -493,7 +492,7 @@ static PyObject* get_solution(SATSolver *cmsat)
     PyObject *py_value = NULL;
     lbool v;
     for (unsigned i = 0; i < max_idx; i++) {
-        v = cmsat->get_model()[i];
+        v = model[i];
 
         if (v == l_True) {
             py_value = Py_True;
@@ -511,6 +510,11 @@ static PyObject* get_solution(SATSolver *cmsat)
     return tuple;
 }
 
+static PyObject* get_solution(SATSolver *cmsat)
+{
+    return model_to_tuple(cmsat->get_model(), cmsat->nVars());
+}
+
 static PyObject* get_raw_solution(SATSolver *cmsat) {
 
     // Create tuple with the size of number of variables in model
@@ -719,6 +723,95 @@ static PyObject* solve(Solver *self, PyObject *args, PyObject *kwds)
     return result;
 }
 
+PyDoc_STRVAR(enumerate_doc,
+"enumerate(projection=None, batch=0, assumptions=None)\n\
+Return the next batch of solutions. Every solution is banned over the\n\
+projection as soon as it is found, so calling it again continues where\n\
+the previous call stopped.\n\
+\n\
+.. example:: \n\
+    >>> s = Solver()\n\
+    >>> s.add_clause([1, 2])\n\
+    >>> while True:\n\
+    ...     sols = s.enumerate(batch=2)\n\
+    ...     if not sols:\n\
+    ...         break\n\
+\n\
+:param projection: (Optional) Variables the solutions must differ on.\n\
+    All variables by default.\n\
+:type projection: <list>\n\
+:param batch: (Optional) Maximum number of solutions to return. 0 means\n\
+    all of them.\n\
+:type batch: <long>\n\
+:param assumptions: (Optional) Same as for solve()\n\
+:type assumptions: <list>\n\
+:return: A list of solutions in the format solve() returns them. Empty if\n\
+    there are no more solutions, or the time or conflict limit was hit.\n\
+:rtype: <list <tuple>>"
+);
+
+static PyObject* enumerate(Solver *self, PyObject *args, PyObject *kwds)
+{
+    PyObject* projection = NULL;
+    PyObject* assumptions = NULL;
+    long batch = 0;
+
+    static char const* kwlist[] = {"projection", "batch", "assumptions", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OlO", const_cast<char**>(kwlist), &projection, &batch, &assumptions)) {
+        return NULL;
+    }
+    if (batch < 0) {
+        PyErr_SetString(PyExc_ValueError, "batch must be at least 0");
+        return NULL;
+    }
+
+    std::vector<uint32_t> proj_vars;
+    if (projection && projection != Py_None) {
+        std::vector<Lit> proj_lits;
+        if (!parse_assumption_lits(projection, self->cmsat, proj_lits)) {
+            return 0;
+        }
+        for(const Lit l: proj_lits) proj_vars.push_back(l.var());
+    }
+    std::vector<Lit> assumption_lits;
+    if (assumptions && assumptions != Py_None) {
+        if (!parse_assumption_lits(assumptions, self->cmsat, assumption_lits)) {
+            return 0;
+        }
+    }
+
+    // The GIL is released, so the models are only turned into tuples
+    // once enumeration has returned
+    std::vector<std::vector<lbool>> models;
+    Py_BEGIN_ALLOW_THREADS      /* release GIL */
+    self->cmsat->enumerate(
+        [&](const std::vector<lbool>& model) {
+            models.push_back(model);
+            return true;
+        },
+        proj_vars.empty() ? NULL : &proj_vars,
+        batch,
+        &assumption_lits);
+    Py_END_ALLOW_THREADS
+
+    PyObject *result = PyList_New(0);
+    if (result == NULL) {
+        PyErr_SetString(PyExc_SystemError, "failed to create a list");
+        return NULL;
+    }
+    for(const auto& model: models) {
+        PyObject* solution = model_to_tuple(model, self->cmsat->nVars());
+        if (!solution) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_Append(result, solution);
+        Py_DECREF(solution);
+    }
+
+    return result;
+}
+
 PyDoc_STRVAR(is_satisfiable_doc,
 "is_satisfiable()\n\
 Return satisfiability of the system.\n\
@@ -787,6 +880,7 @@ static PyMethodDef Solver_methods[] = {
     {"add_xor_clause",(PyCFunction) add_xor_clause,  METH_VARARGS | METH_KEYWORDS, "adds an XOR clause to the system"},
     {"nb_vars", (PyCFunction) nb_vars, METH_VARARGS | METH_KEYWORDS, nb_vars_doc},
     //{"nb_clauses", (PyCFunction) nb_clauses, METH_VARARGS | METH_KEYWORDS, "returns number of clauses"},
+    {"enumerate", (PyCFunction) enumerate, METH_VARARGS | METH_KEYWORDS, enumerate_doc},
     {"is_satisfiable", (PyCFunction) is_satisfiable, METH_VARARGS | METH_KEYWORDS, is_satisfiable_doc},
     {"get_conflict", (PyCFunction) get_conflict, METH_VARARGS | METH_KEYWORDS, get_conflict_doc},
 
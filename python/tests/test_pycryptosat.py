@@ -296,6 +296,28 @@ class TestSolve(unittest.TestCase):
         res, _ = self.solver.solve()
         self.assertEqual(res, True)
 
+    def test_enumerate(self):
+        self.solver.add_clause([1, 2, 3])
+        sols = self.solver.enumerate()
+        self.assertEqual(len(sols), 7)
+        self.assertEqual(len(set(sols)), 7)
+        for sol in sols:
+            self.assertTrue(check_solution([[1, 2, 3]], sol))
+        self.assertEqual(self.solver.enumerate(), [])
+
+    def test_enumerate_batch(self):
+        self.solver.add_clause([1, 2, 3, 4])
+        self.solver.add_clause([-1, 5])
+        seen = set()
+        while True:
+            sols = self.solver.enumerate(projection=[1, 2], batch=2)
+            if not sols:
+                break
+            self.assertTrue(len(sols) <= 2)
+            for sol in sols:
+                seen.add((sol[1], sol[2]))
+        self.assertEqual(len(seen), 4)
+
 
 class TestSolveTimeLimit(unittest.TestCase):
 
@@ -0,0 +1,313 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+# Flattens a gradient boosted forest into the C++ arrays of a FlatForest
+# (src/flat_forest.h), so ClPredictorsTree can evaluate it without linking
+# XGBoost or LightGBM. Reads XGBoost JSON models and LightGBM text models.
+#
+# Usage: gbdt_to_cpp.py model output.cpp name
+
+import sys
+import json
+import math
+import struct
+import hashlib
+
+DEFAULT_LEFT = 1
+NAN_MISSING = 2
+ZERO_MISSING = 4
+
+
+def f32(x):
+    if x >= 3.4028234663852886e+38:
+        return float("inf")
+    if x <= -3.4028234663852886e+38:
+        return float("-inf")
+    return struct.unpack("f", struct.pack("f", x))[0]
+
+
+def f32_step(x, up):
+    """Next float32 towards +inf (up) or -inf"""
+    if math.isinf(x):
+        if (x > 0) == up:
+            return x
+        return (3.4028234663852886e+38 if x > 0 else -3.4028234663852886e+38)
+    if x == 0:
+        tiny = struct.unpack("f", struct.pack("I", 1))[0]
+        return tiny if up else -tiny
+    bits = struct.unpack("I", struct.pack("f", x))[0]
+    if (x > 0) == up:
+        bits += 1
+    else:
+        bits -= 1
+    return struct.unpack("f", struct.pack("I", bits))[0]
+
+
+def lgbm_threshold(t):
+    """LightGBM goes left on x <= t, we go left on x < thr"""
+    f = f32(t)
+    if f > t:
+        f = f32_step(f, False)
+    return f32_step(f, True)
+
+
+class Forest:
+    def __init__(self):
+        self.roots = []
+        self.left = []
+        self.right = []
+        self.thr = []
+        self.feat = []
+        self.flags = []
+        self.leaf = []
+        self.base = 0.0
+        self.sigmoid = 0.0
+        self.average = False
+
+    def add_tree(self, inner, leaves):
+        """inner: list of (feat, thr, flags, left, right), children are
+        local node indices, or ~local leaf index"""
+        node_off = len(self.left)
+        leaf_off = len(self.leaf)
+        self.leaf.extend(leaves)
+        if not inner:
+            assert len(leaves) == 1
+            self.roots.append(~leaf_off)
+            return
+
+        def child(c):
+            if c >= 0:
+                return c + node_off
+            return ~(~c + leaf_off)
+
+        for feat, thr, flags, left, right in inner:
+            if feat < 0 or feat > 0xffff:
+                raise ValueError("feature index %d out of range" % feat)
+            self.feat.append(feat)
+            self.thr.append(thr)
+            self.flags.append(flags)
+            self.left.append(child(left))
+            self.right.append(child(right))
+        self.roots.append(node_off)
+
+
+def logit(p):
+    return math.log(p/(1.0-p))
+
+
+def read_xgb(model):
+    learner = model["learner"]
+    param = learner["learner_model_param"]
+    if int(param.get("num_class", "0")) > 1:
+        raise ValueError("only single-output models are supported")
+
+    base_score = float(str(param["base_score"]).strip("[]"))
+    forest = Forest()
+    obj = learner["objective"]["name"]
+    if obj in ("binary:logistic", "reg:logistic"):
+        forest.sigmoid = 1.0
+        forest.base = logit(base_score)
+    elif obj == "binary:logitraw":
+        forest.base = logit(base_score)
+    elif obj in ("reg:squarederror", "reg:linear", "reg:pseudohubererror"):
+        forest.base = base_score
+    else:
+        raise ValueError("unsupported objective '%s'" % obj)
+
+    booster = learner["gradient_booster"]
+    weights = None
+    if booster["name"] == "dart":
+        weights = booster["weight_drop"]
+        booster = booster["gbtree"]
+    elif booster["name"] != "gbtree":
+        raise ValueError("unsupported booster '%s'" % booster["name"])
+
+    for num, tree in enumerate(booster["model"]["trees"]):
+        lefts = tree["left_children"]
+        rights = tree["right_children"]
+        if any(int(x) != 0 for x in tree.get("split_type", [])):
+            raise ValueError("categorical splits are not supported")
+        w = 1.0 if weights is None else weights[num]
+
+        # Renumber: inner nodes and leaves get their own dense indices
+        inner_id = {}
+        leaf_id = {}
+        for i in range(len(lefts)):
+            if lefts[i] == -1:
+                leaf_id[i] = len(leaf_id)
+            else:
+                inner_id[i] = len(inner_id)
+
+        def child(c):
+            if lefts[c] == -1:
+                return ~leaf_id[c]
+            return inner_id[c]
+
+        inner = []
+        leaves = [0.0]*len(leaf_id)
+        for i in range(len(lefts)):
+            cond = tree["split_conditions"][i]
+            if lefts[i] == -1:
+                leaves[leaf_id[i]] = cond*w
+                continue
+            flags = NAN_MISSING
+            if int(tree["default_left"][i]):
+                flags |= DEFAULT_LEFT
+            inner.append((int(tree["split_indices"][i]), f32(cond), flags,
+                          child(lefts[i]), child(rights[i])))
+        if 0 in leaf_id:
+            inner = []
+        forest.add_tree(inner, leaves)
+    return forest
+
+
+def read_lgbm(text):
+    header = {}
+    trees = []
+    cur = None
+    for line in text.splitlines():
+        line = line.rstrip("\r")
+        if line == "end of trees":
+            break
+        if not line:
+            continue
+        key, _, val = line.partition("=")
+        if key == "Tree":
+            cur = {}
+            trees.append(cur)
+        elif cur is not None:
+            cur[key] = val
+        else:
+            header[key] = val
+    else:
+        raise ValueError("no \"end of trees\" in model")
+
+    if header.get("num_class", "1") != "1":
+        raise ValueError("only single-output models are supported")
+    forest = Forest()
+    obj = header.get("objective", "")
+    if obj.startswith("binary"):
+        forest.sigmoid = 1.0
+        for part in obj.split():
+            if part.startswith("sigmoid:"):
+                forest.sigmoid = float(part[8:])
+    elif obj.startswith("cross_entropy") or obj.startswith("xentropy"):
+        forest.sigmoid = 1.0
+    elif not obj.startswith("regression"):
+        raise ValueError("unsupported objective '%s'" % obj)
+    forest.average = "average_output" in header
+
+    for tree in trees:
+        if tree.get("num_cat", "0") != "0" or tree.get("is_linear", "0") != "0":
+            raise ValueError("categorical and linear trees are not supported")
+        leaves = [float(x) for x in tree["leaf_value"].split()]
+        if len(leaves) == 1:
+            forest.add_tree([], leaves)
+            continue
+
+        inner = []
+        cols = zip(tree["split_feature"].split(), tree["threshold"].split(),
+                   tree["decision_type"].split(), tree["left_child"].split(),
+                   tree["right_child"].split())
+        for feat, thr, dec, left, right in cols:
+            dec = int(dec)
+            if dec & 1:
+                raise ValueError("categorical splits are not supported")
+            flags = 0
+            if dec & 2:
+                flags |= DEFAULT_LEFT
+            missing_type = (dec >> 2) & 3
+            if missing_type == 1:
+                flags |= ZERO_MISSING
+            elif missing_type == 2:
+                flags |= NAN_MISSING
+            inner.append((int(feat), lgbm_threshold(float(thr)), flags,
+                          int(left), int(right)))
+        if len(inner) != len(leaves)-1:
+            raise ValueError("inconsistent tree sizes")
+        forest.add_tree(inner, leaves)
+    return forest
+
+
+def c_float(x):
+    if math.isinf(x):
+        return "HUGE_VALF" if x > 0 else "-HUGE_VALF"
+    return "%.9g" % x
+
+
+def c_double(x):
+    return repr(float(x))
+
+
+def write_array(out, ctype, name, vals, fmt=str):
+    # Empty arrays are not allowed, a dummy element is never read
+    if not vals:
+        vals = [0]
+    out.write("static const %s %s[] = {" % (ctype, name))
+    for i, v in enumerate(vals):
+        if i % 8 == 0:
+            out.write("\n   ")
+        out.write(" %s," % fmt(v))
+    out.write("\n};\n")
+
+
+def write_cpp(forest, out, name, source, digest):
+    out.write("// Generated by gbdt_to_cpp.py from %s, do not edit\n" % source)
+    out.write("// sha1: %s\n\n" % digest)
+    out.write("#include <cmath>\n")
+    out.write("#include \"flat_forest.h\"\n\n")
+    out.write("namespace CMSat {\n\n")
+    write_array(out, "int32_t", name + "_roots", forest.roots)
+    write_array(out, "int32_t", name + "_left", forest.left)
+    write_array(out, "int32_t", name + "_right", forest.right)
+    write_array(out, "float", name + "_thr", forest.thr, c_float)
+    write_array(out, "uint16_t", name + "_feat", forest.feat)
+    write_array(out, "uint8_t", name + "_flags", forest.flags)
+    write_array(out, "double", name + "_leaf", forest.leaf, c_double)
+    out.write("\nextern const FlatForest %s;\n" % name)
+    out.write("const FlatForest %s = {\n" % name)
+    out.write("    %d,\n" % len(forest.roots))
+    for arr in ("roots", "left", "right", "thr", "feat", "flags", "leaf"):
+        out.write("    %s_%s,\n" % (name, arr))
+    out.write("    %r,\n" % forest.base)
+    out.write("    %r,\n" % forest.sigmoid)
+    out.write("    %s\n" % ("true" if forest.average else "false"))
+    out.write("};\n\n}\n")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 4:
+        print("Usage: %s model output.cpp name" % sys.argv[0])
+        sys.exit(-1)
+
+    with open(sys.argv[1], "rb") as f:
+        contents = f.read()
+    text = contents.decode("utf-8")
+    if text.lstrip().startswith("{"):
+        forest = read_xgb(json.loads(text))
+    else:
+        forest = read_lgbm(text)
+
+    with open(sys.argv[2], "w") as out:
+        write_cpp(forest, out, sys.argv[3], sys.argv[1],
+                  hashlib.sha1(contents).hexdigest())
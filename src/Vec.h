@@ -35,6 +35,8 @@ using std::numeric_limits;
 namespace CMSat {
 
 class Watched;
+class watch_array;
+class watch_subarray;
 
 //=================================================================================================
 // Automatically resizable arrays
@@ -63,6 +65,9 @@ public:
         return data + sz;
     }
 private:
+    //Watchlists keep their elements in watch_array's arena
+    friend class watch_array;
+    friend class watch_subarray;
     uint32_t sz;
     uint32_t cap;
 
@@ -390,7 +390,7 @@ void CardFinder::find_cards()
 
     //clean indexes
     for(auto& lit: solver->watches.get_smudged_list()) {
-        auto& ws = solver->watches[lit];
+        watch_subarray ws = solver->watches[lit];
         size_t j = 0;
         for(size_t i = 0; i < ws.size(); i++) {
             if (!ws[i].isIdx()) {
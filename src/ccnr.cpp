@@ -36,8 +36,84 @@ using std::endl;
 using std::string;
 
 
+/**********************************formula*******************************/
+formula::formula()
+{
+    _cl_start.push_back(0);
+}
+
+void formula::reserve(uint64_t num_clauses, uint64_t num_lits)
+{
+    _cl_start.reserve(num_clauses+1);
+    _cl_lits.reserve(num_lits);
+}
+
+void formula::add_clause(const vector<int>& lits)
+{
+    for (int l: lits) {
+        _cl_lits.push_back(lit(l, _num_clauses));
+    }
+    _cl_start.push_back(_cl_lits.size());
+    _num_clauses++;
+}
+
+//Builds the variable occurrences from the clauses, and the neighbour lists if
+//they are certain to fit in max_neighbor_entries
+void formula::finalize(uint64_t max_neighbor_entries)
+{
+    _var_start.assign(_num_vars+2, 0);
+    for (const lit& l: _cl_lits) {
+        _var_start[l.var_num+1]++;
+    }
+    for (int v = 0; v <= _num_vars; v++) {
+        _var_start[v+1] += _var_start[v];
+    }
+    _var_lits.resize(_cl_lits.size(), lit(0, 0));
+    vector<uint32_t> at(_var_start.begin(), _var_start.end()-1);
+    for (const lit& l: _cl_lits) {
+        _var_lits[at[l.var_num]++] = l;
+    }
+
+    uint64_t max_entries = 0;
+    for (int c = 0; c < _num_clauses; c++) {
+        uint64_t sz = _cl_start[c+1] - _cl_start[c];
+        max_entries += sz*(sz-1);
+    }
+    _neighbor_vars.clear();
+    _neighbor_start.clear();
+    if (max_entries > max_neighbor_entries) {
+        return;
+    }
+
+    vector<bool> neighbor_flag(_num_vars+1, false);
+    _neighbor_start.resize(_num_vars+2, 0);
+    for (int v = 1; v <= _num_vars; ++v) {
+        for (lit lv: var_lits(v)) {
+            for (lit lc: clause_lits(lv.clause_num)) {
+                if (!neighbor_flag[lc.var_num] && lc.var_num != v) {
+                    neighbor_flag[lc.var_num] = 1;
+                    _neighbor_vars.push_back(lc.var_num);
+                }
+            }
+        }
+        _neighbor_start[v+1] = _neighbor_vars.size();
+        for (int n: neighbors(v)) {
+            neighbor_flag[n] = 0;
+        }
+    }
+    _neighbor_vars.shrink_to_fit();
+}
+
+uint64_t formula::mem_used() const
+{
+    return (_cl_lits.capacity() + _var_lits.capacity())*sizeof(lit)
+        + (_cl_start.capacity() + _var_start.capacity() + _neighbor_start.capacity())*sizeof(uint32_t)
+        + _neighbor_vars.capacity()*sizeof(int);
+}
+
 //constructor with default setting.
-ls_solver::ls_solver(const bool aspiration)
+ls_solver::ls_solver(const bool aspiration, const formula* f) :
+    _f(f)
 {
     _max_tries = 100;
     _max_steps = 1*1000 * 1000;
@@ -54,6 +130,8 @@ ls_solver::ls_solver(const bool aspiration)
 /**********************************build instance*******************************/
 bool ls_solver::make_space()
 {
+    _num_vars = _f->_num_vars;
+    _num_clauses = _f->_num_clauses;
     if (0 == _num_vars || 0 == _num_clauses) {
         cout << "c [ccnr] The formula size is zero."
         "You may have forgotten to read the formula." << endl;
@@ -69,29 +147,6 @@ bool ls_solver::make_space()
     return true;
 }
 
-void ls_solver::build_neighborhood()
-{
-    vector<bool> neighbor_flag(_num_vars+1);
-    for (uint32_t j = 0; j < neighbor_flag.size(); ++j) {
-        neighbor_flag[j] = 0;
-    }
-    for (int v = 1; v <= _num_vars; ++v) {
-        variable *vp = &(_vars[v]);
-        for (lit lv: vp->literals) {
-            int c = lv.clause_num;
-            for (lit lc: _clauses[c].literals) {
-                if (!neighbor_flag[lc.var_num] && lc.var_num != v) {
-                    neighbor_flag[lc.var_num] = 1;
-                    vp->neighbor_var_nums.push_back(lc.var_num);
-                }
-            }
-        }
-        for (uint32_t j = 0; j < vp->neighbor_var_nums.size(); ++j) {
-            neighbor_flag[vp->neighbor_var_nums[j]] = 0;
-        }
-    }
-}
-
 /****************local search**********************************/
 //bool  *return value modified
 bool ls_solver::local_search(
@@ -107,6 +162,10 @@ bool ls_solver::local_search(
     for (int t = 0; t < _max_tries; t++) {
         initialize(init_solution);
         if (0 == _unsat_clauses.size()) {
+            _best_found_cost = 0;
+            std::copy(_solution.begin(), _solution.end(),
+                      _best_solution.begin());
+            if (_found) _found->store(true, std::memory_order_relaxed);
             result = true;
             break;
         }
@@ -115,7 +174,9 @@ bool ls_solver::local_search(
             int flipv = pick_var();
             flip(flipv);
             for(int var_idx:_unsat_vars) ++_conflict_ct[var_idx];
-            if (_mems > _mems_limit) {
+            if (_mems > _mems_limit
+                || (_found && _found->load(std::memory_order_relaxed))
+            ) {
                 return result;
             }
 
@@ -138,6 +199,7 @@ bool ls_solver::local_search(
 
 
             if (_best_found_cost == 0) {
+                if (_found) _found->store(true, std::memory_order_relaxed);
                 result = true;
                 break;
             }
@@ -195,7 +257,7 @@ void ls_solver::initialize(const vector<bool> *init_solution)
         _clauses[c].sat_var = -1;
         _clauses[c].weight = 1;
 
-        for (lit l: _clauses[c].literals) {
+        for (lit l: _f->clause_lits(c)) {
             if (_solution[l.var_num] == l.sense) {
                 _clauses[c].sat_count++;
                 _clauses[c].sat_var = l.var_num;
@@ -216,7 +278,7 @@ void ls_solver::initialize_variable_datas()
     for (int v = 1; v <= _num_vars; v++) {
         vp = &(_vars[v]);
         vp->score = 0;
-        for (lit l: vp->literals) {
+        for (lit l: _f->var_lits(v)) {
             int c = l.clause_num;
             if (0 == _clauses[c].sat_count) {
                 vp->score += _clauses[c].weight;
@@ -300,10 +362,10 @@ int ls_solver::pick_var()
 
     /*focused random walk*/
     int c = _unsat_clauses[_random_gen.next(_unsat_clauses.size())];
-    clause *cp = &(_clauses[c]);
-    best_var = cp->literals[0].var_num;
-    for (size_t k = 1; k < cp->literals.size(); k++) {
-        int v = cp->literals[k].var_num;
+    span<lit> cl_lits = _f->clause_lits(c);
+    best_var = cl_lits[0].var_num;
+    for (size_t k = 1; k < cl_lits.size(); k++) {
+        int v = cl_lits[k].var_num;
         if (_vars[v].score > _vars[best_var].score) {
             best_var = v;
         } else if (_vars[v].score == _vars[best_var].score &&
@@ -319,17 +381,18 @@ void ls_solver::flip(int flipv)
 {
     _solution[flipv] = 1 - _solution[flipv];
     int org_flipv_score = _vars[flipv].score;
-    _mems += _vars[flipv].literals.size();
+    span<lit> occs = _f->var_lits(flipv);
+    _mems += occs.size();
 
     // Go through each clause the literal is in and update status
-    for (lit l: _vars[flipv].literals) {
+    for (lit l: occs) {
         clause *cp = &(_clauses[l.clause_num]);
         if (_solution[flipv] == l.sense) {
             cp->sat_count++;
             if (1 == cp->sat_count) {
                 sat_a_clause(l.clause_num);
                 cp->sat_var = flipv;
-                for (lit lc: cp->literals) {
+                for (lit lc: _f->clause_lits(l.clause_num)) {
                     _vars[lc.var_num].score -= cp->weight;
                 }
             } else if (2 == cp->sat_count) {
@@ -339,11 +402,11 @@ void ls_solver::flip(int flipv)
             cp->sat_count--;
             if (0 == cp->sat_count) {
                 unsat_a_clause(l.clause_num);
-                for (lit lc: cp->literals) {
+                for (lit lc: _f->clause_lits(l.clause_num)) {
                     _vars[lc.var_num].score += cp->weight;
                 }
             } else if (1 == cp->sat_count) {
-                for (lit lc: cp->literals) {
+                for (lit lc: _f->clause_lits(l.clause_num)) {
                     if (_solution[lc.var_num] == lc.sense) {
                         _vars[lc.var_num].score -= cp->weight;
                         cp->sat_var = lc.var_num;
@@ -378,13 +441,32 @@ void ls_solver::update_cc_after_flip(int flipv)
     }
 
     //update all flipv's neighbor's cc to be 1
-    _mems += vp->neighbor_var_nums.size()/4;
-    for (int v: vp->neighbor_var_nums) {
-        _vars[v].cc_value = 1;
-        if (_vars[v].score > 0 && !(_vars[v].is_in_ccd_vars)) {
-            _ccd_vars.push_back(v);
-            _vars[v].is_in_ccd_vars = 1;
+    if (_f->has_neighbors()) {
+        span<int> neighbors = _f->neighbors(flipv);
+        _mems += neighbors.size()/4;
+        for (int v: neighbors) {
+            neighbor_cc_to_1(v);
         }
+    } else {
+        //Neighbour lists were too large to store, go through the clauses
+        for (lit l: _f->var_lits(flipv)) {
+            span<lit> cl_lits = _f->clause_lits(l.clause_num);
+            _mems += cl_lits.size()/4;
+            for (lit lc: cl_lits) {
+                if (lc.var_num != flipv) {
+                    neighbor_cc_to_1(lc.var_num);
+                }
+            }
+        }
+    }
+}
+
+void ls_solver::neighbor_cc_to_1(int v)
+{
+    _vars[v].cc_value = 1;
+    if (_vars[v].score > 0 && !(_vars[v].is_in_ccd_vars)) {
+        _ccd_vars.push_back(v);
+        _vars[v].is_in_ccd_vars = 1;
     }
 }
 
@@ -400,7 +482,7 @@ void ls_solver::sat_a_clause(int the_clause)
     }
     _index_in_unsat_clauses[last_item] = index;
     //update unsat_appear and unsat_vars
-    for (lit l: _clauses[the_clause].literals) {
+    for (lit l: _f->clause_lits(the_clause)) {
         _vars[l.var_num].unsat_appear--;
         if (0 == _vars[l.var_num].unsat_appear) {
             last_item = _unsat_vars.back();
@@ -418,7 +500,7 @@ void ls_solver::unsat_a_clause(int the_clause)
     _index_in_unsat_clauses[the_clause] = _unsat_clauses.size();
     _unsat_clauses.push_back(the_clause);
     //update unsat_appear and unsat_vars
-    for (lit l: _clauses[the_clause].literals) {
+    for (lit l: _f->clause_lits(the_clause)) {
         _vars[l.var_num].unsat_appear++;
         if (1 == _vars[l.var_num].unsat_appear) {
             _index_in_unsat_vars[l.var_num] = _unsat_vars.size();
@@ -469,7 +551,7 @@ void ls_solver::smooth_clause_weights()
             _delta_total_clause_weight -= _num_clauses;
         }
         if (0 == cp->sat_count) {
-            for (lit l: cp->literals) {
+            for (lit l: _f->clause_lits(c)) {
                 _vars[l.var_num].score += cp->weight;
             }
         } else if (1 == cp->sat_count) {
@@ -506,7 +588,7 @@ void ls_solver::print_solution(bool need_verify)
     if (need_verify) {
         for (int c = 0; c < _num_clauses; c++) {
             sat_flag = false;
-            for (lit l: _clauses[c].literals) {
+            for (lit l: _f->clause_lits(c)) {
                 if (_solution[l.var_num] == l.sense) {
                     sat_flag = true;
                     break;
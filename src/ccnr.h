@@ -23,6 +23,7 @@ THE SOFTWARE.
 #ifndef CCNR_H
 #define CCNR_H
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -67,8 +68,6 @@ struct lit {
     }
 };
 struct variable {
-    vector<lit> literals;
-    vector<int> neighbor_var_nums;
     long long score;
     long long last_flip_step;
     int unsat_appear; //how many unsat clauses it appears in
@@ -76,19 +75,66 @@ struct variable {
     bool is_in_ccd_vars;
 };
 struct clause {
-    vector<lit> literals;
     int sat_count; //no. of satisfied literals
     int sat_var;
     long long weight;
 };
 
+template<class T>
+struct span {
+    const T* b;
+    const T* e;
+    const T* begin() const { return b; }
+    const T* end() const { return e; }
+    size_t size() const { return e-b; }
+    const T& operator[](size_t i) const { return b[i]; }
+};
+
+//The formula in CSR form. It is only read during search, so it is shared
+//between all the walkers.
+class formula
+{
+   public:
+    formula();
+    void reserve(uint64_t num_clauses, uint64_t num_lits);
+    void add_clause(const vector<int>& lits);
+    void finalize(uint64_t max_neighbor_entries);
+
+    span<lit> clause_lits(int c) const
+    {
+        return span<lit>{_cl_lits.data()+_cl_start[c], _cl_lits.data()+_cl_start[c+1]};
+    }
+    span<lit> var_lits(int v) const
+    {
+        return span<lit>{_var_lits.data()+_var_start[v], _var_lits.data()+_var_start[v+1]};
+    }
+    span<int> neighbors(int v) const
+    {
+        return span<int>{_neighbor_vars.data()+_neighbor_start[v], _neighbor_vars.data()+_neighbor_start[v+1]};
+    }
+    //If not, neighbours must be found through the clauses of the variable
+    bool has_neighbors() const { return !_neighbor_start.empty(); }
+    uint64_t mem_used() const;
+
+    int _num_vars = 0;
+    int _num_clauses = 0;
+
+   private:
+    vector<lit> _cl_lits; //lits of clause c are [_cl_start[c], _cl_start[c+1])
+    vector<uint32_t> _cl_start;
+    vector<lit> _var_lits; //occurrences of var v are [_var_start[v], _var_start[v+1])
+    vector<uint32_t> _var_start;
+    vector<int> _neighbor_vars;
+    vector<uint32_t> _neighbor_start;
+};
+
 //---------------------------
 //functions in mersenne.h & mersenne.cpp
 
 class ls_solver
 {
    public:
-    ls_solver(const bool aspiration);
+    ls_solver(const bool aspiration, const formula* f);
     bool parse_arguments(int argc, char **argv);
     bool build_instance(std::string inst);
     bool local_search(
@@ -102,8 +148,12 @@ class ls_solver
         return _best_found_cost;
     }
     void set_verbosity(uint32_t verb);
+    void set_seed(int seed) { _random_seed = seed; }
+    //Stop when this is set, and set it when a solution is found
+    void set_found_flag(std::atomic<bool>* found) { _found = found; }
 
     //formula
+    const formula* _f;
     vector<variable> _vars;
     vector<clause> _clauses;
     int _num_vars;
@@ -123,7 +173,6 @@ class ls_solver
 
     //functions for buiding data structure
     bool make_space();
-    void build_neighborhood();
     int get_cost() { return _unsat_clauses.size(); }
 
     private:
@@ -162,6 +211,7 @@ class ls_solver
     int pick_var();
     void flip(int flipv);
     void update_cc_after_flip(int flipv);
+    void neighbor_cc_to_1(int v);
     void update_clause_weights();
     void smooth_clause_weights();
 
@@ -172,6 +222,7 @@ class ls_solver
     //--------------------
     long long _end_step;
     uint32_t _verbosity = 0;
+    std::atomic<bool>* _found = NULL;
 
     long long up_times = 0;
     long long flip_numbers = 0;
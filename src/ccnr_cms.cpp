@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "solver.h"
 #include "ccnr.h"
 #include "sqlstats.h"
+#include "parallel_for.h"
 //#define SLOW_DEBUG
 
 using namespace CMSat;
@@ -39,13 +40,64 @@ CMS_ccnr::CMS_ccnr(Solver* _solver) :
     seen(_solver->seen),
     toClear(_solver->toClear)
 {
-    ls_s = new CCNR::ls_solver(solver->conf.sls_ccnr_asipire);
-    ls_s->set_verbosity(solver->conf.verbosity);
+    formula = new CCNR::formula;
 }
 
 CMS_ccnr::~CMS_ccnr()
 {
-    delete ls_s;
+    for(auto& w: walkers) delete w;
+    delete formula;
+}
+
+//With several SATSolver threads, each only gets its share of the cores
+uint32_t CMS_ccnr::num_walkers(const SolverConf& conf)
+{
+    uint32_t n = conf.sls_walkers;
+    if (n == 0) n = std::thread::hardware_concurrency()/std::max(conf.num_threads, 1U);
+    return std::max<uint32_t>(n, 1);
+}
+
+//Each walker starts from a different saved polarity, the ones beyond those
+//from a random assignment. They share the formula, and all stop as soon
+//as one of them finds a solution.
+int CMS_ccnr::run_walkers()
+{
+    const uint32_t n = num_walkers(solver->conf);
+    vector<vector<bool>> phases(std::min<uint32_t>(n, 3), vector<bool>(solver->nVars()+1));
+    for(uint32_t i = 0; i < solver->nVars(); i++) {
+        const VarData& vdata = solver->varData[i];
+        phases[0][i+1] = vdata.best_polarity;
+        if (phases.size() > 1) phases[1][i+1] = vdata.stable_polarity;
+        if (phases.size() > 2) phases[2][i+1] = vdata.saved_polarity;
+    }
+
+    std::atomic<bool> found(false);
+    for(uint32_t i = 0; i < n; i++) {
+        CCNR::ls_solver* w = new CCNR::ls_solver(solver->conf.sls_ccnr_asipire, formula);
+        walkers.push_back(w);
+        w->make_space();
+        w->set_seed(1+i);
+        if (i == 0) w->set_verbosity(solver->conf.verbosity);
+        if (n > 1) w->set_found_flag(&found);
+    }
+
+    vector<int> res(n, 0);
+    const long long mems_limit = solver->conf.yalsat_max_mems*2*1000*1000;
+    parallel_for(n, n, [&](uint32_t, uint64_t begin, uint64_t end) {
+        for(uint64_t i = begin; i < end; i++) {
+            res[i] = walkers[i]->local_search(i < phases.size() ? &phases[i] : NULL, mems_limit);
+        }
+    });
+
+    uint32_t best = 0;
+    for(uint32_t i = 1; i < n; i++) {
+        if (walkers[i]->get_best_cost() < walkers[best]->get_best_cost()) best = i;
+    }
+    ls_s = walkers[best];
+    verb_print(1, "[ccnr] walkers: " << n << " best: " << best
+        << " best cost: " << ls_s->get_best_cost());
+
+    return res[best];
 }
 
 lbool CMS_ccnr::main(const uint32_t num_sls_called)
@@ -69,13 +121,12 @@ lbool CMS_ccnr::main(const uint32_t num_sls_called)
         }
         return l_Undef;
     }
-
-    vector<bool> phases(solver->nVars()+1);
-    for(uint32_t i = 0; i < solver->nVars(); i++) {
-        phases[i+1] = solver->varData[i].best_polarity;
+    if (formula->_num_clauses == 0) {
+        verb_print(1, "[ccnr] all clauses satisfied, nothing to do");
+        return l_Undef;
     }
 
-    int res = ls_s->local_search(&phases, solver->conf.yalsat_max_mems*2*1000*1000);
+    int res = run_walkers();
     lbool ret = deal_with_solution(res, num_sls_called);
 
     double time_used = cpuTime()-startTime;
@@ -132,10 +183,7 @@ CMS_ccnr::add_cl_ret CMS_ccnr::add_this_clause(const T& cl)
         return add_cl_ret::unsat;
     }
 
-    for(auto& lit: yals_lits) {
-        ls_s->_clauses[cl_num].literals.push_back(CCNR::lit(lit, cl_num));
-    }
-    cl_num++;
+    formula->add_clause(yals_lits);
 
     return add_cl_ret::added_cl;
 }
@@ -150,9 +198,10 @@ bool CMS_ccnr::init_problem()
     solver->check_stats();
     #endif
 
-    ls_s->_num_vars = solver->nVars();
-    ls_s->_num_clauses = solver->longIrredCls.size() + solver->binTri.irredBins;
-    ls_s->make_space();
+    formula->_num_vars = solver->nVars();
+    formula->reserve(
+        solver->longIrredCls.size() + solver->binTri.irredBins
+        , solver->litStats.irredLits + solver->binTri.irredBins*2);
 
     vector<Lit> this_clause;
     for(size_t i2 = 0; i2 < solver->nVars()*2; i2++) {
@@ -179,27 +228,22 @@ bool CMS_ccnr::init_problem()
         }
     }
 
-    //Shrink the space if we have to
-    assert(ls_s->_num_clauses >= (int)cl_num);
-    ls_s->_num_clauses = (int)cl_num;
-    ls_s->make_space();
-
-    for (int c=0; c < ls_s->_num_clauses; c++) {
-        for(CCNR::lit item: ls_s->_clauses[c].literals) {
-            int v = item.var_num;
-            ls_s->_vars[v].literals.push_back(item);
-        }
-    }
-    ls_s->build_neighborhood();
+    //Neighbour lists may take at most a quarter of the SLS memory budget
+    formula->finalize(
+        (uint64_t)solver->conf.sls_memoutMB*1000ULL*1000ULL/(4*sizeof(int)));
+    verb_print(2, "[ccnr] formula mem: "
+        << formula->mem_used()/(1000*1000) << " MB"
+        << " neighbour lists: " << (formula->has_neighbors() ? "built" : "on the fly"));
 
     return true;
 }
 
 struct ClWeightSorter
 {
-    bool operator()(const CCNR::clause& a, const CCNR::clause& b)
+    const vector<CCNR::clause>& clauses;
+    bool operator()(const uint32_t a, const uint32_t b) const
     {
-        return a.weight > b.weight;
+        return clauses[a].weight > clauses[b].weight;
     }
 };
 
@@ -229,15 +273,17 @@ vector<pair<uint32_t, double>> CMS_ccnr::get_bump_based_on_cls()
     SLOW_DEBUG_DO(for(const auto x: seen) assert(x == 0));
 
     vector<pair<uint32_t, double>> tobump_cl_var;
-    std::sort(ls_s->_clauses.begin(), ls_s->_clauses.end(), ClWeightSorter());
+    vector<uint32_t> cls_by_weight(ls_s->_num_clauses);
+    for(uint32_t c = 0; c < cls_by_weight.size(); c++) cls_by_weight[c] = c;
+    std::sort(cls_by_weight.begin(), cls_by_weight.end(), ClWeightSorter{ls_s->_clauses});
     uint32_t vars_bumped = 0;
     uint32_t individual_vars_bumped = 0;
-    for(const auto& c: ls_s->_clauses) {
+    for(const uint32_t c: cls_by_weight) {
         if (vars_bumped > solver->conf.sls_how_many_to_bump)
             break;
 
-        for(uint32_t i = 0; i < c.literals.size(); i++) {
-            uint32_t v = c.literals[i].var_num-1;
+        for(const CCNR::lit& l: formula->clause_lits(c)) {
+            uint32_t v = l.var_num-1;
             if (v < solver->nVars() &&
                 solver->varData[v].removed == Removed::none &&
                 solver->value(v) == l_Undef &&
@@ -30,11 +30,13 @@ THE SOFTWARE.
 
 namespace CCNR {
     class ls_solver;
+    class formula;
 }
 
 namespace CMSat {
 
 class Solver;
+class SolverConf;
 using std::pair;
 using std::make_pair;
 
@@ -43,6 +45,7 @@ public:
     lbool main(const uint32_t num_sls_called);
     CMS_ccnr(Solver* _solver);
     ~CMS_ccnr();
+    static uint32_t num_walkers(const SolverConf& conf);
 
 private:
     Solver* solver;
@@ -59,8 +62,10 @@ private:
     void init_for_round();
     bool init_problem();
     lbool deal_with_solution(int res, const uint32_t num_sls_called);
-    CCNR::ls_solver* ls_s = NULL;
-    uint32_t cl_num = 0;
+    CCNR::formula* formula = NULL;
+    vector<CCNR::ls_solver*> walkers;
+    CCNR::ls_solver* ls_s = NULL; ///<The walker with the best assignment
+    int run_walkers();
 
     enum class add_cl_ret {added_cl, skipped_cl, unsat};
     template<class T>
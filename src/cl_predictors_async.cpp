@@ -0,0 +1,112 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "cl_predictors_async.h"
+#include "time_mem.h"
+#include <chrono>
+
+using namespace CMSat;
+
+ClPredictorsAsync::ClPredictorsAsync(ClPredictorsAbst* _predictors) :
+    predictors(_predictors)
+{
+    thd = std::thread(&ClPredictorsAsync::worker, this);
+}
+
+ClPredictorsAsync::~ClPredictorsAsync()
+{
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        stop = true;
+    }
+    cv.notify_all();
+    thd.join();
+}
+
+bool ClPredictorsAsync::submit(PredBatch&& _batch)
+{
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        if (job_waiting || job_running) return false;
+        batch = std::move(_batch);
+        job_waiting = true;
+        result_ready = false;
+    }
+    cv.notify_all();
+    return true;
+}
+
+bool ClPredictorsAsync::collect(const uint32_t wait_ms, PredBatch& out)
+{
+    std::unique_lock<std::mutex> lock(mu);
+    if (!result_ready) {
+        if (!job_waiting && !job_running) return false;
+        cv.wait_for(lock, std::chrono::milliseconds(wait_ms),
+            [&]{ return result_ready; });
+        if (!result_ready) return false;
+    }
+    out = std::move(batch);
+    result_ready = false;
+    return true;
+}
+
+void ClPredictorsAsync::worker()
+{
+    while(true) {
+        PredBatch b;
+        {
+            std::unique_lock<std::mutex> lock(mu);
+            cv.wait(lock, [&]{ return stop || job_waiting; });
+            if (stop) return;
+            b = std::move(batch);
+            job_waiting = false;
+            job_running = true;
+        }
+
+        const double myTime = cpuTime();
+        const uint32_t num = b.ids.size();
+        assert(b.data.size() == (size_t)num*predictors->get_step_size());
+        predictors->predict_all(b.data.data(), num);
+        b.pred_short.resize(num);
+        b.pred_long.resize(num);
+        b.pred_forever.resize(num);
+        ClauseStatsExtra tmp;
+        for(uint32_t i = 0; i < num; i++) {
+            predictors->get_prediction_at(tmp, i);
+            b.pred_short[i] = tmp.pred_short_use;
+            b.pred_long[i] = tmp.pred_long_use;
+            b.pred_forever[i] = tmp.pred_forever_use;
+        }
+        predictors->finish_all_predict();
+        b.data.clear();
+        b.data.shrink_to_fit();
+        b.time_used = cpuTime() - myTime;
+
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            batch = std::move(b);
+            job_running = false;
+            result_ready = true;
+        }
+        cv.notify_all();
+    }
+}
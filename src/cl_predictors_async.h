@@ -0,0 +1,82 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef _CLPREDICTORS_ASYNC_H__
+#define _CLPREDICTORS_ASYNC_H__
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "cl_predictors_abs.h"
+
+using std::vector;
+
+namespace CMSat {
+
+//Feature matrix of one reduction point, and once inference is done, the
+//predictions for it. Rows are identified by clause ID, since clauses may
+//be moved, strengthened or deleted before the predictions are applied.
+struct PredBatch
+{
+    uint64_t at_conflict = 0;
+    vector<int32_t> ids;
+    vector<float> data;
+    vector<float> pred_short;
+    vector<float> pred_long;
+    vector<float> pred_forever;
+    double time_used = 0;
+};
+
+//Runs model inference for ReduceDB on a background thread, so the
+//solver thread only builds the feature matrix. The predictor is only
+//ever used by the worker once handed over.
+class ClPredictorsAsync
+{
+public:
+    explicit ClPredictorsAsync(ClPredictorsAbst* predictors);
+    ~ClPredictorsAsync();
+
+    //Returns false, and drops the batch, if the previous one is still running
+    bool submit(PredBatch&& batch);
+
+    //Waits at most wait_ms for the submitted batch to finish
+    bool collect(const uint32_t wait_ms, PredBatch& out);
+
+private:
+    void worker();
+
+    ClPredictorsAbst* predictors;
+    std::thread thd;
+    std::mutex mu;
+    std::condition_variable cv;
+    bool job_waiting = false;
+    bool job_running = false;
+    bool result_ready = false;
+    bool stop = false;
+    PredBatch batch;
+};
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "cl_predictors_tree.h"
+#include "clause.h"
+#include <iostream>
+
+namespace CMSat {
+extern const FlatForest pred_tree_short;
+extern const FlatForest pred_tree_long;
+extern const FlatForest pred_tree_forever;
+}
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+ClPredictorsTree::ClPredictorsTree()
+{
+    for(auto& f: forest) f = NULL;
+}
+
+ClPredictorsTree::~ClPredictorsTree()
+{
+}
+
+int ClPredictorsTree::load_models(const std::string& short_fname,
+                               const std::string& long_fname,
+                               const std::string& forever_fname,
+                               const std::string& /*best_feats_fname*/)
+{
+    const std::string* fnames[3] = {&short_fname, &long_fname, &forever_fname};
+    for(uint32_t i = 0; i < 3; i++) {
+        std::string err;
+        if (!store[i].load_lgbm(*fnames[i], err)) {
+            cout << "ERROR: cannot load tree model '" << *fnames[i] << "': "
+            << err << endl;
+            return 0;
+        }
+        forest[i] = &store[i].get();
+    }
+    return 1;
+}
+
+int ClPredictorsTree::load_models_from_buffers()
+{
+    forest[predict_type::short_pred] = &pred_tree_short;
+    forest[predict_type::long_pred] = &pred_tree_long;
+    forest[predict_type::forever_pred] = &pred_tree_forever;
+    return 0;
+}
+
+void ClPredictorsTree::predict_all(
+    float* const data,
+    const uint32_t num)
+{
+    for(uint32_t i = 0; i < 3; i ++) {
+        assert(forest[i] != NULL);
+        out_result[i].resize(num);
+        forest[i]->predict(data, num, PRED_COLS, out_result[i].data());
+    }
+}
+
+void ClPredictorsTree::get_prediction_at(ClauseStatsExtra& extdata, const uint32_t at)
+{
+    extdata.pred_short_use   = out_result[0][at];
+    extdata.pred_long_use    = out_result[1][at];
+    extdata.pred_forever_use = out_result[2][at];
+}
+
+void ClPredictorsTree::finish_all_predict()
+{
+}
@@ -132,6 +132,8 @@ struct ClauseStats
         is_ternary_resolvent = 0;
         activity = 0;
         is_tracked = false;
+        is_imported = false;
+        imported_used = false;
     }
 
     //Stored data
@@ -143,6 +145,8 @@ struct ClauseStats
     uint32_t locked_for_data_gen:1;
     uint32_t is_ternary_resolvent:1;
     uint32_t is_tracked:1;
+    uint32_t is_imported:1; //learnt by another thread
+    uint32_t imported_used:1; //imported, and used at least once in conflict analysis
     union {
         float   activity;
         uint32_t hash_val; //used in BreakID to remove equivalent clauses
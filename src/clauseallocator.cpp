@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <limits>
 #include <cassert>
 #include <cmath>
+#include <atomic>
 #include "solvertypes.h"
 #include "clause.h"
 #include "solver.h"
@@ -35,12 +36,20 @@ THE SOFTWARE.
 #include "time_mem.h"
 #include "sqlstats.h"
 #include "gaussian.h"
+#include "simplefile.h"
 
 #ifdef USE_VALGRIND
 #include "valgrind/valgrind.h"
 #include "valgrind/memcheck.h"
 #endif
 
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(EMSCRIPTEN)
+#define CL_ALLOC_MMAP
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
 using namespace CMSat;
 
 using std::pair;
@@ -59,11 +68,29 @@ using std::endl;
 
 #define MAXSIZE ((1ULL << (EFFECTIVELY_USEABLE_BITS))-1)
 
+//Offsets can count units of up to (1<<MAX_OFFSET_SHIFT) datapieces.
+//With 64b offsets there is no need to.
+#ifdef LARGE_OFFSETS
+#define MAX_OFFSET_SHIFT 0U
+#else
+#define MAX_OFFSET_SHIFT 4U
+#endif
+
+//Upper limit of the address range reserved by all allocators of the process
+//together. Under ulimit -v, it is a quarter of the limit instead.
+#define MAX_RESERVE_BYTES (1ULL << 40)
+
+//The range reserved is this many times the capacity asked for
+#define RESERVE_GROW_MULT 4
+
 ClauseAllocator::ClauseAllocator() :
     dataStart(NULL)
     , size(0)
     , capacity(0)
     , currentlyUsedSize(0)
+    , offset_shift(0)
+    , reserved(0)
+    , huge_pages(false)
 {
     assert(MIN_LIST_SIZE < MAXSIZE);
 }
@@ -73,16 +100,246 @@ ClauseAllocator::ClauseAllocator() :
 */
 ClauseAllocator::~ClauseAllocator()
 {
+    #ifdef CL_ALLOC_MMAP
+    if (reserved > 0) {
+        release_arena();
+        return;
+    }
+    #endif
     free(dataStart);
 }
 
+void ClauseAllocator::set_offset_shift(const uint32_t shift)
+{
+    assert(size == 0);
+    offset_shift = std::min(shift, MAX_OFFSET_SHIFT);
+}
+
+//Number of datapieces addressable with offsets in units of (1<<shift) datapieces
+uint64_t ClauseAllocator::max_size(const uint32_t shift) const
+{
+    return MAXSIZE << shift;
+}
+
+//Number of datapieces needed for bytes, padded to the offset unit
+uint64_t ClauseAllocator::data_for_bytes(const uint64_t bytes, const uint32_t shift) const
+{
+    const uint64_t elems = bytes/sizeof(BASE_DATA_TYPE) + (bool)(bytes % sizeof(BASE_DATA_TYPE));
+    const uint64_t unit = 1ULL << shift;
+    return (elems + unit - 1) & ~(unit - 1);
+}
+
+#ifdef CL_ALLOC_MMAP
+static uint64_t round_to_pages(const uint64_t bytes)
+{
+    const uint64_t page = sysconf(_SC_PAGESIZE);
+    return (bytes + page - 1) / page * page;
+}
+
+//Address range reserved by all allocators of the process, i.e. all threads
+static std::atomic<uint64_t> reserved_bytes_total(0);
+
+static bool take_reserve_budget(const uint64_t bytes)
+{
+    uint64_t budget = MAX_RESERVE_BYTES;
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_AS, &lim) == 0 && lim.rlim_cur != RLIM_INFINITY) {
+        budget = std::min<uint64_t>(budget, lim.rlim_cur/4);
+    }
+
+    uint64_t cur = reserved_bytes_total.load();
+    do {
+        if (cur + bytes > budget) {
+            return false;
+        }
+    } while (!reserved_bytes_total.compare_exchange_weak(cur, cur + bytes));
+    return true;
+}
+
+static void give_reserve_budget(const uint64_t bytes)
+{
+    reserved_bytes_total.fetch_sub(bytes);
+}
+#endif
+
+/**
+@brief Reserves an address range for at least min_capacity datapieces
+
+The range is PROT_NONE until used, so it is not charged against the commit
+limit even with overcommit turned off. It is a few times what is asked for,
+so that the stack can grow a while by committing pages only. All allocators
+of the process share one budget for these ranges, so that several threads
+together stay well within ulimit -v. If the budget or mmap() refuse, smaller
+ranges are tried down to min_capacity.
+
+If the stack already had a range, it is moved to the new one. On Linux the
+committed pages are remapped, elsewhere they are copied. If no range can be
+had, everything stays as it was, and the caller continues on the heap.
+*/
+void ClauseAllocator::reserve_arena([[maybe_unused]] const uint64_t min_capacity)
+{
+    #ifdef CL_ALLOC_MMAP
+    assert(min_capacity > 0);
+    const uint64_t max_bytes = std::min<uint64_t>(
+        max_size(MAX_OFFSET_SHIFT)*sizeof(BASE_DATA_TYPE), MAX_RESERVE_BYTES);
+    const uint64_t min_bytes = round_to_pages(min_capacity*sizeof(BASE_DATA_TYPE));
+    if (min_bytes > max_bytes || max_bytes > std::numeric_limits<size_t>::max()/2) {
+        return;
+    }
+    uint64_t bytes = std::max<uint64_t>(min_capacity, MIN_LIST_SIZE)
+        *RESERVE_GROW_MULT*sizeof(BASE_DATA_TYPE);
+    bytes = round_to_pages(std::min(bytes, max_bytes));
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    #ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+    #endif
+    void* mem = MAP_FAILED;
+    while (true) {
+        if (take_reserve_budget(bytes)) {
+            mem = mmap(NULL, bytes, PROT_NONE, flags, -1, 0);
+            if (mem != MAP_FAILED) {
+                break;
+            }
+            give_reserve_budget(bytes);
+        }
+        if (bytes == min_bytes) {
+            return;
+        }
+        bytes = std::max(min_bytes, round_to_pages(bytes/2));
+    }
+    #ifdef MADV_HUGEPAGE
+    if (huge_pages) {
+        madvise(mem, bytes, MADV_HUGEPAGE);
+    }
+    #endif
+
+    if (dataStart != NULL) {
+        assert(reserved > 0);
+        const uint64_t committed = round_to_pages(capacity*sizeof(BASE_DATA_TYPE));
+        bool moved = (committed == 0);
+        #ifdef MREMAP_FIXED
+        if (!moved) {
+            moved = mremap(dataStart, committed, committed
+                , MREMAP_MAYMOVE | MREMAP_FIXED, mem) != MAP_FAILED;
+        }
+        #endif
+        if (!moved) {
+            if (mprotect(mem, committed, PROT_READ | PROT_WRITE) != 0) {
+                munmap(mem, bytes);
+                give_reserve_budget(bytes);
+                return;
+            }
+            memcpy(mem, dataStart, size*sizeof(BASE_DATA_TYPE));
+        }
+        release_arena();
+    }
+    dataStart = (BASE_DATA_TYPE*)mem;
+    reserved = bytes/sizeof(BASE_DATA_TYPE);
+    #endif
+}
+
+void ClauseAllocator::release_arena()
+{
+    #ifdef CL_ALLOC_MMAP
+    assert(reserved > 0);
+    munmap(dataStart, reserved*sizeof(BASE_DATA_TYPE));
+    give_reserve_budget(reserved*sizeof(BASE_DATA_TYPE));
+    dataStart = NULL;
+    reserved = 0;
+    #endif
+}
+
+/**
+@brief Commits or gives back memory so that the stack can hold newcapacity datapieces
+
+Inside the reserved range, this only changes page protections, the data never
+moves. Outgrowing the range reserves a larger one, see reserve_arena(). If
+that fails, the stack moves to the heap, where it's a realloc()
+*/
+void ClauseAllocator::set_capacity(const uint64_t newcapacity)
+{
+    assert(newcapacity >= size);
+    if (newcapacity > 0
+        && (dataStart == NULL || (reserved > 0 && newcapacity > reserved))
+    ) {
+        reserve_arena(newcapacity);
+    }
+
+    #ifdef CL_ALLOC_MMAP
+    if (reserved > 0 && newcapacity <= reserved) {
+        char* base = (char*)dataStart;
+        const uint64_t old_bytes = round_to_pages(capacity*sizeof(BASE_DATA_TYPE));
+        const uint64_t new_bytes = round_to_pages(newcapacity*sizeof(BASE_DATA_TYPE));
+        if (new_bytes > old_bytes) {
+            if (mprotect(base + old_bytes, new_bytes - old_bytes, PROT_READ | PROT_WRITE) != 0) {
+                std::cerr
+                << "ERROR: while committing clause space"
+                << endl;
+
+                throw std::bad_alloc();
+            }
+        } else if (new_bytes < old_bytes) {
+            //Mapping over the pages drops them, and their commit charge
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+            #ifdef MAP_NORESERVE
+            flags |= MAP_NORESERVE;
+            #endif
+            void* mem = mmap(base + new_bytes, old_bytes - new_bytes, PROT_NONE, flags, -1, 0);
+            assert(mem != MAP_FAILED);
+            #ifdef MADV_HUGEPAGE
+            if (huge_pages) {
+                madvise(mem, old_bytes - new_bytes, MADV_HUGEPAGE);
+            }
+            #endif
+        }
+        capacity = newcapacity;
+        return;
+    }
+
+    if (reserved > 0) {
+        //Outgrew the reserved range, continue on the heap
+        BASE_DATA_TYPE* new_dataStart = (BASE_DATA_TYPE*)malloc(newcapacity*sizeof(BASE_DATA_TYPE));
+        if (new_dataStart == NULL) {
+            std::cerr
+            << "ERROR: while reallocating clause space"
+            << endl;
+
+            throw std::bad_alloc();
+        }
+        memcpy(new_dataStart, dataStart, size*sizeof(BASE_DATA_TYPE));
+        release_arena();
+        dataStart = new_dataStart;
+        capacity = newcapacity;
+        return;
+    }
+    #endif
+
+    //Reallocate data
+    BASE_DATA_TYPE* new_dataStart;
+    new_dataStart = (BASE_DATA_TYPE*)realloc(
+        dataStart
+        , newcapacity*sizeof(BASE_DATA_TYPE)
+    );
+
+    //Realloc failed?
+    if (new_dataStart == NULL && newcapacity > 0) {
+        std::cerr
+        << "ERROR: while reallocating clause space"
+        << endl;
+
+        throw std::bad_alloc();
+    }
+    dataStart = new_dataStart;
+    capacity = newcapacity;
+}
+
 void* ClauseAllocator::allocEnough(
     uint32_t num_lits
 ) {
     //Try to quickly find a place at the end of a dataStart
     uint64_t neededbytes = sizeof(Clause) + sizeof(Lit)*num_lits;
-    uint64_t needed
-        = neededbytes/sizeof(BASE_DATA_TYPE) + (bool)(neededbytes % sizeof(BASE_DATA_TYPE));
+    uint64_t needed = data_for_bytes(neededbytes, offset_shift);
 
     if (size + needed > capacity) {
         //Grow by default, but don't go under or over the limits
@@ -92,14 +349,14 @@ void* ClauseAllocator::allocEnough(
             newcapacity *= ALLOC_GROW_MULT;
         }
         assert(newcapacity >= size+needed);
-        newcapacity = std::min<size_t>(newcapacity, MAXSIZE);
+        newcapacity = std::min<size_t>(newcapacity, max_size(offset_shift));
 
         //Oops, not enough space anyway
         if (newcapacity < size + needed) {
             std::cerr
             << "ERROR: memory manager can't handle the load."
 #ifndef LARGE_OFFSETS
-            << " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**"
+            << " **PLEASE RUN WITH A LARGER --cloffshift, OR RECOMPILE WITH -DLARGEMEM=ON**"
 #endif
             << " size: " << size
             << " needed: " << needed
@@ -108,7 +365,7 @@ void* ClauseAllocator::allocEnough(
             std::cout
             << "ERROR: memory manager can't handle the load."
 #ifndef LARGE_OFFSETS
-            << " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**"
+            << " **PLEASE RUN WITH A LARGER --cloffshift, OR RECOMPILE WITH -DLARGEMEM=ON**"
 #endif
             << " size: " << size
             << " needed: " << needed
@@ -118,25 +375,7 @@ void* ClauseAllocator::allocEnough(
             throw std::bad_alloc();
         }
 
-        //Reallocate data
-        BASE_DATA_TYPE* new_dataStart;
-        new_dataStart = (BASE_DATA_TYPE*)realloc(
-            dataStart
-            , newcapacity*sizeof(BASE_DATA_TYPE)
-        );
-
-        //Realloc failed?
-        if (new_dataStart == NULL) {
-            std::cerr
-            << "ERROR: while reallocating clause space"
-            << endl;
-
-            throw std::bad_alloc();
-        }
-        dataStart = new_dataStart;
-
-        //Update capacity to reflect the update
-        capacity = newcapacity;
+        set_capacity(newcapacity);
     }
 
     //Add clause to the set
@@ -158,7 +397,9 @@ rerturns a 32-bit value that is a concatenation of these two
 */
 ClOffset ClauseAllocator::get_offset(const Clause* ptr) const
 {
-    return ((BASE_DATA_TYPE*)ptr - dataStart);
+    const uint64_t at = (BASE_DATA_TYPE*)ptr - dataStart;
+    assert((at & ((1ULL << offset_shift) - 1)) == 0);
+    return at >> offset_shift;
 }
 
 /**
@@ -181,7 +422,7 @@ void ClauseAllocator::clauseFree(Clause* cl)
     uint64_t est_num_cl = cl->size();
     est_num_cl = std::max(est_num_cl, (uint64_t)3); //we sometimes allow gauss to allocate 3-long clauses
     uint64_t bytes_freed = sizeof(Clause) + est_num_cl*sizeof(Lit);
-    uint64_t elems_freed = bytes_freed/sizeof(BASE_DATA_TYPE) + (bool)(bytes_freed % sizeof(BASE_DATA_TYPE));
+    uint64_t elems_freed = data_for_bytes(bytes_freed, offset_shift);
     currentlyUsedSize -= elems_freed;
 
     #ifdef VALGRIND_MAKE_MEM_UNDEFINED
@@ -195,55 +436,58 @@ void ClauseAllocator::clauseFree(ClOffset offset)
     clauseFree(cl);
 }
 
-ClOffset ClauseAllocator::move_cl(
-    ClOffset* newDataStart
-    , ClOffset*& new_ptr
-    , Clause* old
-) const {
-    uint64_t bytesNeeded = sizeof(Clause) + old->size()*sizeof(Lit);
-    uint64_t sizeNeeded = bytesNeeded/sizeof(BASE_DATA_TYPE) + (bool)(bytesNeeded % sizeof(BASE_DATA_TYPE));
-    memcpy(new_ptr, old, sizeNeeded*sizeof(BASE_DATA_TYPE));
-
-    ClOffset new_offset = new_ptr-newDataStart;
-    (*old)[0] = Lit::toLit(new_offset & 0xFFFFFFFF);
-    #ifdef LARGE_OFFSETS
-    (*old)[1] = Lit::toLit((new_offset>>32) & 0xFFFFFFFF);
-    #endif
-    old->reloced = true;
+uint64_t ClauseAllocator::cl_data_size(const Clause* cl, const uint32_t shift) const
+{
+    return data_for_bytes(sizeof(Clause) + cl->size()*sizeof(Lit), shift);
+}
 
-    new_ptr += sizeNeeded;
-    return new_offset;
+//Is the stack getting close to what the current offset unit can address?
+bool ClauseAllocator::must_widen() const
+{
+    return offset_shift < MAX_OFFSET_SHIFT
+        && currentlyUsedSize > max_size(offset_shift)/2;
 }
 
-void ClauseAllocator::move_one_watchlist(
-    watch_subarray& ws, ClOffset* newDataStart, ClOffset*& new_ptr)
+bool ClauseAllocator::must_widen_for(const uint32_t num_lits) const
 {
-    for(Watched& w: ws) {
-        if (w.isClause()) {
-            Clause* old = ptr(w.get_offset());
-            assert(!old->freed());
-            Lit blocked = w.getBlockedLit();
-            if (old->reloced) {
-                ClOffset new_offset = (*old)[0].toInt();
-                #ifdef LARGE_OFFSETS
-                new_offset += ((uint64_t)(*old)[1].toInt())<<32;
-                #endif
-                w = Watched(new_offset, blocked);
-            } else {
-                ClOffset new_offset = move_cl(newDataStart, new_ptr, old);
-                w = Watched(new_offset, blocked);
-            }
-        }
+    const uint64_t needed = data_for_bytes(sizeof(Clause) + sizeof(Lit)*num_lits, offset_shift);
+    return offset_shift < MAX_OFFSET_SHIFT
+        && size + needed > max_size(offset_shift);
+}
+
+void ClauseAllocator::mark_live(const ClOffset offset)
+{
+    Clause* cl = ptr(offset);
+    assert(!cl->freed());
+    if (!cl->reloced) {
+        cl->reloced = true;
+        live.push_back(offset);
     }
 }
 
+//Only valid between computing the new places and sliding the clauses there
+ClOffset ClauseAllocator::new_offset(const ClOffset offset) const
+{
+    const Clause* cl = ptr(offset);
+    assert(cl->reloced);
+    ClOffset new_offs = (*cl)[0].toInt();
+    #ifdef LARGE_OFFSETS
+    new_offs += ((uint64_t)(*cl)[1].toInt())<<32;
+    #endif
+    return new_offs;
+}
+
 /**
 @brief If needed, compacts stacks, removing unused clauses
 
 Firstly, the algorithm determines if the number of useless slots is large or
 small compared to the problem size. If it is small, it does nothing. If it is
-large, then it allocates new stacks, copies the non-freed clauses to these new
-stacks, updates all pointers and offsets, and frees the original stacks.
+large, then it collects the live clauses in watchlist order, computes where
+each of them goes in that order, updates all pointers and offsets, then moves
+the clauses in place. The pages freed at the end of the stack are given back.
+
+If the stack is close to the addressable limit, the offset unit is widened
+while at it.
 */
 void ClauseAllocator::consolidate(
     Solver* solver
@@ -255,7 +499,10 @@ void ClauseAllocator::consolidate(
     //1) There is too much memory allocated. Re-allocation will save space
     //   Avoiding segfault (max is 16 outerOffsets, more than 10 is near)
     //2) There is too much empty, unused space (>30%)
+    //3) The offsets must be widened
+    const bool widen = must_widen();
     if (!force
+        && !widen
         && (float_div(currentlyUsedSize, size) > 0.8 || currentlyUsedSize < (100ULL*1000ULL))
     ) {
         if (solver->conf.verbosity >= 3
@@ -267,52 +514,164 @@ void ClauseAllocator::consolidate(
     }
     const double myTime = cpuTime();
 
-    //Pointers that will be moved along
-    BASE_DATA_TYPE * const newDataStart = (BASE_DATA_TYPE*)malloc(currentlyUsedSize*sizeof(BASE_DATA_TYPE));
-    BASE_DATA_TYPE * new_ptr = newDataStart;
+    //Find all live clauses, in the order they are first met in the
+    //watchlists. They are laid out in this order, so clauses watched by the
+    //same literal end up next to each other, as propagation wants them.
+    assert(live.empty());
+    for(watch_subarray_const ws: solver->watches) {
+        for(const Watched& w: ws) {
+            if (w.isClause()) {
+                mark_live(w.get_offset());
+            }
+        }
+    }
+    //Everything else must be watched
+    for(const ClOffset offs: solver->longIrredCls) {
+        assert(ptr(offs)->reloced || ptr(offs)->_xor_is_detached);
+        mark_live(offs);
+    }
+    for(const auto& lredcls: solver->longRedCls) {
+        for(const ClOffset offs: lredcls) {
+            assert(ptr(offs)->reloced || ptr(offs)->_xor_is_detached);
+            mark_live(offs);
+        }
+    }
+    for(const ClOffset offs: solver->detached_xor_repr_cls) {
+        const Clause* cl = ptr(offs);
+        assert(cl->reloced || (cl->used_in_xor() && cl->used_in_xor_full() && cl->_xor_is_detached));
+        mark_live(offs);
+    }
 
-    assert(sizeof(BASE_DATA_TYPE) % sizeof(Lit) == 0);
+    uint32_t new_shift = offset_shift;
+    while (new_shift < MAX_OFFSET_SHIFT && currentlyUsedSize > max_size(new_shift)/2) {
+        new_shift++;
+    }
 
-    vector<bool> visited(solver->watches.size(), 0);
-    for(auto& ws: solver->watches) {
-        move_one_watchlist(ws, newDataStart, new_ptr);
+    //Store the new offset of each clause in its first literal(s)
+    #ifdef LARGE_OFFSETS
+    const uint32_t lits_saved = 2;
+    #else
+    const uint32_t lits_saved = 1;
+    #endif
+    saved_lits.resize(live.size()*lits_saved);
+    uint64_t new_size = 0;
+    for(size_t i = 0; i < live.size(); i++) {
+        Clause* cl = ptr(live[i]);
+        for(uint32_t k = 0; k < lits_saved; k++) {
+            saved_lits[i*lits_saved+k] = (*cl)[k];
+        }
+        const ClOffset new_offs = new_size >> new_shift;
+        (*cl)[0] = Lit::toLit(new_offs & 0xFFFFFFFF);
+        #ifdef LARGE_OFFSETS
+        (*cl)[1] = Lit::toLit((new_offs>>32) & 0xFFFFFFFF);
+        #endif
+        new_size += cl_data_size(cl, new_shift);
+    }
+    if (new_size > max_size(new_shift)) {
+        std::cerr << "ERROR: memory manager can't handle the load." << endl;
+        throw std::bad_alloc();
     }
 
-    update_offsets(solver->longIrredCls, newDataStart, new_ptr);
+    for(watch_subarray ws: solver->watches) {
+        for(Watched& w: ws) {
+            if (w.isClause()) {
+                w = Watched(new_offset(w.get_offset()), w.getBlockedLit());
+            }
+        }
+    }
+    update_offsets(solver->longIrredCls);
     for(auto& lredcls: solver->longRedCls) {
-        update_offsets(lredcls, newDataStart, new_ptr);
+        update_offsets(lredcls);
     }
-    update_offsets(solver->detached_xor_repr_cls, newDataStart, new_ptr);
+    update_offsets(solver->detached_xor_repr_cls);
 
     //Fix up propBy
     for (size_t i = 0; i < solver->nVars(); i++) {
-        VarData& vdata = solver->varData[i];
+        VarHot& vdata = solver->varHot[i];
         if (vdata.reason.isClause()) {
-            if (vdata.removed == Removed::none
+            if (solver->varData[i].removed == Removed::none
                 && solver->decisionLevel() >= vdata.level
                 && vdata.level != 0
                 && solver->value(i) != l_Undef
             ) {
-                Clause* old = ptr(vdata.reason.get_offset());
-                assert(!old->freed());
-                ClOffset new_offset = (*old)[0].toInt();
-                #ifdef LARGE_OFFSETS
-                new_offset += ((uint64_t)(*old)[1].toInt())<<32;
-                #endif
-                vdata.reason = PropBy(new_offset);
+                vdata.reason = PropBy(new_offset(vdata.reason.get_offset()));
             } else {
                 vdata.reason = PropBy();
             }
         }
     }
 
+    //Moving the clauses straight to their new places could overwrite live
+    //clauses not yet moved. So they are first slid to the top of [0, top),
+    //in address order, which only moves them up. Then they are placed at the
+    //bottom in watch order, slab by slab: a slab ends at the next clause that
+    //would reach the lowest one not yet placed, and the rest is slid up
+    //again. As a slab is at least 'top-new_size', a quarter of the live
+    //clauses, peak memory is max(old size, 1.25*live).
+    vector<uint32_t> by_addr(live.size());
+    vector<uint64_t> at(live.size());
+    uint64_t old_live = 0;
+    uint64_t max_cl = 0;
+    for(uint32_t i = 0; i < live.size(); i++) {
+        by_addr[i] = i;
+        at[i] = (uint64_t)live[i] << offset_shift;
+        const Clause* cl = ptr(live[i]);
+        old_live += cl_data_size(cl, offset_shift);
+        max_cl = std::max(max_cl, cl_data_size(cl, new_shift));
+    }
+    std::sort(by_addr.begin(), by_addr.end(),
+        [&](const uint32_t a, const uint32_t b) { return at[a] < at[b]; });
+
+    //When widening, padding can make clauses larger than the gap they leave
+    const uint64_t top = std::max(size, new_size + std::max(new_size/4, max_cl))
+        + (new_size - old_live);
+    if (top > capacity) {
+        set_capacity(top);
+    }
+
+    uint64_t placed = 0;
+    size_t next = 0;
+    while (next < live.size()) {
+        //Slide the clauses not yet placed up, last-to-first
+        uint64_t low = top;
+        for(size_t k = by_addr.size(); k > 0; k--) {
+            const uint32_t i = by_addr[k-1];
+            low -= cl_data_size((const Clause*)(dataStart + at[i]), new_shift);
+            if (low != at[i]) {
+                move_cl(at[i], low);
+                at[i] = low;
+            }
+        }
+        assert(low - placed >= max_cl);
+
+        for(; next < live.size(); next++) {
+            Clause* cl = (Clause*)(dataStart + at[next]);
+            const uint64_t sz = cl_data_size(cl, new_shift);
+            if (placed + sz > low) {
+                break;
+            }
+            Clause* dest = (Clause*)(dataStart + placed);
+            memcpy(dest, cl, sizeof(Clause) + cl->size()*sizeof(Lit));
+            for(uint32_t k = 0; k < lits_saved; k++) {
+                (*dest)[k] = saved_lits[next*lits_saved+k];
+            }
+            dest->reloced = false;
+            placed += sz;
+        }
+        by_addr.erase(std::remove_if(by_addr.begin(), by_addr.end(),
+            [&](const uint32_t i) { return i < next; }), by_addr.end());
+    }
+    assert(placed == new_size);
+    live.clear();
+    saved_lits.clear();
+
     //Update sizes
     const uint64_t old_size = size;
-    size = new_ptr-newDataStart;
-    capacity = currentlyUsedSize;
+    const uint32_t old_shift = offset_shift;
+    offset_shift = new_shift;
+    size = new_size;
+    set_capacity(std::min(capacity, std::max<uint64_t>(currentlyUsedSize, size)));
     currentlyUsedSize = size;
-    free(dataStart);
-    dataStart = newDataStart;
 
     const double time_used = cpuTime() - myTime;
     if (solver->conf.verbosity >= 2
@@ -321,12 +680,17 @@ void ClauseAllocator::consolidate(
         size_t log_2_size = 0;
         if (size > 0) {
             //yes, it can be 0 (only binary clauses, for example)
-            log_2_size = std::log2(size);
+            log_2_size = std::log2(size >> offset_shift);
         }
         cout << "c [mem] consolidate ";
         cout << " old-sz: " << print_value_kilo_mega(old_size*sizeof(BASE_DATA_TYPE))
         << " new-sz: " << print_value_kilo_mega(size*sizeof(BASE_DATA_TYPE))
-        << " new bits offs: " << std::fixed << std::setprecision(2) << log_2_size;
+        << " committed: " << print_value_kilo_mega(capacity*sizeof(BASE_DATA_TYPE))
+        << " new bits offs: " << std::fixed << std::setprecision(2) << log_2_size
+        << " offs-unit: " << (sizeof(BASE_DATA_TYPE) << offset_shift) << "B";
+        if (old_shift != offset_shift) {
+            cout << " (widened)";
+        }
         cout << solver->conf.print_times(time_used)
         << endl;
     }
@@ -339,24 +703,16 @@ void ClauseAllocator::consolidate(
     }
 }
 
-void ClauseAllocator::update_offsets(
-    vector<ClOffset>& offsets,
-    ClOffset* newDataStart,
-    ClOffset*& new_ptr
-) {
+void ClauseAllocator::move_cl(const uint64_t from, const uint64_t to)
+{
+    const Clause* cl = (const Clause*)(dataStart + from);
+    memmove(dataStart + to, cl, sizeof(Clause) + cl->size()*sizeof(Lit));
+}
 
+void ClauseAllocator::update_offsets(vector<ClOffset>& offsets) const
+{
     for(ClOffset& offs: offsets) {
-        Clause* old = ptr(offs);
-        if (!old->reloced) {
-            assert(old->used_in_xor() && old->used_in_xor_full());
-            assert(old->_xor_is_detached);
-            offs = move_cl(newDataStart, new_ptr, old);
-        } else {
-            offs = (*old)[0].toInt();
-            #ifdef LARGE_OFFSETS
-            offs += ((uint64_t)(*old)[1].toInt())<<32;
-            #endif
-        }
+        offs = new_offset(offs);
     }
 }
 
@@ -367,3 +723,38 @@ size_t ClauseAllocator::mem_used() const
 
     return mem;
 }
+
+//Raw image of the arena. The caller must have consolidated it, so that all
+//of [0, size) are live clauses, and must save the offset tables itself.
+void ClauseAllocator::save_state(SimpleOutFile& f) const
+{
+    f.put_uint32_t(offset_shift);
+    f.put_uint64_t(size);
+    if (size > 0) {
+        f.put_buffer(dataStart, size*sizeof(BASE_DATA_TYPE));
+    }
+}
+
+void ClauseAllocator::load_state(SimpleInFile& f)
+{
+    assert(size == 0 && "Can only load into an empty allocator");
+    const uint32_t new_shift = f.get_uint32_t();
+    if (new_shift > MAX_OFFSET_SHIFT) {
+        throw std::bad_alloc();
+    }
+    offset_shift = new_shift;
+    const uint64_t new_size = f.get_uint64_t();
+    if (new_size == 0) {
+        return;
+    }
+    if (new_size > max_size(offset_shift)) {
+        throw std::bad_alloc();
+    }
+
+    if (new_size > capacity) {
+        set_capacity(new_size);
+    }
+    f.get_buffer(dataStart, new_size*sizeof(BASE_DATA_TYPE));
+    size = new_size;
+    currentlyUsedSize = new_size;
+}
@@ -39,6 +39,8 @@ namespace CMSat {
 class Clause;
 class Solver;
 class PropEngine;
+class SimpleOutFile;
+class SimpleInFile;
 
 using std::map;
 using std::vector;
@@ -51,6 +53,20 @@ needed. When instructed, it consolidates the unused space (i.e. clauses free()-e
 Essentially, it is a stack-like allocator for clauses. It is useful to have
 this, because this way, we can address clauses according to their number,
 which is 32-bit, instead of their address, which might be 64-bit
+
+Where mmap() is available, an address range a few times larger than the
+stack is reserved, and pages are only committed as the stack grows, so
+growing mostly does not copy. See reserve_arena().
+Consolidation lays the live clauses out in watchlist order in place, with
+at most a quarter of the live clause bytes on top, and gives the freed
+pages back.
+
+Offsets count units of (1<<offset_shift) datapieces, and clauses are aligned
+to that. A coarser unit addresses a larger stack with the same 32-bit
+offsets, at the price of some padding. Consolidation widens the unit when
+the stack gets close to what the current one can address. Clauses added
+from the outside consolidate first if they would not fit otherwise, see
+must_widen_for().
 */
 class ClauseAllocator {
     public:
@@ -73,7 +89,7 @@ class ClauseAllocator {
 
         inline Clause* ptr(const ClOffset offset) const
         {
-            return (Clause*)(&dataStart[offset]);
+            return (Clause*)(&dataStart[(uint64_t)offset << offset_shift]);
         }
 
         void clauseFree(Clause* c);
@@ -86,21 +102,33 @@ class ClauseAllocator {
         );
 
         size_t mem_used() const;
+        void save_state(SimpleOutFile& f) const;
+        void load_state(SimpleInFile& f);
 
-    private:
-        void update_offsets(
-            vector<ClOffset>& offsets,
-            ClOffset* newDataStart,
-            ClOffset*& new_ptr
-        );
-        void move_one_watchlist(
-            watch_subarray& ws, ClOffset* newDataStart, ClOffset*& new_ptr);
+        ///Ask for transparent huge pages. Only has effect before the first allocation
+        void set_huge_pages(const bool _huge_pages)
+        {
+            huge_pages = _huge_pages;
+        }
+
+        ///Set the initial offset granularity. Only has effect before the first allocation
+        void set_offset_shift(const uint32_t shift);
+        ///A clause of num_lits would not be addressable, but consolidate() can widen the unit
+        bool must_widen_for(const uint32_t num_lits) const;
+        uint32_t get_offset_shift() const
+        {
+            return offset_shift;
+        }
 
-        ClOffset move_cl(
-            ClOffset* newDataStart
-            , ClOffset*& new_ptr
-            , Clause* old
-        ) const;
+    private:
+        void update_offsets(vector<ClOffset>& offsets) const;
+        void mark_live(const ClOffset offset);
+        ClOffset new_offset(const ClOffset offset) const;
+        uint64_t cl_data_size(const Clause* cl, const uint32_t shift) const;
+        uint64_t data_for_bytes(const uint64_t bytes, const uint32_t shift) const;
+        uint64_t max_size(const uint32_t shift) const;
+        bool must_widen() const;
+        void move_cl(const uint64_t from, const uint64_t to);
 
         BASE_DATA_TYPE* dataStart; ///<Stack starts at these positions
         uint64_t size; ///<The number of BASE_DATA_TYPE datapieces currently used in each stack
@@ -120,6 +148,20 @@ class ClauseAllocator {
         */
         uint64_t currentlyUsedSize;
 
+        ///Offsets are in units of (1<<offset_shift) datapieces
+        uint32_t offset_shift;
+
+        ///Number of BASE_DATA_TYPE datapieces reserved with mmap(), 0 if dataStart is on the heap
+        uint64_t reserved;
+        bool huge_pages;
+        void reserve_arena(const uint64_t min_capacity);
+        void release_arena();
+        void set_capacity(const uint64_t newcapacity);
+
+        //Used during consolidation
+        vector<ClOffset> live;
+        vector<Lit> saved_lits;
+
         void* allocEnough(const uint32_t num_lits);
 };
 
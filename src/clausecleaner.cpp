@@ -80,7 +80,7 @@ void ClauseCleaner::clean_binary_implicit(
 }
 
 void ClauseCleaner::clean_implicit_watchlist(
-    watch_subarray& watch_list
+    watch_subarray watch_list
     , const Lit lit
 ) {
     Watched* i = watch_list.begin();
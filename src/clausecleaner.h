@@ -67,7 +67,7 @@ class ClauseCleaner
         };
         ImplicitData impl_data;
         void clean_implicit_watchlist(
-            watch_subarray& watch_list
+            watch_subarray watch_list
             , const Lit lit
         );
         void clean_binary_implicit(
@@ -135,6 +135,7 @@ void CNF::swapVars(const uint32_t which, const int off_by)
 {
     std::swap(assigns[nVars()-off_by-1], assigns[which]);
     std::swap(varData[nVars()-off_by-1], varData[which]);
+    std::swap(varHot[nVars()-off_by-1], varHot[which]);
 }
 
 void CNF::enlarge_nonminimial_datastructs(size_t n)
@@ -142,6 +143,7 @@ void CNF::enlarge_nonminimial_datastructs(size_t n)
     assigns.insert(assigns.end(), n, l_Undef);
     unit_cl_IDs.insert(unit_cl_IDs.end(), n, 0);
     varData.insert(varData.end(), n, VarData());
+    varHot.insert(varHot.end(), n, VarHot());
     depth.insert(depth.end(), n, 0);
 }
 
@@ -156,7 +158,7 @@ void CNF::enlarge_minimal_datastructs(size_t n)
 
 void CNF::save_on_var_memory()
 {
-    //never resize varData --> contains info about what is replaced/etc.
+    //never resize varData, varHot --> contains info about what is replaced/etc.
     //never resize assigns --> contains 0-level assigns
     //never resize interToOuterMain, outerToInterMain
 
@@ -246,6 +248,7 @@ void CNF::updateVars(
     , const vector<uint32_t>& interToOuter2
 ) {
     updateArray(varData, interToOuter);
+    updateArray(varHot, interToOuter);
     updateArray(assigns, interToOuter);
     updateArray(unit_cl_IDs, interToOuter);
     updateBySwap(watches, seen, interToOuter2);
@@ -108,6 +108,8 @@ public:
             conf = *_conf;
         }
         mtrand.seed(conf.origSeed);
+        cl_alloc.set_huge_pages(conf.clause_huge_pages);
+        cl_alloc.set_offset_shift(conf.clause_offset_shift);
         frat = new Drat;
         assert(_must_interrupt_inter != NULL);
         must_interrupt_inter = _must_interrupt_inter;
@@ -130,6 +132,7 @@ public:
     vec<vec<GaussWatched>> gwatches;
     uint32_t num_sls_called = 0;
     vector<VarData> varData;
+    vector<VarHot> varHot;
     branch branch_strategy = branch::vsids;
     string branch_strategy_str = "VSIDS";
     string branch_strategy_str_short = "vs";
@@ -217,7 +220,7 @@ public:
 
     uint32_t level(Lit l) const
     {
-        return varData[l.var()].level;
+        return varHot[l.var()].level;
     }
 
     bool okay() const
@@ -381,6 +384,8 @@ public:
     template<class T> void unserialize(T& ar);
     template<class T> void serialize(T& ar) const;
 #endif
+    void save_bva_state(SimpleOutFile& f) const;
+    void load_bva_state(SimpleInFile& f);
     size_t get_num_long_cls() const;
     size_t get_num_long_irred_cls() const;
     size_t get_num_long_red_cls() const;
@@ -566,8 +571,8 @@ inline void CNF::clean_occur_from_idx(const Lit lit)
 inline bool CNF::clause_locked(const Clause& c, const ClOffset offset) const
 {
     return value(c[0]) == l_True
-        && varData[c[0].var()].reason.isClause()
-        && varData[c[0].var()].reason.get_offset() == offset;
+        && varHot[c[0].var()].reason.isClause()
+        && varHot[c[0].var()].reason.get_offset() == offset;
 }
 
 inline void CNF::clear_one_occur_from_removed_clauses(watch_subarray w)
@@ -803,6 +808,19 @@ inline size_t CNF::get_num_long_cls() const
     return longIrredCls.size() + longRedCls.size();
 }
 
+inline void CNF::save_bva_state(SimpleOutFile& f) const
+{
+    f.put_vector(outer_to_with_bva_map);
+    f.put_uint64_t(num_bva_vars);
+}
+
+inline void CNF::load_bva_state(SimpleInFile& f)
+{
+    outer_to_with_bva_map.clear();
+    f.get_vector(outer_to_with_bva_map);
+    num_bva_vars = f.get_uint64_t();
+}
+
 #ifdef ARJUN_SERIALIZE
 template<class T> void CNF::unserialize(T& ar)
 {
@@ -26,14 +26,9 @@ THE SOFTWARE.
 #include "occsimplifier.h"
 #include "clauseallocator.h"
 #include "sqlstats.h"
+#include "louvain.h"
 #include <limits>
-#include <map>
-#include <utility>
-#include <louvain_communities/louvain_communities.h>
-
-using std::map;
-using std::pair;
-using std::make_pair;
+#include <thread>
 
 using namespace CMSat;
 
@@ -42,6 +37,13 @@ CommunityFinder::CommunityFinder(Solver* _solver) :
 {
 }
 
+uint32_t CommunityFinder::num_threads() const
+{
+    uint32_t n = solver->conf.louvain_threads;
+    if (n == 0) n = std::thread::hardware_concurrency();
+    return std::max<uint32_t>(n, 1);
+}
+
 void CMSat::CommunityFinder::compute()
 {
     //Clean it
@@ -49,82 +51,54 @@ void CMSat::CommunityFinder::compute()
         v.community_num = numeric_limits<uint32_t>::max();
     }
 
-    //Check for too large
-    if (solver->nVars() > 300ULL*1000ULL) {
-        return;
-    }
-
-    double myTime = cpuTime();
-    map<pair<uint32_t, uint32_t>, long double> edges;
-
-    //Binary clauses
-    for(uint32_t watched_at = 0; watched_at< solver->nVars()*2; watched_at++) {
-        Lit l = Lit::toLit(watched_at);
-        watch_subarray_const ws = solver->watches[l];
-        for(uint32_t watched_at_sub = 0; watched_at_sub < ws.size(); watched_at_sub++) {
-            const Watched& w = ws[watched_at_sub];
-            if (w.isBin() &&
-                w.lit2() < l &&
-                !w.red()
-            ) {
-                //VIG graph
-                uint32_t size = 2;
-                long double weight = 1.0L/((long double)size*((long double)size-1.0L)/2.0L);
-
-                uint32_t v1 = l.var();
-                uint32_t v2 = w.lit2().var();
-                //must start with smallest
-                if (v2  < v1) {
-                    std::swap(v1, v2);
-                }
-                auto edge = make_pair(v1, v2);
-                auto it = edges.find(edge);
-                if (it == edges.end()) {
-                    edges[edge] = weight;
-                } else {
-                    it->second+=weight;
+    const double myTime = cpuTime();
+    const double myRealTime = real_time_sec();
+    const uint32_t nvars = solver->nVars();
+    const uint32_t window = std::max<uint32_t>(solver->conf.louvain_clause_window, 1);
+    Louvain graph(nvars, num_threads());
+
+    //VIG graph. A clause of size k is a clique with total weight 1, but
+    //clauses longer than window+1 only connect each literal to the next
+    //window literals, so the graph stays linear in the size of the CNF.
+    graph.build([&](const uint32_t tid, const uint32_t nt, auto& emit) {
+        //Binary clauses, each thread takes a slice of the watchlists
+        const uint64_t nlits = (uint64_t)nvars*2;
+        for(uint64_t at = nlits*tid/nt; at < nlits*(tid+1)/nt; at++) {
+            const Lit l = Lit::toLit(at);
+            for(const Watched& w: solver->watches[l]) {
+                if (w.isBin() && w.lit2() < l && !w.red()) {
+                    emit(l.var(), w.lit2().var(), 1.0f);
                 }
             }
         }
-    }
 
-    //Non-binary clauses
-    for(const auto& offs: solver->longIrredCls) {
-        const Clause* cl = solver->cl_alloc.ptr(offs);
-        //VIG graph
-        uint32_t size = cl->size();
-        long double weight = 1.0L/((long double)size*((long double)size-1.0L)/2.0L);
-        for(uint32_t i = 0; i < cl->size(); i ++) {
-            for(uint32_t i2 = i+1; i2 < cl->size(); i2 ++) {
-                uint32_t v1 = (*cl)[i].var();
-                uint32_t v2 = (*cl)[i2].var();
-
-                //must start with smallest
-                if (v2  < v1) {
-                    std::swap(v1, v2);
+        //Non-binary clauses
+        for(size_t i = tid; i < solver->longIrredCls.size(); i += nt) {
+            const Clause& cl = *solver->cl_alloc.ptr(solver->longIrredCls[i]);
+            const uint32_t size = cl.size();
+            if (size <= window+1) {
+                const float weight = 1.0f/((float)size*((float)size-1.0f)/2.0f);
+                for(uint32_t i1 = 0; i1 < size; i1++) {
+                    for(uint32_t i2 = i1+1; i2 < size; i2++) {
+                        emit(cl[i1].var(), cl[i2].var(), weight);
+                    }
                 }
-                auto edge = make_pair(v1, v2);
-                auto it = edges.find(edge);
-                if (it == edges.end()) {
-                    edges[edge] = weight;
-                } else {
-                    it->second+=weight;
+            } else {
+                const float weight = 1.0f/((float)size*(float)window);
+                for(uint32_t i1 = 0; i1 < size; i1++) {
+                    for(uint32_t d = 1; d <= window; d++) {
+                        emit(cl[i1].var(), cl[(i1+d) % size].var(), weight);
+                    }
                 }
             }
         }
-    }
+    });
+    graph.calculate();
 
-    LouvainC::Communities graph;
-    for(const auto& it: edges) {
-        graph.add_edge(it.first.first, it.first.second, it.second);
-    }
-    graph.calculate(true);
-    auto mapping = graph.get_mapping();
-
-    for(const auto& x: mapping) {
-        assert(x.first < solver->nVars());
-        assert(x.second < solver->nVars());
-        solver->varData[x.first].community_num = x.second;
+    const vector<uint32_t>& mapping = graph.get_mapping();
+    for(uint32_t i = 0; i < nvars; i++) {
+        assert(mapping[i] < nvars);
+        solver->varData[i].community_num = mapping[i];
     }
 
     //Recompute connects_num_communities for all redundant clauses
@@ -136,15 +110,23 @@ void CMSat::CommunityFinder::compute()
         }
     }
 
-
-    double time_passed = cpuTime() - myTime;
+    const double time_passed = cpuTime() - myTime;
+    const double real_time_passed = real_time_sec() - myRealTime;
+    const Louvain::Stats& stats = graph.get_stats();
     if (solver->conf.verbosity) {
-        cout << "c [louvain] Louvain communities found. T: "
-        << std::fixed << std::setprecision(2)
+        cout << "c [louvain] Louvain communities found."
+        << " levels: " << stats.levels
+        << " moves: " << stats.moves
+        << " edges: " << stats.edges
+        << " Q: " << std::fixed << std::setprecision(3) << graph.modularity()
+        << " mem: " << stats.peak_mem/(1024*1024) << " MB"
+        << " wallT: " << std::setprecision(2) << real_time_passed
         << solver->conf.print_times(time_passed) << endl;
     }
 
     if (solver->sqlStats) {
-        solver->sqlStats->time_passed_min(solver, "louvain", time_passed);
+        solver->sqlStats->time_passed_min(solver, "louvain", real_time_passed);
+        solver->sqlStats->mem_used(solver, "louvain", real_time_passed
+            , stats.peak_mem/(1024*1024));
     }
 }
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #define COMMUNITY_FINDER_H__
 
 #include <vector>
+#include <cstdint>
 using std::vector;
 
 namespace CMSat {
@@ -37,6 +38,7 @@ public:
     void compute();
 
 private:
+    uint32_t num_threads() const;
     Solver* solver;
 
 };
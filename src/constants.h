@@ -165,9 +165,11 @@ inline uint32_t rnd_uint(std::mt19937_64& mtrand, const uint32_t maximum) {
 #ifdef __GNUC__
     #define likely(x) __builtin_expect((x), 1)
     #define unlikely(x) __builtin_expect((x), 0)
+    #define cmsat_noinline __attribute__((noinline))
 #else
     #define likely(x) x
     #define unlikely(x) x
+    #define cmsat_noinline
 #endif
 
 ///////////////////
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "solver.h"
 #include "frat.h"
 #include "shareddata.h"
+#include "cuber.h"
 
 #include <fstream>
 #include <cstdint>
@@ -33,6 +34,8 @@ THE SOFTWARE.
 #include <mutex>
 #include <atomic>
 #include <cassert>
+#include <algorithm>
+#include <deque>
 using std::thread;
 using std::vector;
 
@@ -199,7 +202,8 @@ void update_config(SolverConf& conf, unsigned thread_num)
     conf.origSeed += thread_num;
     conf.thread_num = thread_num;
 
-    switch(thread_num % 23) {
+    //MPI ranks shift their threads along the portfolio, see main_mpi.cpp
+    switch((thread_num + conf.thread_config_offset) % 23) {
         case 0: {
             //default setup
             break;
@@ -424,6 +428,14 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
         throw std::runtime_error(err);
     }
     if (num == 1) {
+        //A single thread still runs its slice of the portfolio, e.g. an MPI
+        //rank other than the first one
+        const SolverConf& orig_conf = data->solvers[0]->getConf();
+        if (orig_conf.thread_config_offset != 0) {
+            SolverConf conf = orig_conf;
+            update_config(conf, 0);
+            data->solvers[0]->setConf(conf);
+        }
         return;
     }
     if (data->solvers.size() > 1) {
@@ -454,20 +466,30 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
     #endif
 
     data->cls_lits.reserve(CACHE_SIZE);
+    const SolverConf orig_conf = data->solvers[0]->getConf();
     for(unsigned i = 1; i < num; i++) {
-        SolverConf conf = data->solvers[0]->getConf();
+        SolverConf conf = orig_conf;
         update_config(conf, i);
         data->solvers.push_back(new Solver(&conf, data->must_interrupt));
         data->cpu_times.push_back(0.0);
     }
+    if (orig_conf.thread_config_offset != 0) {
+        SolverConf conf = orig_conf;
+        update_config(conf, 0);
+        data->solvers[0]->setConf(conf);
+    }
 
     //set shared data
-    data->shared_data = new SharedData(data->solvers.size());
+    data->shared_data = new SharedData(
+        data->solvers.size(),
+        data->solvers[0]->conf.sync_long_ring_slots,
+        data->solvers[0]->conf.sync_long_max_size);
     #ifdef USE_GPU
     data->shared_data->gpuClauseSharer->setCpuSolverCount(num);
     #endif
     for(unsigned i = 0; i < num; i++) {
         SolverConf conf = data->solvers[i]->getConf();
+        conf.num_threads = num;
         if (i >= 1) {
             conf.verbosity = 0;
             conf.doFindXors = 0;
@@ -639,6 +661,14 @@ DLL_PUBLIC void SATSolver::set_simplify(const bool simp)
         s.conf.do_simplify_problem = simp;
     }
 }
+DLL_PUBLIC void SATSolver::set_incremental_fast_path(bool val)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.incremental_fast_path = val;
+    }
+}
+
 DLL_PUBLIC void SATSolver::set_picosat_gate_limitK(const uint32_t lim)
 {
     for (size_t i = 0; i < data->solvers.size(); ++i) {
@@ -771,6 +801,48 @@ DLL_PUBLIC bool SATSolver::add_clause(const vector< Lit >& lits)
     return ret;
 }
 
+DLL_PUBLIC bool SATSolver::add_clauses(
+    const Lit* lits,
+    const uint32_t* offsets,
+    size_t n)
+{
+    if (n == 0) return okay();
+    if (data->log) {
+        vector<Lit> cl;
+        for(size_t i = 0; i < n; i++) {
+            cl.assign(lits + offsets[i], lits + offsets[i+1]);
+            (*data->log) << cl << " 0" << endl;
+        }
+    }
+
+    bool ret = true;
+    if (data->solvers.size() > 1) {
+        const size_t num_lits = offsets[n] - offsets[0];
+        if (data->cls_lits.size() + num_lits + n > CACHE_SIZE) {
+            ret = actually_add_clauses_to_threads(data);
+        }
+
+        //Same layout as add_clause(): lit_Undef, then the literals
+        size_t at = data->cls_lits.size();
+        data->cls_lits.resize(at + num_lits + n);
+        Lit* out = data->cls_lits.data();
+        for(size_t i = 0; i < n; i++) {
+            out[at++] = lit_Undef;
+            const uint32_t sz = offsets[i+1] - offsets[i];
+            std::copy(lits + offsets[i], lits + offsets[i+1], out + at);
+            at += sz;
+        }
+    } else {
+        data->solvers[0]->new_vars(data->vars_to_add);
+        data->vars_to_add = 0;
+
+        ret = data->solvers[0]->add_clauses_outside(lits, offsets, n);
+        data->cls += n;
+    }
+
+    return ret;
+}
+
 void add_xor_clause_to_log(const std::vector<unsigned>& vars, bool rhs, std::ofstream* file)
 {
     if (vars.size() == 0) {
@@ -918,6 +990,340 @@ struct OneThreadCalc
     bool only_sampling_solution;
 };
 
+//Shared state of the cube-and-conquer workers
+struct CubeData
+{
+    explicit CubeData(const size_t num_threads) :
+        deques(num_threads)
+        , deque_mutexes(num_threads)
+        , cores_added(num_threads, 0)
+    {}
+
+    //Own deque is used from the back, others are stolen from at the front
+    bool pop(const size_t tid, vector<Lit>& cube)
+    {
+        for(size_t i = 0; i < deques.size(); i++) {
+            const size_t at = (tid+i) % deques.size();
+            std::lock_guard<std::mutex> lock(deque_mutexes[at]);
+            if (deques[at].empty()) continue;
+            if (i == 0) {
+                cube = std::move(deques[at].back());
+                deques[at].pop_back();
+            } else {
+                cube = std::move(deques[at].front());
+                deques[at].pop_front();
+                stolen++;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    //Put back a cube that ran out of its share of the budget
+    void push(const size_t tid, vector<Lit>&& cube)
+    {
+        std::lock_guard<std::mutex> lock(deque_mutexes[tid]);
+        deques[tid].push_back(std::move(cube));
+    }
+
+    //Each cube gets 1/num_threads of what is left of the budget of the whole
+    //call, so the cubes in flight together can't overrun it
+    bool take_budget(uint64_t& confl, double& time)
+    {
+        std::lock_guard<std::mutex> lock(budget_mutex);
+        if (confl_left == 0 || time_left <= 0) return false;
+        const size_t n = deques.size();
+        confl = confl_left;
+        if (confl != numeric_limits<uint64_t>::max()) {
+            confl = std::max<uint64_t>(confl/n, 1);
+        }
+        time = time_left;
+        if (time != numeric_limits<double>::max()) {
+            time /= n;
+        }
+        return true;
+    }
+
+    void spend(const uint64_t confl, const double time)
+    {
+        std::lock_guard<std::mutex> lock(budget_mutex);
+        if (confl_left != numeric_limits<uint64_t>::max()) {
+            confl_left -= std::min(confl, confl_left);
+        }
+        if (time_left != numeric_limits<double>::max()) {
+            time_left = std::max(time_left - time, 0.0);
+        }
+    }
+
+    vector<std::deque<vector<Lit>>> deques;
+    vector<std::mutex> deque_mutexes;
+
+    std::mutex budget_mutex;
+    uint64_t confl_left = numeric_limits<uint64_t>::max();
+    double time_left = numeric_limits<double>::max(); //CPU time, summed over threads
+
+    //Negations of refuted cubes, i.e. clauses implied by the formula
+    std::mutex cores_mutex;
+    vector<vector<Lit>> cores;
+    vector<size_t> cores_added;
+
+    vector<char> neg_assump; //indexed by outside Lit::toInt()
+    std::atomic<bool> done{false};
+    bool unfinished = false;
+    std::atomic<uint64_t> solved{0};
+    std::atomic<uint64_t> pruned{0};
+    std::atomic<uint64_t> stolen{0};
+};
+
+struct OneThreadCube
+{
+    OneThreadCube(
+        DataForThread& _data_for_thread,
+        CubeData& _cube_data,
+        size_t _tid,
+        bool _only_sampling_solution
+    ) :
+        data_for_thread(_data_for_thread)
+        , cube_data(_cube_data)
+        , tid(_tid)
+        , only_sampling_solution(_only_sampling_solution)
+    {
+    }
+
+    void operator()()
+    {
+        Solver& solver = *data_for_thread.solvers[tid];
+        vector<char> in_cube(solver.nVarsOutside()*2, 0);
+        vector<vector<Lit>> cores;
+        vector<Lit> cube;
+
+        while(!cube_data.done) {
+            //Learn the cores the other threads found
+            {
+                std::lock_guard<std::mutex> lock(cube_data.cores_mutex);
+                size_t& added = cube_data.cores_added[tid];
+                for(; added < cube_data.cores.size(); added++) {
+                    cores.push_back(cube_data.cores[added]);
+                }
+            }
+            for(; at_core < cores.size() && solver.okay(); at_core++) {
+                solver.add_clause_outside(cores[at_core]);
+            }
+            if (!solver.okay()) {
+                finish();
+                break;
+            }
+
+            if (!cube_data.pop(tid, cube)) break;
+            if (refuted_by_core(cube, cores, in_cube)) {
+                cube_data.pruned++;
+                continue;
+            }
+
+            uint64_t confl_budget;
+            double time_budget;
+            if (!cube_data.take_budget(confl_budget, time_budget)) {
+                std::lock_guard<std::mutex> lock(*data_for_thread.update_mutex);
+                cube_data.unfinished = true;
+                finish();
+                break;
+            }
+            solver.set_max_confl(confl_budget);
+            solver.conf.maxTime = numeric_limits<double>::max();
+            if (time_budget != numeric_limits<double>::max()) {
+                solver.conf.maxTime = cpuTime() + time_budget;
+            }
+            const uint64_t confl_before = solver.sumConflicts;
+            const double time_before = cpuTime();
+            const lbool ret = solver.solve_with_assumptions(&cube, only_sampling_solution);
+            const uint64_t confl_used = solver.sumConflicts - confl_before;
+            cube_data.spend(confl_used, cpuTime() - time_before);
+
+            if (ret == l_False) {
+                cube_data.solved++;
+                const vector<Lit>& core = solver.get_final_conflict();
+                bool global = true;
+                for(const Lit lit: core) {
+                    global &= (bool)cube_data.neg_assump[lit.toInt()];
+                }
+
+                std::lock_guard<std::mutex> lock(cube_data.cores_mutex);
+                cube_data.cores.push_back(core);
+                if (global) finish();
+                continue;
+            }
+
+            //Only used up its share: try again later, with a new share
+            if (ret == l_Undef
+                && confl_used > 0
+                && !cube_data.done
+                && !solver.must_interrupt_asap()
+            ) {
+                cube_data.push(tid, std::move(cube));
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(*data_for_thread.update_mutex);
+            if (!cube_data.done) {
+                if (ret == l_True) {
+                    *data_for_thread.which_solved = tid;
+                    *data_for_thread.ret = l_True;
+                } else {
+                    cube_data.unfinished = true;
+                }
+                finish();
+            }
+            break;
+        }
+    }
+
+    //Stops the other workers too, even in the middle of a cube
+    void finish()
+    {
+        cube_data.done = true;
+        for(Solver* s: data_for_thread.solvers) {
+            s->set_must_interrupt_asap();
+        }
+    }
+
+    //The cube contains the negation of a known core
+    static bool refuted_by_core(
+        const vector<Lit>& cube,
+        const vector<vector<Lit>>& cores,
+        vector<char>& in_cube)
+    {
+        for(const Lit lit: cube) in_cube[lit.toInt()] = 1;
+        bool refuted = false;
+        for(const auto& core: cores) {
+            refuted = true;
+            for(const Lit lit: core) {
+                if (!in_cube[(~lit).toInt()]) {
+                    refuted = false;
+                    break;
+                }
+            }
+            if (refuted) break;
+        }
+        for(const Lit lit: cube) in_cube[lit.toInt()] = 0;
+        return refuted;
+    }
+
+    DataForThread& data_for_thread;
+    CubeData& cube_data;
+    const size_t tid;
+    bool only_sampling_solution;
+    size_t at_core = 0;
+};
+
+//Splits the problem into cubes with the lookahead of thread 0, then the
+//threads conquer the cubes, stealing from each other's queues
+static lbool calc_cubes(
+    const vector<Lit>* assumptions,
+    CMSatPrivateData* data,
+    bool only_sampling_solution
+) {
+    actually_add_clauses_to_threads(data);
+
+    Solver& solver = *data->solvers[0];
+    const size_t num_threads = data->solvers.size();
+    CubeData cube_data(num_threads);
+    cube_data.neg_assump.resize(solver.nVarsOutside()*2, 0);
+    vector<Lit> assumps;
+    if (assumptions) {
+        assumps = *assumptions;
+        for(const Lit lit: assumps) {
+            cube_data.neg_assump[(~lit).toInt()] = 1;
+        }
+    }
+
+    //The limits are for the whole call, shared by the threads
+    const uint64_t max_confl = solver.conf.max_confl;
+    const double max_time = solver.conf.maxTime;
+    double my_time = cpuTime();
+    if (max_confl != numeric_limits<uint64_t>::max()) {
+        cube_data.confl_left = max_confl - std::min(max_confl, solver.sumConflicts);
+    }
+    if (max_time != numeric_limits<double>::max()) {
+        cube_data.time_left = std::max(max_time - my_time, 0.0);
+    }
+    if (solver.okay()) {
+        vector<vector<Lit>> cubes;
+        Cuber cuber(&solver);
+        const uint64_t confl_before = solver.sumConflicts;
+        cuber.make_cubes(assumps, cubes, cube_data.cores);
+        cube_data.spend(solver.sumConflicts - confl_before, cpuTime() - my_time);
+        for(auto& core: cube_data.cores) {
+            for(Lit& lit: core) lit = ~lit;
+        }
+        for(size_t i = 0; i < cubes.size(); i++) {
+            cube_data.deques[i % num_threads].push_back(std::move(cubes[i]));
+        }
+
+        DataForThread data_for_thread(data, assumptions);
+        vector<thread> thds;
+        for(size_t i = 0; i < num_threads; i++) {
+            thds.push_back(thread(OneThreadCube(
+                data_for_thread, cube_data, i, only_sampling_solution)));
+        }
+        for(std::thread& t: thds){
+            t.join();
+        }
+        solver.unset_must_interrupt_asap();
+
+        if (solver.conf.verbosity) {
+            cout << "c [cube] conquered: " << cube_data.solved
+            << " pruned by cores: " << cube_data.pruned
+            << " stolen: " << cube_data.stolen
+            << " cores: " << cube_data.cores.size()
+            << solver.conf.print_times(cpuTime() - my_time)
+            << endl;
+        }
+
+        if (*data_for_thread.ret == l_True || cube_data.unfinished) {
+            data->okay = data->solvers[data->which_solved]->okay();
+            return *data_for_thread.ret;
+        }
+    }
+
+    //Every cube is refuted. The cores, all implied by the formula, make
+    //the final call on thread 0 quick, and give the final conflict
+    for(size_t i = cube_data.cores_added[0]; i < cube_data.cores.size() && solver.okay(); i++) {
+        solver.add_clause_outside(cube_data.cores[i]);
+    }
+    data->which_solved = 0;
+    solver.conf.max_confl = max_confl;
+    if (max_confl != numeric_limits<uint64_t>::max()) {
+        solver.set_max_confl(cube_data.confl_left);
+    }
+    solver.conf.maxTime = max_time;
+    if (max_time != numeric_limits<double>::max()) {
+        solver.conf.maxTime = cpuTime() + cube_data.time_left;
+    }
+    const lbool ret = solver.solve_with_assumptions(assumptions, only_sampling_solution);
+    data->okay = solver.okay();
+    return ret;
+}
+
+static void log_calc(
+    const vector<Lit>* assumptions,
+    Todo todo,
+    CMSatPrivateData *data
+) {
+    (*data->log) << "c Solver::";
+    if (todo == Todo::todo_solve) {
+        (*data->log) << "solve";
+    } else if (todo == Todo::todo_simplify) {
+        (*data->log) << "simplify";
+    } else {
+        assert(false);
+    }
+    (*data->log) << "( ";
+    if (assumptions) {
+        (*data->log) << *assumptions;
+    }
+    (*data->log) << " )" << endl;
+}
+
 lbool calc(
     const vector< Lit >* assumptions,
     Todo todo,
@@ -945,19 +1351,7 @@ lbool calc(
     }
 
     if (data->log) {
-        (*data->log) << "c Solver::";
-        if (todo == Todo::todo_solve) {
-            (*data->log) << "solve";
-        } else if (todo == Todo::todo_simplify) {
-            (*data->log) << "simplify";
-        } else {
-            assert(false);
-        }
-        (*data->log) << "( ";
-        if (assumptions) {
-            (*data->log) << *assumptions;
-        }
-        (*data->log) << " )" << endl;
+        log_calc(assumptions, todo, data);
     }
 
     //Deal with the single-thread case
@@ -976,6 +1370,10 @@ lbool calc(
         return ret;
     }
 
+    if (todo == Todo::todo_solve && data->solvers[0]->conf.cube_and_conquer) {
+        return calc_cubes(assumptions, data, only_sampling_solution);
+    }
+
     //Multi-threaded case
     DataForThread data_for_thread(data, assumptions);
     vector<thread> thds;
@@ -1053,6 +1451,125 @@ DLL_PUBLIC lbool SATSolver::simplify(const vector< Lit >* assumptions, const str
     return calc(assumptions, Todo::todo_simplify, data, false, strategy);
 }
 
+//The clause banning 'model' over 'projection', or over all variables
+static void enum_block_clause(
+    const vector<lbool>& model,
+    const vector<uint32_t>* projection,
+    vector<Lit>& block
+) {
+    block.clear();
+    if (projection) {
+        for(const uint32_t v: *projection) {
+            if (model[v] != l_Undef) block.push_back(Lit(v, model[v] == l_True));
+        }
+    } else {
+        for(uint32_t v = 0; v < model.size(); v++) {
+            if (model[v] != l_Undef) block.push_back(Lit(v, model[v] == l_True));
+        }
+    }
+}
+
+DLL_PUBLIC lbool SATSolver::enumerate(
+    const std::function<bool(const vector<lbool>& model)>& callback,
+    const vector<uint32_t>* projection,
+    uint64_t limit,
+    const vector<Lit>* assumptions,
+    bool only_indep_solution)
+{
+    if (data->promised_single_call) {
+        cout
+        << "ERROR: You promised to only call solve/simplify() once"
+        << "       by calling set_single_run(), but enumerate() needs more. Exiting."
+        << endl;
+        exit(-1);
+    }
+    data->num_solve_simplify_calls++;
+    data->previous_sum_conflicts = get_sum_conflicts();
+    data->previous_sum_propagations = get_sum_propagations();
+    data->previous_sum_decisions = get_sum_decisions();
+
+    if (data->solvers.size() == 1) {
+        data->must_interrupt->store(false, std::memory_order_relaxed);
+        if (data->timeout != numeric_limits<double>::max()) {
+            data->solvers[0]->conf.maxTime = cpuTime() + data->timeout;
+        }
+        data->solvers[0]->new_vars(data->vars_to_add);
+        data->vars_to_add = 0;
+
+        //Log it the way the multi-threaded loop below runs it, one solve()
+        //per model, each followed by the clause banning that model
+        uint64_t found = 0;
+        vector<Lit> block;
+        std::function<bool(const vector<lbool>&)> logged;
+        if (data->log) {
+            log_calc(assumptions, Todo::todo_solve, data);
+            logged = [&](const vector<lbool>& model) {
+                found++;
+                const bool go_on = callback(model);
+                enum_block_clause(model, projection, block);
+                (*data->log) << block << " 0" << endl;
+                if (go_on && (limit == 0 || found < limit)) {
+                    log_calc(assumptions, Todo::todo_solve, data);
+                }
+                return go_on;
+            };
+        }
+        const lbool ret = data->solvers[0]->enumerate(
+            data->log ? logged : callback,
+            projection, limit, assumptions, only_indep_solution);
+        data->okay = data->solvers[0]->okay();
+        data->cpu_times[0] = cpuTime();
+        return ret;
+    }
+
+    //With multiple threads there is no single search to keep going, every
+    //model is found by a new solve() call
+    const vector<uint32_t>* orig_sampling_vars = data->solvers[0]->conf.sampling_vars;
+    if (projection) set_sampling_vars(projection);
+    uint64_t found = 0;
+    vector<Lit> block;
+    lbool ret;
+    while(true) {
+        ret = calc(assumptions, Todo::todo_solve, data, only_indep_solution);
+        if (ret != l_True) break;
+
+        found++;
+        const vector<lbool>& model = get_model();
+        const bool go_on = callback(model) && (limit == 0 || found < limit);
+        enum_block_clause(model, projection, block);
+        //The ban stays even when stopping, so the next call goes on from here.
+        //It may make the formula UNSAT, but this model was still handed out
+        const bool still_ok = add_clause(block);
+        if (!go_on) break;
+        if (!still_ok) {
+            ret = l_False;
+            break;
+        }
+    }
+    set_sampling_vars(orig_sampling_vars);
+    return ret;
+}
+
+DLL_PUBLIC void SATSolver::save_state(const std::string& fname)
+{
+    actually_add_clauses_to_threads(data);
+    data->solvers[0]->save_state(fname);
+}
+
+DLL_PUBLIC void SATSolver::load_state(const std::string& fname)
+{
+    if (data->cls > 0 || nVars() > 0) {
+        const char err[] = "ERROR: load_state() can only be called on a fresh solver";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+
+    for(auto& s: data->solvers) {
+        s->load_state(fname);
+    }
+    data->okay = data->solvers[0]->okay();
+}
+
 DLL_PUBLIC const vector< lbool >& SATSolver::get_model() const
 {
     return data->solvers[data->which_solved]->get_model();
@@ -1341,6 +1858,29 @@ DLL_PUBLIC uint64_t SATSolver::get_last_decisions()
     return get_sum_decisions() - data->previous_sum_decisions;
 }
 
+DLL_PUBLIC double SATSolver::get_last_simplify_time()
+{
+    double t = 0;
+    for (Solver const* s : data->solvers) {
+        t += s->get_solve_stats().simplify_time_this_solve_call;
+    }
+    return t;
+}
+
+DLL_PUBLIC uint32_t SATSolver::get_last_num_simplify()
+{
+    uint32_t num = 0;
+    for (Solver const* s : data->solvers) {
+        num += s->get_solve_stats().num_simplify_this_solve_call;
+    }
+    return num;
+}
+
+DLL_PUBLIC uint32_t SATSolver::get_last_dirty_vars()
+{
+    return data->solvers[0]->get_solve_stats().dirty_vars_this_solve_call;
+}
+
 void DLL_PUBLIC SATSolver::start_getting_small_clauses(
     uint32_t max_len,
     uint32_t max_glue,
@@ -1641,6 +2181,33 @@ DLL_PUBLIC void SATSolver::set_full_bve(int val)
     }
 }
 
+DLL_PUBLIC void SATSolver::set_sync_long_cls(bool val, uint32_t max_glue, uint32_t max_size)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.sync_long_cls = val;
+        s.conf.sync_long_max_glue = max_glue;
+        s.conf.sync_long_max_size = max_size;
+    }
+}
+
+DLL_PUBLIC void SATSolver::set_sync_xors(bool val)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.sync_xors = val;
+    }
+}
+
+DLL_PUBLIC void SATSolver::set_cube_and_conquer(bool val, uint32_t max_depth)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.cube_and_conquer = val;
+        s.conf.cube_max_depth = max_depth;
+    }
+}
+
 DLL_PUBLIC void SATSolver::set_sls(int val)
 {
     for (size_t i = 0; i < data->solvers.size(); ++i) {
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <utility>
 #include <string>
 #include <limits>
+#include <functional>
 #include <stdio.h>
 #include "solvertypesmini.h"
 
@@ -59,6 +60,8 @@ namespace CMSat {
         void new_vars(const size_t n); //and many new variables to the solver -- much faster
         unsigned nVars() const; //get number of variables inside the solver
         bool add_clause(const std::vector<Lit>& lits);
+        //add n clauses at once: clause i is lits[offsets[i]] .. lits[offsets[i+1]-1], so offsets has n+1 entries
+        bool add_clauses(const Lit* lits, const uint32_t* offsets, size_t n);
         bool add_red_clause(const std::vector<Lit>& lits);
         bool add_xor_clause(const std::vector<unsigned>& vars, bool rhs);
         bool add_bnn_clause(
@@ -75,6 +78,21 @@ namespace CMSat {
 
         lbool solve(const std::vector<Lit>* assumptions = 0, bool only_indep_solution = false); //solve the problem, optionally with assumptions. If only_indep_solution is set, only the independent variables set with set_independent_vars() are returned in the solution
         lbool simplify(const std::vector<Lit>* assumptions = NULL, const std::string* strategy = NULL); //simplify the problem, optionally with assumptions
+        // Enumerate models, calling callback() with each. Every model is banned
+        // over the projection (all variables if NULL) as soon as it is found,
+        // and the search goes on from where it found it. Stops after limit
+        // models (0: no limit) or when callback() returns false. Returns
+        // l_True if stopped that way, l_False if there are no more models and
+        // l_Undef on timeout/interrupt. The bans are permanent, so calling it
+        // again returns the next batch. callback() must not modify the solver.
+        lbool enumerate(
+            const std::function<bool(const std::vector<lbool>& model)>& callback,
+            const std::vector<uint32_t>* projection = NULL,
+            uint64_t limit = 0,
+            const std::vector<Lit>* assumptions = NULL,
+            bool only_indep_solution = false);
+        void save_state(const std::string& fname); //write the current (simplified) problem to a binary file, so load_state() can resume without re-simplifying
+        void load_state(const std::string& fname); //load a file written by save_state() of the same library build. Only allowed on a fresh solver
         const std::vector<lbool>& get_model() const; //get model that satisfies the problem. Only makes sense if previous solve()/simplify() call was l_True
         const std::vector<Lit>& get_conflict() const; //get conflict in terms of the assumptions given in case the previous call to solve() was l_False
         bool okay() const; //the problem is still solveable, i.e. the empty clause hasn't been derived
@@ -102,6 +120,9 @@ namespace CMSat {
 
         void set_num_threads(unsigned n); //Number of threads to use. Must be set before any vars/clauses are added
         void set_allow_otf_gauss(); //allow on-the-fly gaussian elimination
+        void set_sync_long_cls(bool val, uint32_t max_glue = 3, uint32_t max_size = 30); //share long learnt clauses between threads. Size limit can only be raised before set_num_threads()
+        void set_sync_xors(bool val); //share the XORs found by thread 0, and the equivalences Gauss-Jordan derives, between threads
+        void set_cube_and_conquer(bool val, uint32_t max_depth = 8); //with multiple threads, split the problem into at most 2^max_depth cubes and solve them in parallel, instead of running a portfolio
         /**
          * CPU time (in seconds) that can be consumed before the next call to solve() must return
          *
@@ -149,6 +170,7 @@ namespace CMSat {
         void set_no_confl_needed(); //assumptions-based conflict will NOT be calculated for next solve run
         void set_xor_detach(bool val);
         void set_simplify(const bool simp);
+        void set_incremental_fast_path(bool val); //restrict inprocessing to what changed since the previous solve() call, never eliminate assumption variables
         void set_find_xors(bool do_find_xors);
         void set_min_bva_gain(uint32_t min_bva_gain);
         void set_varelim_check_resolvent_subs(bool varelim_check_resolvent_subs); //check subumption and literal during varelim
@@ -191,6 +213,9 @@ namespace CMSat {
         uint64_t get_last_conflicts(); //get total number of conflicts of last solve() or simplify() call of all threads
         uint64_t get_last_propagations();  //get total number of propagations of last solve() or simplify() call made by all threads
         uint64_t get_last_decisions(); //get total number of decisions of last solve() or simplify() call made by all threads
+        double get_last_simplify_time(); //get total CPU time spent in inprocessing during the last solve() call by all threads
+        uint32_t get_last_num_simplify(); //get number of inprocessing rounds performed during the last solve() call by all threads
+        uint32_t get_last_dirty_vars(); //get number of variables touched by clauses added before the last solve() call (only with set_incremental_fast_path())
 
 
         ////////////////////////////
@@ -0,0 +1,219 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "cuber.h"
+#include "solver.h"
+#include "varreplacer.h"
+#include "time_mem.h"
+
+#include <algorithm>
+
+using namespace CMSat;
+
+Cuber::Cuber(Solver* _solver) :
+    solver(_solver)
+{
+}
+
+void Cuber::make_cubes(
+    const vector<Lit>& _assumps,
+    vector<vector<Lit>>& _cubes,
+    vector<vector<Lit>>& _refuted)
+{
+    assert(solver->okay());
+    assert(solver->decisionLevel() == 0);
+    assert(solver->prop_at_head());
+    const double myTime = cpuTime();
+
+    assumps = _assumps;
+    cubes = &_cubes;
+    refuted = &_refuted;
+    path.clear();
+    outer_to_without_bva = solver->build_outer_to_without_bva_map();
+
+    //Everything happens at decision level 1, undone with unassign_to()
+    solver->new_decision_level();
+    bool ok = true;
+    for(Lit lit: assumps) {
+        lit = solver->map_to_with_bva(lit);
+        lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+        lit = solver->map_outer_to_inter(lit);
+        if (solver->varData[lit.var()].removed != Removed::none) {
+            continue;
+        }
+        if (solver->value(lit) == l_True) {
+            continue;
+        }
+        if (!assign_and_prop(lit)) {
+            ok = false;
+            break;
+        }
+    }
+    if (ok) split(0);
+    else emit(*refuted);
+
+    unassign_to(solver->trail_lim[0]);
+    solver->trail_lim.clear();
+    assert(solver->decisionLevel() == 0);
+
+    stats.cpu_time = cpuTime() - myTime;
+    verb_print(1, "[cube] cubes: " << cubes->size()
+        << " refuted by lookahead: " << refuted->size()
+        << " nodes: " << stats.nodes
+        << " failed lits: " << stats.failed_lits
+        << " lookaheads: " << stats.lookaheads
+        << solver->conf.print_times(stats.cpu_time));
+}
+
+//Node is propagated, without conflict
+void Cuber::split(const uint32_t depth)
+{
+    stats.nodes++;
+    if (depth >= solver->conf.cube_max_depth
+        || solver->must_interrupt_asap()
+    ) {
+        emit(*cubes);
+        return;
+    }
+
+    Lit best = lit_Undef;
+    uint64_t best_score = 0;
+    pick_candidates();
+    for(uint32_t i = 0; i < cands.size(); i++) {
+        const uint32_t var = cands[i].second;
+        if (solver->value(var) != l_Undef) continue;
+
+        uint64_t props[2];
+        bool confl[2];
+        for(uint32_t sign = 0; sign < 2; sign++) {
+            confl[sign] = lookahead(Lit(var, sign), props[sign]);
+        }
+
+        //Failed literal(s) under the current node
+        if (confl[0] && confl[1]) {
+            emit(*refuted);
+            return;
+        }
+        if (confl[0] || confl[1]) {
+            const Lit failed = Lit(var, confl[1]);
+            stats.failed_lits++;
+            emit(*refuted, failed);
+            if (!assign_and_prop(~failed)) {
+                emit(*refuted);
+                return;
+            }
+            continue;
+        }
+
+        const uint64_t score = (props[0]+1)*(props[1]+1);
+        if (score > best_score) {
+            best_score = score;
+            best = Lit(var, props[0] < props[1]);
+        }
+    }
+
+    if (best == lit_Undef || solver->value(best) != l_Undef) {
+        emit(*cubes);
+        return;
+    }
+
+    for(const Lit lit: {best, ~best}) {
+        const uint32_t trail_at = solver->trail.size();
+        const uint32_t path_at = path.size();
+        if (assign_and_prop(lit)) {
+            split(depth+1);
+        } else {
+            emit(*refuted);
+        }
+        path.resize(path_at);
+        unassign_to(trail_at);
+    }
+}
+
+//Returns true on conflict
+bool Cuber::lookahead(const Lit lit, uint64_t& props)
+{
+    stats.lookaheads++;
+    const uint32_t trail_at = solver->trail.size();
+    solver->enqueue_light(lit);
+    const PropBy confl = solver->propagate_light<false>();
+    props = solver->trail.size() - trail_at;
+    unassign_to(trail_at);
+    return !confl.isNULL();
+}
+
+//Adds lit to the current node. Returns false on conflict, in which case
+//lit is still on the path, so emit() records the refuted cube
+bool Cuber::assign_and_prop(const Lit lit)
+{
+    path.push_back(lit);
+    solver->enqueue_light(lit);
+    return solver->propagate_light<false>().isNULL();
+}
+
+void Cuber::unassign_to(const uint32_t trail_at)
+{
+    for(uint32_t i = trail_at; i < solver->trail.size(); i++) {
+        solver->assigns[solver->trail[i].lit.var()] = l_Undef;
+    }
+    solver->trail.resize(trail_at);
+    solver->qhead = trail_at;
+}
+
+//Unassigned variables, most watched first
+void Cuber::pick_candidates()
+{
+    cands.clear();
+    for(uint32_t var = 0; var < solver->nVars(); var++) {
+        if (solver->value(var) != l_Undef
+            || solver->varData[var].removed != Removed::none
+            || solver->varData[var].is_bva
+        ) {
+            continue;
+        }
+        const uint64_t score =
+            (uint64_t)(solver->watches[Lit(var, false)].size()+1)
+            *(solver->watches[Lit(var, true)].size()+1);
+        cands.push_back(std::make_pair(score, var));
+    }
+
+    const size_t num = std::min<size_t>(cands.size(), solver->conf.cube_lookahead_cands);
+    std::partial_sort(cands.begin(), cands.begin()+num, cands.end(),
+        [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+            return a.first > b.first;
+    });
+    cands.resize(num);
+}
+
+Lit Cuber::to_outside(const Lit lit) const
+{
+    const Lit outer = solver->map_inter_to_outer(lit);
+    return Lit(outer_to_without_bva[outer.var()], outer.sign());
+}
+
+void Cuber::emit(vector<vector<Lit>>& to, const Lit extra)
+{
+    to.push_back(assumps);
+    vector<Lit>& cube = to.back();
+    for(const Lit lit: path) cube.push_back(to_outside(lit));
+    if (extra != lit_Undef) cube.push_back(to_outside(extra));
+}
@@ -0,0 +1,84 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef CUBER_H_
+#define CUBER_H_
+
+#include <vector>
+#include <cstdint>
+#include "solvertypes.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Solver;
+
+// Lookahead cuber for the cube-and-conquer parallel mode. Splits the search
+// space under a set of assumptions into cubes by recursively branching on
+// the variable whose two polarities propagate the most. Both cubes and
+// refuted cubes are in outside numbering, and start with the assumptions.
+class Cuber
+{
+public:
+    explicit Cuber(Solver* solver);
+    void make_cubes(
+        const vector<Lit>& assumps,
+        vector<vector<Lit>>& cubes,
+        vector<vector<Lit>>& refuted);
+
+    struct Stats
+    {
+        uint64_t nodes = 0;
+        uint64_t lookaheads = 0;
+        uint64_t failed_lits = 0;
+        double cpu_time = 0;
+    };
+    const Stats& get_stats() const;
+
+private:
+    void split(const uint32_t depth);
+    bool lookahead(const Lit lit, uint64_t& props);
+    bool assign_and_prop(const Lit lit);
+    void unassign_to(const uint32_t trail_at);
+    void pick_candidates();
+    Lit to_outside(const Lit lit) const;
+    void emit(vector<vector<Lit>>& to, const Lit extra = lit_Undef);
+
+    Solver* solver;
+    vector<Lit> assumps;
+    vector<Lit> path; //inter literals of the current node
+    vector<uint32_t> outer_to_without_bva;
+    vector<std::pair<uint64_t, uint32_t>> cands;
+    vector<vector<Lit>>* cubes = NULL;
+    vector<vector<Lit>>* refuted = NULL;
+    Stats stats;
+};
+
+inline const Cuber::Stats& Cuber::get_stats() const
+{
+    return stats;
+}
+
+}
+
+#endif //CUBER_H_
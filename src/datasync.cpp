@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
 //#define VERBOSE_DEBUG_MPI_SENDRCV
 
@@ -40,6 +41,20 @@ DataSync::DataSync(Solver* _solver, SharedData* _sharedData) :
 {
 }
 
+DataSync::~DataSync()
+{
+    #ifdef USE_MPI
+    //A collective round still in flight cannot be cancelled, and MPI keeps
+    //writing into its buffers until every other worker has joined it, which
+    //may be after we are gone. In that case the buffers are deliberately
+    //leaked: it happens at most once per process, after the final solve, and
+    //the server aborts all ranks right after it has collected the stats.
+    if (mpiExch != NULL && mpiExch->state == MPILongState::idle) {
+        delete mpiExch;
+    }
+    #endif
+}
+
 void DataSync::finish_up_mpi()
 {
     #ifdef USE_MPI
@@ -61,6 +76,23 @@ void DataSync::finish_up_mpi()
         delete[] mpiSendData;
         mpiSendData = NULL;
     }
+
+    if (mpiExch != NULL) {
+        mpi_send_stats();
+        if (solver->conf.verbosity >= 1) {
+            cout
+            << "c [mpi " << mpiRank << "  ]"
+            << " rounds: " << mpiStats.rounds
+            << " bytes sent: " << mpiStats.bytesSent
+            << " recv: " << mpiStats.bytesRecv
+            << " longs sent: " << mpiStats.longSent
+            << " imported: " << mpiStats.longImported
+            << " dup: " << mpiStats.longDup
+            << " blocked: " << std::fixed << std::setprecision(2)
+            << (double)mpiStats.blockedUs/1e6 << " s"
+            << endl;
+        }
+    }
     #endif
 }
 
@@ -68,30 +100,27 @@ void DataSync::set_shared_data(SharedData* _sharedData)
 {
     sharedData = _sharedData;
     thread_id = _sharedData->cur_thread_id++;
+    #ifndef USE_GPU
+    for(uint32_t t = 0; t < sharedData->bins.size(); t++) {
+        if ((int)t != thread_id) {
+            sharedData->bins[t]->add_reader(thread_id);
+        }
+    }
+    #ifdef USE_MPI
+    sharedData->mpi_bins.add_reader(thread_id);
+    #endif
+    #endif
     #ifdef USE_MPI
     set_up_for_mpi();
     #endif
 }
 
-void DataSync::new_var(const bool bva)
+void DataSync::new_var(const bool /*bva*/)
 {
-    if (!enabled())
-        return;
-
-    if (!bva) {
-        syncFinish.push_back(0);
-        syncFinish.push_back(0);
-    }
-    assert(solver->nVarsOutside()*2 == syncFinish.size());
 }
 
-void DataSync::new_vars(size_t n)
+void DataSync::new_vars(size_t /*n*/)
 {
-    if (!enabled())
-        return;
-
-    syncFinish.insert(syncFinish.end(), 2*n, 0);
-    assert(solver->nVarsOutside()*2 == syncFinish.size());
 }
 
 void DataSync::save_on_var_memory()
@@ -117,6 +146,13 @@ inline void DataSync::rebuild_bva_map_if_needed()
     }
 }
 
+inline Lit DataSync::map_outside_to_inter(Lit lit) const
+{
+    lit = solver->map_to_with_bva(lit);
+    lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+    return solver->map_outer_to_inter(lit);
+}
+
 bool DataSync::syncData()
 {
     if (!enabled()
@@ -144,26 +180,31 @@ bool DataSync::syncData()
     }
 
     //RECEIVE data
-    sharedData->bin_mutex.lock();
-    extend_bins_if_needed();
-    clear_set_binary_values();
+    //Binaries and long clauses are in lock-free stores, no need for a mutex
+    #ifndef USE_GPU
     ok = shareBinData();
-    sharedData->bin_mutex.unlock();
     if (!ok) {
         return false;
     }
 
+    if (solver->conf.sync_long_cls) {
+        ok = shareLongData();
+        if (!ok) {
+            return false;
+        }
+    }
+    #endif
+
     #ifdef USE_MPI
     if (solver->conf.is_mpi
         && solver->conf.thread_num == 0)
     {
-        if (syncMPIFinish.size() < solver->nVarsOutside()*2) {
-            syncMPIFinish.resize(solver->nVarsOutside()*2, 0);
+        if (syncMPIFinish.size() < sharedData->bins.size()) {
+            syncMPIFinish.resize(sharedData->bins.size(), 0);
         }
 
         if (!mpi_get_interrupt()) {
             sharedData->unit_mutex.lock();
-            sharedData->bin_mutex.lock();
             ok = mpi_recv_from_others();
             assert(solver->conf.every_n_mpi_sync > 0);
             if (ok &&
@@ -172,10 +213,16 @@ bool DataSync::syncData()
                 mpi_send_to_others();
             }
             sharedData->unit_mutex.unlock();
-            sharedData->bin_mutex.unlock();
             if (!ok) {
                 return false;
             }
+
+            if (solver->conf.mpi_share_long) {
+                ok = mpi_share_long();
+                if (!ok) {
+                    return false;
+                }
+            }
         }
     }
     #endif
@@ -256,7 +303,9 @@ bool DataSync::shareUnitData()
     return true;
 }
 
-void CMSat::DataSync::signal_new_long_clause(const vector<Lit>& cl)
+void CMSat::DataSync::signal_new_long_clause(
+    const vector<Lit>& cl,
+    [[maybe_unused]] const uint32_t glue)
 {
     if (!enabled()) {
         return;
@@ -283,6 +332,160 @@ void CMSat::DataSync::signal_new_long_clause(const vector<Lit>& cl)
     #else
     if (cl.size() == 2) {
         signal_new_bin_clause(cl[0], cl[1]);
+        return;
+    }
+
+    LongClRing& ring = *sharedData->long_cls[thread_id];
+    if (cl.size() < 3
+        || !solver->conf.sync_long_cls
+        || glue > solver->conf.sync_long_max_glue
+        || cl.size() > solver->conf.sync_long_max_size
+        || cl.size() > ring.get_max_size()
+    ) {
+        return;
+    }
+    rebuild_bva_map_if_needed();
+
+    //Don't signal clauses with BVA variables
+    long_tmp.clear();
+    for(Lit lit: cl) {
+        if (solver->varData[lit.var()].is_bva) {
+            return;
+        }
+        lit = solver->map_inter_to_outer(lit);
+        lit = map_outer_to_outside(lit);
+        long_tmp.push_back(lit);
+    }
+    ring.push(long_tmp, glue);
+    stats.sentLongData++;
+    #endif
+}
+
+////////////////////////////////////////
+// XOR sharing
+////////////////////////////////////////
+bool DataSync::xors_shared()
+{
+    return enabled()
+        && solver->conf.sync_xors
+        && sharedData->num_threads > 1
+        && !solver->frat->enabled();
+}
+
+//Only this thread runs XorFinder when XORs are shared
+bool DataSync::xor_finder_thread()
+{
+    return thread_id == 0;
+}
+
+void DataSync::share_xors(const vector<Xor>& xors)
+{
+    assert(xors_shared());
+    rebuild_bva_map_if_needed();
+
+    vector<SharedXor> out;
+    out.reserve(xors.size());
+    for(const Xor& x: xors) {
+        SharedXor sx;
+        sx.rhs = x.rhs;
+        bool bva = false;
+        for(const uint32_t v: x) {
+            if (solver->varData[v].is_bva) {
+                bva = true;
+                break;
+            }
+            Lit lit = Lit(solver->map_inter_to_outer(v), false);
+            lit = map_outer_to_outside(lit);
+            sx.vars.push_back(lit.var());
+        }
+        if (bva) continue;
+        out.push_back(std::move(sx));
+    }
+    stats.sentXors += out.size();
+
+    std::lock_guard<std::mutex> lock(sharedData->xor_mutex);
+    sharedData->xors = std::move(out);
+    sharedData->xors_gen++;
+}
+
+//Returns false if no XORs have been published yet
+bool DataSync::get_shared_xors(vector<Xor>& xors)
+{
+    assert(xors_shared());
+    assert(solver->okay());
+    vector<SharedXor> in;
+    {
+        std::lock_guard<std::mutex> lock(sharedData->xor_mutex);
+        if (sharedData->xors_gen == 0) return false;
+        in = sharedData->xors;
+    }
+
+    xors.clear();
+    vector<uint32_t> vars;
+    for(const SharedXor& sx: in) {
+        bool rhs = sx.rhs;
+        bool removed = false;
+        vars.clear();
+        for(const uint32_t outside: sx.vars) {
+            assert(outside < solver->nVarsOutside());
+            const Lit lit = map_outside_to_inter(Lit(outside, false));
+            if (solver->varData[lit.var()].removed != Removed::none) {
+                removed = true;
+                break;
+            }
+            rhs ^= lit.sign();
+            if (solver->value(lit.var()) != l_Undef) {
+                rhs ^= solver->value(lit.var()) == l_True;
+                continue;
+            }
+            vars.push_back(lit.var());
+        }
+        if (removed) continue;
+
+        //Replaced variables may now appear twice, they cancel out
+        std::sort(vars.begin(), vars.end());
+        uint32_t j = 0;
+        for(uint32_t i = 0; i < vars.size(); i++) {
+            if (i+1 < vars.size() && vars[i] == vars[i+1]) {
+                i++;
+                continue;
+            }
+            vars[j++] = vars[i];
+        }
+        vars.resize(j);
+
+        if (vars.empty() && rhs) {
+            solver->ok = false;
+            return true;
+        }
+        if (vars.size() <= 1) continue;
+        xors.push_back(Xor(vars, rhs, vector<uint32_t>()));
+    }
+    stats.recvXors += xors.size();
+
+    if (solver->conf.verbosity >= 1) {
+        cout
+        << "c [sync " << thread_id << "  ]"
+        << " got xors " << xors.size()
+        << " (total: " << stats.recvXors << ")"
+        << " mem use: " << sharedData->calc_memory_use_xors()/(1024*1024) << " M"
+        << endl;
+    }
+    return true;
+}
+
+//Lets the other threads know about an equivalence found by Gauss-Jordan
+//elimination, i.e. lit1 XOR lit2 = rhs
+void DataSync::signal_bin_xor(const Lit lit1, const Lit lit2, const bool rhs)
+{
+    #ifndef USE_GPU
+    if (!enabled()) return;
+    if (rhs) {
+        signal_new_bin_clause(lit1, lit2);
+        signal_new_bin_clause(~lit1, ~lit2);
+    } else {
+        signal_new_bin_clause(~lit1, lit2);
+        signal_new_bin_clause(lit1, ~lit2);
     }
     #endif
 }
@@ -425,39 +628,66 @@ PropBy CMSat::DataSync::pop_clauses()
 #ifndef USE_GPU
 bool DataSync::syncBinFromOthers()
 {
-    for (uint32_t wsLit = 0; wsLit < sharedData->bins.size(); wsLit++) {
-        if (sharedData->bins[wsLit].data == NULL) {
-            continue;
-        }
+    if (syncBinFinish.size() < sharedData->bins.size()) {
+        syncBinFinish.resize(sharedData->bins.size(), 0);
+    }
 
-        Lit lit1 = Lit::toLit(wsLit);
-        lit1 = solver->map_to_with_bva(lit1);
-        lit1 = solver->varReplacer->get_lit_replaced_with_outer(lit1);
-        lit1 = solver->map_outer_to_inter(lit1);
-        if (solver->varData[lit1.var()].removed != Removed::none
-            || solver->value(lit1.var()) != l_Undef
-        ) {
+    //Collect what the others added since we last looked
+    bins_tmp.clear();
+    for(uint32_t t = 0; t < sharedData->bins.size(); t++) {
+        if ((int)t == thread_id) {
             continue;
         }
+        collect_bins(*sharedData->bins[t], syncBinFinish[t]);
+    }
+    #ifdef USE_MPI
+    collect_bins(sharedData->mpi_bins, syncMPIBinFinish);
+    #endif
+    std::sort(bins_tmp.begin(), bins_tmp.end());
 
-        vector<Lit>& bins = *sharedData->bins[wsLit].data;
-        watch_subarray ws = solver->watches[lit1];
+    for(size_t start = 0; start < bins_tmp.size();) {
+        const Lit lit1 = bins_tmp[start].first;
+        size_t end = start+1;
+        while(end < bins_tmp.size() && bins_tmp[end].first == lit1) {
+            end++;
+        }
 
-        assert(syncFinish.size() > wsLit);
-        if (bins.size() > syncFinish[wsLit]
-            && !syncBinFromOthers(lit1, bins, syncFinish[wsLit], ws)
+        if (solver->value(lit1.var()) == l_Undef
+            && !syncBinFromOthers(lit1, bins_tmp, start, end, solver->watches[lit1])
         ) {
             return false;
         }
+        start = end;
     }
 
     return true;
 }
 
+void DataSync::collect_bins(BinStore& store, uint64_t& finished)
+{
+    const uint64_t upto = store.get_num();
+    for(uint64_t i = finished; i < upto; i++) {
+        const std::pair<Lit, Lit>& bin = store.at(i);
+        const Lit lit1 = map_outside_to_inter(bin.first);
+        const Lit lit2 = map_outside_to_inter(bin.second);
+        if (solver->varData[lit1.var()].removed != Removed::none
+            || solver->varData[lit2.var()].removed != Removed::none
+            || solver->value(lit1) != l_Undef
+            || solver->value(lit2) != l_Undef
+        ) {
+            continue;
+        }
+        bins_tmp.push_back(std::make_pair(lit1, lit2));
+    }
+    finished = upto;
+    store.done_reading(thread_id, upto);
+}
+
 bool DataSync::syncBinFromOthers(
     const Lit lit
-    , const vector<Lit>& bins
-    , uint32_t& finished
+    , const vector<std::pair<Lit, Lit>>& bins
+    , const size_t start
+    , const size_t end
     , watch_subarray ws
 ) {
     assert(solver->varReplacer->get_lit_replaced_with(lit) == lit);
@@ -473,14 +703,9 @@ bool DataSync::syncBinFromOthers(
     }
 
     vector<Lit> lits(2);
-    for (uint32_t i = finished; i < bins.size(); i++) {
-        Lit otherLit = bins[i];
-        otherLit = solver->map_to_with_bva(otherLit);
-        otherLit = solver->varReplacer->get_lit_replaced_with_outer(otherLit);
-        otherLit = solver->map_outer_to_inter(otherLit);
-        if (solver->varData[otherLit.var()].removed != Removed::none
-            || solver->value(otherLit) != l_Undef
-        ) {
+    for (size_t i = start; i < end; i++) {
+        const Lit otherLit = bins[i].second;
+        if (solver->value(otherLit) != l_Undef) {
             continue;
         }
         assert(seen.size() > otherLit.toInt());
@@ -494,9 +719,10 @@ bool DataSync::syncBinFromOthers(
             if (!solver->okay()) {
                 goto end;
             }
+            toClear.push_back(otherLit);
+            seen[otherLit.toInt()] = true;
         }
     }
-    finished = bins.size();
 
     end:
     for (const Lit l: toClear) {
@@ -507,77 +733,126 @@ bool DataSync::syncBinFromOthers(
     return solver->okay();
 }
 
-void DataSync::syncBinToOthers()
+bool DataSync::shareBinData()
 {
-    for(const std::pair<Lit, Lit>& bin: newBinClauses) {
-        add_bin_to_threads(bin.first, bin.second);
+    assert(solver->okay());
+    uint32_t oldRecvBinData = stats.recvBinData;
+
+    bool ok = syncBinFromOthers();
+    size_t mem = sharedData->calc_memory_use_bins();
+
+    if (solver->conf.verbosity >= 1) {
+        cout
+        << "c [sync " << thread_id << "  ]"
+        << " got bins " << (stats.recvBinData - oldRecvBinData)
+        << " (total: " << stats.recvBinData << ")"
+        << " sent bins total: " << stats.sentBinData
+        << " dropped: " << stats.droppedBinData
+        << " mem use: " << mem/(1024*1024) << " M"
+        << endl;
     }
 
-    newBinClauses.clear();
+    return ok;
 }
 
-bool DataSync::add_bin_to_threads(Lit lit1, Lit lit2)
+bool DataSync::shareLongData()
 {
-    assert(lit1 < lit2);
-    if (sharedData->bins[lit1.toInt()].data == NULL) {
-        return false;
-    }
+    assert(solver->okay());
+    assert(solver->prop_at_head());
+    const uint64_t oldRecvLongData = stats.recvLongData;
 
-    vector<Lit>& bins = *sharedData->bins[lit1.toInt()].data;
-    for (const Lit lit : bins) {
-        if (lit == lit2)
-            return false;
+    const auto& rings = sharedData->long_cls;
+    if (syncLongFinish.size() < rings.size()) {
+        syncLongFinish.resize(rings.size(), 0);
     }
 
-    bins.push_back(lit2);
-    stats.sentBinData++;
-    return true;
-}
+    uint32_t glue;
+    for(uint32_t t = 0; t < rings.size(); t++) {
+        if ((int)t == thread_id) {
+            continue;
+        }
 
-void DataSync::clear_set_binary_values()
-{
-    for(size_t i = 0; i < solver->nVarsOutside()*2; i++) {
-        Lit lit1 = Lit::toLit(i);
-        lit1 = solver->map_to_with_bva(lit1);
-        lit1 = solver->varReplacer->get_lit_replaced_with_outer(lit1);
-        lit1 = solver->map_outer_to_inter(lit1);
-        if (solver->value(lit1) != l_Undef) {
-            sharedData->bins[i].clear();
+        const LongClRing& ring = *rings[t];
+        const uint64_t upto = ring.get_written();
+        uint64_t at = std::max(syncLongFinish[t], ring.get_oldest(upto));
+        for(; at < upto; at++) {
+            //Overwritten while reading, it's lost
+            if (!ring.read(at, long_tmp, glue)) {
+                continue;
+            }
+            if (!add_long_from_other(long_tmp, glue)) {
+                return false;
+            }
         }
+        syncLongFinish[t] = upto;
     }
-}
 
-void DataSync::extend_bins_if_needed()
-{
-    assert(sharedData->bins.size() <= (solver->nVarsOutside())*2);
-    if (sharedData->bins.size() == (solver->nVarsOutside())*2)
-        return;
+    if (solver->conf.verbosity >= 2) {
+        cout
+        << "c [sync " << thread_id << "  ]"
+        << " got longs " << (stats.recvLongData - oldRecvLongData)
+        << " (total: " << stats.recvLongData << ")"
+        << " sent longs total: " << stats.sentLongData
+        << " used: " << stats.usedLongData
+        << " deleted: " << stats.deletedLongData
+        << " mem use: " << sharedData->calc_memory_use_long_cls()/(1024*1024) << " M"
+        << endl;
+    }
 
-    sharedData->bins.resize(solver->nVarsOutside()*2);
+    return true;
 }
 
-bool DataSync::shareBinData()
+bool DataSync::add_long_from_other(vector<Lit>& cl, const uint32_t glue)
 {
-    assert(solver->okay());
-    uint32_t oldRecvBinData = stats.recvBinData;
-    uint32_t oldSentBinData = stats.sentBinData;
+    for(Lit& lit: cl) {
+        lit = map_outside_to_inter(lit);
+        if (solver->varData[lit.var()].removed != Removed::none
+            || solver->value(lit) == l_True
+        ) {
+            return true;
+        }
+    }
 
-    bool ok = syncBinFromOthers();
-    syncBinToOthers();
-    size_t mem = sharedData->calc_memory_use_bins();
+    ClauseStats cl_stats;
+    cl_stats.glue = std::min<uint32_t>(glue, cl.size());
+    cl_stats.is_imported = true;
+    cl_stats.activity = 0;
+    cl_stats.last_touched_any = solver->sumConflicts;
+    #ifndef FINAL_PREDICTOR
+    if (cl_stats.glue <= solver->conf.glue_put_lev0_if_below_or_eq) {
+        cl_stats.which_red_array = 0;
+    } else if (cl_stats.glue <= solver->conf.glue_put_lev1_if_below_or_eq
+        && solver->conf.glue_put_lev1_if_below_or_eq != 0
+    ) {
+        cl_stats.which_red_array = 1;
+    } else {
+        cl_stats.which_red_array = 2;
+    }
+    #else
+    cl_stats.which_red_array = 2;
+    #endif
 
-    if (solver->conf.verbosity >= 1) {
-        cout
-        << "c [sync " << thread_id << "  ]"
-        << " got bins " << (stats.recvBinData - oldRecvBinData)
-        << " (total: " << stats.recvBinData << ")"
-        << " sent bins " << (stats.sentBinData - oldSentBinData)
-        << " (total: " << stats.sentBinData << ")"
-        << " mem use: " << mem/(1024*1024) << " M"
-        << endl;
+    //Don't add FRAT: it would add to the thread data, too
+    Clause* c = solver->add_clause_int(cl, true, &cl_stats, true, NULL, false);
+    if (!solver->okay()) {
+        return false;
     }
 
-    return ok;
+    if (c != NULL) {
+        stats.recvLongData++;
+        #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+        solver->red_stats_extra.push_back(ClauseStatsExtra());
+        c->stats.extra_pos = solver->red_stats_extra.size()-1;
+        auto& ext_stats = solver->red_stats_extra[c->stats.extra_pos];
+        ext_stats.introduced_at_conflict = solver->sumConflicts;
+        ext_stats.orig_glue = c->stats.glue;
+        ext_stats.orig_size = c->size();
+        #endif
+        const ClOffset offset = solver->cl_alloc.get_offset(c);
+        solver->longRedCls[c->stats.which_red_array].push_back(offset);
+    }
+
+    return true;
 }
 
 void DataSync::signal_new_bin_clause(Lit lit1, Lit lit2)
@@ -586,6 +861,13 @@ void DataSync::signal_new_bin_clause(Lit lit1, Lit lit2)
         return;
     }
 
+    //Satisfied or shortened at level 0, no use to anyone
+    if ((solver->value(lit1) != l_Undef && solver->level(lit1) == 0)
+        || (solver->value(lit2) != l_Undef && solver->level(lit2) == 0)
+    ) {
+        return;
+    }
+
     if (must_rebuild_bva_map) {
         outer_to_without_bva_map = solver->build_outer_to_without_bva_map();
         must_rebuild_bva_map = false;
@@ -604,7 +886,12 @@ void DataSync::signal_new_bin_clause(Lit lit1, Lit lit2)
     if (lit1.toInt() > lit2.toInt()) {
         std::swap(lit1, lit2);
     }
-    newBinClauses.push_back(std::make_pair(lit1, lit2));
+    BinStore& store = *sharedData->bins[thread_id];
+    if (store.push(lit1, lit2)) {
+        stats.sentBinData++;
+    } else if (store.full()) {
+        stats.droppedBinData++;
+    }
 }
 #endif
 
@@ -623,6 +910,35 @@ void DataSync::set_up_for_mpi()
         assert(err == MPI_SUCCESS);
         release_assert(mpiRank != 0);
         assert(sharedData != NULL);
+
+        //Only thread 0 talks MPI. The workers get their own communicator
+        //so that their collectives don't involve the server.
+        if (solver->conf.thread_num == 0 && mpiWorkers == MPI_COMM_NULL) {
+            MPI_Group world;
+            MPI_Group workers;
+            const int server = 0;
+            err = MPI_Comm_group(MPI_COMM_WORLD, &world);
+            assert(err == MPI_SUCCESS);
+            err = MPI_Group_excl(world, 1, &server, &workers);
+            assert(err == MPI_SUCCESS);
+            err = MPI_Comm_create_group(MPI_COMM_WORLD, workers, 3, &mpiWorkers);
+            assert(err == MPI_SUCCESS);
+            MPI_Group_free(&workers);
+            MPI_Group_free(&world);
+
+            err = MPI_Comm_rank(mpiWorkers, &mpiWorkerRank);
+            assert(err == MPI_SUCCESS);
+            err = MPI_Comm_size(mpiWorkers, &mpiWorkerSize);
+            assert(err == MPI_SUCCESS);
+            mpiExch = new MPIExchange;
+        }
+
+        //Thread 0 forwards every thread's binaries, including its own
+        if (solver->conf.thread_num == 0) {
+            for(auto& store: sharedData->bins) {
+                store->add_reader(sharedData->num_threads);
+            }
+        }
     }
 }
 
@@ -701,8 +1017,11 @@ bool DataSync::mpi_recv_from_others()
 
     //Receive data
     uint32_t* buf = new uint32_t[count];
+    const double myTime = MPI_Wtime();
     err = MPI_Recv((unsigned*)buf, count, MPI_UNSIGNED, 0, 0, MPI_COMM_WORLD, &status);
     assert(err == MPI_SUCCESS);
+    mpiStats.blockedUs += (MPI_Wtime()-myTime)*1e6;
+    mpiStats.bytesRecv += (uint64_t)count*sizeof(uint32_t);
 
     //Unit clauses
     int at = 0;
@@ -733,7 +1052,15 @@ bool DataSync::mpi_recv_from_others()
         at++;
         for (uint32_t i = 0; i < num; i++, at++) {
             Lit otherLit = Lit::toLit(buf[at]);
-            thisMpiRecvBinData += add_bin_to_threads(lit, otherLit);
+            thisMpiRecvBinData += sharedData->mpi_bins.push(lit, otherLit);
+        }
+    }
+    if (sharedData->mpi_bins.full() && !mpi_bins_full) {
+        mpi_bins_full = true;
+        if (solver->conf.verbosity) {
+            cout << "c [mpi " << mpiRank << "]"
+            << " threads lag behind on received binaries, dropping some"
+            << endl;
         }
     }
     mpiRecvBinData += thisMpiRecvBinData;
@@ -788,27 +1115,28 @@ void DataSync::mpi_send_to_others()
         data.push_back(toInt(sharedData->value[var]));
     }
 
-    //Set up binaries
-    assert(sharedData->bins.size() == solver->nVarsOutside()*2);
+    //Set up binaries, grouped by their first literal
     uint32_t thisMpiSentBinData = 0;
-    data.push_back(solver->nVarsOutside()*2);
+    vector<vector<Lit>> bins_by_lit(solver->nVarsOutside()*2);
+    assert(syncMPIFinish.size() == sharedData->bins.size());
+    for(uint32_t t = 0; t < sharedData->bins.size(); t++) {
+        BinStore& store = *sharedData->bins[t];
+        const uint64_t upto = store.get_num();
+        for(uint64_t i = syncMPIFinish[t]; i < upto; i++) {
+            const std::pair<Lit, Lit>& bin = store.at(i);
+            bins_by_lit[bin.first.toInt()].push_back(bin.second);
+        }
+        syncMPIFinish[t] = upto;
+        store.done_reading(sharedData->num_threads, upto);
+    }
 
+    data.push_back(solver->nVarsOutside()*2);
     for(uint32_t wsLit = 0; wsLit < solver->nVarsOutside()*2; wsLit++) {
-        //Lit lit1 = ~Lit::toLit(wsLit);
-        assert(syncMPIFinish.size() > wsLit);
-        if (sharedData->bins[wsLit].data == NULL) {
-            data.push_back(0);
-            continue;
-        }
-        uint32_t size = sharedData->bins[wsLit].data->size();
-        assert(size >= syncMPIFinish[wsLit]);
-        uint32_t sizeToSend = size - syncMPIFinish[wsLit];
-        data.push_back(sizeToSend);
-        for (uint32_t i = syncMPIFinish[wsLit]; i < size; i++) {
-            data.push_back(sharedData->bins[wsLit].data->at(i).toInt());
+        data.push_back(bins_by_lit[wsLit].size());
+        for (const Lit lit: bins_by_lit[wsLit]) {
+            data.push_back(lit.toInt());
             thisMpiSentBinData++;
         }
-        syncMPIFinish[wsLit] = size;
     }
     mpiSentBinData += thisMpiSentBinData;
 
@@ -823,8 +1151,11 @@ void DataSync::mpi_send_to_others()
     mpiSendData = new uint32_t[data.size()];
     std::copy(data.begin(), data.end(), mpiSendData);
     //err = MPI_Isend(mpiSendData, data.size(), MPI_UNSIGNED, 0, 0, MPI_COMM_WORLD, &sendReq);
+    const double myTime = MPI_Wtime();
     err = MPI_Send(mpiSendData, data.size(), MPI_UNSIGNED, 0, 0, MPI_COMM_WORLD);
     assert(err == MPI_SUCCESS);
+    mpiStats.blockedUs += (MPI_Wtime()-myTime)*1e6;
+    mpiStats.bytesSent += data.size()*sizeof(uint32_t);
 
     #ifdef VERBOSE_DEBUG_MPI_SENDRCV
     std::cout << "-->> MPI " << mpiRank << " thread " << thread_id <<
@@ -877,4 +1208,314 @@ bool DataSync::mpi_get_unit(
 
     return true;
 }
+
+///////////////////////////////////////
+// MPI long clause exchange
+///////////////////////////////////////
+
+//Forget the clauses seen once there are this many
+static const size_t mpi_long_seen_max = 1ULL << 20;
+
+static inline void put_varint(vector<uint8_t>& buf, uint32_t x)
+{
+    while(x >= 0x80) {
+        buf.push_back((uint8_t)(x | 0x80));
+        x >>= 7;
+    }
+    buf.push_back((uint8_t)x);
+}
+
+//Returns FALSE on a truncated or malformed packet
+static inline bool get_varint(const uint8_t*& at, const uint8_t* end, uint32_t& x)
+{
+    x = 0;
+    for(uint32_t shift = 0; shift < 35; shift += 7) {
+        if (at == end) {
+            return false;
+        }
+        const uint8_t b = *at++;
+        x |= (uint32_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//Literals must be sorted
+static uint64_t hash_sorted_clause(const Lit* lits, const uint32_t size)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+    for(uint32_t i = 0; i < size; i++) {
+        h ^= lits[i].toInt();
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+bool DataSync::mpi_test(MPI_Request& req)
+{
+    int flag;
+    const double myTime = MPI_Wtime();
+    int err = MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+    assert(err == MPI_SUCCESS);
+    mpiStats.blockedUs += (MPI_Wtime()-myTime)*1e6;
+    return flag;
+}
+
+//Polls the current round and starts a new one when the previous one has
+//finished. Never waits for the other workers.
+bool DataSync::mpi_share_long()
+{
+    if (mpiExch == NULL || mpiWorkerSize < 2) {
+        return true;
+    }
+    MPIExchange& x = *mpiExch;
+    int err;
+    double myTime;
+    bool started = false;
+    while(true) {
+        switch(x.state) {
+            case MPILongState::idle: {
+                if (started) {
+                    return true;
+                }
+                started = true;
+                x.send_buf.clear();
+                mpi_pack_long(x.send_buf);
+                x.send_count = x.send_buf.size();
+                x.counts.resize(mpiWorkerSize);
+                myTime = MPI_Wtime();
+                err = MPI_Iallgather(&x.send_count, 1, MPI_INT,
+                    x.counts.data(), 1, MPI_INT, mpiWorkers, &x.req);
+                assert(err == MPI_SUCCESS);
+                mpiStats.blockedUs += (MPI_Wtime()-myTime)*1e6;
+                x.state = MPILongState::counts;
+                break;
+            }
+
+            case MPILongState::counts: {
+                if (!mpi_test(x.req)) {
+                    return true;
+                }
+                x.displs.resize(mpiWorkerSize);
+                uint64_t total = 0;
+                for(int i = 0; i < mpiWorkerSize; i++) {
+                    x.displs[i] = total;
+                    total += x.counts[i];
+                }
+                release_assert(total <= (uint64_t)std::numeric_limits<int>::max());
+                x.recv_buf.resize(std::max<uint64_t>(total, 1));
+                myTime = MPI_Wtime();
+                err = MPI_Iallgatherv(x.send_buf.data(), x.send_count, MPI_BYTE,
+                    x.recv_buf.data(), x.counts.data(), x.displs.data(), MPI_BYTE,
+                    mpiWorkers, &x.req);
+                assert(err == MPI_SUCCESS);
+                mpiStats.blockedUs += (MPI_Wtime()-myTime)*1e6;
+                x.state = MPILongState::data;
+                break;
+            }
+
+            case MPILongState::data: {
+                if (!mpi_test(x.req)) {
+                    return true;
+                }
+                x.state = MPILongState::idle;
+                mpiStats.rounds++;
+                mpiStats.bytesSent += x.send_count;
+
+                const uint64_t oldImported = mpiStats.longImported;
+                for(int i = 0; i < mpiWorkerSize; i++) {
+                    if (i == mpiWorkerRank) {
+                        continue;
+                    }
+                    mpiStats.bytesRecv += x.counts[i];
+                    const uint8_t* at = x.recv_buf.data() + x.displs[i];
+                    if (!mpi_unpack_long(at, at + x.counts[i])) {
+                        return false;
+                    }
+                }
+
+                if (solver->conf.verbosity >= 2) {
+                    cout
+                    << "c [mpi " << mpiRank << "  ]"
+                    << " round " << mpiStats.rounds
+                    << " imported longs " << (mpiStats.longImported - oldImported)
+                    << " (total: " << mpiStats.longImported << ")"
+                    << " sent longs total: " << mpiStats.longSent
+                    << " dup: " << mpiStats.longDup
+                    << " bytes sent: " << mpiStats.bytesSent
+                    << " recv: " << mpiStats.bytesRecv
+                    << " blocked: " << std::fixed << std::setprecision(2)
+                    << (double)mpiStats.blockedUs/1e6 << " s"
+                    << endl;
+                }
+                break;
+            }
+        }
+    }
+}
+
+//Packet: number of clauses, then for each clause its size, glue, first
+//literal, and the gaps between its sorted literals, all as varints.
+void DataSync::mpi_pack_long(vector<uint8_t>& buf)
+{
+    const auto& rings = sharedData->long_cls;
+    if (syncMPILongFinish.size() < rings.size()) {
+        syncMPILongFinish.resize(rings.size(), 0);
+    }
+
+    mpiLongCands.clear();
+    mpiLongLits.clear();
+    if (mpiLongSeen.size() > mpi_long_seen_max) {
+        mpiLongSeen.clear();
+    }
+    uint32_t glue;
+    for(uint32_t t = 0; t < rings.size(); t++) {
+        const LongClRing& ring = *rings[t];
+        const uint64_t upto = ring.get_written();
+        uint64_t at = std::max(syncMPILongFinish[t], ring.get_oldest(upto));
+        for(; at < upto; at++) {
+            if (!ring.read(at, long_tmp, glue)) {
+                continue;
+            }
+            if (glue > solver->conf.mpi_long_max_glue
+                || long_tmp.size() > solver->conf.mpi_long_max_size
+            ) {
+                mpiStats.longFiltered++;
+                continue;
+            }
+
+            std::sort(long_tmp.begin(), long_tmp.end());
+            const uint64_t h = hash_sorted_clause(long_tmp.data(), long_tmp.size());
+            if (!mpiLongSeen.insert(h).second) {
+                continue;
+            }
+            mpiLongCands.push_back(MPILongCand{
+                glue, (uint32_t)mpiLongLits.size(), (uint32_t)long_tmp.size(), h});
+            mpiLongLits.insert(mpiLongLits.end(), long_tmp.begin(), long_tmp.end());
+        }
+        syncMPILongFinish[t] = upto;
+    }
+
+    //Best clauses first, in case they don't all fit
+    std::stable_sort(mpiLongCands.begin(), mpiLongCands.end(),
+        [](const MPILongCand& a, const MPILongCand& b) {
+            return a.glue < b.glue;
+        });
+
+    vector<uint8_t> body;
+    uint32_t num = 0;
+    for(; num < mpiLongCands.size(); num++) {
+        const MPILongCand& c = mpiLongCands[num];
+        const Lit* lits = mpiLongLits.data() + c.start;
+        const size_t before = body.size();
+        put_varint(body, c.size);
+        put_varint(body, c.glue);
+        put_varint(body, lits[0].toInt());
+        for(uint32_t i = 1; i < c.size; i++) {
+            put_varint(body, lits[i].toInt() - lits[i-1].toInt() - 1);
+        }
+        if (body.size() > solver->conf.mpi_long_max_bytes) {
+            body.resize(before);
+            break;
+        }
+    }
+
+    //Didn't fit, they can still be imported if another worker sends them
+    for(uint32_t i = num; i < mpiLongCands.size(); i++) {
+        mpiLongSeen.erase(mpiLongCands[i].hash);
+        mpiStats.longFiltered++;
+    }
+    mpiStats.longSent += num;
+
+    put_varint(buf, num);
+    buf.insert(buf.end(), body.begin(), body.end());
+}
+
+bool DataSync::mpi_unpack_long(const uint8_t* at, const uint8_t* end)
+{
+    LongClRing& ring = *sharedData->long_cls[thread_id];
+    uint32_t num;
+    if (!get_varint(at, end, num)) {
+        return true;
+    }
+
+    uint32_t size;
+    uint32_t glue;
+    uint32_t val;
+    for(uint32_t n = 0; n < num; n++) {
+        if (!get_varint(at, end, size)
+            || !get_varint(at, end, glue)
+            || !get_varint(at, end, val)
+            || size < 3
+        ) {
+            break;
+        }
+        long_tmp.resize(size);
+        long_tmp[0] = Lit::toLit(val);
+        bool malformed = false;
+        for(uint32_t i = 1; i < size; i++) {
+            if (!get_varint(at, end, val)) {
+                malformed = true;
+                break;
+            }
+            long_tmp[i] = Lit::toLit(long_tmp[i-1].toInt() + val + 1);
+        }
+        if (malformed || long_tmp.back().var() >= solver->nVarsOutside()) {
+            break;
+        }
+        mpiStats.longRecv++;
+
+        if (mpiLongSeen.size() > mpi_long_seen_max) {
+            mpiLongSeen.clear();
+        }
+        const uint64_t h = hash_sorted_clause(long_tmp.data(), size);
+        if (!mpiLongSeen.insert(h).second) {
+            mpiStats.longDup++;
+            continue;
+        }
+
+        //Pass it on to the other threads of this rank, too
+        if (solver->conf.sync_long_cls && size <= ring.get_max_size()) {
+            ring.push(long_tmp, glue);
+        }
+        const uint64_t oldRecvLongData = stats.recvLongData;
+        if (!add_long_from_other(long_tmp, glue)) {
+            return false;
+        }
+        mpiStats.longImported += stats.recvLongData - oldRecvLongData;
+    }
+
+    return true;
+}
+
+void DataSync::mpi_send_stats()
+{
+    MPIExchange& x = *mpiExch;
+    if (x.stats_sent) {
+        return;
+    }
+
+    uint64_t b[MPIStats::num_fields];
+    b[0] = mpiStats.rounds;
+    b[1] = mpiStats.bytesSent;
+    b[2] = mpiStats.bytesRecv;
+    b[3] = mpiStats.longSent;
+    b[4] = mpiStats.longRecv;
+    b[5] = mpiStats.longImported;
+    b[6] = mpiStats.longDup;
+    b[7] = mpiStats.longFiltered;
+    b[8] = mpiStats.blockedUs;
+
+    const double myTime = MPI_Wtime();
+    int err = MPI_Send(b, MPIStats::num_fields, MPI_UINT64_T,
+        0, //server
+        2, //tag "2", i.e. statistics
+        MPI_COMM_WORLD);
+    assert(err == MPI_SUCCESS);
+    mpiStats.blockedUs += (MPI_Wtime()-myTime)*1e6;
+    x.stats_sent = true;
+}
 #endif
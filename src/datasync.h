@@ -27,19 +27,23 @@ THE SOFTWARE.
 #include "watched.h"
 #include "propby.h"
 #include "watcharray.h"
+#include "xor.h"
 #ifdef USE_MPI
 #include "mpi.h"
+#include <unordered_set>
 #endif //USE_MPI
 
 namespace CMSat {
 
 class Clause;
+class BinStore;
 class SharedData;
 class Solver;
 class DataSync
 {
     public:
         DataSync(Solver* solver, SharedData* sharedData);
+        ~DataSync();
         void finish_up_mpi();
         bool enabled();
         void set_shared_data(SharedData* sharedData);
@@ -52,7 +56,16 @@ class DataSync
            const vector<uint32_t>& outerToInter
             , const vector<uint32_t>& interToOuter
         );
-        void signal_new_long_clause(const vector<Lit>& clause);
+        void signal_new_long_clause(const vector<Lit>& clause, const uint32_t glue);
+        void signal_imported_cl_used();
+        void signal_imported_cl_deleted();
+
+        //XOR sharing, see conf.sync_xors
+        bool xors_shared();
+        bool xor_finder_thread();
+        void share_xors(const vector<Xor>& xors);
+        bool get_shared_xors(vector<Xor>& xors);
+        void signal_bin_xor(const Lit lit1, const Lit lit2, const bool rhs);
 
         #ifdef USE_GPU
         vector<Lit> clause_tmp;
@@ -70,20 +83,46 @@ class DataSync
             uint32_t recvUnitData = 0;
             uint32_t sentBinData = 0;
             uint32_t recvBinData = 0;
+            uint64_t droppedBinData = 0; //readers lagged too far behind
+            uint64_t sentLongData = 0;
+            uint64_t recvLongData = 0;
+            uint64_t usedLongData = 0;
+            uint64_t deletedLongData = 0;
+            uint32_t sentXors = 0;
+            uint32_t recvXors = 0;
         };
         const Stats& get_stats() const;
 
+        //Per-rank MPI statistics, sent to the server as tag 2 at the end
+        struct MPIStats
+        {
+            uint64_t rounds = 0;
+            uint64_t bytesSent = 0;
+            uint64_t bytesRecv = 0;
+            uint64_t longSent = 0;
+            uint64_t longRecv = 0;
+            uint64_t longImported = 0;
+            uint64_t longDup = 0;
+            uint64_t longFiltered = 0;
+            uint64_t blockedUs = 0; //time spent inside MPI calls
+            static const int num_fields = 9;
+        };
+
     private:
-        void extend_bins_if_needed();
         Lit map_outer_to_outside(Lit lit) const;
+        Lit map_outside_to_inter(Lit lit) const;
         bool shareUnitData();
         bool shareBinData();
         bool syncBinFromOthers();
-        bool syncBinFromOthers(const Lit lit, const vector<Lit>& bins, uint32_t& finished, watch_subarray ws);
-        void syncBinToOthers();
-        void clear_set_binary_values();
-        bool add_bin_to_threads(const Lit lit1, const Lit lit2);
+        bool syncBinFromOthers(
+            const Lit lit,
+            const vector<std::pair<Lit, Lit>>& bins,
+            const size_t start,
+            const size_t end,
+            watch_subarray ws);
         void signal_new_bin_clause(Lit lit1, Lit lit2);
+        bool shareLongData();
+        bool add_long_from_other(vector<Lit>& cl, const uint32_t glue);
         void rebuild_bva_map_if_needed();
 
 
@@ -92,12 +131,13 @@ class DataSync
         #endif
         int thread_id = -1;
 
-        //stuff to sync
-        vector<std::pair<Lit, Lit> > newBinClauses;
-
         //stats
         uint64_t lastSyncConf = 0;
-        vector<uint32_t> syncFinish;
+        void collect_bins(BinStore& store, uint64_t& finished);
+        vector<uint64_t> syncBinFinish; //per-thread position in its binary store
+        vector<std::pair<Lit, Lit>> bins_tmp;
+        vector<uint64_t> syncLongFinish; //per-thread position in its long clause ring
+        vector<Lit> long_tmp;
         Stats stats;
 
         //Other systems
@@ -115,8 +155,50 @@ class DataSync
             const uint32_t var,
             uint32_t& thisGotUnitData
         );
-        vector<uint32_t> syncMPIFinish;
+        vector<uint64_t> syncMPIFinish; //per-thread position in its binary store
+        uint64_t syncMPIBinFinish = 0; //position in sharedData->mpi_bins
+        bool mpi_bins_full = false; //already warned about dropped ones
         MPI_Request   sendReq;
+
+        //Long clause exchange between the workers, see conf.mpi_share_long.
+        //One round is an MPI_Iallgather of the packet sizes followed by
+        //an MPI_Iallgatherv of the packets, both polled from syncData().
+        enum class MPILongState {idle, counts, data};
+        struct MPIExchange
+        {
+            MPILongState state = MPILongState::idle;
+            MPI_Request req;
+            int send_count = 0;
+            vector<int> counts;
+            vector<int> displs;
+            vector<uint8_t> send_buf;
+            vector<uint8_t> recv_buf;
+
+            //The stats are sent once, when the solve finishes. The server
+            //waits for exactly one such message from every worker
+            bool stats_sent = false;
+        };
+        bool mpi_share_long();
+        void mpi_pack_long(vector<uint8_t>& buf);
+        bool mpi_unpack_long(const uint8_t* at, const uint8_t* end);
+        bool mpi_test(MPI_Request& req);
+        void mpi_send_stats();
+        MPI_Comm      mpiWorkers = MPI_COMM_NULL;
+        int           mpiWorkerRank = 0;
+        int           mpiWorkerSize = 0;
+        MPIExchange*  mpiExch = NULL;
+        vector<uint64_t> syncMPILongFinish; //per-thread position in its long clause ring
+        struct MPILongCand
+        {
+            uint32_t glue;
+            uint32_t start; //in mpiLongLits
+            uint32_t size;
+            uint64_t hash;
+        };
+        vector<MPILongCand> mpiLongCands;
+        vector<Lit>   mpiLongLits;
+        std::unordered_set<uint64_t> mpiLongSeen;
+        MPIStats      mpiStats;
         uint32_t*     mpiSendData = NULL;
 
         int           mpiRank = 0;
@@ -140,6 +222,16 @@ inline const DataSync::Stats& DataSync::get_stats() const
     return stats;
 }
 
+inline void DataSync::signal_imported_cl_used()
+{
+    stats.usedLongData++;
+}
+
+inline void DataSync::signal_imported_cl_deleted()
+{
+    stats.deletedLongData++;
+}
+
 inline Lit DataSync::map_outer_to_outside(const Lit lit) const
 {
     return Lit(outer_to_without_bva_map[lit.var()], lit.sign());
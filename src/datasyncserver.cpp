@@ -22,8 +22,10 @@ THE SOFTWARE.
 
 #include <cassert>
 #include <unistd.h>
+#include <iomanip>
 
 #include "datasyncserver.h"
+#include "datasync.h"
 #include "solvertypes.h"
 using std::vector;
 
@@ -38,6 +40,7 @@ DataSyncServer::DataSyncServer()
     assert(err == MPI_SUCCESS);
 
     sendRequests.resize(mpiSize);
+    worker_stats.resize(mpiSize);
     sendRequestsFinished.resize(mpiSize, true);
     interruptRequests.resize(mpiSize);
 
@@ -143,6 +146,40 @@ void DataSyncServer::mpi_recv_from_others()
     numGotPacket++;
 }
 
+//Tag of message "2". Every worker sends its stats exactly once, when its
+//solve finishes, so this waits for one message from each of them. BLOCKING.
+void DataSyncServer::mpi_recv_stats()
+{
+    for (int source = 1; source < mpiSize; source++) {
+        vector<uint64_t>& dat = worker_stats[source];
+        dat.resize(DataSync::MPIStats::num_fields);
+        int err = MPI_Recv(dat.data(), dat.size(), MPI_UINT64_T,
+                       source,
+                       2, //tag "2", i.e. statistics
+                       MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        assert(err == MPI_SUCCESS);
+    }
+}
+
+void DataSyncServer::print_worker_stats() const
+{
+    for (int i = 1; i < mpiSize; i++) {
+        const vector<uint64_t>& dat = worker_stats[i];
+        cout << "c [mpi] rank " << i
+        << " rounds: " << dat[0]
+        << " bytes sent: " << dat[1]
+        << " recv: " << dat[2]
+        << " longs sent: " << dat[3]
+        << " recv: " << dat[4]
+        << " imported: " << dat[5]
+        << " dup: " << dat[6]
+        << " filtered: " << dat[7]
+        << " blocked: " << std::fixed << std::setprecision(2)
+        << (double)dat[8]/1e6 << " s"
+        << endl;
+    }
+}
+
 void DataSyncServer::get_bin(const Lit lit1, const Lit lit2)
 {
     assert(lit1 < lit2);
@@ -448,6 +485,10 @@ lbool DataSyncServer::actAsServer()
         {
             interrupt_sent = true;
 
+            //The interrupt makes every worker finish and send its stats
+            mpi_recv_stats();
+            print_worker_stats();
+
             //HACK below, we don't cleanly exit
             if (solution_val == l_True) {
                 cout << "s SATISFIABLE" << endl;
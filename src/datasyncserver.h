@@ -39,6 +39,7 @@ class DataSyncServer {
         void print_solution();
         void send_cnf_to_solvers();
         void add_clause(const vector<Lit>& lits);
+        void add_red_clause(const vector<Lit>&) {} //implied, not needed
         void new_vars(uint32_t i);
         void new_var();
         void add_xor_clause(const vector<uint32_t>& vars, bool& rhs);
@@ -52,6 +53,8 @@ class DataSyncServer {
         void sendDataToAll();
         bool check_interrupt_and_forward_to_all();
         void finish_data_send();
+        void mpi_recv_stats();
+        void print_worker_stats() const;
 
         std::vector<uint32_t> syncMPIFinish;
         std::vector<std::vector<Lit> > bins;
@@ -65,6 +68,8 @@ class DataSyncServer {
         std::vector<bool> sendRequestsFinished;
         std::vector<MPI_Request> interruptRequests;
 
+        std::vector<std::vector<uint64_t>> worker_stats; //latest tag 2 from each rank
+
         vector<lbool> model;
         lbool solution_val = l_Undef;
         bool interrupt_sent = false;
@@ -0,0 +1,531 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DIMACSLOADER_MMAP
+#endif
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "solvertypesmini.h"
+
+namespace CMSat {
+
+// Fast loader for plain CNF: 'p cnf' headers, clauses and ordinary comments.
+// Plain files are mmapped and cut at line boundaries into pieces of bounded
+// size that worker threads parse while the calling thread adds the previous
+// ones with add_clauses(). Gzipped files are decompressed by a separate
+// thread while the calling thread parses and adds. At most a few pieces are
+// in flight at any time, so memory use does not grow with the file.
+//
+// At the first line it cannot handle (XOR/BNN lines, weights, 'c ind',
+// 'c red', clauses spanning lines, malformed input, etc.) it stops and
+// load() returns FALSE. Everything before that line has been added to the
+// solver, the caller must parse the rest with DimacsParser from
+// resume_offset(), which is in the uncompressed text and at line
+// resume_line(), counted from 0 as DimacsParser does.
+template<class S>
+class DimacsLoader
+{
+public:
+    DimacsLoader(S* solver, unsigned verbosity, unsigned num_threads);
+    bool load(const std::string& fname);
+    uint64_t resume_offset() const { return done_bytes; }
+    uint64_t resume_line() const { return done_lines; }
+
+private:
+    struct Piece {
+        const char* data = NULL;
+        size_t size = 0;
+        std::vector<char> text; //gzipped input only
+
+        std::vector<Lit> lits;
+        std::vector<uint32_t> offs; //num clauses + 1 entries
+        uint32_t num_vars = 0;
+        uint32_t header_vars = 0;
+        uint64_t header_cls = 0;
+        uint32_t num_headers = 0;
+        uint64_t empty_lines = 0;
+        uint64_t lines = 0; //before 'stop'
+        size_t stop = 0; //less than 'size' if a line could not be parsed
+
+        void clear();
+    };
+
+    static bool is_blank(const char c);
+    static void parse(Piece& p);
+    static bool special_comment(const char* w, const char* const end);
+    bool add(Piece& p);
+    bool load_plain(const char* data, size_t size);
+    #ifdef USE_ZLIB
+    bool load_gz(const std::string& fname);
+    #endif
+    void print_stats() const;
+
+    S* solver;
+    unsigned verbosity;
+    unsigned num_threads;
+
+    //Stats, also where to resume
+    uint64_t done_bytes = 0;
+    uint64_t done_lines = 0;
+    uint64_t num_cls = 0;
+    uint64_t empty_lines = 0;
+    uint32_t orig_vars = 0;
+    size_t num_pieces = 0;
+
+    static const size_t piece_size = 4ULL << 20;
+    //Files below this are parsed on the calling thread only
+    static const size_t min_parallel_size = 16ULL << 20;
+    //Pieces parsed but not yet added, per parsing thread
+    static const size_t max_queued = 2;
+};
+
+template<class S>
+DimacsLoader<S>::DimacsLoader(S* _solver, unsigned _verbosity, unsigned _num_threads) :
+    solver(_solver)
+    , verbosity(_verbosity)
+    , num_threads(std::max(_num_threads, 1U))
+{
+}
+
+template<class S>
+void DimacsLoader<S>::Piece::clear()
+{
+    lits.clear();
+    offs.clear();
+    num_vars = 0;
+    header_vars = 0;
+    header_cls = 0;
+    num_headers = 0;
+    empty_lines = 0;
+    lines = 0;
+    stop = 0;
+}
+
+template<class S>
+bool DimacsLoader<S>::special_comment(const char* w, const char* const end)
+{
+    const size_t len = end - w;
+    static const char* const words[] = {"red", "MUST", "ind", "p"};
+    for(const char* word: words) {
+        if (len == strlen(word) && memcmp(w, word, len) == 0) return true;
+    }
+    return len >= 8 && memcmp(w, "Solver::", 8) == 0;
+}
+
+//Whitespace that does not end the line
+template<class S>
+bool DimacsLoader<S>::is_blank(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+template<class S>
+void DimacsLoader<S>::parse(Piece& p)
+{
+    #define DIMACSLOADER_SKIP_WS \
+        while (at < end && is_blank(*at)) at++
+    #define DIMACSLOADER_FAIL \
+        do { \
+            p.lits.resize(p.offs.back()); \
+            p.stop = line - p.data; \
+            return; \
+        } while (0)
+
+    const char* at = p.data;
+    const char* const end = p.data + p.size;
+    p.offs.push_back(0);
+    while (at < end) {
+        const char* const line = at;
+        DIMACSLOADER_SKIP_WS;
+        if (at == end) break;
+
+        const char c = *at;
+        if (c == '\n') {
+            p.empty_lines++;
+            p.lines++;
+            at++;
+            continue;
+        }
+
+        if (c == 'c') {
+            at++;
+            DIMACSLOADER_SKIP_WS;
+            const char* w = at;
+            while (at < end && !is_blank(*at) && *at != '\n') at++;
+            if (special_comment(w, at)) DIMACSLOADER_FAIL;
+            while (at < end && *at != '\n') at++;
+            if (at < end) {
+                at++;
+                p.lines++;
+            }
+            continue;
+        }
+
+        if (c == 'p') {
+            at++;
+            DIMACSLOADER_SKIP_WS;
+            if (end - at < 3 || memcmp(at, "cnf", 3) != 0) DIMACSLOADER_FAIL;
+            at += 3;
+            uint64_t nums[2];
+            for(uint64_t& num: nums) {
+                DIMACSLOADER_SKIP_WS;
+                if (at == end || *at < '0' || *at > '9') DIMACSLOADER_FAIL;
+                num = 0;
+                while (at < end && *at >= '0' && *at <= '9') {
+                    num = num*10 + (*at - '0');
+                    if (num > (1ULL << 31)) DIMACSLOADER_FAIL;
+                    at++;
+                }
+            }
+            if (nums[0] >= (1ULL << 28)) DIMACSLOADER_FAIL;
+            p.header_vars = std::max<uint32_t>(p.header_vars, nums[0]);
+            p.header_cls = nums[1];
+            p.num_headers++;
+            while (at < end && *at != '\n') at++;
+            if (at < end) {
+                at++;
+                p.lines++;
+            }
+            continue;
+        }
+
+        //Clause. Same rules as DimacsParser::readClause()
+        uint32_t num_vars = p.num_vars;
+        for (;;) {
+            DIMACSLOADER_SKIP_WS;
+            bool neg = false;
+            if (at < end && *at == '-') {
+                neg = true;
+                at++;
+            } else if (at < end && *at == '+') {
+                at++;
+            }
+            if (at == end || *at < '0' || *at > '9') DIMACSLOADER_FAIL;
+            uint32_t val = 0;
+            while (at < end && *at >= '0' && *at <= '9') {
+                val = val*10 + (*at - '0');
+                if (val > (1U << 28)) DIMACSLOADER_FAIL;
+                at++;
+            }
+            if (val == 0) break;
+            if (at == end || !is_blank(*at)) DIMACSLOADER_FAIL;
+            p.lits.push_back(Lit(val-1, neg));
+            num_vars = std::max(num_vars, val);
+        }
+        DIMACSLOADER_SKIP_WS;
+        if (at < end) {
+            if (*at != '\n') DIMACSLOADER_FAIL;
+            at++;
+            p.lines++;
+        }
+        p.num_vars = num_vars;
+        p.offs.push_back(p.lits.size());
+    }
+    p.stop = p.size;
+    #undef DIMACSLOADER_FAIL
+    #undef DIMACSLOADER_SKIP_WS
+}
+
+//Adds what was parsed from the piece, returns FALSE if the rest of the
+//piece could not be parsed
+template<class S>
+bool DimacsLoader<S>::add(Piece& p)
+{
+    if (p.num_headers && verbosity) {
+        std::cout
+        << "c -- header says num vars:   " << std::setw(12) << p.header_vars << std::endl
+        << "c -- header says num clauses:" << std::setw(12) << p.header_cls << std::endl;
+    }
+    const uint32_t need_vars = std::max(p.num_vars, p.header_vars);
+    if (solver->nVars() < need_vars) {
+        solver->new_vars(need_vars - solver->nVars());
+    }
+    const size_t n = p.offs.size()-1;
+    if (n > 0) {
+        solver->add_clauses(p.lits.data(), p.offs.data(), n);
+    }
+
+    num_cls += n;
+    empty_lines += p.empty_lines;
+    done_bytes += p.stop;
+    done_lines += p.lines;
+    num_pieces++;
+    return p.stop == p.size;
+}
+
+template<class S>
+bool DimacsLoader<S>::load_plain(const char* data, const size_t size)
+{
+    //Cut after a newline, every line is self-contained in DIMACS
+    std::vector<size_t> bounds(1, 0);
+    while (bounds.back() < size) {
+        size_t at = bounds.back() + piece_size;
+        const void* nl = at < size ? memchr(data + at, '\n', size - at) : NULL;
+        at = nl ? ((const char*)nl - data) + 1 : size;
+        bounds.push_back(at);
+    }
+    const size_t num = bounds.size()-1;
+
+    const size_t threads = size < min_parallel_size ? 0
+        : std::min<size_t>(num_threads, num);
+    const size_t window = std::max<size_t>(1, threads*max_queued);
+    std::vector<Piece> slots(window);
+    std::vector<char> ready(window, 0);
+    std::mutex mu;
+    std::condition_variable cv;
+    size_t next = 0;
+    size_t added = 0;
+    bool stop = false;
+
+    auto parse_piece = [&](const size_t i) {
+        Piece& p = slots[i % window];
+        p.clear();
+        p.data = data + bounds[i];
+        p.size = bounds[i+1] - bounds[i];
+        parse(p);
+    };
+    auto worker = [&]() {
+        for (;;) {
+            size_t i;
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait(lock, [&]{ return stop || next == num || next < added + window; });
+                if (stop || next == num) return;
+                i = next++;
+            }
+            parse_piece(i);
+            std::lock_guard<std::mutex> lock(mu);
+            ready[i % window] = 1;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> thds;
+    for(size_t i = 0; i < threads; i++) thds.push_back(std::thread(worker));
+
+    bool ok = true;
+    for(; added < num; ) {
+        const size_t slot = added % window;
+        if (threads == 0) {
+            parse_piece(added);
+        } else {
+            std::unique_lock<std::mutex> lock(mu);
+            cv.wait(lock, [&]{ return ready[slot]; });
+        }
+        ok = add(slots[slot]);
+
+        #ifdef DIMACSLOADER_MMAP
+        //Drop the pages of the added text, they are not needed anymore
+        const size_t page = sysconf(_SC_PAGESIZE);
+        const size_t from = bounds[added]/page*page;
+        const size_t to = bounds[added+1]/page*page;
+        if (ok && to > from) madvise((void*)(data + from), to - from, MADV_DONTNEED);
+        #endif
+
+        std::lock_guard<std::mutex> lock(mu);
+        ready[slot] = 0;
+        added++;
+        if (!ok) stop = true;
+        cv.notify_all();
+        if (!ok) break;
+    }
+    for(std::thread& t: thds) t.join();
+    return ok;
+}
+
+#ifdef USE_ZLIB
+template<class S>
+bool DimacsLoader<S>::load_gz(const std::string& fname)
+{
+    gzFile in = gzopen(fname.c_str(), "rb");
+    if (in == NULL) return false;
+    gzbuffer(in, 1U << 20);
+
+    std::mutex mu;
+    std::condition_variable cv;
+    std::deque<std::vector<char>> queue;
+    bool reader_done = false;
+    bool read_error = false;
+    bool stop = false;
+
+    //Decompress on a separate thread, hand over blocks that end on a newline
+    std::thread reader([&]() {
+        std::vector<char> carry;
+        for (;;) {
+            std::vector<char> buf;
+            buf.swap(carry);
+            const size_t at = buf.size();
+            buf.resize(at + piece_size);
+            const int got = gzread(in, buf.data() + at, piece_size);
+            if (got < 0) {
+                std::lock_guard<std::mutex> lock(mu);
+                read_error = true;
+                break;
+            }
+            buf.resize(at + got);
+            if (got > 0) {
+                size_t last = buf.size();
+                while (last > 0 && buf[last-1] != '\n') last--;
+                if (last == 0) {
+                    //No newline yet, keep reading into the same buffer
+                    carry.swap(buf);
+                    continue;
+                }
+                carry.assign(buf.begin() + last, buf.end());
+                buf.resize(last);
+            }
+            const bool eof = (got == 0);
+
+            std::unique_lock<std::mutex> lock(mu);
+            cv.wait(lock, [&]{ return stop || queue.size() < max_queued; });
+            if (stop) break;
+            if (!buf.empty()) queue.push_back(std::move(buf));
+            cv.notify_all();
+            if (eof) break;
+        }
+        std::lock_guard<std::mutex> lock(mu);
+        reader_done = true;
+        cv.notify_all();
+    });
+
+    Piece p;
+    bool ok = true;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mu);
+            cv.wait(lock, [&]{ return !queue.empty() || reader_done; });
+            if (queue.empty()) {
+                //Whatever was read is added, resume after it
+                ok = !read_error;
+                break;
+            }
+            p.text = std::move(queue.front());
+            queue.pop_front();
+            cv.notify_all();
+        }
+        p.clear();
+        p.data = p.text.data();
+        p.size = p.text.size();
+        parse(p);
+        if (!add(p)) {
+            ok = false;
+            std::lock_guard<std::mutex> lock(mu);
+            stop = true;
+            cv.notify_all();
+            break;
+        }
+    }
+    reader.join();
+    gzclose(in);
+    return ok;
+}
+#endif
+
+template<class S>
+void DimacsLoader<S>::print_stats() const
+{
+    if (!verbosity) return;
+    if (empty_lines) {
+        std::cout
+        << "c WARNING: " << empty_lines << " empty lines"
+        << " -- this is not part of the DIMACS specifications. Ignored."
+        << std::endl;
+    }
+    std::cout
+    << "c -- clauses added: " << num_cls << std::endl
+    << "c -- vars added " << (solver->nVars() - orig_vars)
+    << " (fast loader, " << num_pieces << " pieces)"
+    << std::endl;
+}
+
+template<class S>
+bool DimacsLoader<S>::load(const std::string& fname)
+{
+    orig_vars = solver->nVars();
+    FILE* f = fopen(fname.c_str(), "rb");
+    if (f == NULL) return false;
+    unsigned char magic[2] = {0, 0};
+    const size_t got = fread(magic, 1, 2, f);
+    fclose(f);
+
+    bool ret = false;
+    if (got == 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        #ifdef USE_ZLIB
+        ret = load_gz(fname);
+        #else
+        return false;
+        #endif
+    } else {
+        #ifdef DIMACSLOADER_MMAP
+        const int fd = open(fname.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            close(fd);
+            return false;
+        }
+        const size_t size = st.st_size;
+        if (size == 0) {
+            close(fd);
+            ret = true;
+        } else {
+            void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (data == MAP_FAILED) return false;
+            madvise(data, size, MADV_SEQUENTIAL);
+            ret = load_plain((const char*)data, size);
+            munmap(data, size);
+        }
+        #else
+        return false;
+        #endif
+    }
+
+    print_stats();
+    return ret;
+}
+
+}
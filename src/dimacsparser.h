@@ -46,7 +46,11 @@ template <class C, class S>
 class DimacsParser
 {
     public:
-        DimacsParser(S* solver, const std::string* debugLib, unsigned _verbosity);
+        DimacsParser(
+            S* solver,
+            const std::string* debugLib,
+            unsigned _verbosity,
+            size_t start_line = 0);
 
         template <class T> bool parse_DIMACS(
             T input_stpeam,
@@ -118,10 +122,11 @@ DimacsParser<C, S>::DimacsParser(
     S* _solver
     , const std::string* _debugLib
     , unsigned _verbosity
+    , size_t start_line
 ):
     solver(_solver)
     , verbosity(_verbosity)
-    , lineNum(0)
+    , lineNum(start_line)
 {
     if (_debugLib) {
         debugLib = *_debugLib;
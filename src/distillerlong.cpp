@@ -300,7 +300,9 @@ bool DistillerLong::distill_long_cls_all(
     lit_counts.resize(solver->nVars()*2, 0);
     vector<ClOffset> todo;
     todo.reserve(offs.size());
-    for(uint32_t prio = 0; prio < (red ? 1: 2); prio ++) {
+    //In the incremental fast path only the new (never distilled) clauses
+    const uint32_t num_prio = (red || solver->inc_restrict_simp()) ? 1 : 2;
+    for(uint32_t prio = 0; prio < num_prio; prio ++) {
         uint32_t j = 0;
         for(uint32_t i = 0; i < offs.size(); i ++) {
             Clause* cl = solver->cl_alloc.ptr(offs[i]);
@@ -540,7 +542,7 @@ ClOffset DistillerLong::try_distill_clause_and_return_new(
             assert(val == l_True);
             cl[j++] = cl[i];
             True_confl = true;
-            confl = solver->varData[cl[i].var()].reason;
+            confl = solver->varHot[cl[i].var()].reason;
             break;
         }
     }
@@ -0,0 +1,250 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "flat_forest.h"
+
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+
+using namespace CMSat;
+
+//Rows scored per pass over the forest. Going tree by tree over a block
+//keeps both the tree and the rows in L1.
+static const uint32_t block_rows = 128;
+
+void FlatForest::predict(
+    const float* data,
+    const uint32_t num,
+    const uint32_t stride,
+    double* out) const
+{
+    double sum[block_rows];
+    for(uint32_t start = 0; start < num; start += block_rows) {
+        const uint32_t n = std::min(block_rows, num-start);
+        const float* rows = data + (uint64_t)start*stride;
+        std::fill(sum, sum+n, 0.0);
+
+        for(uint32_t t = 0; t < num_trees; t++) {
+            const int32_t root = roots[t];
+            if (root < 0) {
+                const double val = leaf[~root];
+                for(uint32_t r = 0; r < n; r++) sum[r] += val;
+                continue;
+            }
+
+            for(uint32_t r = 0; r < n; r++) {
+                const float* row = rows + (uint64_t)r*stride;
+                int32_t at = root;
+                while(at >= 0) {
+                    //Selects instead of branches, the split outcomes are
+                    //unpredictable
+                    const uint8_t f = flags[at];
+                    float x = row[feat[at]];
+                    const bool nan = std::isnan(x);
+                    x = (nan && !(f & nan_missing)) ? 0.0f : x;
+                    const bool missing = ((f & nan_missing) && nan)
+                        | ((f & zero_missing) && std::fabs(x) <= 1e-35f);
+                    const bool go_left = missing ? (f & default_left) : x < thr[at];
+                    at = go_left ? left[at] : right[at];
+                }
+                sum[r] += leaf[~at];
+            }
+        }
+
+        for(uint32_t r = 0; r < n; r++) {
+            double score = sum[r];
+            if (average && num_trees > 0) score /= num_trees;
+            score += base;
+            if (sigmoid != 0) score = 1.0/(1.0+std::exp(-sigmoid*score));
+            out[start+r] = score;
+        }
+    }
+}
+
+template<class T>
+static bool parse_list(const string& val, vector<T>& out)
+{
+    out.clear();
+    std::istringstream ss(val);
+    T x;
+    while(ss >> x) out.push_back(x);
+    return ss.eof();
+}
+
+//LightGBM goes left on "x <= t" with t a double, x a float. The smallest
+//float above the largest float <= t gives the same split with "x < thr".
+static float lgbm_threshold(const double t)
+{
+    float f = (float)t;
+    if ((double)f > t) f = std::nextafter(f, -std::numeric_limits<float>::infinity());
+    return std::nextafter(f, std::numeric_limits<float>::infinity());
+}
+
+bool FlatForestStore::load_lgbm(const string& fname, string& err)
+{
+    std::ifstream in(fname);
+    if (!in) {
+        err = "cannot open file " + fname;
+        return false;
+    }
+
+    roots.clear(); left.clear(); right.clear(); thr.clear();
+    feat.clear(); flags.clear(); leaf.clear();
+    forest = FlatForest();
+
+    std::map<string, string> header;
+    std::map<string, string> tree;
+    bool in_tree = false;
+    auto flush_tree = [&]() -> bool {
+        if (!in_tree) return true;
+        in_tree = false;
+        if (tree.count("num_cat") && tree["num_cat"] != "0") {
+            err = "categorical splits are not supported";
+            return false;
+        }
+        if (tree.count("is_linear") && tree["is_linear"] != "0") {
+            err = "linear trees are not supported";
+            return false;
+        }
+
+        vector<double> t_leaf;
+        vector<double> t_thr;
+        vector<int64_t> t_feat, t_dec, t_left, t_right;
+        if (!parse_list(tree["leaf_value"], t_leaf) || t_leaf.empty()) {
+            err = "bad leaf_value in tree";
+            return false;
+        }
+        const int32_t node_off = left.size();
+        const int32_t leaf_off = leaf.size();
+        for(const double v: t_leaf) leaf.push_back(v);
+        if (t_leaf.size() == 1) {
+            roots.push_back(~leaf_off);
+            tree.clear();
+            return true;
+        }
+
+        if (!parse_list(tree["split_feature"], t_feat)
+            || !parse_list(tree["threshold"], t_thr)
+            || !parse_list(tree["decision_type"], t_dec)
+            || !parse_list(tree["left_child"], t_left)
+            || !parse_list(tree["right_child"], t_right)
+        ) {
+            err = "cannot parse tree";
+            return false;
+        }
+        const size_t inner = t_leaf.size()-1;
+        if (t_feat.size() != inner || t_thr.size() != inner || t_dec.size() != inner
+            || t_left.size() != inner || t_right.size() != inner
+        ) {
+            err = "inconsistent tree sizes";
+            return false;
+        }
+
+        auto child = [&](const int64_t c) -> int32_t {
+            return c >= 0 ? c + node_off : ~(~c + leaf_off);
+        };
+        for(size_t i = 0; i < inner; i++) {
+            const int64_t dec = t_dec[i];
+            if (dec & 1) {
+                err = "categorical splits are not supported";
+                return false;
+            }
+            if (t_feat[i] < 0 || t_feat[i] > std::numeric_limits<uint16_t>::max()) {
+                err = "feature index out of range";
+                return false;
+            }
+            uint8_t f = 0;
+            if (dec & 2) f |= FlatForest::default_left;
+            const int64_t missing_type = (dec >> 2) & 3;
+            if (missing_type == 1) f |= FlatForest::zero_missing;
+            if (missing_type == 2) f |= FlatForest::nan_missing;
+
+            feat.push_back(t_feat[i]);
+            thr.push_back(lgbm_threshold(t_thr[i]));
+            flags.push_back(f);
+            left.push_back(child(t_left[i]));
+            right.push_back(child(t_right[i]));
+        }
+        roots.push_back(node_off);
+        tree.clear();
+        return true;
+    };
+
+    string line;
+    bool ended = false;
+    while(std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line == "end of trees") {
+            ended = true;
+            break;
+        }
+        if (line.empty()) continue;
+        const size_t eq = line.find('=');
+        const string key = line.substr(0, eq);
+        const string val = eq == string::npos ? "" : line.substr(eq+1);
+        if (key == "Tree") {
+            if (!flush_tree()) return false;
+            in_tree = true;
+            continue;
+        }
+        if (in_tree) tree[key] = val;
+        else header[key] = val;
+    }
+    if (!ended || !flush_tree()) {
+        if (err.empty()) err = "no \"end of trees\" in model";
+        return false;
+    }
+
+    if (header.count("num_class") && header["num_class"] != "1") {
+        err = "only single-output models are supported";
+        return false;
+    }
+    const string& obj = header["objective"];
+    double sigmoid = 0;
+    if (obj.substr(0, 6) == "binary") {
+        sigmoid = 1.0;
+        const size_t at = obj.find("sigmoid:");
+        if (at != string::npos) sigmoid = std::stod(obj.substr(at+8));
+    } else if (obj.substr(0, 13) == "cross_entropy" || obj.substr(0, 8) == "xentropy") {
+        sigmoid = 1.0;
+    } else if (obj.substr(0, 10) != "regression") {
+        err = "unsupported objective '" + obj + "'";
+        return false;
+    }
+
+    forest.num_trees = roots.size();
+    forest.roots = roots.data();
+    forest.left = left.data();
+    forest.right = right.data();
+    forest.thr = thr.data();
+    forest.feat = feat.data();
+    forest.flags = flags.data();
+    forest.leaf = leaf.data();
+    forest.base = 0;
+    forest.sigmoid = sigmoid;
+    forest.average = header.count("average_output") > 0;
+    return true;
+}
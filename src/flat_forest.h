@@ -0,0 +1,85 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef FLAT_FOREST_H_
+#define FLAT_FOREST_H_
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+namespace CMSat {
+
+using std::vector;
+using std::string;
+
+// A gradient boosted forest in flat, structure-of-arrays form. Node and leaf
+// indices are global over all trees. A child (or root) >= 0 is an inner node,
+// a negative one is ~leaf_index. Every split is "x < thr goes left", LightGBM's
+// "x <= thr" is converted when the model is flattened. The arrays are either
+// generated C++ (scripts/gbdt_to_cpp.py) or owned by a FlatForestStore.
+struct FlatForest
+{
+    enum : uint8_t {
+        default_left = 1, //missing value goes left
+        nan_missing = 2, //NaN is missing
+        zero_missing = 4, //NaN is treated as zero, zero is missing
+    };
+
+    uint32_t num_trees;
+    const int32_t* roots;
+    const int32_t* left;
+    const int32_t* right;
+    const float* thr;
+    const uint16_t* feat;
+    const uint8_t* flags;
+    const double* leaf;
+    double base; //added to the raw score
+    double sigmoid; //0 = identity, otherwise 1/(1+exp(-sigmoid*score))
+    bool average; //random forest mode, raw score is averaged over the trees
+
+    //Rows are "stride" floats apart, "out" receives "num" predictions
+    void predict(const float* data, uint32_t num, uint32_t stride, double* out) const;
+};
+
+// Owns the arrays of a forest read from a LightGBM text model at runtime
+class FlatForestStore
+{
+public:
+    //Returns false and sets "err" if the model cannot be flattened
+    bool load_lgbm(const string& fname, string& err);
+    const FlatForest& get() const { return forest; }
+
+private:
+    vector<int32_t> roots;
+    vector<int32_t> left;
+    vector<int32_t> right;
+    vector<float> thr;
+    vector<uint16_t> feat;
+    vector<uint8_t> flags;
+    vector<double> leaf;
+    FlatForest forest = {};
+};
+
+}
+
+#endif //FLAT_FOREST_H_
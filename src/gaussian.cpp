@@ -126,7 +126,7 @@ struct ColSorter {
         }
 
         return false;
-        //return solver->varData[a].level < solver->varData[b].level;
+        //return solver->varHot[a].level < solver->varHot[b].level;
         //return solver->var_act_vsids[a] > solver->var_act_vsids[b];
     }
 
@@ -179,7 +179,7 @@ void EGaussian::select_columnorder() {
         cout << "assump:" << (int)assump
         << " act: " << std::setprecision(2) << std::scientific
         << solver->var_act_vsids[x] << std::fixed
-        << " level: " << solver->varData[x].level
+        << " level: " << solver->varHot[x].level
         << endl;
     }
     #endif
@@ -652,6 +652,10 @@ gret EGaussian::init_adjust_matrix()
 
                 solver->ok = solver->add_xor_clause_inter(tmp_clause, !xorEqualFalse, true);
                 release_assert(solver->ok);
+                if (solver->datasync->xors_shared()) {
+                    solver->datasync->signal_bin_xor(
+                        tmp_clause[0], tmp_clause[1], !xorEqualFalse);
+                }
                 VERBOSE_PRINT("-> toplevel bin-xor on row: " << row_i << " cl2: " << tmp_clause);
 
                 // reset this row all zero, no need for this row
@@ -725,7 +729,7 @@ uint32_t EGaussian::get_max_level(const GaussQData& gqd, const uint32_t row_n)
 
     for (uint32_t i = 1; i < cl->size(); i++) {
         Lit l = (*cl)[i];
-        uint32_t nLevel = solver->varData[l.var()].level;
+        uint32_t nLevel = solver->varHot[l.var()].level;
         if (nLevel > nMaxLevel) {
             nMaxLevel = nLevel;
             nMaxInd = i;
@@ -988,7 +992,7 @@ void EGaussian::prop_lit(
         for(auto const& a: *x) {
             assert(solver->value(a) != l_True);
             if (solver->value(a) == l_False) {
-                assert(solver->varData[a.var()].level == 0);
+                assert(solver->varHot[a.var()].level == 0);
                 assert(solver->unit_cl_IDs[a.var()] != 0);
             }
             if (solver->value(a) == l_Undef) num_unset ++;
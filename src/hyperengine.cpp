@@ -52,7 +52,7 @@ Lit HyperEngine::propagate_bfs(const uint64_t timeout)
     if (trail.size() - trail_lim.back() == 1) {
         //Set up root node
         Lit root = trail[qhead].lit;
-        varData[root.var()].reason = PropBy(~lit_Undef, false, false, false, 0);
+        varHot[root.var()].reason = PropBy(~lit_Undef, false, false, false, 0);
     }
 
     uint32_t nlBinQHead = qhead;
@@ -193,8 +193,8 @@ void HyperEngine::add_hyper_bin(const Lit p)
     }
 
     enqueue_with_acestor_info(p, deepestAncestor, true, ID);
-    varData[p.var()].reason.setHyperbin(true);
-    varData[p.var()].reason.setHyperbinNotAdded(hyperBinNotAdded);
+    varHot[p.var()].reason.setHyperbin(true);
+    varHot[p.var()].reason.setHyperbinNotAdded(hyperBinNotAdded);
 }
 
 /**
@@ -208,7 +208,7 @@ Lit HyperEngine::remove_which_bin_due_to_trans_red(
     , bool thisStepRed
 ) {
     propStats.otfHyperTime += 1;
-    const PropBy& data = varData[conflict.var()].reason;
+    const PropBy& data = varHot[conflict.var()].reason;
 
     bool onlyIrred = !data.isRedStep();
     Lit lookingForAncestor = data.getAncestor();
@@ -333,7 +333,7 @@ bool HyperEngine::is_ancestor_of(
     ) {
         #ifdef VERBOSE_DEBUG_FULLPROP
         cout << "Current acestor: " << thisAncestor
-        << " redundant step? " << varData[thisAncestor.var()].reason.isRedStep()
+        << " redundant step? " << varHot[thisAncestor.var()].reason.isRedStep()
         << endl;
         #endif
 
@@ -352,7 +352,7 @@ bool HyperEngine::is_ancestor_of(
             return true;
         }
 
-        const PropBy& data = varData[thisAncestor.var()].reason;
+        const PropBy& data = varHot[thisAncestor.var()].reason;
         if ((onlyIrred && data.isRedStep())
             || data.getHyperbinNotAdded()
         ) {
@@ -392,7 +392,7 @@ void HyperEngine::add_hyper_bin(const Lit p, const Clause& cl)
     ) {
         if (*it != p) {
             assert(value(*it) == l_False);
-            if (varData[it->var()].level != 0)
+            if (varHot[it->var()].level != 0)
                 currAncestors.push_back(~*it);
         }
     }
@@ -412,10 +412,10 @@ Lit HyperEngine::analyzeFail(const PropBy propBy)
     switch(propBy.getType()) {
         case binary_t: {
             const Lit lit = ~propBy.lit2();
-            if (varData[lit.var()].level != 0)
+            if (varHot[lit.var()].level != 0)
                 currAncestors.push_back(lit);
 
-            if (varData[failBinLit.var()].level != 0)
+            if (varHot[failBinLit.var()].level != 0)
                 currAncestors.push_back(~failBinLit);
 
             break;
@@ -425,7 +425,7 @@ Lit HyperEngine::analyzeFail(const PropBy propBy)
             const uint32_t offset = propBy.get_offset();
             const Clause& cl = *cl_alloc.ptr(offset);
             for(size_t i = 0; i < cl.size(); i++) {
-                if (varData[cl[i].var()].level != 0)
+                if (varHot[cl[i].var()].level != 0)
                     currAncestors.push_back(~cl[i]);
             }
             break;
@@ -494,7 +494,7 @@ Lit HyperEngine::deepest_common_ancestor()
             }
 
             //Update ancestor to its own ancestor, i.e. step up this 'thread'
-            *it = varData[it->var()].reason.getAncestor();
+            *it = varHot[it->var()].reason.getAncestor();
         }
     }
     #ifdef VERBOSE_DEBUG_FULLPROP
@@ -516,22 +516,22 @@ void HyperEngine::remove_bin_clause(Lit lit, const int32_t ID)
 {
     //The binary clause we should remove
     const BinaryClause clauseToRemove(
-        ~varData[lit.var()].reason.getAncestor(),
+        ~varHot[lit.var()].reason.getAncestor(),
         lit,
-        varData[lit.var()].reason.isRedStep(),
+        varHot[lit.var()].reason.isRedStep(),
         ID);
 
     //We now remove the clause
     //If it's hyper-bin, then we remove the to-be-added hyper-binary clause
     //However, if the hyper-bin was never added because only 1 literal was unbound at level 0 (i.e. through
     //clause cleaning, the clause would have been 2-long), then we don't do anything.
-    if (!varData[lit.var()].reason.getHyperbin()) {
+    if (!varHot[lit.var()].reason.getHyperbin()) {
         #ifdef VERBOSE_DEBUG_FULLPROP
         cout << "Normal removing clause " << clauseToRemove << endl;
         #endif
         propStats.otfHyperTime += 2;
         uselessBin.insert(clauseToRemove);
-    } else if (!varData[lit.var()].reason.getHyperbinNotAdded()) {
+    } else if (!varHot[lit.var()].reason.getHyperbinNotAdded()) {
         #ifdef VERBOSE_DEBUG_FULLPROP
         cout << "Removing hyper-bin clause " << clauseToRemove << endl;
         #endif
@@ -572,7 +572,7 @@ PropResult HyperEngine::prop_bin_with_ancestor_info(
         confl = PropBy(~p, k->red(), k->get_ID());
         return PROP_FAIL;
 
-    } else if (varData[lit.var()].level != 0 && perform_transitive_reduction) {
+    } else if (varHot[lit.var()].level != 0 && perform_transitive_reduction) {
         //Propaged already
         assert(val == l_True);
 
@@ -583,8 +583,8 @@ PropResult HyperEngine::prop_bin_with_ancestor_info(
 
         //Remove this one
         if (remove == p) {
-            const Lit origAnc = varData[lit.var()].reason.getAncestor();
-            const int32_t origID = varData[lit.var()].reason.getID();
+            const Lit origAnc = varHot[lit.var()].reason.getAncestor();
+            const int32_t origID = varHot[lit.var()].reason.getID();
             assert(origAnc != lit_Undef);
             #ifdef VERBOSE_DEBUG_FULLPROP
             cout << "ID of k: " << k->get_ID() << " ID of orig: " << origID << " removing latter, origAnc: " << origAnc << endl;
@@ -593,8 +593,8 @@ PropResult HyperEngine::prop_bin_with_ancestor_info(
             remove_bin_clause(lit, origID);
 
             //Update data indicating what lead to lit
-            varData[lit.var()].reason = PropBy(~p, k->red(), false, false, k->get_ID());
-            assert(varData[p.var()].level != 0);
+            varHot[lit.var()].reason = PropBy(~p, k->red(), false, false, k->get_ID());
+            assert(varHot[p.var()].level != 0);
             depth[lit.var()] = depth[p.var()] + 1;
             //NOTE: we don't update the levels of other literals... :S
 
@@ -665,7 +665,7 @@ void HyperEngine::enqueue_with_acestor_info(
     //during intree probing
     enqueue<true>(p, decisionLevel(), PropBy(~ancestor, redStep, false, false, ID));
 
-    assert(varData[ancestor.var()].level != 0);
+    assert(varHot[ancestor.var()].level != 0);
 
     if (use_depth_trick) {
         depth[p.var()] = depth[ancestor.var()] + 1;
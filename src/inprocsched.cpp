@@ -0,0 +1,245 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "inprocsched.h"
+#include "solver.h"
+#include "sqlstats.h"
+#include "time_mem.h"
+#include "trim.h"
+
+#include <sstream>
+#include <algorithm>
+#include <iomanip>
+
+using namespace CMSat;
+
+//How much a removed variable, clause and literal is worth
+static const double gain_per_var = 10.0;
+static const double gain_per_cl = 1.0;
+static const double gain_per_irred_lit = 0.25;
+static const double gain_per_red_lit = 0.05;
+
+//Below this fraction of the average utility, a run counts as fruitless
+static const double low_utility_ratio = 0.05;
+
+InprocSched::InprocSched(Solver* _solver) :
+    solver(_solver)
+{
+}
+
+vector<string> InprocSched::split_units(const string& strategy)
+{
+    vector<string> ret;
+    std::istringstream ss(strategy);
+    string token;
+    string occ;
+    while(std::getline(ss, token, ',')) {
+        token = trim(token);
+        std::transform(token.begin(), token.end(), token.begin(), ::tolower);
+        if (token.empty()) continue;
+        if (token.substr(0,3) == "occ") {
+            if (!occ.empty()) occ += ", ";
+            occ += token;
+            continue;
+        }
+        if (!occ.empty()) {
+            ret.push_back(occ);
+            occ.clear();
+        }
+        ret.push_back(token);
+    }
+    if (!occ.empty()) ret.push_back(occ);
+
+    return ret;
+}
+
+//Passes whose place in the schedule matters for correctness or that have
+//their own every-N gating are never skipped or moved. Neither are sls and
+//lucky: they look for a model or for good phases, not for a smaller formula,
+//so their gain here would always be zero and they would be backed off.
+bool InprocSched::pinned(const string& unit)
+{
+    return unit.substr(0, 5) == "must-"
+        || unit == "sls"
+        || unit == "lucky"
+        || unit == "renumber"
+        || unit == "cl-consolidate"
+        || unit == "clean-cls"
+        || unit == "louvain-comms"
+        || unit == "card-find"
+        || unit == "breakid"
+        || unit == "bosphorus";
+}
+
+InprocSched::Snapshot InprocSched::snapshot() const
+{
+    Snapshot s;
+    s.time = cpuTime();
+    s.free_vars = solver->get_num_free_vars();
+    s.irred_cls = solver->longIrredCls.size() + solver->binTri.irredBins;
+    s.irred_lits = solver->litStats.irredLits + solver->binTri.irredBins*2;
+    s.red_lits = solver->litStats.redLits + solver->binTri.redBins*2;
+    return s;
+}
+
+double InprocSched::avg_utility() const
+{
+    double sum = 0;
+    uint32_t num = 0;
+    for(const auto& u: units) {
+        if (u.second.runs == 0) continue;
+        sum += u.second.utility;
+        num++;
+    }
+    return num == 0 ? 0 : sum/num;
+}
+
+void InprocSched::log(
+    const string& unit, const char* decision, const UnitStats& u,
+    const double cost, const double gain)
+{
+    verb_print(2, "[sched] " << std::left << std::setw(8) << decision
+        << " unit: '" << unit << "'"
+        << " runs: " << u.runs
+        << " cost: " << std::setprecision(3) << cost
+        << " gain: " << gain
+        << " util: " << u.utility
+        << " boost: " << u.boost
+        << " skip-left: " << u.skip_left);
+
+    if (solver->sqlStats) {
+        solver->sqlStats->inproc_sched(solver, unit, decision, cost, gain,
+            u.utility, u.boost);
+    }
+}
+
+vector<string> InprocSched::plan(const string& strategy)
+{
+    const vector<string> all = split_units(strategy);
+    const double avg = avg_utility();
+    round++;
+
+    //Decide once per round for each unit, a unit may appear more than once
+    std::map<string, bool> skip;
+    for(const string& unit: all) {
+        if (pinned(unit) || skip.count(unit)) continue;
+        UnitStats& u = units[unit];
+        if (u.skip_left > 0) {
+            u.skip_left--;
+            u.boost = 1.0;
+            skip[unit] = true;
+            log(unit, "skip", u, 0, 0);
+            continue;
+        }
+        skip[unit] = false;
+        u.boost = 1.0;
+        if (u.runs > 0 && avg > 0 && u.utility > avg) {
+            u.boost = std::min(u.utility/avg, solver->conf.inproc_sched_max_boost);
+            log(unit, "boost", u, 0, 0);
+        }
+    }
+
+    //Between pinned units, run the most useful first. Units never run
+    //before go first, in the order given.
+    vector<string> ret;
+    vector<string> segment;
+    auto flush = [&]() {
+        std::stable_sort(segment.begin(), segment.end(),
+            [&](const string& a, const string& b) {
+                const UnitStats& ua = units[a];
+                const UnitStats& ub = units[b];
+                if ((ua.runs == 0) != (ub.runs == 0)) return ua.runs == 0;
+                return ua.utility > ub.utility;
+            });
+        ret.insert(ret.end(), segment.begin(), segment.end());
+        segment.clear();
+    };
+    for(const string& unit: all) {
+        if (pinned(unit)) {
+            flush();
+            ret.push_back(unit);
+            continue;
+        }
+        if (!skip[unit]) segment.push_back(unit);
+    }
+    flush();
+
+    if (solver->conf.verbosity >= 2) {
+        std::stringstream ss;
+        for(const string& unit: ret) ss << unit << ", ";
+        verb_print(2, "[sched] plan: " << ss.str());
+    }
+
+    return ret;
+}
+
+void InprocSched::begin(const string& unit)
+{
+    at_begin = snapshot();
+    orig_multiplier = solver->conf.global_timeout_multiplier;
+    if (!pinned(unit)) {
+        solver->conf.global_timeout_multiplier *= units[unit].boost;
+    }
+}
+
+void InprocSched::end(const string& unit)
+{
+    solver->conf.global_timeout_multiplier = orig_multiplier;
+    if (pinned(unit)) return;
+
+    const Snapshot now = snapshot();
+    const auto drop = [](const uint64_t before, const uint64_t after) {
+        return before > after ? (double)(before-after) : 0.0;
+    };
+    const double gain =
+        gain_per_var*drop(at_begin.free_vars, now.free_vars)
+        + gain_per_cl*drop(at_begin.irred_cls, now.irred_cls)
+        + gain_per_irred_lit*drop(at_begin.irred_lits, now.irred_lits)
+        + gain_per_red_lit*drop(at_begin.red_lits, now.red_lits);
+    double cost = 1.0;
+    if (solver->conf.inproc_sched != InprocSchedMode::deterministic) {
+        cost = std::max(now.time - at_begin.time, 0.0001);
+    }
+
+    UnitStats& u = units[unit];
+    const double avg = avg_utility();
+    const double rate = gain/cost;
+    u.utility = u.runs == 0 ? rate : 0.5*u.utility + 0.5*rate;
+    u.runs++;
+    u.sum_cost += cost;
+    u.sum_gain += gain;
+
+    //Back off exponentially from units that achieve (almost) nothing.
+    //A unit that appears more than once in a round backs off once.
+    if (gain == 0 || (avg > 0 && rate < avg*low_utility_ratio)) {
+        if (u.fruitless_round != round) {
+            u.skip_left = std::min<uint32_t>(
+                1U << std::min<uint32_t>(u.fruitless_in_row, 16),
+                solver->conf.inproc_sched_max_skip);
+            u.fruitless_in_row++;
+            u.fruitless_round = round;
+        }
+    } else {
+        u.fruitless_in_row = 0;
+    }
+    log(unit, "run", u, cost, gain);
+}
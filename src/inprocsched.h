@@ -0,0 +1,92 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef INPROCSCHED_H_
+#define INPROCSCHED_H_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+#include <limits>
+
+namespace CMSat {
+
+using std::vector;
+using std::string;
+
+class Solver;
+
+// Decides which inprocessing passes of a strategy string to run, in which
+// order, and with what time-limit multiplier. Consecutive occ-* tokens form
+// one unit, as they are executed together by OccSimplifier. Every unit run
+// is measured: cost is CPU time (or one per run in deterministic mode),
+// gain is the weighted drop in free variables, clauses and literals.
+class InprocSched
+{
+public:
+    explicit InprocSched(Solver* solver);
+
+    //Units to run in this round, in order
+    vector<string> plan(const string& strategy);
+    void begin(const string& unit);
+    void end(const string& unit);
+
+private:
+    struct Snapshot
+    {
+        double time;
+        uint64_t free_vars;
+        uint64_t irred_cls;
+        uint64_t irred_lits;
+        uint64_t red_lits;
+    };
+
+    struct UnitStats
+    {
+        uint64_t runs = 0;
+        uint32_t fruitless_in_row = 0;
+        uint32_t skip_left = 0;
+        uint64_t fruitless_round = std::numeric_limits<uint64_t>::max();
+        double utility = 0; //EMA of gain/cost
+        double boost = 1.0;
+        double sum_cost = 0;
+        double sum_gain = 0;
+    };
+
+    static vector<string> split_units(const string& strategy);
+    static bool pinned(const string& unit);
+    Snapshot snapshot() const;
+    double avg_utility() const;
+    void log(const string& unit, const char* decision, const UnitStats& u,
+        double cost, double gain);
+
+    Solver* solver;
+    std::map<string, UnitStats> units;
+    uint64_t round = 0;
+    Snapshot at_begin;
+    double orig_multiplier;
+};
+
+}
+
+#endif //INPROCSCHED_H_
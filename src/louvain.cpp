@@ -0,0 +1,315 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "louvain.h"
+
+#include <limits>
+
+using namespace CMSat;
+
+//Community totals are kept in fixed point, so they can be updated atomically
+static const double tot_scale = (double)(1ULL << 24);
+
+namespace {
+struct CommWeight
+{
+    uint32_t comm;
+    float weight;
+    bool operator<(const CommWeight& other) const
+    {
+        return comm < other.comm;
+    }
+};
+
+//Sorts by community and merges entries of the same community
+void merge_comm_weights(vector<CommWeight>& buf)
+{
+    std::sort(buf.begin(), buf.end());
+    size_t j = 0;
+    for(size_t i = 0; i < buf.size(); i++) {
+        if (j > 0 && buf[j-1].comm == buf[i].comm) {
+            buf[j-1].weight += buf[i].weight;
+        } else {
+            buf[j++] = buf[i];
+        }
+    }
+    buf.resize(j);
+}
+}
+
+Louvain::Louvain(const uint32_t num_nodes, const uint32_t _num_threads) :
+    num_threads(std::max<uint32_t>(1, _num_threads))
+{
+    graph.start.resize(num_nodes+1, 0);
+    mapping.resize(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++) mapping[i] = i;
+}
+
+size_t Louvain::mem_used() const
+{
+    return graph.mem_used() + mapping.capacity()*sizeof(uint32_t);
+}
+
+void Louvain::merge_parallel_edges()
+{
+    const uint32_t n = graph.num_nodes();
+    vector<uint64_t> len(n+1, 0);
+    vector<vector<CommWeight>> bufs(num_threads);
+    parallel_for(num_threads, n, [&](uint32_t tid, uint64_t begin, uint64_t end) {
+        vector<CommWeight>& buf = bufs[tid];
+        for(uint64_t i = begin; i < end; i++) {
+            buf.clear();
+            for(uint64_t e = graph.start[i]; e < graph.start[i+1]; e++) {
+                buf.push_back(CommWeight{graph.adj[e], graph.weight[e]});
+            }
+            merge_comm_weights(buf);
+            uint64_t at = graph.start[i];
+            for(const auto& x: buf) {
+                graph.adj[at] = x.comm;
+                graph.weight[at] = x.weight;
+                at++;
+            }
+            len[i] = buf.size();
+        }
+    });
+
+    CSRGraph merged;
+    merged.start.resize(n+1);
+    uint64_t sum = 0;
+    for(uint32_t i = 0; i < n; i++) {
+        merged.start[i] = sum;
+        sum += len[i];
+    }
+    merged.start[n] = sum;
+    merged.adj.resize(sum);
+    merged.weight.resize(sum);
+    parallel_for(num_threads, n, [&](uint32_t, uint64_t begin, uint64_t end) {
+        for(uint64_t i = begin; i < end; i++) {
+            std::copy_n(graph.adj.begin()+graph.start[i], len[i],
+                merged.adj.begin()+merged.start[i]);
+            std::copy_n(graph.weight.begin()+graph.start[i], len[i],
+                merged.weight.begin()+merged.start[i]);
+        }
+    });
+    graph = std::move(merged);
+    stats.edges = graph.adj.size()/2;
+}
+
+//One level of local moving. comm must be the identity on entry
+uint64_t Louvain::move_nodes(const CSRGraph& g, vector<std::atomic<uint32_t>>& comm)
+{
+    const uint32_t n = g.num_nodes();
+    vector<double> k(n);
+    vector<int64_t> k_fixed(n);
+    vector<std::atomic<int64_t>> tot(n);
+    vector<std::atomic<uint32_t>> size(n);
+    double m2 = 0;
+    for(uint32_t i = 0; i < n; i++) {
+        double sum = 0;
+        for(uint64_t e = g.start[i]; e < g.start[i+1]; e++) sum += (double)g.weight[e];
+        k[i] = sum;
+        k_fixed[i] = (int64_t)(sum*tot_scale);
+        tot[i].store(k_fixed[i], std::memory_order_relaxed);
+        size[i].store(1, std::memory_order_relaxed);
+        m2 += sum;
+    }
+    if (m2 == 0) return 0;
+
+    uint64_t total_moved = 0;
+    vector<vector<CommWeight>> bufs(num_threads);
+    for(uint32_t round = 0; round < 32; round++) {
+        std::atomic<uint64_t> moved(0);
+        parallel_for(num_threads, n, [&](uint32_t tid, uint64_t begin, uint64_t end) {
+            vector<CommWeight>& buf = bufs[tid];
+            uint64_t this_moved = 0;
+            for(uint64_t i = begin; i < end; i++) {
+                buf.clear();
+                for(uint64_t e = g.start[i]; e < g.start[i+1]; e++) {
+                    if (g.adj[e] == i) continue;
+                    buf.push_back(CommWeight{
+                        comm[g.adj[e]].load(std::memory_order_relaxed), g.weight[e]});
+                }
+                merge_comm_weights(buf);
+
+                const uint32_t own = comm[i].load(std::memory_order_relaxed);
+                const double k_per_m2 = k[i]/m2;
+                double own_w = 0;
+                for(const auto& x: buf) if (x.comm == own) own_w = x.weight;
+                const double own_tot =
+                    (double)(tot[own].load(std::memory_order_relaxed)-k_fixed[i])/tot_scale;
+                const double own_gain = own_w - own_tot*k_per_m2;
+
+                uint32_t best = own;
+                double best_gain = own_gain;
+                for(const auto& x: buf) {
+                    if (x.comm == own) continue;
+                    const double gain = (double)x.weight
+                        - (double)tot[x.comm].load(std::memory_order_relaxed)/tot_scale*k_per_m2;
+                    if (gain > best_gain || (gain == best_gain && best != own && x.comm < best)) {
+                        best = x.comm;
+                        best_gain = gain;
+                    }
+                }
+                if (best == own) continue;
+                if (size[own].load(std::memory_order_relaxed) == 1
+                    && size[best].load(std::memory_order_relaxed) == 1
+                    && best > own
+                ) {
+                    continue;
+                }
+
+                comm[i].store(best, std::memory_order_relaxed);
+                tot[own].fetch_sub(k_fixed[i], std::memory_order_relaxed);
+                tot[best].fetch_add(k_fixed[i], std::memory_order_relaxed);
+                size[own].fetch_sub(1, std::memory_order_relaxed);
+                size[best].fetch_add(1, std::memory_order_relaxed);
+                this_moved++;
+            }
+            moved += this_moved;
+        });
+        total_moved += moved;
+        if (moved*1000 <= n) break;
+    }
+    return total_moved;
+}
+
+//Builds the graph of communities, and renumbers comm to be dense
+uint32_t Louvain::aggregate(
+    const CSRGraph& g,
+    const vector<std::atomic<uint32_t>>& comm,
+    CSRGraph& coarse,
+    vector<uint32_t>& node_comm)
+{
+    const uint32_t n = g.num_nodes();
+    const uint32_t undef = std::numeric_limits<uint32_t>::max();
+    vector<uint32_t> dense(n, undef);
+    uint32_t nc = 0;
+    node_comm.resize(n);
+    for(uint32_t i = 0; i < n; i++) {
+        const uint32_t c = comm[i].load(std::memory_order_relaxed);
+        if (dense[c] == undef) dense[c] = nc++;
+        node_comm[i] = dense[c];
+    }
+
+    //Members of each community
+    vector<uint64_t> mem_start(nc+1, 0);
+    for(uint32_t i = 0; i < n; i++) mem_start[node_comm[i]+1]++;
+    for(uint32_t c = 0; c < nc; c++) mem_start[c+1] += mem_start[c];
+    vector<uint32_t> members(n);
+    {
+        vector<uint64_t> at(mem_start.begin(), mem_start.end()-1);
+        for(uint32_t i = 0; i < n; i++) members[at[node_comm[i]]++] = i;
+    }
+
+    struct Part {
+        vector<uint32_t> adj;
+        vector<float> weight;
+        vector<uint64_t> len;
+        vector<CommWeight> buf;
+    };
+    vector<Part> parts(num_threads);
+    parallel_for(num_threads, nc, [&](uint32_t tid, uint64_t begin, uint64_t end) {
+        Part& p = parts[tid];
+        for(uint64_t c = begin; c < end; c++) {
+            p.buf.clear();
+            for(uint64_t m = mem_start[c]; m < mem_start[c+1]; m++) {
+                const uint32_t i = members[m];
+                for(uint64_t e = g.start[i]; e < g.start[i+1]; e++) {
+                    p.buf.push_back(CommWeight{node_comm[g.adj[e]], g.weight[e]});
+                }
+            }
+            merge_comm_weights(p.buf);
+            for(const auto& x: p.buf) {
+                p.adj.push_back(x.comm);
+                p.weight.push_back(x.weight);
+            }
+            p.len.push_back(p.buf.size());
+        }
+    });
+
+    coarse.start.clear();
+    coarse.adj.clear();
+    coarse.weight.clear();
+    coarse.start.reserve(nc+1);
+    for(auto& p: parts) {
+        uint64_t at = coarse.adj.size();
+        for(const uint64_t l: p.len) {
+            coarse.start.push_back(at);
+            at += l;
+        }
+        coarse.adj.insert(coarse.adj.end(), p.adj.begin(), p.adj.end());
+        coarse.weight.insert(coarse.weight.end(), p.weight.begin(), p.weight.end());
+        p = Part();
+    }
+    coarse.start.push_back(coarse.adj.size());
+    assert(coarse.num_nodes() == nc);
+    return nc;
+}
+
+void Louvain::calculate(const uint32_t max_levels)
+{
+    CSRGraph work;
+    const CSRGraph* cur = &graph;
+    for(uint32_t level = 0; level < max_levels; level++) {
+        const uint32_t n = cur->num_nodes();
+        vector<std::atomic<uint32_t>> comm(n);
+        for(uint32_t i = 0; i < n; i++) comm[i].store(i, std::memory_order_relaxed);
+
+        const uint64_t moved = move_nodes(*cur, comm);
+        stats.moves += moved;
+        if (moved == 0) break;
+
+        CSRGraph coarse;
+        vector<uint32_t> node_comm;
+        const uint32_t nc = aggregate(*cur, comm, coarse, node_comm);
+        stats.peak_mem = std::max(stats.peak_mem,
+            mem_used() + work.mem_used() + coarse.mem_used());
+        parallel_for(num_threads, mapping.size(), [&](uint32_t, uint64_t begin, uint64_t end) {
+            for(uint64_t v = begin; v < end; v++) mapping[v] = node_comm[mapping[v]];
+        });
+        stats.levels++;
+        if (nc == n) break;
+        work = std::move(coarse);
+        cur = &work;
+    }
+}
+
+double Louvain::modularity() const
+{
+    const uint32_t n = graph.num_nodes();
+    vector<double> tot(n, 0);
+    double in = 0;
+    double m2 = 0;
+    for(uint32_t i = 0; i < n; i++) {
+        for(uint64_t e = graph.start[i]; e < graph.start[i+1]; e++) {
+            const double w = graph.weight[e];
+            if (mapping[graph.adj[e]] == mapping[i]) in += w;
+            tot[mapping[i]] += w;
+            m2 += w;
+        }
+    }
+    if (m2 == 0) return 0;
+
+    double q = in/m2;
+    for(const double t: tot) q -= (t/m2)*(t/m2);
+    return q;
+}
@@ -0,0 +1,191 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef LOUVAIN_H_
+#define LOUVAIN_H_
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+#include "parallel_for.h"
+
+namespace CMSat {
+
+using std::vector;
+
+// Undirected weighted graph in compressed sparse row form. Every edge is
+// stored in both rows, a self-loop of weight w is stored as 2*w.
+struct CSRGraph
+{
+    vector<uint64_t> start; //num_nodes()+1 entries
+    vector<uint32_t> adj;
+    vector<float> weight;
+
+    uint32_t num_nodes() const
+    {
+        return start.empty() ? 0 : start.size()-1;
+    }
+
+    size_t mem_used() const
+    {
+        return start.capacity()*sizeof(uint64_t)
+            + adj.capacity()*sizeof(uint32_t)
+            + weight.capacity()*sizeof(float);
+    }
+};
+
+// Parallel Louvain community detection, after "Parallel heuristics for
+// scalable community detection" by Lu, Halappanavar and Kalyanaraman.
+// Nodes move asynchronously, community totals are updated atomically, and
+// singletons only move to singletons with a lower ID, to avoid swapping.
+class Louvain
+{
+public:
+    Louvain(const uint32_t num_nodes, const uint32_t num_threads);
+
+    // The producer is called as produce(tid, num_threads, emit) on each
+    // thread, twice: once to count and once to fill the rows. It must emit
+    // the same edges both times, by calling emit(u, v, weight).
+    template<class Producer> void build(Producer produce);
+
+    void calculate(const uint32_t max_levels = 20);
+    const vector<uint32_t>& get_mapping() const;
+    double modularity() const;
+    size_t mem_used() const;
+
+    struct Stats
+    {
+        uint32_t levels = 0;
+        uint64_t moves = 0;
+        uint64_t edges = 0;
+        size_t peak_mem = 0;
+    };
+    const Stats& get_stats() const;
+
+private:
+    //With a single thread the counters need no locked instructions
+    template<bool concurrent>
+    static uint64_t bump(std::atomic<uint64_t>& x)
+    {
+        if (concurrent) return x.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t val = x.load(std::memory_order_relaxed);
+        x.store(val+1, std::memory_order_relaxed);
+        return val;
+    }
+
+    template<bool concurrent>
+    struct CountEdge
+    {
+        vector<std::atomic<uint64_t>>& deg;
+        void operator()(const uint32_t u, const uint32_t v, const float) const
+        {
+            if (u == v) return;
+            bump<concurrent>(deg[u]);
+            bump<concurrent>(deg[v]);
+        }
+    };
+
+    template<bool concurrent>
+    struct FillEdge
+    {
+        vector<std::atomic<uint64_t>>& at;
+        CSRGraph& g;
+        void operator()(const uint32_t u, const uint32_t v, const float w) const
+        {
+            if (u == v) return;
+            uint64_t i = bump<concurrent>(at[u]);
+            g.adj[i] = v;
+            g.weight[i] = w;
+            i = bump<concurrent>(at[v]);
+            g.adj[i] = u;
+            g.weight[i] = w;
+        }
+    };
+
+    template<bool concurrent, class Producer> void build_with(Producer& produce);
+    void merge_parallel_edges();
+    uint64_t move_nodes(const CSRGraph& g, vector<std::atomic<uint32_t>>& comm);
+    uint32_t aggregate(
+        const CSRGraph& g,
+        const vector<std::atomic<uint32_t>>& comm,
+        CSRGraph& coarse,
+        vector<uint32_t>& node_comm);
+
+    const uint32_t num_threads;
+    CSRGraph graph;
+    vector<uint32_t> mapping;
+    Stats stats;
+};
+
+template<class Producer>
+void Louvain::build(Producer produce)
+{
+    if (num_threads == 1) build_with<false>(produce);
+    else build_with<true>(produce);
+    merge_parallel_edges();
+}
+
+template<bool concurrent, class Producer>
+void Louvain::build_with(Producer& produce)
+{
+    const uint32_t n = graph.num_nodes();
+    vector<std::atomic<uint64_t>> at(n+1);
+    for(auto& x: at) x.store(0, std::memory_order_relaxed);
+
+    parallel_for(num_threads, num_threads, [&](uint32_t, uint64_t begin, uint64_t end) {
+        CountEdge<concurrent> count{at};
+        for(uint64_t t = begin; t < end; t++) produce((uint32_t)t, num_threads, count);
+    });
+
+    uint64_t sum = 0;
+    for(uint32_t i = 0; i < n; i++) {
+        graph.start[i] = sum;
+        sum += at[i].load(std::memory_order_relaxed);
+        at[i].store(graph.start[i], std::memory_order_relaxed);
+    }
+    graph.start[n] = sum;
+    graph.adj.resize(sum);
+    graph.weight.resize(sum);
+
+    parallel_for(num_threads, num_threads, [&](uint32_t, uint64_t begin, uint64_t end) {
+        FillEdge<concurrent> fill{at, graph};
+        for(uint64_t t = begin; t < end; t++) produce((uint32_t)t, num_threads, fill);
+    });
+    stats.peak_mem = graph.mem_used() + at.size()*sizeof(uint64_t);
+}
+
+inline const vector<uint32_t>& Louvain::get_mapping() const
+{
+    return mapping;
+}
+
+inline const Louvain::Stats& Louvain::get_stats() const
+{
+    return stats;
+}
+
+}
+
+#endif //LOUVAIN_H_
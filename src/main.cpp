@@ -51,6 +51,7 @@ THE SOFTWARE.
 #include "main_common.h"
 #include "time_mem.h"
 #include "dimacsparser.h"
+#include "dimacsloader.h"
 #include "cryptominisat.h"
 #include "signalcode.h"
 #include "argparse.hpp"
@@ -78,16 +79,19 @@ Main::Main(int _argc, char** _argv) :
 {
 }
 
-void Main::readInAFile(SATSolver* solver2, const string& filename)
+void Main::parse_file_with_dimacsparser(
+    SATSolver* solver2,
+    const string& filename,
+    vector<uint32_t>& parsed_sampling_vars,
+    const uint64_t offset,
+    const uint64_t line)
 {
-    solver2->add_sql_tag("filename", filename);
-    if (conf.verbosity) cout << "c Reading file '" << filename << "'" << endl;
     #ifndef USE_ZLIB
     FILE * in = fopen(filename.c_str(), "rb");
-    DimacsParser<StreamBuffer<FILE*, FN>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
+    DimacsParser<StreamBuffer<FILE*, FN>, SATSolver> parser(solver2, &debugLib, conf.verbosity, line);
     #else
     gzFile in = gzopen(filename.c_str(), "rb");
-    DimacsParser<StreamBuffer<gzFile, GZ>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
+    DimacsParser<StreamBuffer<gzFile, GZ>, SATSolver> parser(solver2, &debugLib, conf.verbosity, line);
     #endif
 
     if (in == NULL) {
@@ -99,12 +103,57 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
         std::exit(1);
     }
 
+    //Continue where the fast loader stopped, offset is in uncompressed text
+    #ifndef USE_ZLIB
+    const bool seek_ok = (offset == 0 || fseek(in, offset, SEEK_SET) == 0);
+    #else
+    const bool seek_ok = (offset == 0 || gzseek(in, offset, SEEK_SET) == (z_off_t)offset);
+    #endif
+    if (!seek_ok) {
+        std::cerr
+        << "ERROR! Could not seek in file '"
+        << filename
+        << "' to line " << line+1 << endl;
+
+        std::exit(1);
+    }
+
     bool strict_header = false;
     if (!parser.parse_DIMACS(in, strict_header)) {
         exit(-1);
     }
 
-    if (!sampling_vars_str.empty() && !parser.sampling_vars.empty()) {
+    parsed_sampling_vars.swap(parser.sampling_vars);
+
+    #ifndef USE_ZLIB
+        fclose(in);
+    #else
+        gzclose(in);
+    #endif
+}
+
+void Main::readInAFile(SATSolver* solver2, const string& filename)
+{
+    solver2->add_sql_tag("filename", filename);
+    if (conf.verbosity) cout << "c Reading file '" << filename << "'" << endl;
+
+    vector<uint32_t> parsed_sampling_vars;
+    if (fast_parse && debugLib.empty()) {
+        DimacsLoader<SATSolver> loader(
+            solver2, conf.verbosity, std::thread::hardware_concurrency());
+        if (!loader.load(filename)) {
+            if (conf.verbosity) {
+                cout << "c Fast loader stopped at line " << loader.resume_line()+1
+                << ", using the regular parser from there" << endl;
+            }
+            parse_file_with_dimacsparser(solver2, filename, parsed_sampling_vars,
+                loader.resume_offset(), loader.resume_line());
+        }
+    } else {
+        parse_file_with_dimacsparser(solver2, filename, parsed_sampling_vars);
+    }
+
+    if (!sampling_vars_str.empty() && !parsed_sampling_vars.empty()) {
         cerr << "ERROR! Sampling vars set in console but also in CNF." << endl;
         exit(-1);
     }
@@ -120,7 +169,7 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
             if (ss.peek() == ',' || ss.peek() == ' ') ss.ignore();
         }
     } else {
-        sampling_vars.swap(parser.sampling_vars);
+        sampling_vars.swap(parsed_sampling_vars);
     }
 
     if (sampling_vars.empty()) {
@@ -150,12 +199,6 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
     }
 
     call_after_parse();
-
-    #ifndef USE_ZLIB
-        fclose(in);
-    #else
-        gzclose(in);
-    #endif
 }
 
 void Main::readInStandardInput(SATSolver* solver2)
@@ -302,6 +345,17 @@ void Main::add_supported_options()
         .default_value(1)
         .action([&](const auto& a) {num_threads = std::atoi(a.c_str());})
         .help("Number of threads");
+    program.add_argument("--mode")
+        .default_value("portfolio")
+        .help("{portfolio,cube} How to use multiple threads. 'portfolio' -> every thread solves the whole problem with a different configuration. 'cube' -> thread 0 splits the problem into cubes with lookahead, and the threads solve the cubes, stealing work from each other");
+    program.add_argument("--cubedepth")
+        .action([&](const auto& a) {conf.cube_max_depth = std::atoi(a.c_str());})
+        .default_value(conf.cube_max_depth)
+        .help("Split into at most 2^N cubes in cube mode");
+    program.add_argument("--cubecands")
+        .action([&](const auto& a) {conf.cube_lookahead_cands = std::atoi(a.c_str());})
+        .default_value(conf.cube_lookahead_cands)
+        .help("Number of variables to look ahead on when picking the variable to split on in cube mode");
     program.add_argument("-m", "--mult")
         .action([&](const auto& a) {conf.orig_global_timeout_multiplier = std::atof(a.c_str());})
         .default_value(conf.orig_global_timeout_multiplier)
@@ -343,7 +397,7 @@ void Main::add_supported_options()
     program.add_argument("--predtype")
         .action([&](const auto& a) {conf.predictor_type = std::atoi(a.c_str());})
         .default_value(conf.predictor_type)
-        .help("Type of predictor. Supported: py, xgb, lgbm")
+        .help("Type of predictor. Supported: py, xgb, lgbm, tree (native evaluator of the LightGBM/bundled models)")
     program.add_argument("--predtables")
         .action([&](const auto& a) {conf.pred_tables = std::atoi(a.c_str());})
         .default_value(conf.pred_tables)
@@ -429,7 +483,19 @@ void Main::add_supported_options()
     program.add_argument("--preddontmovetime")
         .action([&](const auto& a) {conf.pred_dontmove_until_timeinside = std::atoi(a.c_str());})
         .default_value(conf.pred_dontmove_until_timeinside)
-        .help("Don't move clause until it's time has passed. For lev0 and lev1 only. If 1 = half time needs to pass (e.g. if we check every 50k conflicts, it must have been in the solver for 25k or it's force-kept). If 2 = the full time is needed, in the example, 25k.")
+        .help("Don't move clause until it's time has passed. For lev0 and lev1 only. If 1 = half time needs to pass (e.g. if we check every 50k conflicts, it must have been in the solver for 25k or it's force-kept). If 2 = the full time is needed, in the example, 25k.");
+    program.add_argument("--predasync")
+        .action([&](const auto& a) {conf.pred_async = std::atoi(a.c_str());})
+        .default_value(conf.pred_async)
+        .help("Run clause quality inference on a background thread. Predictions are applied at the next reduction point");
+    program.add_argument("--predasyncwait")
+        .action([&](const auto& a) {conf.pred_async_wait_ms = std::atoi(a.c_str());})
+        .default_value(conf.pred_async_wait_ms)
+        .help("Wait at most this many ms for background inference at a reduction point, then fall back to glue/activity ranking");
+    program.add_argument("--predasyncmaxage")
+        .action([&](const auto& a) {conf.pred_async_max_age = std::atoi(a.c_str());})
+        .default_value(conf.pred_async_max_age)
+        .help("Predictions computed more than this many conflicts ago are not applied, glue/activity ranking is used instead");
     #endif
 
 
@@ -515,6 +581,10 @@ void Main::add_supported_options()
         .flag()
         .action([&](const auto&) {dont_ban_solutions = true;})
         .help("Don't ban the solution once it's found");
+    program.add_argument("--fastparse")
+        .action([&](const auto& a) {fast_parse = std::atoi(a.c_str());})
+        .default_value(fast_parse)
+        .help("Load CNF files with the fast loader: plain files are mmapped and parsed by multiple threads while the clauses are added, gzipped files are decompressed on a separate thread. The regular parser takes over from the first line using DIMACS extensions or a clause spanning lines");
     program.add_argument("--debuglib")
         .action([&](const auto& a) {debugLib = a;})
         .help("Parse special comments to run solve/simplify during parsing of CNF");
@@ -601,6 +671,10 @@ void Main::add_supported_options()
         .action([&](const auto& a) {conf.sls_bump_type = std::atoi(a.c_str());})
         .default_value(conf.sls_bump_type)
         .help("How to calculate what variable to bump. 1 = clause-based, 2 = var-flip-based, 3 = var-score-based");
+    program.add_argument("--slswalkers")
+        .action([&](const auto& a) {conf.sls_walkers = std::atoi(a.c_str());})
+        .default_value(conf.sls_walkers)
+        .help("Number of independent CCNR walkers to run in parallel threads, each from a different phase. 0 = one per hardware thread, divided between the solver threads");
 
     /* po::options_description probeOptions("Probing options"); */
     /* probeOptions.add_options() */
@@ -647,6 +721,10 @@ void Main::add_supported_options()
         .action([&](const auto& a) {conf.max_num_simplify_per_solve_call = std::atoi(a.c_str());})
         .default_value(conf.max_num_simplify_per_solve_call)
         .help("Maximum number of simplifiactions to perform for every solve() call. After this, no more inprocessing will take place.");
+    program.add_argument("--incrfast")
+        .action([&](const auto& a) {conf.incremental_fast_path = std::atoi(a.c_str());})
+        .default_value(conf.incremental_fast_path)
+        .help("Incremental fast path: the first inprocessing of every solve() call only revisits variables touched since the previous call, and assumption variables are never eliminated -- only matters in library mode");
 
     program.add_argument("--schedule")
         .action([&](const auto& a) {conf.simplify_schedule_nonstartup = a;})
@@ -654,6 +732,17 @@ void Main::add_supported_options()
     program.add_argument("--preschedule")
         .action([&](const auto& a) {conf.simplify_schedule_startup = a;})
         .help("Schedule for simplification at startup");
+    program.add_argument("--inprocsched")
+        .default_value("fixed")
+        .help("{fixed,adaptive,deterministic} 'fixed' -> run the simplification schedule as given. 'adaptive' -> measure the simplification achieved per second by each pass, then reorder passes by it, skip fruitless ones with exponential backoff and give more time to productive ones. 'deterministic' -> like adaptive, but measures per run instead of per second, so it is reproducible");
+    program.add_argument("--inprocschedboost")
+        .action([&](const auto& a) {conf.inproc_sched_max_boost = std::atof(a.c_str());})
+        .default_value(conf.inproc_sched_max_boost)
+        .help("Maximum time limit multiplier the adaptive simplification scheduler gives a productive pass");
+    program.add_argument("--inprocschedskip")
+        .action([&](const auto& a) {conf.inproc_sched_max_skip = std::atoi(a.c_str());})
+        .default_value(conf.inproc_sched_max_skip)
+        .help("Maximum number of simplification rounds the adaptive scheduler skips a fruitless pass for");
     program.add_argument("--occsimp")
         .action([&](const auto& a) {conf.perform_occur_based_simp = std::atoi(a.c_str());})
         .default_value(conf.perform_occur_based_simp)
@@ -712,6 +801,10 @@ void Main::add_supported_options()
         .action([&](const auto& a) {conf.maxOccurIrredMB = std::atof(a.c_str());})
         .default_value(conf.maxOccurIrredMB)
         .help("Don't allow irredundant occur size to be beyond this many MB");
+    program.add_argument("--occthreads")
+        .action([&](const auto& a) {conf.occ_threads = std::atoi(a.c_str());})
+        .default_value(conf.occ_threads)
+        .help("Threads for building the occurrence lists, for long clause subsumption and strengthening, and for testing variables during BVE. 0 = one per hardware thread");
     ;
 
     /* po::options_description sub_str_time_limits("Occ-based subsumption and strengthening time limits"); */
@@ -900,6 +993,18 @@ void Main::add_supported_options()
         .action([&](const auto& a) {conf.sql_overwrite_file = std::atoi(a.c_str());})
         .default_value(conf.sql_overwrite_file)
         .help("Overwrite the SQLite database file if it exists");
+    program.add_argument("--sqlasync")
+        .action([&](const auto& a) {conf.sql_async = std::atoi(a.c_str());})
+        .default_value(conf.sql_async)
+        .help("Write SQL data from a separate thread, many rows per transaction, in WAL mode");
+    program.add_argument("--sqlqueuemb")
+        .action([&](const auto& a) {conf.sql_queue_mb = std::atoi(a.c_str());})
+        .default_value(conf.sql_queue_mb)
+        .help("Size of the queue between the solver and the SQL writer thread, in MB");
+    program.add_argument("--sqlqueuedrop")
+        .action([&](const auto& a) {conf.sql_queue_drop = std::atoi(a.c_str());})
+        .default_value(conf.sql_queue_drop)
+        .help("When the SQL queue is full: 0 = wait for the writer, 1 = drop the record. Dropped records are counted in the 'tags' table");
     program.add_argument("--cldatadumpratio")
         .action([&](const auto& a) {conf.dump_individual_cldata_ratio = std::atof(a.c_str());})
         .default_value(conf.dump_individual_cldata_ratio)
@@ -908,6 +1013,14 @@ void Main::add_supported_options()
         .action([&](const auto& a) {conf.lock_for_data_gen_ratio = std::atof(a.c_str());})
         .default_value(conf.lock_for_data_gen_ratio)
         .help("Lock for data generation into lev0, setting locked_for_data_gen. Only works when clause is marked for dumping ('--cldatadumpratio' )");
+    program.add_argument("--louvainthreads")
+        .action([&](const auto& a) {conf.louvain_threads = std::atoi(a.c_str());})
+        .default_value(conf.louvain_threads)
+        .help("Threads used to build the variable graph and compute its Louvain communities. 0 = one per hardware thread");
+    program.add_argument("--louvainwindow")
+        .action([&](const auto& a) {conf.louvain_clause_window = std::atoi(a.c_str());})
+        .default_value(conf.louvain_clause_window)
+        .help("Clauses longer than this+1 are not turned into a full clique in the community graph, every literal is only connected to the next this many literals of the clause");
 #endif
 
     /* po::options_description printOptions("Printing options"); */
@@ -1004,6 +1117,14 @@ void Main::add_supported_options()
         .action([&](const auto& a) {conf.full_watch_consolidate_every_n_confl = std::atoll(a.c_str());})
         .default_value(conf.full_watch_consolidate_every_n_confl)
         .help("Consolidate watchlists fully once every N conflicts. Scheduled during simplification rounds.");
+    program.add_argument("--clhugepages")
+        .action([&](const auto& a) {conf.clause_huge_pages = std::atoi(a.c_str());})
+        .default_value(conf.clause_huge_pages)
+        .help("Ask the OS for transparent huge pages for the clause memory arena");
+    program.add_argument("--cloffshift")
+        .action([&](const auto& a) {conf.clause_offset_shift = std::atoi(a.c_str());})
+        .default_value(conf.clause_offset_shift)
+        .help("Clause offsets initially count units of 2^N words. Larger N addresses more clause memory with 32-bit offsets, at the cost of padding. It is widened automatically when needed, at most to 4");
 
     /* po::options_description miscOptions("Misc options"); */
     /* miscOptions.add_options() */
@@ -1033,6 +1154,22 @@ void Main::add_supported_options()
         .action([&](const auto& a) {conf.sync_every_confl = std::atoll(a.c_str());})
         .default_value(conf.sync_every_confl)
         .help("Sync threads every N conflicts");
+    program.add_argument("--synclong")
+        .action([&](const auto& a) {conf.sync_long_cls = std::atoi(a.c_str());})
+        .default_value(conf.sync_long_cls)
+        .help("Share long learnt clauses between threads");
+    program.add_argument("--synclongglue")
+        .action([&](const auto& a) {conf.sync_long_max_glue = std::atoi(a.c_str());})
+        .default_value(conf.sync_long_max_glue)
+        .help("Share long learnt clauses between threads only if their glue is at most this");
+    program.add_argument("--synclongsize")
+        .action([&](const auto& a) {conf.sync_long_max_size = std::atoi(a.c_str());})
+        .default_value(conf.sync_long_max_size)
+        .help("Share long learnt clauses between threads only if their size is at most this");
+    program.add_argument("--syncxor")
+        .action([&](const auto& a) {conf.sync_xors = std::atoi(a.c_str());})
+        .default_value(conf.sync_xors)
+        .help("Share the XORs found by thread 0 with the other threads, along with the equivalences Gauss-Jordan elimination derives");
     program.add_argument("--clearinter")
         .action([&](const auto& a) {need_clean_exit = std::atoi(a.c_str());})
         .default_value(0)
@@ -1296,6 +1433,23 @@ void Main::parse_polarity_type()
     else throw WrongParam(mode, "unknown polarity-mode");
 }
 
+void Main::parse_parallel_mode()
+{
+    string mode = program.get<string>("mode");
+    if (mode == "portfolio") conf.cube_and_conquer = false;
+    else if (mode == "cube") conf.cube_and_conquer = true;
+    else throw WrongParam(mode, "unknown parallel mode");
+}
+
+void Main::parse_inproc_sched()
+{
+    string mode = program.get<string>("inprocsched");
+    if (mode == "fixed") conf.inproc_sched = InprocSchedMode::fixed;
+    else if (mode == "adaptive") conf.inproc_sched = InprocSchedMode::adaptive;
+    else if (mode == "deterministic") conf.inproc_sched = InprocSchedMode::deterministic;
+    else throw WrongParam(mode, "unknown inprocessing scheduler mode");
+}
+
 void Main::manually_parse_some_options()
 {
     #ifndef USE_BREAKID
@@ -1357,6 +1511,8 @@ void Main::manually_parse_some_options()
     }
 
     parse_polarity_type();
+    parse_parallel_mode();
+    parse_inproc_sched();
     parse_restart_type();
 
     try {
@@ -1531,6 +1687,31 @@ lbool Main::multi_solutions()
     }
 
     unsigned long current_nr_of_solutions = 0;
+    if (max_nr_of_solutions > 1 && !dont_ban_solutions) {
+        //The last model is printed by the caller
+        return solver->enumerate(
+            [&](const vector<lbool>&) {
+                current_nr_of_solutions++;
+                if (current_nr_of_solutions == max_nr_of_solutions) return false;
+
+                printResultFunc(&cout, false, l_True);
+                if (resultfile) {
+                    printResultFunc(resultfile, true, l_True);
+                }
+                if (conf.verbosity) {
+                    cout
+                    << "c Number of solutions found until now: "
+                    << std::setw(6) << current_nr_of_solutions
+                    << endl;
+                }
+                return true;
+            },
+            sampling_vars.empty() ? NULL : &sampling_vars,
+            max_nr_of_solutions,
+            &assumps,
+            only_sampling_solution);
+    }
+
     lbool ret = l_True;
     while(current_nr_of_solutions < max_nr_of_solutions && ret == l_True) {
         ret = solver->solve(&assumps, only_sampling_solution);
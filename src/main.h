@@ -64,6 +64,8 @@ class Main: public MainCommon
         void manually_parse_some_options();
         void parse_restart_type();
         void parse_polarity_type();
+        void parse_parallel_mode();
+        void parse_inproc_sched();
         void check_num_threads_sanity(const unsigned thread_num) const;
         argparse::ArgumentParser program = argparse::ArgumentParser("cryptominisat5");
 
@@ -75,6 +77,12 @@ class Main: public MainCommon
 
         //File reading
         void readInAFile(SATSolver* solver2, const string& filename);
+        void parse_file_with_dimacsparser(
+            SATSolver* solver2,
+            const string& filename,
+            vector<uint32_t>& parsed_sampling_vars,
+            const uint64_t offset = 0,
+            const uint64_t line = 0);
         void readInStandardInput(SATSolver* solver2);
         void parseInAllFiles(SATSolver* solver2);
 
@@ -112,6 +120,7 @@ class Main: public MainCommon
         string result_fname;
         string input_file;
         std::ofstream* resultfile = NULL;
+        int fast_parse = true;
 
         //Drat checker
         bool clause_ID_needed = false;
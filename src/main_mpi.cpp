@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "dimacsparser.h"
 
 
+using namespace CMSat;
 using std::cout;
 using std::endl;
 
@@ -48,6 +49,8 @@ vector<lbool> solve(lbool& solution_val)
     conf.is_mpi = true;
     conf.do_bva = false;
 
+    //Every rank runs a different slice of the thread portfolio
+    conf.thread_config_offset = (mpiRank-1)*num_threads;
     if (mpiSize > 1 && mpiRank > 1) {
         conf.origSeed = mpiRank*2000; //this will be added T that is the thread number within the MPI
         if (mpiRank % 6 == 3) {
@@ -121,9 +124,16 @@ vector<lbool> solve(lbool& solution_val)
 
 int main(int argc, char** argv)
 {
+    //The solver's thread 0 does all MPI calls of a worker, but it is not
+    //the main thread
     int err;
-    err = MPI_Init(&argc, &argv);
+    int provided;
+    err = MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
     assert(err == MPI_SUCCESS);
+    if (provided < MPI_THREAD_SERIALIZED) {
+        cout << "ERROR: the MPI library does not support MPI_THREAD_SERIALIZED" << endl;
+        exit(-1);
+    }
 
     int mpiRank, mpiSize;
     err = MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
@@ -54,6 +54,7 @@ THE SOFTWARE.
 #include "gatefinder.h"
 #include "bva.h"
 #include "trim.h"
+#include "parallel_for.h"
 extern "C" {
 #include "picosat/picosat.h"
 }
@@ -101,11 +102,29 @@ OccSimplifier::OccSimplifier(Solver* _solver):
     tmp_bin_cl.resize(2);
 }
 
+//Worker copy for parallel BVE. It only runs test_elim_and_fill_resolvents()
+//and so needs nothing but its own scratch space
+OccSimplifier::OccSimplifier(Solver* _solver, const OccSimplifier* _parent):
+    solver(_solver)
+    , parent(_parent)
+    , seen(worker_seen)
+    , seen2(worker_seen2)
+    , toClear(worker_toClear)
+    , velim_order(VarOrderLt(varElimComplexity))
+    , gateFinder(NULL)
+    , anythingHasBeenElimed(false)
+    , elimedMapBuilt(false)
+{
+    bva = NULL;
+    sub_str = NULL;
+}
+
 OccSimplifier::~OccSimplifier()
 {
     delete bva;
     delete sub_str;
     delete gateFinder;
+    for(OccSimplifier* w: elim_workers) delete w;
 }
 
 void OccSimplifier::new_var(const uint32_t /*orig_outer*/)
@@ -231,6 +250,18 @@ bool OccSimplifier::get_elimed_clause_at(uint32_t& at,uint32_t& at2, vector<Lit>
     return false;
 }
 
+//Lits are packed Lit::toInt() values. No early exit, so that the loop can
+//be vectorised; clauses on the elimed stack are short
+static inline bool elimed_cl_satisfied(
+    const uint32_t* lits, const uint32_t sz, const vector<lbool>& model)
+{
+    uint8_t sat = 0;
+    for(uint32_t i = 0; i < sz; i++) {
+        sat |= (model[lits[i] >> 1].getValue() ^ (lits[i] & 1)) == l_True.getValue();
+    }
+    return sat;
+}
+
 void OccSimplifier::extend_model(SolutionExtender* extender)
 {
     //Either a variable is not eliminated, or its value is undef
@@ -246,50 +277,140 @@ void OccSimplifier::extend_model(SolutionExtender* extender)
     print_elimed_clauses_reverse();
     #endif
 
+    if (!elimed_packed_built
+        || elimed_packed_replaced != solver->varReplacer->get_num_replaced_vars()
+    ) {
+        build_elimed_packed();
+    }
+
+    //Only the vars whose clauses contain a var that changed since the
+    //previous extension need to be re-evaluated, the rest keep their value
+    const bool incremental = extend_prev_in.size() == solver->model.size();
+    if (incremental) {
+        std::fill(elimed_packed_dirty.begin(), elimed_packed_dirty.end(), 0);
+        for(uint32_t v = 0; v < solver->model.size(); v++) {
+            if (solver->model[v] != extend_prev_in[v]) mark_elimed_packed_dirty(v);
+        }
+    } else {
+        std::fill(elimed_packed_dirty.begin(), elimed_packed_dirty.end(), 1);
+    }
+    extend_prev_in = solver->model;
+
     //go through in reverse order
     vector<Lit> lits;
-    for (long int i = (int)elimedClauses.size()-1; i >= 0; i--) {
-        ElimedClauses* it = &elimedClauses[i];
-        if (it->toRemove) {
+    uint32_t rechecked = 0;
+    const uint32_t* at = elimed_packed.data();
+    for (uint32_t i = 0; i < elimed_packed_vars; i++) {
+        const Lit elimedOn = Lit::toLit(at[0]);
+        const uint32_t* const end = at + 2 + at[1];
+        if (!elimed_packed_dirty[i]) {
+            solver->model[elimedOn.var()] = extend_prev_out[elimedOn.var()];
+            if (solver->varReplacer->var_is_replacing(elimedOn.var())) {
+                solver->varReplacer->extend_model(elimedOn.var());
+            }
+            at = end;
             continue;
         }
 
-        Lit elimedOn = solver->varReplacer->get_lit_replaced_with_outer(it->at(0, eClsLits));
-        size_t at = 1;
-        bool satisfied = false;
-        lits.clear();
-        while(at < it->size()) {
-            //built clause, reached marker, "lits" is now valid
-            if (it->at(at, eClsLits) == lit_Undef) {
-                if (!satisfied) {
-                    [[maybe_unused]] bool var_set = extender->addClause(lits, elimedOn.var());
-
-                    #ifndef DEBUG_VARELIM
-                    //all should be satisfied in fact
-                    //no need to go any further
-                    if (var_set) break;
-                    #endif
-                }
-                satisfied = false;
+        rechecked++;
+        at += 2;
+        while(at < end) {
+            const uint32_t sz = *at++;
+            if (!elimed_cl_satisfied(at, sz, solver->model)) {
                 lits.clear();
+                for(uint32_t x = 0; x < sz; x++) lits.push_back(Lit::toLit(at[x]));
+                [[maybe_unused]] bool var_set = extender->addClause(lits, elimedOn.var());
 
-            //Building clause, "lits" is not yet valid
-            } else if (!satisfied) {
-                Lit l = it->at(at, eClsLits);
-                l = solver->varReplacer->get_lit_replaced_with_outer(l);
-                lits.push_back(l);
-
-                //Elimed clause can be skipped, it's satisfied
-                if (solver->model_value(l) == l_True) {
-                    satisfied = true;
-                }
+                #ifndef DEBUG_VARELIM
+                //all should be satisfied in fact
+                //no need to go any further
+                if (var_set) break;
+                #endif
             }
-            at++;
+            at += sz;
         }
+        at = end;
         extender->dummyElimed(elimedOn.var());
+        if (incremental
+            && solver->model[elimedOn.var()] != extend_prev_out[elimedOn.var()]
+        ) {
+            mark_elimed_packed_dirty(elimedOn.var());
+        }
     }
+    extend_prev_out = solver->model;
+
     if (solver->conf.verbosity >= 2) {
-        cout << "c [extend] Extended " << elimedClauses.size() << " var-elim clauses" << endl;
+        cout << "c [extend] Extended " << elimed_packed_vars << " var-elim clauses"
+        << " re-checked: " << rechecked << endl;
+    }
+}
+
+void OccSimplifier::build_elimed_packed()
+{
+    const uint32_t nvars = solver->nVarsOuter();
+    elimed_packed.clear();
+    elimed_packed_vars = 0;
+    elimed_packed_occ_start.assign(nvars+1, 0);
+    vector<uint32_t> last_entry(nvars, numeric_limits<uint32_t>::max());
+    vector<pair<uint32_t, uint32_t>> occ_tmp;
+
+    //reverse order, that's how they are extended
+    for (long int i = (long int)elimedClauses.size()-1; i >= 0; i--) {
+        const ElimedClauses& e = elimedClauses[i];
+        if (e.toRemove) continue;
+
+        const Lit elimedOn = solver->varReplacer->get_lit_replaced_with_outer(e.at(0, eClsLits));
+        elimed_packed.push_back(elimedOn.toInt());
+        const size_t words_at = elimed_packed.size();
+        elimed_packed.push_back(0);
+
+        size_t size_at = words_at;
+        for(size_t at = 1; at < e.size(); at++) {
+            if (size_at == words_at) {
+                size_at = elimed_packed.size();
+                elimed_packed.push_back(0);
+            }
+            const Lit l = e.at(at, eClsLits);
+            if (l == lit_Undef) {
+                elimed_packed[size_at] = elimed_packed.size() - size_at - 1;
+                size_at = words_at;
+                continue;
+            }
+
+            const Lit l2 = solver->varReplacer->get_lit_replaced_with_outer(l);
+            elimed_packed.push_back(l2.toInt());
+            if (l2.var() != elimedOn.var() && last_entry[l2.var()] != elimed_packed_vars) {
+                last_entry[l2.var()] = elimed_packed_vars;
+                elimed_packed_occ_start[l2.var()+1]++;
+                occ_tmp.push_back(std::make_pair(l2.var(), elimed_packed_vars));
+            }
+        }
+        assert(size_at == words_at);
+        elimed_packed[words_at] = elimed_packed.size() - words_at - 1;
+        elimed_packed_vars++;
+    }
+
+    for(uint32_t v = 0; v < nvars; v++) {
+        elimed_packed_occ_start[v+1] += elimed_packed_occ_start[v];
+    }
+    elimed_packed_occ.resize(occ_tmp.size());
+    vector<uint32_t> fill_at(elimed_packed_occ_start.begin(), elimed_packed_occ_start.end()-1);
+    for(const auto& o: occ_tmp) {
+        elimed_packed_occ[fill_at[o.first]++] = o.second;
+    }
+
+    elimed_packed_dirty.assign(elimed_packed_vars, 1);
+    extend_prev_in.clear();
+    extend_prev_out.clear();
+    elimed_packed_replaced = solver->varReplacer->get_num_replaced_vars();
+    elimed_packed_built = true;
+}
+
+void OccSimplifier::mark_elimed_packed_dirty(const uint32_t var)
+{
+    if (var+1 >= elimed_packed_occ_start.size()) return;
+    for(uint32_t x = elimed_packed_occ_start[var]; x < elimed_packed_occ_start[var+1]; x++) {
+        elimed_packed_dirty[elimed_packed_occ[x]] = 1;
     }
 }
 
@@ -593,12 +714,32 @@ void OccSimplifier::print_linkin_data(const LinkInData link_in_data) const
 }
 
 
+//Below this many clauses, linking in is not worth the threads
+static const size_t par_link_in_min_cls = 20000;
+
+//Below this many candidates, BVE is not worth the threads
+static const size_t par_bve_min_vars = 1000;
+static const size_t par_bve_vars_per_thread = 64;
+
+uint32_t OccSimplifier::occ_threads() const
+{
+    uint32_t n = solver->conf.occ_threads;
+    if (n == 0) n = std::thread::hardware_concurrency();
+    return std::max<uint32_t>(n, 1);
+}
+
 OccSimplifier::LinkInData OccSimplifier::link_in_clauses(
     const vector<ClOffset>& toAdd
     , bool alsoOccur
     , uint32_t max_size
     , int64_t link_in_lit_limit
 ) {
+    const uint32_t threads = occ_threads();
+    if (threads > 1 && toAdd.size() >= par_link_in_min_cls) {
+        return link_in_clauses_parallel(
+            toAdd, alsoOccur, max_size, link_in_lit_limit, threads);
+    }
+
     LinkInData link_in_data;
     for (const ClOffset offs: toAdd) {
         Clause* cl = solver->cl_alloc.ptr(offs);
@@ -630,6 +771,110 @@ OccSimplifier::LinkInData OccSimplifier::link_in_clauses(
     return link_in_data;
 }
 
+//Gives the same result as the serial link_in_clauses(), down to the order
+//of the watchlists and of added_cl_to_var. Each thread owns a range of
+//literals. Clause-local work is split by clause, and it also hands every
+//literal occurrence to the thread owning that literal, so the watchlists
+//can then be filled per literal range, in clause order, with each
+//occurrence visited by one thread only.
+OccSimplifier::LinkInData OccSimplifier::link_in_clauses_parallel(
+    const vector<ClOffset>& toAdd
+    , bool alsoOccur
+    , uint32_t max_size
+    , int64_t link_in_lit_limit
+    , const uint32_t threads
+) {
+    LinkInData link_in_data;
+
+    //Whether a clause is linked depends on the ones before it
+    vector<uint8_t> linked(toAdd.size(), 0);
+    for (size_t i = 0; i < toAdd.size(); i++) {
+        const Clause* cl = solver->cl_alloc.ptr(toAdd[i]);
+        if (alsoOccur
+            && cl->size() < max_size
+            && link_in_lit_limit > 0
+        ) {
+            linked[i] = 1;
+            link_in_data.cl_linked++;
+            link_in_lit_limit -= cl->size();
+            clause_lits_added += cl->size();
+        } else {
+            link_in_data.cl_not_linked++;
+        }
+    }
+
+    //Per clause. Vars are touched in order of first occurrence, so each
+    //slice collects its own, and they are merged in slice order.
+    //occs[slice][owner] are the occurrences of owner's literals in the
+    //slice's clauses, in clause order.
+    const uint64_t num_lits = solver->nVars()*2;
+    vector<vector<uint32_t>> touched(threads);
+    vector<vector<vector<std::pair<Lit, ClOffset>>>> occs(
+        threads, vector<vector<std::pair<Lit, ClOffset>>>(threads));
+    parallel_for(threads, toAdd.size(), [&](uint32_t tid, uint64_t begin, uint64_t end) {
+        vector<uint8_t> var_seen(solver->nVars(), 0);
+        for (uint64_t i = begin; i < end; i++) {
+            Clause* cl = solver->cl_alloc.ptr(toAdd[i]);
+            cl->recalc_abst_if_needed();
+            assert(cl->abst == calcAbstraction(*cl));
+            assert(!cl->red() || cl->stats.glue > 0);
+            if (linked[i]) {
+                assert(!cl->stats.marked_clause);
+                assert(cl->size() > 2);
+                if (!cl->red()) {
+                    for(const Lit l: *cl) {
+                        if (var_seen[l.var()]) continue;
+                        var_seen[l.var()] = 1;
+                        touched[tid].push_back(l.var());
+                    }
+                }
+                cl->setOccurLinked(true);
+            } else {
+                cl->setOccurLinked(false);
+            }
+            std::sort(cl->begin(), cl->end());
+            if (linked[i]) {
+                for(const Lit l: *cl) {
+                    occs[tid][(uint64_t)l.toInt()*threads/num_lits].push_back(
+                        std::make_pair(l, toAdd[i]));
+                }
+            }
+        }
+    });
+    for(const auto& t: touched) {
+        for(const uint32_t v: t) added_cl_to_var.touch(v);
+    }
+
+    //Per literal. Counting first lets every watchlist grow only once.
+    //Growing allocates from the shared watch arena, so that part is serial.
+    if (link_in_data.cl_linked > 0) {
+        vector<uint32_t> num(num_lits, 0);
+        parallel_for(threads, threads, [&](uint32_t owner, uint64_t, uint64_t) {
+            for(uint32_t slice = 0; slice < threads; slice++) {
+                for(const auto& o: occs[slice][owner]) num[o.first.toInt()]++;
+            }
+        });
+        for(uint32_t x = 0; x < num.size(); x++) {
+            if (num[x] == 0) continue;
+            watch_subarray ws = solver->watches[Lit::toLit(x)];
+            ws.capacity(ws.size() + num[x]);
+        }
+
+        parallel_for(threads, threads, [&](uint32_t owner, uint64_t, uint64_t) {
+            for(uint32_t slice = 0; slice < threads; slice++) {
+                for(const auto& o: occs[slice][owner]) {
+                    const Clause* cl = solver->cl_alloc.ptr(o.second);
+                    if (!cl->red()) n_occurs[o.first.toInt()]++;
+                    solver->watches[o.first].push_(Watched(o.second, cl->abst));
+                }
+            }
+        });
+    }
+
+    clauses.insert(clauses.end(), toAdd.begin(), toAdd.end());
+    return link_in_data;
+}
+
 bool OccSimplifier::check_varelim_when_adding_back_cl(const Clause* cl) const
 {
     bool notLinkedNeedFree = false;
@@ -803,6 +1048,7 @@ bool OccSimplifier::can_eliminate_var(const uint32_t var) const
     if (solver->value(var) != l_Undef ||
         solver->varData[var].removed != Removed::none ||
         solver->var_inside_assumptions(var) != l_Undef ||
+        (solver->conf.incremental_fast_path && solver->inc_var_frozen(var)) ||
         ((solver->conf.sampling_vars || solver->fast_backw.fast_backw_on) &&
             sampling_vars_occsimp[var])
     ) {
@@ -1180,6 +1426,7 @@ bool OccSimplifier::eliminate_vars()
     assert(solver->watches.get_smudged_list().empty());
     bvestats.clear();
     bvestats.numCalls = 1;
+    const uint32_t threads = occ_threads();
 
     //Go through the ordered list of variables to eliminate
     int64_t last_elimed = 1;
@@ -1241,7 +1488,12 @@ bool OccSimplifier::eliminate_vars()
             assert(solver->prop_at_head());
             removed_cl_with_var.clear();
             update_varelim_complexity_heap();
-            while(!velim_order.empty()
+
+            //Arjun's E mode does lit-rem before testing, can't be batched
+            const bool par = threads > 1
+                && !solver->conf.varelim_check_resolvent_subs
+                && velim_order.size() >= par_bve_min_vars;
+            while((!velim_order.empty() || elim_batch_at < elim_batch.size())
                 && *limit_to_decrease > 0
                 && varelim_num_limit > 0
                 && varelim_linkin_limit_bytes > 0
@@ -1250,14 +1502,31 @@ bool OccSimplifier::eliminate_vars()
             ) {
                 assert(solver->prop_at_head());
                 assert(limit_to_decrease == &norm_varelim_time_limit);
-                uint32_t var = velim_order.removeMin();
+                ElimCand* cand = NULL;
+                uint32_t var;
+                if (par) {
+                    if (elim_batch_at < elim_batch.size()
+                        && !next_elim_cand_in_order()
+                    ) {
+                        return_elim_batch();
+                    }
+                    if (elim_batch_at == elim_batch.size()) {
+                        fill_elim_batch(threads);
+                        if (elim_batch.empty()) continue;
+                        test_elim_batch(threads);
+                    }
+                    cand = &elim_batch[elim_batch_at++];
+                    var = cand->var;
+                } else {
+                    var = velim_order.removeMin();
+                }
 
                 //Stats
                 *limit_to_decrease -= 20;
                 wenThrough++;
 
                 if (!can_eliminate_var(var)) continue;
-                if (maybe_eliminate(var)) {
+                if (cand ? maybe_eliminate_tested(*cand) : maybe_eliminate(var)) {
                     vars_elimed++;
                     varelim_num_limit--;
                     last_elimed++;
@@ -1276,8 +1545,10 @@ bool OccSimplifier::eliminate_vars()
 
                 assert(solver->okay());
                 assert(solver->prop_at_head());
+                if (cand) invalidate_elim_batch();
                 update_varelim_complexity_heap();
             }
+            return_elim_batch();
             assert(solver->prop_at_head());
             assert(added_long_cl.empty());
             assert(added_irred_bin.empty());
@@ -1382,6 +1653,7 @@ bool OccSimplifier::eliminate_vars()
     }
 
 end:
+    return_elim_batch();
     if (solver->okay()) {
         assert(solver->prop_at_head());
         assert(added_long_cl.empty());
@@ -1516,7 +1788,7 @@ struct MyOccSorter
 
 void OccSimplifier::sort_occurs_and_set_abst()
 {
-    for(auto& ws: solver->watches) {
+    for(watch_subarray ws: solver->watches) {
         std::sort(ws.begin(), ws.end(), MyOccSorter(solver));
 
         for(Watched& w: ws) {
@@ -2248,7 +2520,17 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
                 ternary_res();
             }
         } else if (token == "occ-xor") {
-            if (solver->conf.doFindXors &&
+            DataSync* ds = solver->datasync;
+            if (ds->xors_shared() && !ds->xor_finder_thread()) {
+                //Take the XORs the finder thread found, if any
+                vector<Xor> shared;
+                if (ds->get_shared_xors(shared)) {
+                    if (!solver->okay()) continue;
+                    XorFinder finder(this, solver);
+                    finder.import_xors(std::move(shared));
+                    runStats.xorTime += finder.get_stats().findTime;
+                }
+            } else if (solver->conf.doFindXors &&
                 #ifdef USE_TBUDDY
                 true)
                 #else
@@ -2258,6 +2540,7 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
                 XorFinder finder(this, solver);
                 finder.find_xors();
                 runStats.xorTime += finder.get_stats().findTime;
+                if (ds->xors_shared()) ds->share_xors(solver->xorclauses);
             }
         } else if (token == "occ-lit-rem") {
             if (!solver->frat->enabled()) all_occ_based_lit_rem();
@@ -2995,6 +3278,7 @@ bool OccSimplifier::uneliminate(uint32_t var)
 
     //Mark for removal from elimed list
     elimedClauses[at_elimed_cls].toRemove = true;
+    elimed_packed_built = false;
     can_remove_elimed_clauses = true;
     assert(elimedClauses[at_elimed_cls].at(0, eClsLits).var() == var);
 
@@ -3271,6 +3555,7 @@ void OccSimplifier::cleanElimedClauses()
 
         if (i->toRemove) {
             elimedMapBuilt = false;
+            elimed_packed_built = false;
             i_eClsLits += i->size();
             assert(i_eClsLits == i->end);
             i->start = numeric_limits<uint64_t>::max();
@@ -3306,6 +3591,7 @@ void OccSimplifier::rem_cls_from_watch_due_to_varelim(
     , bool add_to_block
 ) {
     elimedMapBuilt = false;
+    elimed_packed_built = false;
 
     //Copy&clear i.e. MOVE
     solver->watches[lit].moveTo(tmp_rem_cls_copy);
@@ -3442,7 +3728,8 @@ bool OccSimplifier::find_irreg_gate(
 ) {
     // Too expensive
     if (turned_off_irreg_gate || picolits_added > (double)solver->conf.global_timeout_multiplier * (double)solver->conf.picosat_gate_limitK * (double)1000) {
-        if (solver->conf.verbosity && !turned_off_irreg_gate) {
+        //Workers don't print, test_elim_batch() does it for them
+        if (solver->conf.verbosity && !turned_off_irreg_gate && !parent) {
             cout << "c [occ-bve] turning off picosat-based irreg gate detection, added lits: " << print_value_kilo_mega(picolits_added) << endl;
         }
         turned_off_irreg_gate = true;
@@ -4408,24 +4695,25 @@ bool OccSimplifier::test_elim_and_fill_resolvents(const uint32_t var)
     assert(solver->value(var) == l_Undef);
     resolvents.clear();
     const Lit lit = Lit(var, false);
+    const vector<uint32_t>& occs = parent ? parent->n_occurs : n_occurs;
 
     //Gather data
     #ifdef CHECK_N_OCCUR
-    if (n_occurs[Lit(var, false).toInt()] != calc_data_for_heuristic(Lit(var, false))) {
+    if (occs[Lit(var, false).toInt()] != calc_data_for_heuristic(Lit(var, false))) {
         cout << "lit " << Lit(var, false) << endl;
-        cout << "n_occ is: " << n_occurs[Lit(var, false).toInt()] << endl;
+        cout << "n_occ is: " << occs[Lit(var, false).toInt()] << endl;
         cout << "calc is: " << calc_data_for_heuristic(Lit(var, false)) << endl;
         assert(false);
     }
 
-    if (n_occurs[Lit(var, true).toInt()] != calc_data_for_heuristic(Lit(var, true))) {
+    if (occs[Lit(var, true).toInt()] != calc_data_for_heuristic(Lit(var, true))) {
         cout << "lit " << Lit(var, true) << endl;
-        cout << "n_occ is: " << n_occurs[Lit(var, true).toInt()] << endl;
+        cout << "n_occ is: " << occs[Lit(var, true).toInt()] << endl;
         cout << "calc is: " << calc_data_for_heuristic(Lit(var, true)) << endl;
     }
     #endif
-    uint32_t pos = n_occurs[Lit(var, false).toInt()];
-    uint32_t neg = n_occurs[Lit(var, true).toInt()];
+    uint32_t pos = occs[Lit(var, false).toInt()];
+    uint32_t neg = occs[Lit(var, true).toInt()];
 
     //set-up
     clean_from_red_or_removed(solver->watches[lit], poss);
@@ -4482,7 +4770,7 @@ bool OccSimplifier::test_elim_and_fill_resolvents(const uint32_t var)
         gates = true;
     }
 
-    if (gates && solver->conf.verbosity > 5) {
+    if (gates && solver->conf.verbosity > 5 && !parent) {
         cout << "Elim on gate, lit: " << lit << " g poss: ";
         for(const auto& w: gates_poss) {
             if (w.isClause()) {
@@ -4747,6 +5035,7 @@ void OccSimplifier::create_dummy_elimed_clause(const Lit lit)
         ElimedClauses(eClsLits.size()-1, eClsLits.size())
     );
     elimedMapBuilt = false;
+    elimed_packed_built = false;
 }
 
 bool OccSimplifier::occ_based_lit_rem(uint32_t var, uint32_t& removed) {
@@ -4882,7 +5171,16 @@ bool OccSimplifier::maybe_eliminate(const uint32_t var)
 
     if (solver->value(var) != l_Undef || !solver->okay()) return false;
     if (!test_elim_and_fill_resolvents(var) || *limit_to_decrease < 0) return false;  //didn't eliminate :( }
+    elim_var_with_resolvents(var);
+
+    return true; //eliminated!
+}
+
+//Eliminates var, adding the resolvents in "resolvents"
+void OccSimplifier::elim_var_with_resolvents(const uint32_t var)
+{
     bvestats.triedToElimVars++;
+    const Lit lit = Lit(var, false);
 
     print_var_eliminate_stat(lit);
 
@@ -4903,8 +5201,183 @@ bool OccSimplifier::maybe_eliminate(const uint32_t var)
 
 end:
     set_var_as_eliminated(var);
+}
 
-    return true; //eliminated!
+//Takes the cheapest variables from velim_order, in order, as long as their
+//neighbourhoods (the variables of their irredundant clauses) don't overlap.
+//Testing them can then run in parallel, and eliminating one cannot change
+//what the others were tested against, unless units are propagated or
+//sub/str reaches them, see invalidate_elim_batch()
+void OccSimplifier::fill_elim_batch(const uint32_t threads)
+{
+    for(const uint32_t v: elim_nb_marked) elim_nb_owner[v] = 0;
+    elim_nb_marked.clear();
+    elim_nb_owner.resize(solver->nVars(), 0);
+    elim_batch.clear();
+    elim_batch_at = 0;
+    elim_batch_trail = solver->trail_size();
+
+    const size_t max_batch = threads*par_bve_vars_per_thread;
+    size_t popped = 0;
+    while(!velim_order.empty()
+        && elim_batch.size() < max_batch
+        && popped < max_batch*4
+    ) {
+        const uint32_t var = velim_order.removeMin();
+        popped++;
+        if (!can_eliminate_var(var)) {
+            *limit_to_decrease -= 20;
+            continue;
+        }
+
+        bool clash = false;
+        elim_nb_tmp.clear();
+        elim_nb_tmp.push_back(var);
+        for(const Lit l: {Lit(var, false), Lit(var, true)}) {
+            *limit_to_decrease -= (long)solver->watches[l].size();
+            for(const Watched& w: solver->watches[l]) {
+                if (w.isBin()) {
+                    if (!w.red()) elim_nb_tmp.push_back(w.lit2().var());
+                } else if (w.isClause()) {
+                    const Clause& cl = *solver->cl_alloc.ptr(w.get_offset());
+                    if (cl.getRemoved() || cl.red()) continue;
+                    *limit_to_decrease -= (long)cl.size();
+                    for(const Lit l2: cl) elim_nb_tmp.push_back(l2.var());
+                }
+            }
+        }
+        for(const uint32_t v: elim_nb_tmp) {
+            if (elim_nb_owner[v] != 0) {
+                clash = true;
+                break;
+            }
+        }
+        if (clash) {
+            //The serial loop would eliminate it before the ones after it
+            velim_order.insert(var);
+            break;
+        }
+
+        elim_batch.resize(elim_batch.size()+1);
+        ElimCand& c = elim_batch.back();
+        c.var = var;
+        c.valid = true;
+        for(const uint32_t v: elim_nb_tmp) {
+            if (elim_nb_owner[v] == 0) {
+                elim_nb_owner[v] = elim_batch.size();
+                elim_nb_marked.push_back(v);
+            }
+        }
+    }
+}
+
+void OccSimplifier::test_elim_batch(const uint32_t threads)
+{
+    while(elim_workers.size() < threads) {
+        elim_workers.push_back(new OccSimplifier(solver, this));
+    }
+    for(uint32_t i = 0; i < threads; i++) {
+        OccSimplifier* w = elim_workers[i];
+        w->worker_seen.resize(seen.size(), 0);
+        w->worker_seen2.resize(seen2.size(), 0);
+        w->var_to_picovar.resize(solver->nVars(), 0);
+        w->grow = grow;
+        w->picolits_added = picolits_added;
+        w->turned_off_irreg_gate = turned_off_irreg_gate;
+    }
+
+    const int64_t start_limit = *limit_to_decrease;
+    const int64_t start_weaken = weaken_time_limit;
+    parallel_for(threads, elim_batch.size(),
+        [&](uint32_t tid, uint64_t begin, uint64_t end) {
+        OccSimplifier* w = elim_workers[tid];
+        for(uint64_t i = begin; i < end; i++) {
+            ElimCand& c = elim_batch[i];
+            w->norm_varelim_time_limit = start_limit;
+            w->limit_to_decrease = &w->norm_varelim_time_limit;
+            w->weaken_time_limit = start_weaken;
+            const uint64_t picolits = w->picolits_added;
+            const uint64_t timeouts = w->bvestats.gatefind_timeouts;
+
+            c.ok = w->test_elim_and_fill_resolvents(c.var);
+            c.cost = start_limit - w->norm_varelim_time_limit;
+            c.weaken_cost = start_weaken - w->weaken_time_limit;
+            c.picolits = w->picolits_added - picolits;
+            c.gatefind_timeouts = w->bvestats.gatefind_timeouts - timeouts;
+            std::swap(c.res, w->resolvents);
+        }
+    });
+    for(uint32_t i = 0; i < threads; i++) {
+        const OccSimplifier* w = elim_workers[i];
+        if (w->turned_off_irreg_gate && !turned_off_irreg_gate) {
+            turned_off_irreg_gate = true;
+            if (solver->conf.verbosity) {
+                cout << "c [occ-bve] turning off picosat-based irreg gate detection, added lits: " << print_value_kilo_mega(w->picolits_added) << endl;
+            }
+        }
+    }
+}
+
+//Same as maybe_eliminate() but with the test already done by a worker
+bool OccSimplifier::maybe_eliminate_tested(ElimCand& c)
+{
+    assert(solver->ok);
+    assert(solver->prop_at_head());
+    assert(c.valid);
+
+    print_var_elim_complexity_stats(c.var);
+    bvestats.testedToElimVars++;
+    *limit_to_decrease -= c.cost;
+    weaken_time_limit -= c.weaken_cost;
+    picolits_added += c.picolits;
+    bvestats.gatefind_timeouts += c.gatefind_timeouts;
+    if (!c.ok || *limit_to_decrease < 0) return false;
+
+    std::swap(resolvents, c.res);
+    elim_var_with_resolvents(c.var);
+    return true;
+}
+
+//Marks the candidates whose neighbourhood has been touched since the test
+void OccSimplifier::invalidate_elim_batch()
+{
+    if (solver->trail_size() != elim_batch_trail) {
+        for(size_t i = elim_batch_at; i < elim_batch.size(); i++) {
+            elim_batch[i].valid = false;
+        }
+        return;
+    }
+    for(const uint32_t v: elim_calc_need_update.getTouchedList()) {
+        const uint32_t owner = elim_nb_owner[v];
+        if (owner > elim_batch_at) elim_batch[owner-1].valid = false;
+    }
+}
+
+//Whether the serial loop would pop the next candidate now. Its score is
+//up-to-date as long as it is valid: it would only change if its
+//neighbourhood was touched.
+bool OccSimplifier::next_elim_cand_in_order() const
+{
+    const ElimCand& c = elim_batch[elim_batch_at];
+    if (!c.valid) return false;
+    if (velim_order.empty()) return true;
+    return VarOrderLt(varElimComplexity)(c.var, velim_order[0]);
+}
+
+//Puts the untried candidates back, e.g. when a limit has been reached
+void OccSimplifier::return_elim_batch()
+{
+    for(size_t i = elim_batch_at; i < elim_batch.size(); i++) {
+        const uint32_t var = elim_batch[i].var;
+        if (can_eliminate_var(var) && !velim_order.inHeap(var)) {
+            if (!elim_batch[i].valid) {
+                varElimComplexity[var] = heuristicCalcVarElimScore(var);
+            }
+            velim_order.insert(var);
+        }
+    }
+    elim_batch.clear();
+    elim_batch_at = 0;
 }
 
 void OccSimplifier::add_pos_lits_to_dummy_and_seen(
@@ -5264,6 +5737,10 @@ void OccSimplifier::order_vars_for_elim()
         if (!can_eliminate_var(var))
             continue;
 
+        //Occurrences of untouched vars are the same as last time
+        if (solver->inc_restrict_simp() && !solver->inc_var_dirty(var))
+            continue;
+
         *limit_to_decrease -= 50;
         assert(!velim_order.inHeap(var));
         varElimComplexity[var] = heuristicCalcVarElimScore(var);
@@ -5323,6 +5800,10 @@ size_t OccSimplifier::mem_used() const
     b += sub_str->mem_used();
     b += elimedClauses.capacity()*sizeof(ElimedClauses);
     b += eClsLits.capacity()*sizeof(Lit);
+    b += elimed_packed.capacity()*sizeof(uint32_t);
+    b += elimed_packed_occ.capacity()*sizeof(uint32_t);
+    b += elimed_packed_occ_start.capacity()*sizeof(uint32_t);
+    b += (extend_prev_in.capacity() + extend_prev_out.capacity())*sizeof(lbool);
     b += blk_var_to_cls.size()*sizeof(uint32_t);
     b += velim_order.mem_used();
     b += varElimComplexity.capacity()*sizeof(int)*2;
@@ -5572,3 +6053,28 @@ void OccSimplifier::blocked_clause_elim()
         unlink_clause(off);
     }
 }
+
+void OccSimplifier::save_state(SimpleOutFile& f) const
+{
+    f.put_vector(eClsLits);
+    f.put_uint64_t(elimedClauses.size());
+    for(const auto& c: elimedClauses) {
+        c.save_to_file(f);
+    }
+    f.put_uint32_t(can_remove_elimed_clauses);
+    f.put_uint64_t(bvestats_global.numVarsElimed);
+}
+
+void OccSimplifier::load_state(SimpleInFile& f)
+{
+    eClsLits.clear();
+    f.get_vector(eClsLits);
+    elimedClauses.resize(f.get_uint64_t());
+    for(auto& c: elimedClauses) {
+        c.load_from_file(f);
+    }
+    can_remove_elimed_clauses = f.get_uint32_t();
+    bvestats_global.numVarsElimed = f.get_uint64_t();
+    elimedMapBuilt = false;
+    elimed_packed_built = false;
+}
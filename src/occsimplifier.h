@@ -279,6 +279,7 @@ public:
 
     /// Used ONLY for XOR, changes occur setup
     void sort_occurs_and_set_abst();
+    uint32_t occ_threads() const; ///< see conf.occ_threads
     vector<ClOffset> added_long_cl;
     TouchList added_cl_to_var; // to perform forward-subsumption of clauses added as part of BVE
                                // contains a list of literals that have been added as part of
@@ -308,6 +309,8 @@ public:
     template<class T>
     void unserialize_elimed_cls(T& ar);
 #endif
+    void save_state(SimpleOutFile& f) const;
+    void load_state(SimpleInFile& f);
 
 private:
     friend class SubsumeStrengthen;
@@ -344,6 +347,10 @@ private:
 
     //Persistent data
     Solver*  solver;              ///<The solver this simplifier is connected to
+    const OccSimplifier* parent = NULL; ///<Set for BVE worker copies only
+    vector<uint32_t> worker_seen;
+    vector<uint8_t> worker_seen2;
+    vector<Lit> worker_toClear;
     vector<uint32_t>& seen;
     vector<uint8_t>& seen2;
     vector<Lit>& toClear;
@@ -404,6 +411,13 @@ private:
         , uint32_t max_size
         , int64_t link_in_lit_limit
     );
+    OccSimplifier::LinkInData link_in_clauses_parallel(
+        const vector<ClOffset>& toAdd
+        , bool alsoOccur
+        , uint32_t max_size
+        , int64_t link_in_lit_limit
+        , uint32_t threads
+    );
     void set_limits();
 
     //Finish-up
@@ -439,9 +453,14 @@ private:
     ///Order variables according to their complexity of elimination
     struct VarOrderLt {
         const vector<uint64_t>&  varElimComplexity;
+        //Ties are broken by variable, so the order does not depend on the
+        //shape of the heap and parallel BVE can follow it exactly
         bool operator () (const uint64_t x, const uint64_t y) const
         {
-            return varElimComplexity[x] < varElimComplexity[y];
+            if (varElimComplexity[x] != varElimComplexity[y]) {
+                return varElimComplexity[x] < varElimComplexity[y];
+            }
+            return x < y;
         }
 
         explicit VarOrderLt(
@@ -468,6 +487,7 @@ private:
     TouchList   elim_calc_need_update;
     vector<ClOffset> cl_to_free_later;
     bool        maybe_eliminate(const uint32_t var);
+    void        elim_var_with_resolvents(const uint32_t var);
     bool        forward_subsume_irred(
         const Lit lit,
         cl_abst_type abs,
@@ -611,6 +631,34 @@ private:
         }
     };
     Resolvents resolvents;
+
+    //Parallel BVE: batches of variables whose neighbourhoods don't overlap
+    //are tested by worker copies, then eliminated here one by one, in the
+    //same order and with the same outcome as the serial loop
+    OccSimplifier(Solver* solver, const OccSimplifier* parent);
+    struct ElimCand {
+        uint32_t var;
+        bool ok = false; ///<Result of test_elim_and_fill_resolvents()
+        bool valid = true; ///<False if the neighbourhood changed since the test
+        int64_t cost = 0;
+        int64_t weaken_cost = 0;
+        uint64_t picolits = 0;
+        uint64_t gatefind_timeouts = 0;
+        Resolvents res;
+    };
+    vector<OccSimplifier*> elim_workers;
+    vector<ElimCand> elim_batch;
+    size_t elim_batch_at = 0;
+    size_t elim_batch_trail = 0;
+    vector<uint32_t> elim_nb_owner; ///<var -> 1+index in elim_batch
+    vector<uint32_t> elim_nb_marked;
+    vector<uint32_t> elim_nb_tmp;
+    void fill_elim_batch(const uint32_t threads);
+    void test_elim_batch(const uint32_t threads);
+    bool maybe_eliminate_tested(ElimCand& cand);
+    bool next_elim_cand_in_order() const;
+    void invalidate_elim_batch();
+    void return_elim_batch();
     uint32_t calc_data_for_heuristic(const Lit lit);
     uint64_t time_spent_on_calc_otf_update;
     uint64_t num_otf_update_until_now;
@@ -662,6 +710,21 @@ private:
     void cleanElimedClauses();
     bool can_remove_elimed_clauses = false;
 
+    //Packed copy of the elimed clauses for extend_model(), in the order they
+    //are extended, with the replaced literals already applied. Per var:
+    //elimed-on lit, number of words that follow, then size + lits per clause
+    vector<uint32_t> elimed_packed;
+    uint32_t elimed_packed_vars = 0;
+    bool elimed_packed_built = false;
+    size_t elimed_packed_replaced = 0; ///<Num replaced vars when built
+    vector<uint32_t> elimed_packed_occ_start; ///<var -> its range in occ
+    vector<uint32_t> elimed_packed_occ; ///<packed entries a var appears in
+    vector<uint8_t> elimed_packed_dirty;
+    vector<lbool> extend_prev_in; ///<model before the previous extension
+    vector<lbool> extend_prev_out; ///<model after the previous extension
+    void build_elimed_packed();
+    void mark_elimed_packed_dirty(const uint32_t var);
+
     ///Stats from this run
     Stats runStats;
 
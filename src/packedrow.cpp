@@ -29,6 +29,11 @@ THE SOFTWARE.
 
 #include "packedrow.h"
 
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define PACKEDROW_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
 // #define VERBOSE_DEBUG
 // #define SLOW_DEBUG
 
@@ -64,10 +69,13 @@ uint32_t PackedRow::find_watchVar(
     non_resp_var = numeric_limits<uint32_t>::max();
     tmp_clause.clear();
 
-    for(int i = 0; i < size*64; i++) {
-        if (this->operator[](i)){
+    for(int i = 0; i < size; i++) {
+        uint64_t tmp = mp[i];
+        while (tmp) {
+            const uint32_t col = i*64 + scan_fwd_64b(tmp)-1;
+            tmp &= tmp-1;
             popcnt++;
-            uint32_t var = col_to_var[i];
+            uint32_t var = col_to_var[col];
             tmp_clause.push_back(Lit(var, false));
 
             if (!var_has_resp_row[var]) {
@@ -217,3 +225,326 @@ gret PackedRow::propGause(
     //Conflict
     return gret::confl;
 }
+
+//////////////////////
+// Row kernels
+//////////////////////
+
+static void xor_in_scalar(int64_t* a, const int64_t* b, int num)
+{
+    for (int i = 0; i < num; i++) {
+        a[i] ^= b[i];
+    }
+}
+
+static uint32_t popcnt_scalar(const int64_t* a, int num)
+{
+    uint32_t ret = 0;
+    for (int i = 0; i < num; i++) {
+        ret += __builtin_popcountll((uint64_t)a[i]);
+    }
+    return ret;
+}
+
+static uint32_t popcnt_at_least_2_scalar(const int64_t* a, int num)
+{
+    uint32_t ret = 0;
+    for (int i = 0; i < num && ret < 2; i++) {
+        ret += __builtin_popcountll((uint64_t)a[i]);
+    }
+    return ret;
+}
+
+static uint32_t set_and_until_popcnt_atleast2_scalar(
+    int64_t* out, const int64_t* a, const int64_t* b, int num)
+{
+    uint32_t pop = 0;
+    for (int i = 0; i < num && pop < 2; i++) {
+        out[i] = a[i] & b[i];
+        pop += __builtin_popcountll((uint64_t)out[i]);
+    }
+    return pop;
+}
+
+static const PackedRowKernels kernels_scalar = {
+    "scalar"
+    , xor_in_scalar
+    , popcnt_scalar
+    , popcnt_at_least_2_scalar
+    , set_and_until_popcnt_atleast2_scalar
+};
+
+#ifdef PACKEDROW_X86_DISPATCH
+//Without -mpopcnt, __builtin_popcountll is a libgcc call. These are the
+//same loops, but with the POPCNT instruction.
+__attribute__((target("popcnt")))
+static uint32_t popcnt_hw(const int64_t* a, int num)
+{
+    uint64_t r0 = 0, r1 = 0;
+    int i = 0;
+    for (; i + 2 <= num; i += 2) {
+        r0 += _mm_popcnt_u64(a[i]);
+        r1 += _mm_popcnt_u64(a[i+1]);
+    }
+    if (i < num) r0 += _mm_popcnt_u64(a[i]);
+    return r0 + r1;
+}
+
+__attribute__((target("popcnt")))
+static uint32_t popcnt_at_least_2_hw(const int64_t* a, int num)
+{
+    uint32_t ret = 0;
+    for (int i = 0; i < num && ret < 2; i++) {
+        ret += _mm_popcnt_u64(a[i]);
+    }
+    return ret;
+}
+
+__attribute__((target("popcnt")))
+static uint32_t set_and_until_popcnt_atleast2_hw(
+    int64_t* out, const int64_t* a, const int64_t* b, int num)
+{
+    uint32_t pop = 0;
+    for (int i = 0; i < num && pop < 2; i++) {
+        out[i] = a[i] & b[i];
+        pop += _mm_popcnt_u64(out[i]);
+    }
+    return pop;
+}
+
+__attribute__((target("avx2")))
+static void xor_in_avx2(int64_t* a, const int64_t* b, int num)
+{
+    int i = 0;
+    for (; i + 4 <= num; i += 4) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*)(a+i));
+        const __m256i y = _mm256_loadu_si256((const __m256i*)(b+i));
+        _mm256_storeu_si256((__m256i*)(a+i), _mm256_xor_si256(x, y));
+    }
+    for (; i < num; i++) {
+        a[i] ^= b[i];
+    }
+}
+
+//Nibble lookup with PSHUFB, summed up with PSADBW (W. Mula)
+__attribute__((target("avx2,popcnt")))
+static uint32_t popcnt_avx2(const int64_t* a, int num)
+{
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 4 <= num; i += 4) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(a+i));
+        const __m256i lo = _mm256_and_si256(v, low_mask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        const __m256i cnt = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lookup, lo),
+            _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+    uint64_t ret = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+        + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+    for (; i < num; i++) {
+        ret += _mm_popcnt_u64(a[i]);
+    }
+    return ret;
+}
+
+//These almost always stop within the first few words, so only all-zero
+//blocks are skipped with SIMD, the rest is counted with POPCNT
+__attribute__((target("avx2,popcnt")))
+static uint32_t popcnt_at_least_2_avx2(const int64_t* a, int num)
+{
+    uint32_t ret = 0;
+    int i = 0;
+    for (; i + 4 <= num; i += 4) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(a+i));
+        if (_mm256_testz_si256(v, v)) continue;
+        ret += _mm_popcnt_u64(a[i]) + _mm_popcnt_u64(a[i+1])
+            + _mm_popcnt_u64(a[i+2]) + _mm_popcnt_u64(a[i+3]);
+        if (ret >= 2) return ret;
+    }
+    for (; i < num && ret < 2; i++) {
+        ret += _mm_popcnt_u64(a[i]);
+    }
+    return ret;
+}
+
+__attribute__((target("avx2,popcnt")))
+static uint32_t set_and_until_popcnt_atleast2_avx2(
+    int64_t* out, const int64_t* a, const int64_t* b, int num)
+{
+    uint32_t pop = 0;
+    int i = 0;
+    for (; i + 4 <= num; i += 4) {
+        const __m256i v = _mm256_and_si256(
+            _mm256_loadu_si256((const __m256i*)(a+i)),
+            _mm256_loadu_si256((const __m256i*)(b+i)));
+        _mm256_storeu_si256((__m256i*)(out+i), v);
+        if (_mm256_testz_si256(v, v)) continue;
+        pop += _mm_popcnt_u64(out[i]) + _mm_popcnt_u64(out[i+1])
+            + _mm_popcnt_u64(out[i+2]) + _mm_popcnt_u64(out[i+3]);
+        if (pop >= 2) return pop;
+    }
+    for (; i < num && pop < 2; i++) {
+        out[i] = a[i] & b[i];
+        pop += _mm_popcnt_u64(out[i]);
+    }
+    return pop;
+}
+
+#define AVX512_TARGET __attribute__((target("avx512f,avx512vpopcntdq")))
+
+//_mm512_reduce_add_epi64() trips -Wuninitialized in some GCC headers
+AVX512_TARGET
+static inline uint64_t hsum_avx512(const __m512i v)
+{
+    uint64_t tmp[8];
+    _mm512_storeu_si512((void*)tmp, v);
+    return tmp[0] + tmp[1] + tmp[2] + tmp[3] + tmp[4] + tmp[5] + tmp[6] + tmp[7];
+}
+
+AVX512_TARGET
+static void xor_in_avx512(int64_t* a, const int64_t* b, int num)
+{
+    int i = 0;
+    for (; i + 8 <= num; i += 8) {
+        const __m512i x = _mm512_loadu_si512((const void*)(a+i));
+        const __m512i y = _mm512_loadu_si512((const void*)(b+i));
+        _mm512_storeu_si512((void*)(a+i), _mm512_xor_si512(x, y));
+    }
+    if (i < num) {
+        const __mmask8 m = (__mmask8)((1U << (num-i)) - 1);
+        const __m512i x = _mm512_maskz_loadu_epi64(m, a+i);
+        const __m512i y = _mm512_maskz_loadu_epi64(m, b+i);
+        _mm512_mask_storeu_epi64(a+i, m, _mm512_xor_si512(x, y));
+    }
+}
+
+AVX512_TARGET
+static uint32_t popcnt_avx512(const int64_t* a, int num)
+{
+    __m512i acc = _mm512_setzero_si512();
+    int i = 0;
+    for (; i + 8 <= num; i += 8) {
+        const __m512i v = _mm512_loadu_si512((const void*)(a+i));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+    }
+    if (i < num) {
+        const __mmask8 m = (__mmask8)((1U << (num-i)) - 1);
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(m, a+i)));
+    }
+    return hsum_avx512(acc);
+}
+
+AVX512_TARGET
+static uint32_t popcnt_at_least_2_avx512(const int64_t* a, int num)
+{
+    uint32_t ret = 0;
+    for (int i = 0; i < num; i += 8) {
+        const __mmask8 m = (num-i >= 8) ? 0xff : (__mmask8)((1U << (num-i)) - 1);
+        const __m512i v = _mm512_maskz_loadu_epi64(m, a+i);
+        if (!_mm512_test_epi64_mask(v, v)) continue;
+        ret += hsum_avx512(_mm512_popcnt_epi64(v));
+        if (ret >= 2) return ret;
+    }
+    return ret;
+}
+
+AVX512_TARGET
+static uint32_t set_and_until_popcnt_atleast2_avx512(
+    int64_t* out, const int64_t* a, const int64_t* b, int num)
+{
+    uint32_t pop = 0;
+    for (int i = 0; i < num; i += 8) {
+        const __mmask8 m = (num-i >= 8) ? 0xff : (__mmask8)((1U << (num-i)) - 1);
+        const __m512i v = _mm512_and_si512(
+            _mm512_maskz_loadu_epi64(m, a+i),
+            _mm512_maskz_loadu_epi64(m, b+i));
+        _mm512_mask_storeu_epi64(out+i, m, v);
+        if (!_mm512_test_epi64_mask(v, v)) continue;
+        pop += hsum_avx512(_mm512_popcnt_epi64(v));
+        if (pop >= 2) return pop;
+    }
+    return pop;
+}
+#undef AVX512_TARGET
+
+static const PackedRowKernels kernels_popcnt = {
+    "popcnt"
+    , xor_in_scalar
+    , popcnt_hw
+    , popcnt_at_least_2_hw
+    , set_and_until_popcnt_atleast2_hw
+};
+
+static const PackedRowKernels kernels_avx2 = {
+    "avx2"
+    , xor_in_avx2
+    , popcnt_avx2
+    , popcnt_at_least_2_avx2
+    , set_and_until_popcnt_atleast2_avx2
+};
+
+static const PackedRowKernels kernels_avx512 = {
+    "avx512"
+    , xor_in_avx512
+    , popcnt_avx512
+    , popcnt_at_least_2_avx512
+    , set_and_until_popcnt_atleast2_avx512
+};
+
+static bool cpu_has_kernels(const PackedRowKernels& k)
+{
+    __builtin_cpu_init();
+    if (&k == &kernels_avx512) {
+        return __builtin_cpu_supports("avx512f")
+            && __builtin_cpu_supports("avx512vpopcntdq");
+    }
+    if (&k == &kernels_avx2) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    }
+    if (&k == &kernels_popcnt) {
+        return __builtin_cpu_supports("popcnt");
+    }
+    return true;
+}
+#endif //PACKEDROW_X86_DISPATCH
+
+static PackedRowKernels best_packedrow_kernels()
+{
+    #ifdef PACKEDROW_X86_DISPATCH
+    if (cpu_has_kernels(kernels_avx512)) return kernels_avx512;
+    if (cpu_has_kernels(kernels_avx2)) return kernels_avx2;
+    if (cpu_has_kernels(kernels_popcnt)) return kernels_popcnt;
+    #endif
+    return kernels_scalar;
+}
+
+PackedRowKernels CMSat::packedrow_kernels = best_packedrow_kernels();
+
+bool CMSat::select_packedrow_kernels(const std::string& which)
+{
+    if (which == "auto") {
+        packedrow_kernels = best_packedrow_kernels();
+        return true;
+    }
+    if (which == "scalar") {
+        packedrow_kernels = kernels_scalar;
+        return true;
+    }
+
+    #ifdef PACKEDROW_X86_DISPATCH
+    for(const PackedRowKernels* k: {&kernels_popcnt, &kernels_avx2, &kernels_avx512}) {
+        if (which == k->name) {
+            if (!cpu_has_kernels(*k)) return false;
+            packedrow_kernels = *k;
+            return true;
+        }
+    }
+    #endif
+    return false;
+}
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <iostream>
 #include <algorithm>
 #include <limits>
+#include <string>
 
 #include "solvertypes.h"
 #include "Vec.h"
@@ -43,6 +44,25 @@ using std::vector;
 class PackedMatrix;
 class EGaussian;
 
+//Kernels over the int64_t words of a row, without the RHS. The best one
+//for the CPU is picked at startup, see packedrow.cpp. Rows shorter than
+//PACKEDROW_MIN_DISPATCH words are handled inline, the call isn't worth it.
+struct PackedRowKernels
+{
+    const char* name;
+    void (*xor_in)(int64_t* a, const int64_t* b, int num);
+    uint32_t (*popcnt)(const int64_t* a, int num);
+    uint32_t (*popcnt_at_least_2)(const int64_t* a, int num);
+    uint32_t (*set_and_until_popcnt_atleast2)(
+        int64_t* out, const int64_t* a, const int64_t* b, int num);
+};
+extern PackedRowKernels packedrow_kernels;
+static const int PACKEDROW_MIN_DISPATCH = 4;
+
+//"auto", "scalar", "popcnt", "avx2" or "avx512". Returns false if the CPU
+//doesn't support it, in which case nothing changes.
+bool select_packedrow_kernels(const std::string& which);
+
 class PackedRow
 {
 public:
@@ -126,6 +146,10 @@ public:
         assert(b.size == size);
         #endif
 
+        if (size >= PACKEDROW_MIN_DISPATCH) {
+            return packedrow_kernels.set_and_until_popcnt_atleast2(mp, a.mp, b.mp, size);
+        }
+
         uint32_t pop = 0;
         for (int i = 0; i < size && pop < 2; i++) {
             *(mp + i) = *(a.mp + i) & *(b.mp + i);
@@ -144,6 +168,10 @@ public:
         #endif
 
         rhs_internal ^= b.rhs_internal;
+        if (size >= PACKEDROW_MIN_DISPATCH) {
+            packedrow_kernels.xor_in(mp, b.mp, size);
+            return;
+        }
         for (int i = 0; i < size; i++) {
             *(mp + i) ^= *(b.mp + i);
         }
@@ -301,6 +329,10 @@ inline std::ostream& operator << (std::ostream& os, const PackedRow& m)
 
 inline uint32_t PackedRow::popcnt_at_least_2() const
 {
+    if (size >= PACKEDROW_MIN_DISPATCH) {
+        return packedrow_kernels.popcnt_at_least_2(mp, size);
+    }
+
     uint32_t ret = 0;
     for (int i = 0; i < size && ret < 2; i++) {
         ret += __builtin_popcountll((uint64_t)mp[i]);
@@ -310,6 +342,10 @@ inline uint32_t PackedRow::popcnt_at_least_2() const
 
 inline uint32_t PackedRow::popcnt() const
 {
+    if (size >= PACKEDROW_MIN_DISPATCH) {
+        return packedrow_kernels.popcnt(mp, size);
+    }
+
     uint32_t ret = 0;
     for (int i = 0; i < size; i++) {
         ret += __builtin_popcountll((uint64_t)mp[i]);
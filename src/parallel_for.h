@@ -0,0 +1,138 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef PARALLEL_FOR_H_
+#define PARALLEL_FOR_H_
+
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace CMSat {
+
+// Runs f(tid, begin, end) on num_threads threads over [0, n)
+template<class F>
+void parallel_for(const uint32_t num_threads, const uint64_t n, F f)
+{
+    if (num_threads <= 1 || n < num_threads) {
+        f(0, 0, n);
+        return;
+    }
+    std::vector<std::thread> thds;
+    for(uint32_t t = 0; t < num_threads; t++) {
+        const uint64_t begin = n*t/num_threads;
+        const uint64_t end = n*(t+1)/num_threads;
+        thds.push_back(std::thread([=, &f]() { f(t, begin, end); }));
+    }
+    for(auto& t: thds) t.join();
+}
+
+// Same as parallel_for(), but the threads are started once and kept for
+// many calls. For callers that run lots of short loops, where starting
+// threads every time would cost more than the loop itself.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(const uint32_t _num_threads) :
+        num_threads(std::max<uint32_t>(_num_threads, 1))
+    {
+        for(uint32_t t = 1; t < num_threads; t++) {
+            thds.push_back(std::thread([this, t]() { work(t); }));
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            stop = true;
+        }
+        start_cv.notify_all();
+        for(auto& t: thds) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    uint32_t size() const { return num_threads; }
+
+    // Runs f(tid, begin, end) over [0, n), the calling thread is tid 0
+    template<class F>
+    void run(const uint64_t n, F f)
+    {
+        if (num_threads <= 1 || n < num_threads) {
+            f(0, 0, n);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            job = [&f](uint32_t tid, uint64_t begin, uint64_t end) { f(tid, begin, end); };
+            job_n = n;
+            running = num_threads-1;
+            generation++;
+        }
+        start_cv.notify_all();
+        f(0, 0, n/num_threads);
+
+        std::unique_lock<std::mutex> lock(mu);
+        done_cv.wait(lock, [this]() { return running == 0; });
+        job = nullptr;
+    }
+
+private:
+    void work(const uint32_t tid)
+    {
+        uint64_t seen_generation = 0;
+        while(true) {
+            std::unique_lock<std::mutex> lock(mu);
+            start_cv.wait(lock, [&]() { return stop || generation != seen_generation; });
+            if (stop) return;
+            seen_generation = generation;
+            const uint64_t n = job_n;
+            lock.unlock();
+
+            job(tid, n*tid/num_threads, n*(tid+1)/num_threads);
+
+            lock.lock();
+            if (--running == 0) done_cv.notify_one();
+        }
+    }
+
+    const uint32_t num_threads;
+    std::vector<std::thread> thds;
+    std::mutex mu;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    std::function<void(uint32_t, uint64_t, uint64_t)> job;
+    uint64_t job_n = 0;
+    uint64_t generation = 0;
+    uint32_t running = 0;
+    bool stop = false;
+};
+
+}
+
+#endif //PARALLEL_FOR_H_
@@ -331,11 +331,11 @@ vector<Lit>* PropEngine::get_bnn_reason(BNN* bnn, Lit lit)
         return &bnn_confl_reason;
     }
 
-    auto& reason = varData[lit.var()].reason;
+    auto& reason = varHot[lit.var()].reason;
 //     cout
-//     << " reason lev: " << varData[lit.var()].level
+//     << " reason lev: " << varHot[lit.var()].level
 //     << " sublev: " << varData[lit.var()].sublevel
-//     << " reason type: " << varData[lit.var()].reason.getType()
+//     << " reason type: " << varHot[lit.var()].reason.getType()
 //     << endl;
     assert(reason.isBNN());
     if (reason.bnn_reason_set()) {
@@ -583,7 +583,7 @@ bool PropEngine::prop_long_cl_any_order(
             uint32_t nMaxInd = 1;
             // pass over all the literals in the clause and find the one with the biggest level
             for (uint32_t nInd = 2; nInd < c.size(); ++nInd) {
-                uint32_t nLevel = varData[c[nInd].var()].level;
+                uint32_t nLevel = varHot[c[nInd].var()].level;
                 if (nLevel > nMaxLevel) {
                     nMaxLevel = nLevel;
                     nMaxInd = nInd;
@@ -649,7 +649,7 @@ PropBy PropEngine::propagate_any_order()
 
     while (qhead < trail.size() && confl.isNULL()) {
         const Lit p = trail[qhead].lit;     // 'p' is enqueued fact to propagate.
-        varData[p.var()].propagated = true;
+        if (!bnns.empty()) varData[p.var()].propagated = true;
         watch_subarray ws = watches[~p];
         uint32_t currLevel = trail[qhead].lev;
 
@@ -777,11 +777,11 @@ void PropEngine::updateVars(
 void PropEngine::print_trail()
 {
     for(size_t i = trail_lim[0]; i < trail.size(); i++) {
-        assert(varData[trail[i].lit.var()].level == trail[i].lev);
+        assert(varHot[trail[i].lit.var()].level == trail[i].lev);
         cout
         << "trail " << i << ":" << trail[i].lit
         << " lev: " << trail[i].lev
-        << " reason: " << varData[trail[i].lit.var()].reason
+        << " reason: " << varHot[trail[i].lit.var()].reason
         << endl;
     }
 }
@@ -919,6 +919,7 @@ void PropEngine::sql_dump_vardata_picktime(uint32_t v, PropBy from)
         solver
         , outer_var
         , varData[v]
+        , varHot[v]
         , rel_activity_at_picktime
     );
 }
@@ -264,6 +264,7 @@ public:
 
 protected:
     friend class DataSync;
+    friend class Cuber;
     int64_t simpDB_props = 0;
     void new_var(
         const bool bva,
@@ -428,7 +429,7 @@ uint32_t PropEngine::calc_glue(const T& ps)
     MYFLAG++;
     uint32_t nblevels = 0;
     for (Lit lit: ps) {
-        int l = varData[lit.var()].level;
+        int l = varHot[lit.var()].level;
         if (l != 0 && permDiff[l] != MYFLAG) {
             permDiff[l] = MYFLAG;
             nblevels++;
@@ -596,9 +597,9 @@ void PropEngine::enqueue(const Lit p, const uint32_t level, const PropBy from, b
 
     const bool sign = p.sign();
     assigns[v] = boolToLBool(!sign);
-    varData[v].reason = from;
-    varData[v].level = level;
-    varData[v].sublevel = trail.size();
+    varHot[v].reason = from;
+    varHot[v].level = level;
+    if (!bnns.empty()) varData[v].sublevel = trail.size();
     if (!inprocess) {
         #ifdef STATS_NEEDED
         if (sign) {
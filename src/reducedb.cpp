@@ -24,16 +24,19 @@ THE SOFTWARE.
 #include "solver.h"
 #include "solverconf.h"
 #include "sqlstats.h"
+#include "datasync.h"
 #ifdef FINAL_PREDICTOR
 #include "cl_predictors_xgb.h"
 #include "cl_predictors_lgbm.h"
 #include "cl_predictors_py.h"
+#include "cl_predictors_tree.h"
 #endif
 
 // #define VERBOSE_DEBUG
 
 
 #include <functional>
+#include <unordered_map>
 #include <cmath>
 
 using namespace CMSat;
@@ -200,6 +203,7 @@ ReduceDB::ReduceDB(Solver* _solver) :
 ReduceDB::~ReduceDB()
 {
     #ifdef FINAL_PREDICTOR
+    delete pred_async;
     //delete predictors;
     #endif
 }
@@ -684,8 +688,37 @@ void ReduceDB::pred_move_to_lev1_and_lev0()
     solver->longRedCls[2].resize(j);
 }
 
+void ReduceDB::set_up_pred_input(const Clause* cl, float* data)
+{
+    const auto& stats_extra = solver->red_stats_extra[cl->stats.extra_pos];
+    double act_ranking_rel = safe_div(stats_extra.act_ranking, commdata.all_learnt_size);
+    double uip1_ranking_rel = safe_div(stats_extra.uip1_ranking, commdata.all_learnt_size);
+    double prop_ranking_rel = safe_div(stats_extra.prop_ranking, commdata.all_learnt_size);
+    double sum_uip1_per_time_ranking_rel = safe_div(stats_extra.sum_uip1_per_time_ranking, commdata.all_learnt_size);
+    double sum_props_per_time_ranking_rel = safe_div(stats_extra.sum_props_per_time_ranking, commdata.all_learnt_size);
+
+    int ret = predictors->set_up_input(
+        cl,
+        solver->sumConflicts,
+        act_ranking_rel,
+        uip1_ranking_rel,
+        prop_ranking_rel,
+        stats_extra.sum_uip1_per_time_ranking,
+        stats_extra.sum_props_per_time_ranking,
+        sum_uip1_per_time_ranking_rel,
+        sum_props_per_time_ranking_rel,
+        commdata,
+        solver,
+        data
+    );
+    assert(ret == predictors->get_step_size());
+}
+
 void ReduceDB::update_preds(const vector<ClOffset>& offs)
 {
+    //Already set by apply_async_preds()
+    if (pred_async) return;
+
     int step_size = predictors->get_step_size();
     float* data_orig = (float*)malloc(step_size*offs.size()*sizeof(float));
     memset(data_orig, 0, step_size*offs.size()*sizeof(float));
@@ -701,33 +734,13 @@ void ReduceDB::update_preds(const vector<ClOffset>& offs)
         Clause* cl = solver->cl_alloc.ptr(offset);
         auto& stats_extra = solver->red_stats_extra[cl->stats.extra_pos];
 
-        double act_ranking_rel = safe_div(stats_extra.act_ranking, commdata.all_learnt_size);
-        double uip1_ranking_rel = safe_div(stats_extra.uip1_ranking, commdata.all_learnt_size);
-        double prop_ranking_rel = safe_div(stats_extra.prop_ranking, commdata.all_learnt_size);
-        double sum_uip1_per_time_ranking_rel = safe_div(stats_extra.sum_uip1_per_time_ranking, commdata.all_learnt_size);
-        double sum_props_per_time_ranking_rel = safe_div(stats_extra.sum_props_per_time_ranking, commdata.all_learnt_size);
-
         stats_extra.pred_short_use = 0;
         stats_extra.pred_long_use = 0;
         stats_extra.pred_forever_use = 0;
         assert(stats_extra.introduced_at_conflict <= solver->sumConflicts);
         uint64_t age = solver->sumConflicts - stats_extra.introduced_at_conflict;
         if (age > solver->conf.every_pred_reduce) {
-            int ret = predictors->set_up_input(
-                cl,
-                solver->sumConflicts,
-                act_ranking_rel,
-                uip1_ranking_rel,
-                prop_ranking_rel,
-                stats_extra.sum_uip1_per_time_ranking,
-                stats_extra.sum_props_per_time_ranking,
-                sum_uip1_per_time_ranking_rel,
-                sum_props_per_time_ranking_rel,
-                commdata,
-                solver,
-                data
-            );
-            assert(ret == step_size);
+            set_up_pred_input(cl, data);
             data_at++;
             data += step_size;
         }
@@ -752,6 +765,85 @@ void ReduceDB::update_preds(const vector<ClOffset>& offs)
     free(data_orig);
 }
 
+//Applies the predictions made in the background since the last reduction.
+//If they are not ready in time, or are too old, clauses are ranked by glue
+//and activity instead.
+void ReduceDB::apply_async_preds(const vector<ClOffset>& all_learnt)
+{
+    PredBatch batch;
+    const bool ready = pred_async->collect(solver->conf.pred_async_wait_ms, batch);
+    const bool fresh = ready
+        && solver->sumConflicts - batch.at_conflict <= solver->conf.pred_async_max_age;
+
+    if (!fresh) {
+        pred_async_fallback++;
+        for(const auto& offset: all_learnt) {
+            const Clause* cl = solver->cl_alloc.ptr(offset);
+            auto& stats_extra = solver->red_stats_extra[cl->stats.extra_pos];
+            double score = 1.0 - safe_div(stats_extra.act_ranking, commdata.all_learnt_size);
+            if (cl->stats.glue <= solver->conf.glue_put_lev0_if_below_or_eq) score += 2.0;
+            else if (cl->stats.glue <= solver->conf.glue_put_lev1_if_below_or_eq) score += 1.0;
+            stats_extra.pred_short_use = score;
+            stats_extra.pred_long_use = score;
+            stats_extra.pred_forever_use = score;
+        }
+        verb_print(2, "[DBCL pred] async predictions "
+            << (ready ? "too old" : "not ready") << ", ranking by glue and activity");
+        return;
+    }
+
+    pred_async_applied++;
+    std::unordered_map<int32_t, uint32_t> row;
+    row.reserve(batch.ids.size());
+    for(uint32_t i = 0; i < batch.ids.size(); i++) row[batch.ids[i]] = i;
+
+    uint32_t found = 0;
+    for(const auto& offset: all_learnt) {
+        const Clause* cl = solver->cl_alloc.ptr(offset);
+        auto& stats_extra = solver->red_stats_extra[cl->stats.extra_pos];
+        stats_extra.pred_short_use = 0;
+        stats_extra.pred_long_use = 0;
+        stats_extra.pred_forever_use = 0;
+
+        //Clauses learnt or changed since the batch was submitted stay at 0
+        const auto it = row.find(cl->stats.ID);
+        if (it == row.end()) continue;
+        found++;
+        stats_extra.pred_short_use = batch.pred_short[it->second];
+        stats_extra.pred_long_use = batch.pred_long[it->second];
+        stats_extra.pred_forever_use = batch.pred_forever[it->second];
+    }
+    verb_print(2, "[DBCL pred] async predictions applied: " << found
+        << " of " << batch.ids.size()
+        << " age: " << solver->sumConflicts - batch.at_conflict
+        << " inference T: " << std::setprecision(2) << batch.time_used);
+}
+
+//Takes a snapshot of the features of all clauses old enough to predict and
+//hands it to the background thread
+void ReduceDB::submit_async_preds()
+{
+    const int step_size = predictors->get_step_size();
+    PredBatch batch;
+    batch.at_conflict = solver->sumConflicts;
+    for(const auto& cls: solver->longRedCls) {
+        for(const auto& offset: cls) {
+            const Clause* cl = solver->cl_alloc.ptr(offset);
+            const auto& stats_extra = solver->red_stats_extra[cl->stats.extra_pos];
+            assert(stats_extra.introduced_at_conflict <= solver->sumConflicts);
+            const uint64_t age = solver->sumConflicts - stats_extra.introduced_at_conflict;
+            if (age <= solver->conf.every_pred_reduce) continue;
+
+            batch.ids.push_back(cl->stats.ID);
+            batch.data.resize(batch.data.size() + step_size);
+            set_up_pred_input(cl, batch.data.data() + batch.data.size() - step_size);
+        }
+    }
+    if (!pred_async->submit(std::move(batch))) {
+        verb_print(2, "[DBCL pred] previous async prediction still running, not submitting");
+    }
+}
+
 void ReduceDB::update_preds_lev2()
 {
     double myTime = cpuTime();
@@ -840,6 +932,7 @@ void ReduceDB::clean_lev0_once_in_a_while()
                 solver->watches.smudge((*cl)[1]);
                 solver->litStats.redLits -= cl->size();
 
+                if (cl->stats.is_imported) solver->datasync->signal_imported_cl_deleted();
                 *solver->frat << del << *cl << fin;
                 cl->setRemoved();
                 delayed_clause_free.push_back(offset);
@@ -918,6 +1011,7 @@ void ReduceDB::clean_lev1_once_in_a_while()
                 solver->watches.smudge((*cl)[1]);
                 solver->litStats.redLits -= cl->size();
 
+                if (cl->stats.is_imported) solver->datasync->signal_imported_cl_deleted();
                 *solver->frat << del << *cl << fin;
                 cl->setRemoved();
                 delayed_clause_free.push_back(offset);
@@ -979,6 +1073,7 @@ void ReduceDB::delete_from_lev2()
             solver->watches.smudge((*cl)[1]);
             solver->litStats.redLits -= cl->size();
 
+            if (cl->stats.is_imported) solver->datasync->signal_imported_cl_deleted();
             *solver->frat << del << *cl << fin;
             cl->setRemoved();
             delayed_clause_free.push_back(offset);
@@ -1068,8 +1163,10 @@ void ReduceDB::handle_predictors()
             predictors = new ClPredictorsLGBM;
         } else if (solver->conf.predictor_type == "py") {
             predictors = new ClPredictorsPy;
+        } else if (solver->conf.predictor_type == "tree") {
+            predictors = new ClPredictorsTree;
         } else {
-            cout << "ERROR: You must give either lgbm or xgboost for predictor" << endl;
+            cout << "ERROR: You must give either lgbm, xgb, py or tree for predictor" << endl;
             exit(-1);
         }
         if (solver->conf.pred_conf_location.empty()) {
@@ -1087,13 +1184,16 @@ void ReduceDB::handle_predictors()
         } else {
             vector<string> locations;
             vector<string> tiers = {"short", "long", "forever"};
+            //The native evaluator reads the LightGBM models
+            const string model_type = solver->conf.predictor_type == "tree" ?
+                "lgbm" : solver->conf.predictor_type;
             for (uint32_t i = 0; i < 3; i ++) {
                 locations.push_back(solver->conf.pred_conf_location + "/" +
                 std::string("predictor-")
                 + (solver->conf.pred_tables[i] == '0' ? "used_later" : "used_later_anc")
                 + "-"
                 + tiers[i] + "-"
-                + solver->conf.predictor_type
+                + model_type
                 + std::string(".json"));
             }
 
@@ -1116,6 +1216,9 @@ void ReduceDB::handle_predictors()
                 cout << endl;
             }
         }
+        if (solver->conf.pred_async) {
+            pred_async = new ClPredictorsAsync(predictors);
+        }
     }
 
     assert(delayed_clause_free.empty());
@@ -1136,6 +1239,7 @@ void ReduceDB::handle_predictors()
         total_sum_uip1_used,
         all_learnt.size(),
         median_data);
+    if (pred_async) apply_async_preds(all_learnt);
 
     //Move clauses around
     T2_deleted = 0;
@@ -1158,6 +1262,8 @@ void ReduceDB::handle_predictors()
     delete_from_lev2();
     clean_lev0_once_in_a_while();
     clean_lev1_once_in_a_while();
+    //Features must be taken before the per-round stats are reset
+    if (pred_async) submit_async_preds();
     reset_predict_stats();
 
     //Cleanup
@@ -1202,8 +1308,12 @@ void ReduceDB::handle_predictors()
 
         cout
         << "c [DBCL pred] "
-        << solver->conf.print_times(cpuTime()-myTime)
-        << endl;
+        << solver->conf.print_times(cpuTime()-myTime);
+        if (pred_async) {
+            cout << " async applied: " << pred_async_applied
+            << " fallback: " << pred_async_fallback;
+        }
+        cout << endl;
     }
 
     if (solver->sqlStats) {
@@ -1310,6 +1420,7 @@ void ReduceDB::remove_cl_from_lev2() {
         solver->watches.smudge((*cl)[1]);
         solver->litStats.redLits -= cl->size();
 
+        if (cl->stats.is_imported) solver->datasync->signal_imported_cl_deleted();
         *solver->frat << del << *cl << fin;
         cl->setRemoved();
         #ifdef VERBOSE_DEBUG
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "clauseallocator.h"
 #ifdef FINAL_PREDICTOR
 #include "cl_predictors_abs.h"
+#include "cl_predictors_async.h"
 #endif
 
 namespace CMSat {
@@ -101,7 +102,13 @@ private:
 
     #ifdef FINAL_PREDICTOR
     ClPredictorsAbst* predictors = NULL;
+    ClPredictorsAsync* pred_async = NULL;
     uint32_t num_times_pred_called = 0;
+    uint32_t pred_async_applied = 0;
+    uint32_t pred_async_fallback = 0;
+    void apply_async_preds(const vector<ClOffset>& all_learnt);
+    void submit_async_preds();
+    void set_up_pred_input(const Clause* cl, float* data);
     void update_preds_lev2();
     void pred_move_to_lev1_and_lev0();
     void delete_from_lev2();
@@ -174,7 +174,7 @@ inline void Searcher::add_lit_to_learnt(
     }
     #endif
 
-    if (varData[var].level == 0) {
+    if (varHot[var].level == 0) {
         if (frat->enabled()) {
             assert(value(var) != l_Undef);
             assert(unit_cl_IDs[var] != 0);
@@ -189,11 +189,11 @@ inline void Searcher::add_lit_to_learnt(
 
     if (!inprocess) {
         #ifdef STATS_NEEDED_BRANCH
-        if (varData[var].level != 0 &&
-            !level_used_for_cl_arr[varData[var].level]
+        if (varHot[var].level != 0 &&
+            !level_used_for_cl_arr[varHot[var].level]
         ) {
-            level_used_for_cl_arr[varData[var].level] = 1;
-            level_used_for_cl.push_back(varData[var].level);
+            level_used_for_cl_arr[varHot[var].level] = 1;
+            level_used_for_cl.push_back(varHot[var].level);
         }
         #endif
 
@@ -211,7 +211,7 @@ inline void Searcher::add_lit_to_learnt(
         }
     }
 
-    if (varData[var].level >= nDecisionLevel) {
+    if (varHot[var].level >= nDecisionLevel) {
         pathC++;
     } else {
         learnt_clause.push_back(lit);
@@ -228,7 +228,7 @@ inline void Searcher::recursiveConfClauseMin()
 
     size_t i, j;
     for (i = j = 1; i < learnt_clause.size(); i++) {
-        if (varData[learnt_clause[i].var()].reason.isNULL()
+        if (varHot[learnt_clause[i].var()].reason.isNULL()
             || !litRedundant(learnt_clause[i], abstract_level)
         ) {
             learnt_clause[j++] = learnt_clause[i];
@@ -241,7 +241,7 @@ void Searcher::normalClMinim()
 {
     size_t i,j;
     for (i = j = 1; i < learnt_clause.size(); i++) {
-        const PropBy& reason = varData[learnt_clause[i].var()].reason;
+        const PropBy& reason = varHot[learnt_clause[i].var()].reason;
         size_t size;
         Lit *lits = NULL;
         int32_t ID;
@@ -308,7 +308,7 @@ void Searcher::normalClMinim()
                     std::exit(-1);
             }
 
-            if (!seen[p.var()] && varData[p.var()].level > 0) {
+            if (!seen[p.var()] && varHot[p.var()].level > 0) {
                 learnt_clause[j++] = learnt_clause[i];
                 break;
             } else {
@@ -439,6 +439,10 @@ void Searcher::add_lits_to_learnt(
                 antec_data.longIrred++;
                 #endif
             }
+            if (cl->stats.is_imported && !cl->stats.imported_used && !inprocess) {
+                cl->stats.imported_used = true;
+                solver->datasync->signal_imported_cl_used();
+            }
             #if defined(NORMAL_CL_USE_STATS)
             cl->stats.uip1_used++;
             #endif
@@ -598,7 +602,7 @@ void Searcher::print_fully_minimized_learnt_clause() const
     if (conf.verbosity >= 6) {
         cout << "Final clause: " << learnt_clause << endl;
         for (uint32_t i = 0; i < learnt_clause.size(); i++) {
-            cout << "lev learnt_clause[" << i << "]:" << varData[learnt_clause[i].var()].level << endl;
+            cout << "lev learnt_clause[" << i << "]:" << varHot[learnt_clause[i].var()].level << endl;
         }
     }
 }
@@ -614,7 +618,7 @@ size_t Searcher::find_backtrack_level_of_learnt()
                 max_i = i;
         }
         std::swap(learnt_clause[max_i], learnt_clause[1]);
-        return varData[learnt_clause[1].var()].level;
+        return varHot[learnt_clause[1].var()].level;
     }
 }
 
@@ -652,7 +656,7 @@ void Searcher::create_learnt_clause(PropBy confl)
         default:
             assert(false);
     }
-    uint32_t nDecisionLevel = varData[lit0.var()].level;
+    uint32_t nDecisionLevel = varHot[lit0.var()].level;
 
     // 1st UIP clause generation
     learnt_clause.push_back(lit_Undef); //make space for ~p
@@ -667,8 +671,8 @@ void Searcher::create_learnt_clause(PropBy confl)
             assert(p != lit_Undef);
         } while(trail[index+1].lev < nDecisionLevel);
 
-        confl = varData[p.var()].reason;
-        assert(varData[p.var()].level > 0);
+        confl = varHot[p.var()].reason;
+        assert(varHot[p.var()].level > 0);
 
         //This clears out vars that haven't been added to learnt_clause,
         //but their 'seen' has been set
@@ -767,11 +771,11 @@ void Searcher::simple_create_learnt_clause(
             until = out_learnt.size();
         }
         p = trail[index + 1].lit;
-        confl = varData[p.var()].reason;
+        confl = varHot[p.var()].reason;
 
         //under normal circumstances this does not happen, but here, it can
         //reason is undefined for level 0
-        if (varData[p.var()].level == 0) {
+        if (varHot[p.var()].level == 0) {
             confl = PropBy();
         }
         seen[p.var()] = 0;
@@ -884,7 +888,7 @@ void Searcher::analyze_conflict(
     vars_used_for_cl.clear();
     for(auto& lev: level_used_for_cl) {
         vars_used_for_cl.push_back(trail[trail_lim[lev-1]].lit.var());
-        assert(varData[trail[trail_lim[lev-1]].lit.var()].reason == PropBy());
+        assert(varHot[trail[trail_lim[lev-1]].lit.var()].reason == PropBy());
         assert(level_used_for_cl_arr[lev] == 1);
         level_used_for_cl_arr[lev] = 0;
     }
@@ -930,7 +934,7 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
         #endif
 
         Lit p_analyze = analyze_stack.top();
-        const PropBy reason = varData[analyze_stack.top().var()].reason;
+        const PropBy reason = varHot[analyze_stack.top().var()].reason;
         PropByType type = reason.getType();
         analyze_stack.pop();
 
@@ -998,8 +1002,8 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
             }
             stats.recMinimCost++;
 
-            if (!seen[p2.var()] && varData[p2.var()].level > 0) {
-                if (!varData[p2.var()].reason.isNULL()
+            if (!seen[p2.var()] && varHot[p2.var()].level > 0) {
+                if (!varHot[p2.var()].reason.isNULL()
                     && (abstractLevel(p2.var()) & abstract_levels) != 0
                 ) {
                     seen[p2.var()] = 1;
@@ -1071,7 +1075,7 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
 
     //It's been set at level 0. The seen[] may not be large enough to do
     //seen[p.var()] -- we might have mem-saved that
-    if (varData[p.var()].level == 0) {
+    if (varHot[p.var()].level == 0) {
         return;
     }
 
@@ -1081,9 +1085,9 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
     for (int64_t i = (int64_t)trail.size() - 1; i >= (int64_t)trail_lim[0]; i--) {
         const uint32_t x = trail[i].lit.var();
         if (seen[x]) {
-            const PropBy reason = varData[x].reason;
+            const PropBy reason = varHot[x].reason;
             if (reason.isNULL()) {
-                assert(varData[x].level > 0);
+                assert(varHot[x].level > 0);
                 out_conflict.push_back(~trail[i].lit);
             } else {
                 int32_t ID;
@@ -1093,7 +1097,7 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
                         ID = cl.stats.ID;
                         assert(value(cl[0]) == l_True);
                         for(const Lit lit: cl) {
-                            if (varData[lit.var()].level > 0) {
+                            if (varHot[lit.var()].level > 0) {
                                 seen[lit.var()] = 1;
                             }
                         }
@@ -1104,7 +1108,7 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
                         vector<Lit>* cl = get_bnn_reason(
                             bnns[reason.getBNNidx()], lit_Undef);
                         for(const Lit lit: *cl) {
-                            if (varData[lit.var()].level > 0) {
+                            if (varHot[lit.var()].level > 0) {
                                 seen[lit.var()] = 1;
                             }
                         }
@@ -1113,7 +1117,7 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
 
                     case PropByType::binary_t: {
                         const Lit lit = reason.lit2();
-                        if (varData[lit.var()].level > 0) {
+                        if (varHot[lit.var()].level > 0) {
                             seen[lit.var()] = 1;
                         }
                         ID = reason.getID();
@@ -1125,7 +1129,7 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
                             get_reason(reason.get_row_num(), ID);
                         assert(value((*cl)[0]) == l_True);
                         for(const Lit lit: *cl) {
-                            if (varData[lit.var()].level > 0) {
+                            if (varHot[lit.var()].level > 0) {
                                 seen[lit.var()] = 1;
                             }
                         }
@@ -1319,6 +1323,21 @@ lbool Searcher::search()
             } else {
                 dec_ret = new_decision<false>();
             }
+            if (dec_ret == l_True
+                && solver->enumerating()
+                && !fast_backw.fast_backw_on
+            ) {
+                //Model reported and blocked, search goes on from the
+                //blocking level
+                if (!solver->enum_found_model(true)) {
+                    if (!solver->okay()) {
+                        search_ret = l_False;
+                        goto end;
+                    }
+                    params.needToStopSearch = true;
+                }
+                continue;
+            }
             if (dec_ret != l_Undef) {
                 search_ret = dec_ret;
                 goto end;
@@ -1537,7 +1556,7 @@ void Searcher::dump_var_for_learnt_cl(const uint32_t v,
     //When it's a decision clause, the REAL clause could have already
     //set some variable to having been propagated (due to asserting clause)
     //so this assert() no longer holds for all literals
-    assert(is_decision || varData[v].reason == PropBy());
+    assert(is_decision || varHot[v].reason == PropBy());
     if (varData[v].dump) {
         uint64_t outer_var = map_inter_to_outer(v);
         solver->sqlStats->dec_var_clid(
@@ -1695,6 +1714,7 @@ Clause* Searcher::handle_last_confl(
     }
     *frat << fin;
     VERBOSE_PRINT("Chain ID created: " << ID);
+    solver->datasync->signal_new_long_clause(learnt_clause, glue);
 
     if (learnt_clause.size() <= 2) {
         cl = NULL;
@@ -1822,7 +1842,6 @@ bool Searcher::handle_conflict(PropBy confl)
         , glue_before_minim         //return glue before minimization here
         , size_before_minim         //return glue before minimization here
     );
-    solver->datasync->signal_new_long_clause(learnt_clause);
     #ifdef USE_GPU
     solver->datasync->trySendAssignmentToGpu();
     #endif
@@ -1853,7 +1872,7 @@ bool Searcher::handle_conflict(PropBy confl)
         }
         for(Lit l: decision_clause) {
             seen[l.toInt()] = 0;
-            assert(varData[l.var()].reason == PropBy());
+            assert(varHot[l.var()].reason == PropBy());
         }
     }
 
@@ -2206,7 +2225,7 @@ void Searcher::rebuildOrderHeap()
     vs.reserve(nVars());
     for (uint32_t v = 0; v < nVars(); v++) {
         if (varData[v].removed != Removed::none
-            || (value(v) != l_Undef && varData[v].level == 0)
+            || (value(v) != l_Undef && varHot[v].level == 0)
         ) {
             continue;
         } else {
@@ -2804,7 +2823,7 @@ void Searcher::print_solution_varreplace_status() const
         if (varData[var].removed == Removed::replaced
             || varData[var].removed == Removed::elimed
         ) {
-            assert(value(var) == l_Undef || varData[var].level == 0);
+            assert(value(var) == l_Undef || varHot[var].level == 0);
         }
 
         if (conf.verbosity >= 6
@@ -2814,7 +2833,7 @@ void Searcher::print_solution_varreplace_status() const
             cout
             << "var: " << var
             << " value: " << value(var)
-            << " level:" << varData[var].level
+            << " level:" << varHot[var].level
             << " type: " << removed_type_to_string(varData[var].removed)
             << endl;
         }
@@ -3198,6 +3217,9 @@ void Searcher::consolidate_watches(const bool full)
         << conf.print_times(time_used)
         << endl;
     }
+    if (conf.verbosity >= 2) {
+        watches.print_stat();
+    }
 
     std::stringstream ss;
     ss << "consolidate " << (full ? "full" : "mini") << " watches";
@@ -3292,12 +3314,12 @@ void Searcher::cancelUntil(uint32_t blevel)
             assert(value(var) != l_Undef);
 
             //Clear out BNN reason on backtrack
-            if (varData[var].reason.isBNN() &&
-                varData[var].reason.bnn_reason_set())
+            if (varHot[var].reason.isBNN() &&
+                varHot[var].reason.bnn_reason_set())
             {
-                uint32_t reason_idx = varData[var].reason.get_bnn_reason();
+                uint32_t reason_idx = varHot[var].reason.get_bnn_reason();
                 bnn_reasons_empty_slots.push_back(reason_idx);
-                varData[var].reason = PropBy();
+                varHot[var].reason = PropBy();
             }
             if (!bnns.empty()) reverse_prop(trail[i].lit);
 
@@ -3305,7 +3327,7 @@ void Searcher::cancelUntil(uint32_t blevel)
             if (!inprocess) {
                 varData[var].last_canceled = sumConflicts;
             }
-            if (!inprocess && varData[var].reason == PropBy()) {
+            if (!inprocess && varHot[var].reason == PropBy()) {
                 //we want to dump & this was a decision var
                 uint64_t sumConflicts_during = sumConflicts - varData[var].sumConflicts_at_picktime;
                 uint64_t sumDecisions_during = sumDecisions - varData[var].sumDecisions_at_picktime;
@@ -3458,17 +3480,17 @@ ConflictData Searcher::find_conflict_level(PropBy& pb)
     ConflictData data;
 
     if (pb.getType() == PropByType::binary_t) {
-        data.nHighestLevel = varData[failBinLit.var()].level;
+        data.nHighestLevel = varHot[failBinLit.var()].level;
 
         if (data.nHighestLevel == decisionLevel()
-            && varData[pb.lit2().var()].level == decisionLevel()
+            && varHot[pb.lit2().var()].level == decisionLevel()
         ) {
             return data;
         }
 
         uint32_t highestId = 0;
         // find the largest decision level in the clause
-        uint32_t nLevel = varData[pb.lit2().var()].level;
+        uint32_t nLevel = varHot[pb.lit2().var()].level;
         if (nLevel > data.nHighestLevel) {
             highestId = 1;
             data.nHighestLevel = nLevel;
@@ -3519,9 +3541,9 @@ ConflictData Searcher::find_conflict_level(PropBy& pb)
                 break;
         }
 
-        data.nHighestLevel = varData[clause[0].var()].level;
+        data.nHighestLevel = varHot[clause[0].var()].level;
         if (data.nHighestLevel == decisionLevel()
-            && varData[clause[1].var()].level == decisionLevel()
+            && varHot[clause[1].var()].level == decisionLevel()
         ) {
             return data;
         }
@@ -3529,7 +3551,7 @@ ConflictData Searcher::find_conflict_level(PropBy& pb)
         uint32_t highestId = 0;
         // find the largest decision level in the clause
         for (uint32_t nLitId = 1; nLitId < size; ++nLitId) {
-            uint32_t nLevel = varData[clause[nLitId].var()].level;
+            uint32_t nLevel = varHot[clause[nLitId].var()].level;
             if (nLevel > data.nHighestLevel) {
                 highestId = nLitId;
                 data.nHighestLevel = nLevel;
@@ -3855,7 +3877,7 @@ PropBy Searcher::insert_gpu_clause(Lit* lits, uint32_t count)
     j = 0;
     for(uint32_t i = 0; i < count; i ++) {
         const Lit l = lits[i];
-        if (varData[l.var()].level == 0) {
+        if (varHot[l.var()].level == 0) {
             if (value(l) == l_True) {
                 return PropBy();
             }
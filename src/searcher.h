@@ -458,7 +458,7 @@ class Searcher : public HyperEngine
 
 inline uint32_t Searcher::abstractLevel(const uint32_t x) const
 {
-    return ((uint32_t)1) << (varData[x].level & 31);
+    return ((uint32_t)1) << (varHot[x].level & 31);
 }
 
 inline const SearchStats& Searcher::get_stats() const
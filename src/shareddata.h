@@ -31,20 +31,317 @@ THE SOFTWARE.
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include <memory>
+#include <limits>
+#include <algorithm>
 using std::vector;
 using std::mutex;
 
 namespace CMSat {
 
+//Long learnt clauses exported by a single thread. Only the owning thread
+//writes, all other threads read. Slots are overwritten in a ring, so every
+//slot carries a sequence number that lets readers detect (and skip) slots
+//that were overwritten while they were being read.
+class LongClRing
+{
+    public:
+        LongClRing(const uint32_t _num_slots, const uint32_t _max_size) :
+            num_slots(_num_slots)
+            , max_size(_max_size)
+            , slots(new Slot[_num_slots])
+            , lits(new std::atomic<uint32_t>[(size_t)_num_slots*_max_size])
+        {
+            written.store(0);
+        }
+
+        LongClRing(const LongClRing&) = delete;
+        LongClRing& operator=(const LongClRing&) = delete;
+
+        //Only called by the owning thread
+        void push(const vector<Lit>& cl, const uint32_t glue)
+        {
+            assert(cl.size() <= max_size);
+            const uint64_t at = written.load(std::memory_order_relaxed);
+            Slot& slot = slots[at % num_slots];
+            std::atomic<uint32_t>* dat = lits.get() + (at % num_slots)*max_size;
+
+            slot.seq.store(2*at+1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.size.store(cl.size(), std::memory_order_relaxed);
+            slot.glue.store(glue, std::memory_order_relaxed);
+            for(uint32_t i = 0; i < cl.size(); i++) {
+                dat[i].store(cl[i].toInt(), std::memory_order_relaxed);
+            }
+            slot.seq.store(2*at+2, std::memory_order_release);
+            written.store(at+1, std::memory_order_release);
+        }
+
+        //Number of clauses ever pushed
+        uint64_t get_written() const
+        {
+            return written.load(std::memory_order_acquire);
+        }
+
+        //Oldest position that can still be read
+        uint64_t get_oldest(const uint64_t upto) const
+        {
+            return (upto > num_slots) ? upto - num_slots : 0;
+        }
+
+        //Returns FALSE if the slot has been overwritten in the meanwhile
+        bool read(const uint64_t at, vector<Lit>& cl, uint32_t& glue) const
+        {
+            const Slot& slot = slots[at % num_slots];
+            const std::atomic<uint32_t>* dat = lits.get() + (at % num_slots)*max_size;
+
+            const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq != 2*at+2) {
+                return false;
+            }
+            const uint32_t sz = std::min(slot.size.load(std::memory_order_relaxed), max_size);
+            glue = slot.glue.load(std::memory_order_relaxed);
+            cl.resize(sz);
+            for(uint32_t i = 0; i < sz; i++) {
+                cl[i] = Lit::toLit(dat[i].load(std::memory_order_relaxed));
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot.seq.load(std::memory_order_relaxed) == seq;
+        }
+
+        uint32_t get_max_size() const
+        {
+            return max_size;
+        }
+
+        size_t mem_used() const
+        {
+            return (size_t)num_slots*(sizeof(Slot) + max_size*sizeof(uint32_t));
+        }
+
+    private:
+        struct Slot {
+            Slot() {
+                seq.store(0);
+                size.store(0);
+                glue.store(0);
+            }
+            std::atomic<uint64_t> seq;
+            std::atomic<uint32_t> size;
+            std::atomic<uint32_t> glue;
+        };
+
+        const uint32_t num_slots;
+        const uint32_t max_size;
+        std::unique_ptr<Slot[]> slots;
+        std::unique_ptr<std::atomic<uint32_t>[]> lits;
+        std::atomic<uint64_t> written;
+};
+
+//Binary clauses exported by a single thread. Only the owning thread writes,
+//and it publishes new entries by bumping 'num' with release semantics, so
+//readers never wait and never see a half-written entry. Storage is chunked
+//so that appending never moves already published entries.
+//
+//Every reader registers itself and reports how far it has read via
+//done_reading(). Once all registered readers are past a chunk, the writer
+//frees it, so memory is bounded by how far the slowest reader lags behind,
+//not by how long the solver has been running. If the lag would exceed
+//max_lag_chunks, push() drops the binary instead of waiting for the
+//readers, sharing resumes once they catch up.
+//
+//The writer keeps a small direct-mapped table of recently pushed binaries,
+//so the same binary learnt (or received) over and over is only stored once
+//in most cases. It is a filter, not a set: a binary evicted from the table
+//may be stored again, readers already deal with duplicates.
+class BinStore
+{
+    public:
+        BinStore(
+            const uint32_t _num_readers,
+            const uint32_t _max_lag_chunks = 1U << 12
+        ) :
+            num_readers(_num_readers)
+            , max_lag_chunks(_max_lag_chunks)
+            , chunks(new std::atomic<std::pair<Lit, Lit>*>[_max_lag_chunks])
+            , read_upto(new std::atomic<uint64_t>[_num_readers])
+            , recent(new uint64_t[recent_size])
+        {
+            for(uint32_t i = 0; i < recent_size; i++) {
+                recent[i] = 0;
+            }
+            for(uint32_t i = 0; i < max_lag_chunks; i++) {
+                chunks[i].store(NULL);
+            }
+            for(uint32_t i = 0; i < num_readers; i++) {
+                read_upto[i].store(not_reading);
+            }
+            num.store(0);
+            freed_chunks.store(0);
+        }
+
+        ~BinStore()
+        {
+            for(uint32_t i = 0; i < max_lag_chunks; i++) {
+                delete[] chunks[i].load();
+            }
+        }
+
+        BinStore(const BinStore&) = delete;
+        BinStore& operator=(const BinStore&) = delete;
+
+        //Must be called before the writer starts pushing, until then no
+        //reader holds back reclamation
+        void add_reader(const uint32_t reader)
+        {
+            assert(reader < num_readers);
+            assert(num.load() == 0);
+            read_upto[reader].store(0, std::memory_order_release);
+        }
+
+        //The reader will never again read anything below 'upto'
+        void done_reading(const uint32_t reader, const uint64_t upto)
+        {
+            assert(reader < num_readers);
+            assert(read_upto[reader].load(std::memory_order_relaxed) <= upto);
+            read_upto[reader].store(upto, std::memory_order_release);
+        }
+
+        //Only called by the owning thread. Returns FALSE if the binary was
+        //filtered as a duplicate or dropped because the readers lag too far
+        //behind, see full()
+        bool push(const Lit lit1, const Lit lit2)
+        {
+            //+1 so that the all-zero initial table never matches
+            const uint64_t key =
+                (((uint64_t)lit1.toInt() << 32) | lit2.toInt()) + 1;
+            uint64_t& slot = recent[(key * 0x9E3779B97F4A7C15ULL) >> (64-recent_bits)];
+            if (slot == key) {
+                return false;
+            }
+
+            const uint64_t at = num.load(std::memory_order_relaxed);
+            const uint64_t chunk = at >> chunk_bits;
+            if ((at & (chunk_size-1)) == 0) {
+                free_read_chunks();
+                if (chunk - freed_chunks.load(std::memory_order_relaxed)
+                    >= max_lag_chunks
+                ) {
+                    return false;
+                }
+            }
+            slot = key;
+
+            auto& dat_ptr = chunks[chunk % max_lag_chunks];
+            std::pair<Lit, Lit>* dat = dat_ptr.load(std::memory_order_relaxed);
+            if (dat == NULL) {
+                dat = new std::pair<Lit, Lit>[chunk_size];
+                dat_ptr.store(dat, std::memory_order_relaxed);
+            }
+            dat[at & (chunk_size-1)] = std::make_pair(lit1, lit2);
+            num.store(at+1, std::memory_order_release);
+            return true;
+        }
+
+        //Only meaningful for the owning thread. TRUE if the next push()
+        //would be dropped, because the slowest reader lags too far behind
+        bool full() const
+        {
+            const uint64_t n = num.load(std::memory_order_relaxed);
+            return (n & (chunk_size-1)) == 0
+                && (n >> chunk_bits) - freed_chunks.load(std::memory_order_relaxed)
+                    >= max_lag_chunks;
+        }
+
+        //Everything below this can be read without any locking
+        uint64_t get_num() const
+        {
+            return num.load(std::memory_order_acquire);
+        }
+
+        //Caller must make sure that at < get_num(), and that it is a
+        //registered reader that has not yet reported reading past 'at'
+        const std::pair<Lit, Lit>& at(const uint64_t at) const
+        {
+            const auto* dat = chunks[(at >> chunk_bits) % max_lag_chunks]
+                .load(std::memory_order_relaxed);
+            return dat[at & (chunk_size-1)];
+        }
+
+        size_t mem_used() const
+        {
+            const uint64_t n = get_num();
+            const uint64_t live = ((n+chunk_size-1) >> chunk_bits)
+                - freed_chunks.load(std::memory_order_relaxed);
+            size_t mem = (size_t)max_lag_chunks*sizeof(std::atomic<std::pair<Lit, Lit>*>);
+            mem += num_readers*sizeof(std::atomic<uint64_t>);
+            mem += recent_size*sizeof(uint64_t);
+            mem += live*chunk_size*sizeof(std::pair<Lit, Lit>);
+            return mem;
+        }
+
+        static constexpr uint32_t chunk_bits = 12;
+        static constexpr uint64_t chunk_size = 1ULL << chunk_bits;
+
+    private:
+        //Only called by the owning thread
+        void free_read_chunks()
+        {
+            uint64_t upto = num.load(std::memory_order_relaxed);
+            for(uint32_t i = 0; i < num_readers; i++) {
+                upto = std::min(upto, read_upto[i].load(std::memory_order_acquire));
+            }
+
+            uint64_t freed = freed_chunks.load(std::memory_order_relaxed);
+            for(; freed < (upto >> chunk_bits); freed++) {
+                auto& dat_ptr = chunks[freed % max_lag_chunks];
+                delete[] dat_ptr.load(std::memory_order_relaxed);
+                dat_ptr.store(NULL, std::memory_order_relaxed);
+            }
+            freed_chunks.store(freed, std::memory_order_relaxed);
+        }
+
+        static constexpr uint64_t not_reading = std::numeric_limits<uint64_t>::max();
+        static constexpr uint32_t recent_bits = 14;
+        static constexpr uint32_t recent_size = 1U << recent_bits;
+        const uint32_t num_readers;
+        const uint32_t max_lag_chunks;
+        std::unique_ptr<std::atomic<std::pair<Lit, Lit>*>[]> chunks;
+        std::unique_ptr<std::atomic<uint64_t>[]> read_upto;
+        std::unique_ptr<uint64_t[]> recent;
+        std::atomic<uint64_t> num;
+        std::atomic<uint64_t> freed_chunks;
+};
+
+//An XOR in outside numbering, see SharedData::xors
+struct SharedXor
+{
+    vector<uint32_t> vars;
+    bool rhs;
+};
+
 class SharedData
 {
     public:
-        SharedData(const uint32_t _num_threads) :
+        SharedData(
+            const uint32_t _num_threads,
+            const uint32_t long_cl_slots = 1U << 14,
+            const uint32_t long_cl_max_size = 30
+        ) :
+            #if defined(USE_MPI) && !defined(USE_GPU)
+            mpi_bins(_num_threads),
+            #endif
             num_threads(_num_threads)
         {
             #ifdef USE_GPU
             csOpts.verbosity = 0;
             gpuClauseSharer = GpuShare::makeGpuClauseSharerPtr(csOpts);
+            #else
+            for(uint32_t i = 0; i < num_threads; i++) {
+                bins.push_back(std::make_unique<BinStore>(num_bin_readers()));
+                long_cls.push_back(std::make_unique<LongClRing>(
+                    long_cl_slots, long_cl_max_size));
+            }
             #endif
             cur_thread_id.store(0);
         }
@@ -56,59 +353,75 @@ class SharedData
             #endif
         }
 
-        struct Spec {
-            Spec() :
-                data(new vector<Lit>)
-            {}
-
-            Spec(const Spec&) = delete;
-            Spec& operator=(const Spec&) = delete;
-            
-            Spec(Spec&& other)
-            #ifndef _MSC_VER
-            noexcept
-            #endif
-            :
-                data(std::move(other.data))
-            {
-                other.data = NULL;
-            }
-            ~Spec() {
-                clear();
-            }
-            vector<Lit>* data = NULL;
-
-            void clear()
-            {
-                delete data;
-                data = NULL;
-            }
-        };
-
         #ifdef USE_GPU
         GpuShare::GpuClauseSharerOptions csOpts;
         GpuShare::GpuClauseSharer* gpuClauseSharer = NULL;
         #else
-        vector<Spec> bins;
-        std::mutex bin_mutex;
+        //One per thread, indexed by DataSync::thread_id. The readers of
+        //each store are the other threads, by thread_id, plus under MPI
+        //thread 0 forwarding it to the other nodes as reader num_threads
+        vector<std::unique_ptr<BinStore>> bins;
+        vector<std::unique_ptr<LongClRing>> long_cls;
+
+        #ifdef USE_MPI
+        //Binaries received from other MPI nodes. Written only by thread 0,
+        //which does the MPI exchange, read by every thread including 0
+        BinStore mpi_bins;
+        #endif
         #endif
 
         vector<lbool> value;
         std::mutex unit_mutex;
+
+        //XORs found by thread 0. The other threads copy these instead of
+        //running their own XorFinder. Replaced as a whole, under xor_mutex
+        std::mutex xor_mutex;
+        vector<SharedXor> xors;
+        uint64_t xors_gen = 0;
+
         std::atomic<int> cur_thread_id;
         uint32_t num_threads;
 
+        uint32_t num_bin_readers() const
+        {
+            #ifdef USE_MPI
+            return num_threads+1;
+            #else
+            return num_threads;
+            #endif
+        }
+
         size_t calc_memory_use_bins()
         {
             size_t mem = 0;
             mem += value.capacity()*sizeof(lbool);
             #ifndef USE_GPU
-            mem += bins.capacity()*sizeof(Spec);
-            for(size_t i = 0; i < bins.size(); i++) {
-                if (bins[i].data) {
-                    mem += bins[i].data->capacity()*sizeof(Lit);
-                    mem += sizeof(vector<Lit>);
-                }
+            for(const auto& store: bins) {
+                mem += store->mem_used();
+            }
+            #ifdef USE_MPI
+            mem += mpi_bins.mem_used();
+            #endif
+            #endif
+            return mem;
+        }
+
+        size_t calc_memory_use_xors()
+        {
+            std::lock_guard<std::mutex> lock(xor_mutex);
+            size_t mem = xors.capacity()*sizeof(SharedXor);
+            for(const auto& x: xors) {
+                mem += x.vars.capacity()*sizeof(uint32_t);
+            }
+            return mem;
+        }
+
+        size_t calc_memory_use_long_cls()
+        {
+            size_t mem = 0;
+            #ifndef USE_GPU
+            for(const auto& ring: long_cls) {
+                mem += ring->mem_used();
             }
             #endif
             return mem;
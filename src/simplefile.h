@@ -85,6 +85,11 @@ public:
         put(&d, sizeof(T));
     }
 
+    void put_buffer(const void* ptr, size_t num)
+    {
+        put(ptr, num);
+    }
+
 private:
     std::ofstream* outf = NULL;
     //vector<char> buffer;
@@ -159,6 +164,11 @@ public:
         inf->read((char*)&d, sizeof(T));
     }
 
+    void get_buffer(void* ptr, size_t num)
+    {
+        get_raw(ptr, num, 1);
+    }
+
 private:
     std::ifstream* inf = NULL;
 
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include "sls.h"
 #include "solver.h"
 #include "ccnr_cms.h"
+#include "ccnr.h"
 
 using namespace CMSat;
 
@@ -40,6 +41,13 @@ lbool SLS::run(const uint32_t num_sls_called)
 
 lbool SLS::run_ccnr(const uint32_t num_sls_called)
 {
+    //CCNR addresses literals with 31-bit clause numbers and 32-bit offsets
+    const uint64_t numliterals = solver->litStats.irredLits + solver->binTri.irredBins*2;
+    if (numliterals >= (1ULL << 31)) {
+        verb_print(1, "[sls] too many literals for CCNR -- skipping");
+        return l_Undef;
+    }
+
     CMS_ccnr ccnr(solver);
     double mem_needed_mb = (double)approx_mem_needed()/(1000.0*1000.0);
     double maxmem = solver->conf.sls_memoutMB*solver->conf.var_and_mem_out_mult;
@@ -58,42 +66,27 @@ lbool SLS::run_ccnr(const uint32_t num_sls_called)
 
 uint64_t SLS::approx_mem_needed()
 {
-    uint32_t numvars = solver->nVars();
-    uint32_t numclauses = solver->longIrredCls.size() + solver->binTri.irredBins;
+    uint64_t numvars = solver->nVars();
+    uint64_t numclauses = solver->longIrredCls.size() + solver->binTri.irredBins;
     uint64_t numliterals = solver->litStats.irredLits + solver->binTri.irredBins*2;
     uint64_t needed = 0;
 
-    //LIT storage (all clause data)
-    needed += (solver->litStats.irredLits+solver->binTri.irredBins*2)*sizeof(Lit);
-
-    //This is just an estimation of yalsat's memory needs.
-
-    //clause
-    needed += sizeof(Lit *) * numclauses;
-    //clsize
-    needed += sizeof(uint32_t) * numclauses;
-
-    //false_cls
-    needed += sizeof(uint32_t) * numclauses;
-    //map_cl_to_false_cls
-    needed += sizeof(uint32_t) * numclauses;
-    //numtruelit
-    needed += sizeof(uint32_t) * numclauses;
-
-    //occurrence
-    needed += sizeof(uint32_t *) * (2 * numvars);
-    //numoccurrence
-    needed += sizeof(uint32_t) * (2 * numvars);
-    //assigns
-    needed += sizeof(lbool) * numvars;
-    //breakcount
-    needed += sizeof(uint32_t) * numvars;
-    //makecount
-    needed += sizeof(uint32_t) * numvars;
-
-    //occur_list_alloc
-    needed += sizeof(uint32_t) * numliterals;
-
+    //Formula, shared by the walkers: literals of each clause and
+    //occurrences of each variable, both in CSR form. Neighbour lists are
+    //only built if they fit in a quarter of sls_memoutMB.
+    needed += 2 * sizeof(CCNR::lit) * numliterals;
+    needed += sizeof(uint32_t) * (numclauses + numvars);
+
+    //Per walker
+    uint64_t per_walker = 0;
+    //clause state, unsat_clauses, index_in_unsat_clauses
+    per_walker += (sizeof(CCNR::clause) + 2*sizeof(int)) * numclauses;
+    //var state, solution, best_solution
+    per_walker += (sizeof(CCNR::variable) + 2*sizeof(uint8_t)) * numvars;
+    //conflict_ct, unsat_vars, index_in_unsat_vars, ccd_vars
+    per_walker += 4 * sizeof(int) * numvars;
+
+    needed += CMS_ccnr::num_walkers(solver->conf) * per_walker;
 
     return needed;
 }
@@ -77,7 +77,9 @@ THE SOFTWARE.
 #include "lucky.h"
 #include "get_clause_query.h"
 #include "community_finder.h"
+#include "inprocsched.h"
 #include "oracle/oracle.h"
+#include "simplefile.h"
 extern "C" {
 #include "picosat/picosat.h"
 }
@@ -136,6 +138,7 @@ Solver::Solver(const SolverConf *_conf, std::atomic<bool>* _must_interrupt_inter
     datasync = new DataSync(this, NULL);
     Searcher::solver = this;
     reduceDB = new ReduceDB(this);
+    inproc_sched = new InprocSched(this);
 
     set_up_sql_writer();
     next_lev1_reduce = conf.every_lev1_reduce;
@@ -162,6 +165,7 @@ Solver::~Solver()
     delete subsumeImplicit;
     delete datasync;
     delete reduceDB;
+    delete inproc_sched;
 #ifdef USE_BREAKID
     delete breakid;
 #endif
@@ -716,6 +720,14 @@ void Solver::add_bnn_clause_inter(
             free(bnn);
             bnn = NULL;
         } else {
+            //sublevel and propagated are only maintained while there are BNNs
+            if (bnns.empty()) {
+                for(uint32_t i = 0; i < trail.size(); i++) {
+                    const uint32_t v = trail[i].lit.var();
+                    varData[v].sublevel = i;
+                    varData[v].propagated = i < qhead;
+                }
+            }
             bnns.push_back(bnn);
             attach_bnn(bnns.size()-1);
         }
@@ -884,6 +896,27 @@ bool Solver::addClauseHelper(vector<Lit>& ps)
     return true;
 }
 
+//Takes INTER lits
+void Solver::inc_mark_dirty(const vector<Lit>& ps)
+{
+    if (inc_dirty_outer.size() < nVarsOuter()) {
+        inc_dirty_outer.resize(nVarsOuter(), 0);
+    }
+    for(const Lit lit: ps) {
+        const uint32_t outer = map_inter_to_outer(lit.var());
+        if (!inc_dirty_outer[outer]) {
+            inc_dirty_outer[outer] = 1;
+            inc_dirty_list.push_back(outer);
+        }
+    }
+}
+
+void Solver::inc_clear_dirty()
+{
+    for(const uint32_t outer: inc_dirty_list) inc_dirty_outer[outer] = 0;
+    inc_dirty_list.clear();
+}
+
 bool Solver::add_clause_outer_copylits(const vector<Lit>& lits)
 {
     vector<Lit> ps = lits;
@@ -918,7 +951,11 @@ bool Solver::add_clause_outer(vector<Lit>& ps, bool red)
     }
 
     std::sort(ps.begin(), ps.end());
+    if (conf.incremental_fast_path) inc_mark_dirty(ps);
     if (red) assert(!frat->enabled() && "Cannot have both FRAT and adding of redundant clauses");
+    if (ps.size() > 2 && cl_alloc.must_widen_for(ps.size())) {
+        cl_alloc.consolidate(this, true);
+    }
     Clause *cl = add_clause_int(
         ps
         , red //redundant?
@@ -1262,6 +1299,12 @@ void Solver::set_assumptions()
 
         const Lit outer_lit = map_inter_to_outer(inter_lit);
         assumptions[i] = AssumptionPair(outer_lit, outside_lit);
+        if (conf.incremental_fast_path) {
+            if (inc_frozen_outer.size() <= outer_lit.var()) {
+                inc_frozen_outer.resize(nVarsOuter(), 0);
+            }
+            inc_frozen_outer[outer_lit.var()] = 1;
+        }
     }
 
     fill_assumptions_set();
@@ -1583,7 +1626,8 @@ lbool Solver::simplify_problem_outside(const string* strategy)
         bool backup_breakid = conf.doBreakid;
         conf.doSLS = false;
         conf.doBreakid = false;
-        status = simplify_problem(false, strategy ? *strategy : conf.simplify_schedule_nonstartup);
+        status = simplify_problem(false,
+            strategy ? *strategy : conf.simplify_schedule_nonstartup, strategy == NULL);
         conf.doSLS = backup_sls;
         conf.doBreakid = backup_breakid;
     }
@@ -1619,6 +1663,8 @@ void Solver::reset_for_solving()
     luby_loop_num = 0;
     conf.global_timeout_multiplier = conf.orig_global_timeout_multiplier;
     solveStats.num_simplify_this_solve_call = 0;
+    solveStats.simplify_time_this_solve_call = 0;
+    solveStats.dirty_vars_this_solve_call = inc_dirty_list.size();
     if (conf.verbosity >= 6) {
         cout << "c " << __func__ << " called" << endl;
     }
@@ -1697,6 +1743,9 @@ lbool Solver::solve_with_assumptions(
     if (breakid) breakid->start_new_solving();
     #endif
 
+    //Clauses added since the last call may have spilled out of the watch arena
+    watches.consolidate();
+
     //Simplify in case simplify_at_startup is set
     if (status == l_Undef
         && nVars() > 0
@@ -1727,7 +1776,8 @@ lbool Solver::solve_with_assumptions(
     conf.maxTime = numeric_limits<double>::max();
     datasync->finish_up_mpi();
     conf.conf_needed = true;
-    set_must_interrupt_asap();
+    //In cube mode the other threads are still busy with their own cubes
+    if (!conf.cube_and_conquer) set_must_interrupt_asap();
     assert(decisionLevel()== 0);
     assert(!ok || prop_at_head());
     if (_assumptions == NULL || _assumptions->empty()) {
@@ -1748,6 +1798,209 @@ lbool Solver::solve_with_assumptions(
     return status;
 }
 
+lbool Solver::enumerate(
+    const std::function<bool(const vector<lbool>&)>& callback,
+    const vector<uint32_t>* projection,
+    const uint64_t limit,
+    const vector<Lit>* _assumptions,
+    const bool only_indep_solution
+) {
+    const double myTime = cpuTime();
+    const vector<uint32_t>* orig_sampling_vars = conf.sampling_vars;
+    if (projection) {
+        //Keeps BVE away from the projection, so the search decides all of it
+        conf.sampling_vars = projection;
+        if (okay() && !uneliminate_outside_vars(*projection)) {
+            conf.sampling_vars = orig_sampling_vars;
+            return l_False;
+        }
+    }
+
+    enum_state = EnumState();
+    enum_state.callback = &callback;
+    enum_state.projection = projection;
+    enum_state.limit = limit;
+    enum_state.only_indep = only_indep_solution;
+
+    //Models are normally reported and blocked from inside the search loop,
+    //see enum_found_model(). This loop only restarts solving when a model
+    //was found elsewhere, e.g. by simplification
+    const uint64_t max_confl = conf.max_confl;
+    const double max_time = conf.maxTime;
+    lbool status;
+    while(true) {
+        status = solve_with_assumptions(_assumptions, only_indep_solution);
+        if (status != l_True || !enum_found_model(false)) break;
+        unset_must_interrupt_asap();
+        conf.max_confl = max_confl;
+        conf.maxTime = max_time;
+    }
+    //Banning the last model may well make the formula UNSAT, but that model
+    //was still found and handed out, so the caller must see l_True
+    if (enum_state.stopped) status = l_True;
+
+    verb_print(1, "[enum] models: " << enum_state.found
+        << " blocked in search: " << enum_state.blocked_in_search
+        << " at top level: " << enum_state.blocked_at_top
+        << " ret: " << status
+        << " T: " << std::setprecision(2) << std::fixed << (cpuTime() - myTime));
+
+    enum_state = EnumState();
+    conf.sampling_vars = orig_sampling_vars;
+    return status;
+}
+
+bool Solver::enum_found_model(const bool in_search)
+{
+    if (in_search) {
+        assert(prop_at_head());
+        model = assigns;
+        extend_solution(enum_state.only_indep);
+    }
+    enum_state.found++;
+    const bool go_on = (*enum_state.callback)(model)
+        && (enum_state.limit == 0 || enum_state.found < enum_state.limit);
+
+    //Ban the model over the projection, in OUTSIDE numbering
+    enum_block_outside.clear();
+    if (enum_state.projection) {
+        for(const uint32_t v: *enum_state.projection) {
+            if (model[v] != l_Undef) {
+                enum_block_outside.push_back(Lit(v, model[v] == l_True));
+            }
+        }
+    } else {
+        for(uint32_t v = 0; v < nVarsOutside(); v++) {
+            if (model[v] != l_Undef) {
+                enum_block_outside.push_back(Lit(v, model[v] == l_True));
+            }
+        }
+    }
+    if (in_search && enum_block_in_search()) {
+        enum_state.blocked_in_search++;
+    } else {
+        enum_state.blocked_at_top++;
+        enum_block_at_top();
+    }
+
+    if (!go_on) {
+        enum_state.stopped = true;
+        set_must_interrupt_asap();
+    }
+    return go_on && okay();
+}
+
+//Adds the blocking clause without leaving the current trail: only the
+//levels above its highest-level literal are undone, and the clause then
+//propagates just like a learnt clause would. Returns FALSE if the clause
+//needs the full top-level treatment of add_clause_outside() instead.
+//With BNNs, blocking here loses models, so the clause is always added at
+//the top level then.
+bool Solver::enum_block_in_search()
+{
+    if (frat->enabled() || !bnns.empty()) return false;
+
+    enum_block_inter.clear();
+    for(const Lit outside: enum_block_outside) {
+        Lit lit = back_number_from_outside_to_outer(outside);
+        lit = varReplacer->get_lit_replaced_with_outer(lit);
+        lit = map_outer_to_inter(lit);
+
+        //Eliminated, or a detached XOR's variable that the model sets
+        //differently than the trail
+        if (varData[lit.var()].removed != Removed::none
+            || value(lit) != l_False
+        ) {
+            return false;
+        }
+        if (varHot[lit.var()].level == 0) continue;
+        enum_block_inter.push_back(lit);
+    }
+
+    //Replaced variables may map to the same literal
+    vector<Lit>& cl = enum_block_inter;
+    uint32_t j = 0;
+    for(uint32_t i = 0; i < cl.size(); i++) {
+        if (seen[cl[i].toInt()]) continue;
+        seen[cl[i].toInt()] = 1;
+        cl[j++] = cl[i];
+    }
+    cl.resize(j);
+    for(const Lit lit: cl) seen[lit.toInt()] = 0;
+    if (cl.size() < 2) return false;
+
+    //Highest level literal first, second highest next
+    for(uint32_t at = 0; at < 2; at++) {
+        uint32_t best = at;
+        for(uint32_t i = at+1; i < cl.size(); i++) {
+            if (varHot[cl[i].var()].level > varHot[cl[best].var()].level) best = i;
+        }
+        std::swap(cl[at], cl[best]);
+    }
+    const uint32_t lev0 = varHot[cl[0].var()].level;
+    const uint32_t lev1 = varHot[cl[1].var()].level;
+
+    if (lev0 == lev1
+        || (conf.diff_declev_for_chrono > -1
+            && bnns.empty()
+            && ((int)decisionLevel() - (int)lev1) >= conf.diff_declev_for_chrono)
+    ) {
+        cancelUntil(lev0-1);
+    } else {
+        cancelUntil(lev1);
+    }
+    const bool unit = value(cl[1]) == l_False;
+
+    const int32_t ID = ++clauseID;
+    if (conf.incremental_fast_path) inc_mark_dirty(cl);
+    if (cl.size() == 2) {
+        attach_bin_clause(cl[0], cl[1], false, ID, false);
+        if (unit) enqueue<false>(cl[0], lev1, PropBy(cl[1], false, ID));
+    } else {
+        Clause* c = cl_alloc.Clause_new(cl, sumConflicts, ID);
+        c->isRed = false;
+        const ClOffset offs = cl_alloc.get_offset(c);
+        attachClause(*c, false);
+        longIrredCls.push_back(offs);
+        if (unit) enqueue<false>(cl[0], lev1, PropBy(offs));
+    }
+
+    return true;
+}
+
+bool Solver::enum_block_at_top()
+{
+    cancelUntil(0);
+    if (!propagate<false>().isNULL()) {
+        ok = false;
+        return false;
+    }
+    return add_clause_outside(enum_block_outside);
+}
+
+//Takes OUTSIDE variables
+bool Solver::uneliminate_outside_vars(const vector<uint32_t>& vars)
+{
+    assert(decisionLevel() == 0);
+    for(const uint32_t v: vars) {
+        if (v >= nVarsOutside()) {
+            std::cerr << "ERROR: projection variable " << v+1
+            << " is larger than the number of variables: " << nVarsOutside() << endl;
+            exit(-1);
+        }
+        uint32_t outer = back_number_from_outside_to_outer(v);
+        outer = varReplacer->get_var_replaced_with_outer(outer);
+        const uint32_t var = map_outer_to_inter(outer);
+        if (detached_xor_clauses && varData[var].removed == Removed::clashed) {
+            if (!fully_undo_xor_detach()) return false;
+        }
+        if (varData[var].removed == Removed::elimed) {
+            if (!occsimplifier->uneliminate(var)) return false;
+        }
+    }
+    return okay();
+}
+
 void Solver::write_final_frat_clauses()
 {
     if (!frat->enabled()) return;
@@ -2280,10 +2533,34 @@ lbool Solver::execute_inprocess_strategy(
     return okay() ? l_Undef : l_False;
 }
 
+//Runs the units of the strategy in the order and with the boosts picked
+//by the adaptive scheduler, letting it measure each of them
+lbool Solver::execute_scheduled_strategy(const bool startup, const string& strategy)
+{
+    for(const string& unit: inproc_sched->plan(strategy)) {
+        if (sumConflicts >= conf.max_confl
+            || cpuTime() > conf.maxTime
+            || must_interrupt_asap()
+            || nVars() == 0
+            || !okay()
+        ) {
+            break;
+        }
+
+        inproc_sched->begin(unit);
+        const lbool ret = execute_inprocess_strategy(startup, unit);
+        inproc_sched->end(unit);
+        if (ret == l_False) return l_False;
+    }
+
+    return okay() ? l_Undef : l_False;
+}
+
 /**
 @brief The function that brings together almost all CNF-simplifications
 */
-lbool Solver::simplify_problem(const bool startup, const string& strategy)
+lbool Solver::simplify_problem(
+    const bool startup, const string& strategy, const bool may_reschedule)
 {
     assert(okay());
     #ifdef DEBUG_IMPLICIT_STATS
@@ -2303,6 +2580,7 @@ lbool Solver::simplify_problem(const bool startup, const string& strategy)
     }
 
     lbool ret = l_Undef;
+    const double myTime = cpuTime();
     clear_order_heap();
     set_clash_decision_vars();
     if (!clear_gauss_matrices()) return l_False;
@@ -2313,10 +2591,28 @@ lbool Solver::simplify_problem(const bool startup, const string& strategy)
         << endl;
     }
 
+    //Only the first inprocessing of a solve() call is restricted. If the
+    //call runs long enough to inprocess again, it's a full one.
+    inc_restrict_simp_now = conf.incremental_fast_path
+        && solveStats.num_simplify > 0
+        && solveStats.num_simplify_this_solve_call == 0;
+    if (conf.incremental_fast_path) {
+        verb_print(1, "[incremental] restricting inprocessing: " << inc_restrict_simp_now
+            << " dirty vars: " << inc_dirty_list.size());
+    }
+
     if (ret == l_Undef) {
-        ret = execute_inprocess_strategy(startup, strategy);
+        //An explicitly given strategy is executed as-is
+        if (conf.inproc_sched != InprocSchedMode::fixed && may_reschedule) {
+            ret = execute_scheduled_strategy(startup, strategy);
+        } else {
+            ret = execute_inprocess_strategy(startup, strategy);
+        }
     }
     assert(ret != l_True);
+    inc_restrict_simp_now = false;
+    inc_clear_dirty();
+    solveStats.simplify_time_this_solve_call += cpuTime() - myTime;
 
     //Free unused watch memory
     free_unused_watches();
@@ -2587,6 +2883,7 @@ uint64_t Solver::mem_used_vardata() const
     uint64_t mem = 0;
     mem += assigns.capacity()*sizeof(lbool);
     mem += varData.capacity()*sizeof(VarData);
+    mem += varHot.capacity()*sizeof(VarHot);
 
     return mem;
 }
@@ -3119,6 +3416,90 @@ bool Solver::add_clause_outside(const vector<Lit>& lits, bool red)
     return add_clause_outer(back_number_from_outside_to_outer_tmp, red);
 }
 
+//Adds n clauses in CSR form, see SATSolver::add_clauses(). On a fresh
+//solver without FRAT the clauses are cleaned and attached directly, with no
+//renumbering, and the units are propagated once, at the end of the batch.
+//So clauses are only cleaned against the units, not against what the units
+//imply, which is equisatisfiable to calling add_clause_outside() on each
+bool Solver::add_clauses_outside(
+    const Lit* lits,
+    const uint32_t* offsets,
+    const size_t n)
+{
+    if (!ok) return false;
+    if (!fresh_solver || get_num_bva_vars() > 0 || frat->enabled()) {
+        vector<Lit> cl;
+        for(size_t i = 0; i < n && ok; i++) {
+            cl.assign(lits + offsets[i], lits + offsets[i+1]);
+            add_clause_outside(cl);
+        }
+        return ok;
+    }
+
+    assert(decisionLevel() == 0);
+    assert(qhead == trail.size());
+    const size_t origTrailSize = trail.size();
+    vector<Lit>& ps = add_clause_int_tmp_cl;
+    for(size_t i = 0; i < n && ok; i++) {
+        const uint32_t sz = offsets[i+1] - offsets[i];
+        if (sz > (0x01UL << 28)) {
+            cout << "Too long clause!" << endl;
+            throw CMSat::TooLongClauseError();
+        }
+        ps.assign(lits + offsets[i], lits + offsets[i+1]);
+        for(const Lit lit: ps) {
+            if (lit.var() >= nVarsOuter()) {
+                std::cerr
+                << "ERROR: Variable " << lit.var() + 1
+                << " inserted, but max var is "
+                << nVarsOuter()
+                << endl;
+                std::exit(-1);
+            }
+        }
+        std::sort(ps.begin(), ps.end());
+        if (conf.incremental_fast_path) inc_mark_dirty(ps);
+
+        //Same IDs as add_clause_outer() would hand out
+        ClauseStats clstats;
+        clstats.ID = ++clauseID;
+        if (!sort_and_clean_clause(ps, ps, false, true)) continue;
+        const int32_t ID = (ps.size() == sz) ? clstats.ID : ++clauseID;
+
+        switch (ps.size()) {
+            case 0:
+                assert(unsat_cl_ID == 0);
+                unsat_cl_ID = clauseID;
+                ok = false;
+                break;
+            case 1:
+                enqueue<false>(ps[0]);
+                break;
+            case 2:
+                attach_bin_clause(ps[0], ps[1], false, ID);
+                break;
+            default: {
+                if (cl_alloc.must_widen_for(ps.size())) {
+                    cl_alloc.consolidate(this, true);
+                }
+                Clause* c = cl_alloc.Clause_new(ps, sumConflicts, ID);
+                c->isRed = false;
+                c->stats = clstats;
+                c->stats.ID = ID;
+                attachClause(*c);
+                longIrredCls.push_back(cl_alloc.get_offset(c));
+                break;
+            }
+        }
+    }
+    if (ok && qhead < trail.size()) {
+        ok = propagate<true>().isNULL();
+    }
+    zeroLevAssignsByCNF += trail.size() - origTrailSize;
+
+    return ok;
+}
+
 bool Solver::full_probe(const bool bin_only)
 {
     assert(okay());
@@ -5224,7 +5605,7 @@ bool Solver::oracle_sparsify()
     fin:
     uint32_t bin_red_added = 0;
     uint32_t bin_irred_removed = 0;
-    for(auto& ws: watches) {
+    for(watch_subarray ws: watches) {
         uint32_t j = 0;
         for(uint32_t i = 0; i < ws.size(); i++) {
             if (ws[i].isBNN()) {
@@ -5304,6 +5685,7 @@ string Solver::serialize_solution_reconstruction_data() const
         ar << interToOuterMain;
         ar << outerToInterMain;
         ar << varData;
+        ar << varHot;
         ar << minNumVars;
         CNF::serialize(ar);
         occsimplifier->serialize_elimed_cls(ar);
@@ -5325,6 +5707,7 @@ void Solver::create_from_solution_reconstruction_data(const string& data)
         ar >> interToOuterMain;
         ar >> outerToInterMain;
         ar >> varData;
+        ar >> varHot;
         ar >> minNumVars;
         CNF::unserialize(ar);
         occsimplifier->unserialize_elimed_cls(ar);
@@ -5333,6 +5716,198 @@ void Solver::create_from_solution_reconstruction_data(const string& data)
 }
 #endif
 
+static const uint64_t state_magic = 0x4554415453534d43ULL; //"CMSSTATE"
+static const uint32_t state_version = 3;
+
+static void put_state_header(SimpleOutFile& f)
+{
+    f.put_uint64_t(state_magic);
+    f.put_uint32_t(state_version);
+    f.put_uint32_t(sizeof(Clause));
+    f.put_uint32_t(sizeof(VarData));
+    f.put_uint32_t(sizeof(ClOffset));
+    f.put_uint32_t(sizeof(BASE_DATA_TYPE));
+}
+
+static bool check_state_header(SimpleInFile& f)
+{
+    if (f.get_uint64_t() != state_magic) return false;
+    if (f.get_uint32_t() != state_version) return false;
+    if (f.get_uint32_t() != sizeof(Clause)) return false;
+    if (f.get_uint32_t() != sizeof(VarData)) return false;
+    if (f.get_uint32_t() != sizeof(ClOffset)) return false;
+    if (f.get_uint32_t() != sizeof(BASE_DATA_TYPE)) return false;
+    return true;
+}
+
+//Dumps the simplified problem (arena, offset tables, variable maps,
+//activities, polarities, replacement tables and eliminated clauses) so
+//that load_state() can continue from here without re-simplifying.
+//The image is only valid for the same build of the library.
+void Solver::save_state(const string& fname)
+{
+    assert(decisionLevel() == 0);
+    if (frat->enabled()) {
+        throw std::runtime_error("ERROR: save_state() cannot be used with FRAT");
+    }
+    for(const auto& bnn: bnns) {
+        if (bnn != NULL) {
+            throw std::runtime_error("ERROR: save_state() cannot be used with BNNs");
+        }
+    }
+
+    if (ok && qhead < trail.size()) ok = propagate<true>().isNULL();
+    if (ok && detached_xor_clauses) fully_undo_xor_detach();
+    if (ok) remove_and_clean_all();
+    if (ok) cl_alloc.consolidate(this, true, true);
+
+    SimpleOutFile f;
+    f.start(fname);
+    put_state_header(f);
+    f.put_uint32_t(ok);
+    if (!ok) return;
+
+    f.put_uint32_t(nVarsOuter());
+    f.put_uint32_t(nVars());
+    f.put_vector(interToOuterMain);
+    f.put_vector(outerToInterMain);
+    save_bva_state(f);
+    f.put_vector(assigns);
+    f.put_vector(varData);
+    f.put_vector(varHot);
+    vector<uint8_t> must_set(undef_must_set_vars.begin(), undef_must_set_vars.end());
+    f.put_vector(must_set);
+
+    f.put_uint64_t(trail.size());
+    for(const auto& t: trail) f.put_lit(t.lit);
+
+    f.put_vector(var_act_vsids);
+    f.put_struct(var_inc_vsids);
+    f.put_vector(vmtf_btab);
+    f.put_uint32_t(clauseID);
+    f.put_uint64_t(sumConflicts);
+    f.put_uint32_t(solveStats.num_simplify);
+    f.put_uint32_t(fresh_solver);
+
+    cl_alloc.save_state(f);
+    f.put_vector(longIrredCls);
+    f.put_uint64_t(longRedCls.size());
+    for(const auto& lev: longRedCls) f.put_vector(lev);
+    f.put_vector(longRedClsSizes);
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    f.put_vector(red_stats_extra);
+    #endif
+
+    vector<Lit> bins;
+    vector<int32_t> bin_ids;
+    vector<uint8_t> bin_red;
+    for(uint32_t i = 0; i < nVars()*2; i++) {
+        const Lit lit = Lit::toLit(i);
+        for(const Watched& w: watches[lit]) {
+            if (!w.isBin() || lit > w.lit2()) continue;
+            bins.push_back(lit);
+            bins.push_back(w.lit2());
+            bin_ids.push_back(w.get_ID());
+            bin_red.push_back(w.red());
+        }
+    }
+    f.put_vector(bins);
+    f.put_vector(bin_ids);
+    f.put_vector(bin_red);
+
+    varReplacer->save_state(f);
+    f.put_uint32_t(occsimplifier != NULL);
+    if (occsimplifier) occsimplifier->save_state(f);
+}
+
+void Solver::load_state(const string& fname)
+{
+    assert(nVarsOuter() == 0 && cl_alloc.mem_used() == 0);
+    if (!std::ifstream(fname.c_str()).good()) {
+        throw std::runtime_error("ERROR: cannot open state file " + fname);
+    }
+
+    SimpleInFile f;
+    f.start(fname);
+    if (!check_state_header(f)) {
+        throw std::runtime_error(
+            "ERROR: state file " + fname + " was written by a different version or build");
+    }
+    if (!f.get_uint32_t()) {
+        ok = false;
+        return;
+    }
+
+    const uint32_t n_outer = f.get_uint32_t();
+    const uint32_t n_inter = f.get_uint32_t();
+    new_vars(n_outer);
+    interToOuterMain.clear();
+    outerToInterMain.clear();
+    assigns.clear();
+    varData.clear();
+    varHot.clear();
+    f.get_vector(interToOuterMain);
+    f.get_vector(outerToInterMain);
+    load_bva_state(f);
+    f.get_vector(assigns);
+    f.get_vector(varData);
+    f.get_vector(varHot);
+    vector<uint8_t> must_set;
+    f.get_vector(must_set);
+    undef_must_set_vars.assign(must_set.begin(), must_set.end());
+    if (n_inter < n_outer) save_on_var_memory(n_inter);
+
+    trail.clear();
+    const uint64_t trail_sz = f.get_uint64_t();
+    for(uint64_t i = 0; i < trail_sz; i++) trail.push_back(Trail(f.get_lit(), 0));
+    qhead = trail.size();
+
+    var_act_vsids.clear();
+    vmtf_btab.clear();
+    f.get_vector(var_act_vsids);
+    f.get_struct(var_inc_vsids);
+    f.get_vector(vmtf_btab);
+    clauseID = f.get_uint32_t();
+    sumConflicts = f.get_uint64_t();
+    solveStats.num_simplify = f.get_uint32_t();
+    fresh_solver = f.get_uint32_t();
+
+    cl_alloc.load_state(f);
+    f.get_vector(longIrredCls);
+    longRedCls.resize(f.get_uint64_t());
+    for(auto& lev: longRedCls) {
+        lev.clear();
+        f.get_vector(lev);
+    }
+    longRedClsSizes.clear();
+    f.get_vector(longRedClsSizes);
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    red_stats_extra.clear();
+    f.get_vector(red_stats_extra);
+    #endif
+    for(const auto& offs: longIrredCls) attachClause(*cl_alloc.ptr(offs), false);
+    for(const auto& lev: longRedCls) {
+        for(const auto& offs: lev) attachClause(*cl_alloc.ptr(offs), false);
+    }
+
+    vector<Lit> bins;
+    vector<int32_t> bin_ids;
+    vector<uint8_t> bin_red;
+    f.get_vector(bins);
+    f.get_vector(bin_ids);
+    f.get_vector(bin_red);
+    for(size_t i = 0; i < bin_ids.size(); i++) {
+        attach_bin_clause(bins[i*2], bins[i*2+1], bin_red[i], bin_ids[i], false);
+    }
+
+    varReplacer->load_state(f);
+    if (f.get_uint32_t()) {
+        assert(occsimplifier);
+        occsimplifier->load_state(f);
+    }
+    rebuildOrderHeap();
+}
+
 pair<lbool, vector<lbool>> Solver::extend_minimized_model(const vector<lbool>& m)
 {
     if (!ok) return make_pair(l_False, vector<lbool>());
@@ -5584,7 +6159,7 @@ bool Solver::backbone_simpl(int64_t orig_max_confl, bool cmsgen, bool& finished)
 
 void Solver::detach_and_free_all_irred_cls()
 {
-    for(auto& ws: watches) {
+    for(watch_subarray ws: watches) {
         uint32_t j = 0;
         for(uint32_t i = 0; i < ws.size(); i++) {
             if (ws[i].isBin()) {
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include <utility>
 #include <string>
 #include <algorithm>
+#include <functional>
 
 #include "solvertypes.h"
 #include "propengine.h"
@@ -74,12 +75,17 @@ class ReduceDB;
 class InTree;
 class BreakID;
 class GetClauseQuery;
+class InprocSched;
 
 struct SolveStats
 {
     uint32_t num_simplify = 0;
     uint32_t num_simplify_this_solve_call = 0;
     uint32_t num_solve_calls = 0;
+
+    //Per-call overhead of the last solve() call
+    double simplify_time_this_solve_call = 0;
+    uint32_t dirty_vars_this_solve_call = 0;
 };
 
 class Solver : public Searcher
@@ -94,6 +100,7 @@ class Solver : public Searcher
         void new_external_var();
         void new_external_vars(size_t n);
         bool add_clause_outside(const vector<Lit>& lits, bool red = false);
+        bool add_clauses_outside(const Lit* lits, const uint32_t* offsets, size_t n);
         bool add_xor_clause_outside(const vector<uint32_t>& vars, bool rhs);
         bool add_bnn_clause_outside(
             const vector<Lit>& lits,
@@ -105,6 +112,16 @@ class Solver : public Searcher
             const vector<Lit>* _assumptions = NULL,
             bool only_indep_solution = false);
         lbool simplify_with_assumptions(const vector<Lit>* _assumptions = NULL, const string* strategy = NULL);
+        lbool enumerate(
+            const std::function<bool(const vector<lbool>&)>& callback,
+            const vector<uint32_t>* projection = NULL,
+            const uint64_t limit = 0,
+            const vector<Lit>* _assumptions = NULL,
+            const bool only_indep_solution = false);
+        //Called by the search loop on a full assignment while enumerating.
+        //Returns FALSE if enumeration must stop
+        bool enumerating() const { return enum_state.callback != NULL; }
+        bool enum_found_model(const bool in_search);
         void  set_shared_data(SharedData* shared_data);
         vector<Lit> probe_inter_tmp;
         lbool probe_outside(Lit l, uint32_t& min_props);
@@ -187,6 +204,7 @@ class Solver : public Searcher
         StrImplWImpl* dist_impl_with_impl = NULL;
         CardFinder*            card_finder = NULL;
         GetClauseQuery*        get_clause_query = NULL;
+        InprocSched*           inproc_sched = NULL;
 
         SearchStats sumSearchStats;
         PropStats sumPropStats;
@@ -197,10 +215,17 @@ class Solver : public Searcher
         bool fully_enqueue_this(const Lit lit_ID);
         void update_assumptions_after_varreplace();
 
+        //Incremental fast path, see conf.incremental_fast_path
+        bool inc_restrict_simp() const { return inc_restrict_simp_now; }
+        bool inc_var_dirty(const uint32_t var) const;
+        bool inc_var_frozen(const uint32_t var) const;
+
         //State load/unload
         string serialize_solution_reconstruction_data() const;
         void create_from_solution_reconstruction_data(const string& str);
         pair<lbool, vector<lbool>> extend_minimized_model(const vector<lbool>& m);
+        void save_state(const string& fname);
+        void load_state(const string& fname);
 
         // Clauses
         bool add_clause_outer_copylits(const vector<Lit>& ps);
@@ -411,6 +436,24 @@ class Solver : public Searcher
         void check_too_large_variable_number(const vector<Lit>& lits) const;
 
         lbool simplify_problem_outside(const string* strategy = NULL);
+
+        //Model enumeration, see enumerate()
+        struct EnumState {
+            const std::function<bool(const vector<lbool>&)>* callback = NULL;
+            const vector<uint32_t>* projection = NULL;
+            uint64_t limit = 0;
+            bool only_indep = false;
+            bool stopped = false;
+            uint64_t found = 0;
+            uint64_t blocked_in_search = 0;
+            uint64_t blocked_at_top = 0;
+        };
+        EnumState enum_state;
+        vector<Lit> enum_block_outside;
+        vector<Lit> enum_block_inter;
+        bool enum_block_in_search();
+        bool enum_block_at_top();
+        bool uneliminate_outside_vars(const vector<uint32_t>& vars);
         void move_to_outside_assumps(const vector<Lit>* assumps);
         vector<Lit> back_number_from_outside_to_outer_tmp;
         void back_number_from_outside_to_outer(const vector<Lit>& lits)
@@ -456,10 +499,21 @@ class Solver : public Searcher
             const double cpu_time_total,
             const double wallclock_time_started=0) const;
 
-        lbool simplify_problem(const bool startup, const string& strategy);
+        lbool simplify_problem(
+            const bool startup, const string& strategy, const bool may_reschedule = true);
         lbool execute_inprocess_strategy(const bool startup, const string& strategy);
+        lbool execute_scheduled_strategy(const bool startup, const string& strategy);
         SolveStats solveStats;
         void check_minimization_effectiveness(lbool status);
+
+        //Incremental fast path, indexed by OUTER var, since the
+        //inter numbering changes at every renumbering
+        void inc_mark_dirty(const vector<Lit>& ps);
+        void inc_clear_dirty();
+        vector<uint8_t> inc_dirty_outer;
+        vector<uint32_t> inc_dirty_list;
+        vector<uint8_t> inc_frozen_outer;
+        bool inc_restrict_simp_now = false;
         void check_recursive_minimization_effectiveness(const lbool status);
         void extend_solution(const bool only_indep_solution);
         void check_too_many_in_tier0();
@@ -698,4 +752,16 @@ inline bool Solver::removed_var_ext(uint32_t var) const
     return value(var) != l_Undef || varData[var].removed != Removed::none;
 }
 
+inline bool Solver::inc_var_dirty(const uint32_t var) const
+{
+    const uint32_t outer = interToOuterMain[var];
+    return outer < inc_dirty_outer.size() && inc_dirty_outer[outer];
+}
+
+inline bool Solver::inc_var_frozen(const uint32_t var) const
+{
+    const uint32_t outer = interToOuterMain[var];
+    return outer < inc_frozen_outer.size() && inc_frozen_outer[outer];
+}
+
 } //end namespace
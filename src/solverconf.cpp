@@ -103,6 +103,9 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , pred_forever_check_every_n(12)
         , pred_distill_only_smallgue(false)
         , pred_dontmove_until_timeinside(1) //always move, don't wait
+        , pred_async(0)
+        , pred_async_wait_ms(20)
+        , pred_async_max_age(25000) //applied at the next pred reduce, i.e. ~10k conflicts later
 
         , every_lev1_reduce(10000) // kept for a while then moved to lev2
         , every_lev2_reduce(15000) // cleared regularly
@@ -180,7 +183,12 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , dump_individual_restarts_and_clauses(true)
         , dump_individual_cldata_ratio(0.01)
         , sql_overwrite_file(0)
+        , sql_async(1)
+        , sql_queue_mb(16)
+        , sql_queue_drop(0)
         , lock_for_data_gen_ratio(0.1)
+        , louvain_threads(0)
+        , louvain_clause_window(16)
 
         //Var-elim
         , doVarElim        (true)
@@ -274,6 +282,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , num_conflicts_of_search_inc(1.4)
         , num_conflicts_of_search_inc_max(10)
         , max_num_simplify_per_solve_call(25)
+        , incremental_fast_path(false)
         , simplify_schedule_startup(
             "sub-impl, occ-backw-sub,"
             "scc-vrepl,"
@@ -298,6 +307,9 @@ DLL_PUBLIC SolverConf::SolverConf() :
             "bosphorus,"
             "louvain-comms,"
         )
+        , inproc_sched(InprocSchedMode::fixed)
+        , inproc_sched_max_boost(4.0)
+        , inproc_sched_max_skip(8)
 
         //Occur based simplification
         , perform_occur_based_simp(true)
@@ -307,6 +319,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , maxOccurRedMB    (600)
         , maxOccurRedLitLinkedM(50)
         , subsume_gothrough_multip(1.0)
+        , occ_threads(1)
 
         //WalkSAT
         , doSLS(true)
@@ -320,6 +333,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , sls_how_many_to_bump(100)
         , sls_bump_var_max_n_times(100)
         , sls_bump_type(6)
+        , sls_walkers(1)
 
         //Distillation
         , do_distill_clauses(true)
@@ -344,6 +358,8 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , must_renumber    (false)
         , doSaveMem        (true)
         , full_watch_consolidate_every_n_confl (4ULL*1000ULL*1000ULL) //validated in run 8113323.wlm01
+        , clause_huge_pages (false)
+        , clause_offset_shift (0)
 
         //Misc optimisations
         , doStrSubImplicit (true)
@@ -371,8 +387,22 @@ DLL_PUBLIC SolverConf::SolverConf() :
 
         //Multi-thread, MPI
         , sync_every_confl(7000) //THREAD syncing
+        , sync_long_cls(true)
+        , sync_long_max_glue(3)
+        , sync_long_max_size(30)
+        , sync_long_ring_slots(1U << 14)
+        , sync_xors(true)
+        , cube_and_conquer(false)
+        , cube_max_depth(8)
+        , cube_lookahead_cands(32)
         , every_n_mpi_sync(3) //every N thread sync, we do an MPI sync
+        , mpi_share_long(true)
+        , mpi_long_max_glue(3)
+        , mpi_long_max_size(20)
+        , mpi_long_max_bytes(64*1024) //per worker, per exchange round
         , thread_num(0)
+        , thread_config_offset(0)
+        , num_threads(1)
         , is_mpi(false)
 
         // Oracle
@@ -53,6 +53,12 @@ inline unsigned clean_to_int(ClauseClean t)
     return 255;
 }
 
+enum class InprocSchedMode {
+    fixed = 0
+    , adaptive = 1 //cost is CPU time
+    , deterministic = 2 //cost is the number of runs
+};
+
 enum class Restart {
     glue = 0
     , geom = 1
@@ -250,6 +256,9 @@ class DLL_PUBLIC SolverConf
         uint32_t pred_forever_check_every_n;
         int   pred_distill_only_smallgue;
         int   pred_dontmove_until_timeinside;
+        int      pred_async;
+        uint32_t pred_async_wait_ms;
+        uint32_t pred_async_max_age;
 
         //if non-zero, we reduce at every X conflicts.
         //Reduced according to whether it's been used recently
@@ -335,7 +344,12 @@ class DLL_PUBLIC SolverConf
         bool      dump_individual_restarts_and_clauses;
         double    dump_individual_cldata_ratio;
         int       sql_overwrite_file;
+        int       sql_async; ///<Write from a separate thread, in batches
+        uint32_t  sql_queue_mb;
+        int       sql_queue_drop; ///<Drop records when the queue is full, instead of waiting
         double    lock_for_data_gen_ratio;
+        uint32_t  louvain_threads; ///<0 = an even share of the hardware threads per solver thread
+        uint32_t  louvain_clause_window;
 
         //Var-elim
         int      doVarElim;          ///<Perform variable elimination
@@ -436,8 +450,12 @@ class DLL_PUBLIC SolverConf
         double   num_conflicts_of_search_inc;
         double   num_conflicts_of_search_inc_max;
         uint32_t max_num_simplify_per_solve_call;
+        int      incremental_fast_path; //only revisit vars touched since last solve() call
         string   simplify_schedule_startup;
         string   simplify_schedule_nonstartup;
+        InprocSchedMode inproc_sched;
+        double   inproc_sched_max_boost;
+        uint32_t inproc_sched_max_skip;
 
         //Simplification
         int      perform_occur_based_simp;
@@ -447,6 +465,7 @@ class DLL_PUBLIC SolverConf
         double maxOccurRedMB;
         double maxOccurRedLitLinkedM;
         double   subsume_gothrough_multip;
+        uint32_t occ_threads; ///<For occur building, sub/str and BVE, 0 = one per hardware thread
 
         //Walksat
         int doSLS;
@@ -460,6 +479,7 @@ class DLL_PUBLIC SolverConf
         uint32_t sls_how_many_to_bump;
         uint32_t sls_bump_var_max_n_times;
         uint32_t sls_bump_type;
+        uint32_t sls_walkers; ///<Independent CCNR walkers run in parallel, 0 = one per hardware thread
 
         //Distillation
         int      do_distill_clauses;
@@ -480,6 +500,8 @@ class DLL_PUBLIC SolverConf
         int       must_renumber; ///< if set, all "renumber" is treated as a "must-renumber"
         int       doSaveMem;
         uint64_t  full_watch_consolidate_every_n_confl;
+        int       clause_huge_pages; ///< ask for transparent huge pages for the clause arena
+        int       clause_offset_shift; ///< clause offsets initially count units of 2^N words
         int must_always_conslidate = 0; // only used for debugging
 
         //Misc Optimisations
@@ -509,8 +531,22 @@ class DLL_PUBLIC SolverConf
 
         //Multi-thread, MPI
         unsigned long long sync_every_confl;
+        int      sync_long_cls;
+        uint32_t sync_long_max_glue;
+        uint32_t sync_long_max_size;
+        uint32_t sync_long_ring_slots;
+        int      sync_xors;
+        int      cube_and_conquer;
+        uint32_t cube_max_depth;
+        uint32_t cube_lookahead_cands;
         uint32_t every_n_mpi_sync;
+        int      mpi_share_long;
+        uint32_t mpi_long_max_glue;
+        uint32_t mpi_long_max_size;
+        uint32_t mpi_long_max_bytes;
         unsigned thread_num;
+        unsigned thread_config_offset;
+        unsigned num_threads; ///<Number of SATSolver threads, they share the hardware threads
         uint32_t is_mpi;
 
         // Oracle
@@ -39,34 +39,31 @@ THE SOFTWARE.
 
 using std::make_pair;
 
-#define bind_null_or_double(stmt,bindat,stucture,func) \
+#define bind_null_or_double(rec,stucture,func) \
 { \
     if (stucture.num_data_elements() == 0) {\
-        sqlite3_bind_null(stmt, bindat); \
+        rec.add_null(); \
     } else { \
-        sqlite3_bind_double(stmt, bindat, stucture.func()); \
+        rec.add_double(stucture.func()); \
     }\
-    bindat++; \
 }
 
-#define bind_null_or_int(stmt,bindat,stucture,func) \
+#define bind_null_or_int(rec,stucture,func) \
 { \
     if (stucture.num_data_elements() == 0) {\
-        sqlite3_bind_null(stmt, bindat); \
+        rec.add_null(); \
     } else { \
-        sqlite3_bind_int(stmt, bindat, stucture.func()); \
+        rec.add_int64(stucture.func()); \
     }\
-    bindat++; \
 }
 
-#define bind_null_or_int64(stmt,bindat,stucture,func) \
+#define bind_null_or_int64(rec,stucture,func) \
 { \
     if (stucture.num_data_elements() == 0) {\
-        sqlite3_bind_null(stmt, bindat); \
+        rec.add_null(); \
     } else { \
-        sqlite3_bind_int64(stmt, bindat, stucture.func()); \
+        rec.add_int64(stucture.func()); \
     }\
-    bindat++; \
 }
 
 using std::cout;
@@ -142,6 +139,7 @@ SQLiteStats::~SQLiteStats()
         return;
 
     dump_id_confl_cache();
+    delete writer;
 
     //Free all the prepared statements
     del_prepared_stmt(stmtRst);
@@ -152,6 +150,7 @@ SQLiteStats::~SQLiteStats()
     del_prepared_stmt(stmtReduceDB_common);
     del_prepared_stmt(stmtTimePassed);
     del_prepared_stmt(stmtMemUsed);
+    del_prepared_stmt(stmtInprocSched);
     del_prepared_stmt(stmt_clause_stats);
     del_prepared_stmt(stmt_delete_cl);
     del_prepared_stmt(stmt_update_id);
@@ -185,6 +184,7 @@ bool SQLiteStats::setup(const Solver* solver)
     addStartupData();
     init("timepassed", &stmtTimePassed);
     init("memused", &stmtMemUsed);
+    init("inprocsched", &stmtInprocSched);
     init("satzilla_features", &stmtFeat);
     init("clause_stats", &stmt_clause_stats);
     init("restart", &stmtRst);
@@ -203,6 +203,10 @@ bool SQLiteStats::setup(const Solver* solver)
     init("var_dist", &stmt_var_dist);
     #endif
 
+    verbosity = solver->conf.verbosity;
+    writer = new SQLiteWriter(db, solver->conf.sql_async,
+        solver->conf.sql_queue_mb*1024ULL*1024ULL, solver->conf.sql_queue_drop);
+
     return true;
 }
 
@@ -236,8 +240,11 @@ bool SQLiteStats::connectServer(const Solver* solver)
         std::exit(-1);
     }
 
-    if (sqlite3_exec(db, "PRAGMA journal_mode = MEMORY", NULL, NULL, NULL)) {
-        cerr << "ERROR: Problem setting pragma journal_mode = MEMORY to SQLite DB" << endl;
+    //The writer thread commits often, WAL makes that cheap
+    const char* journal = solver->conf.sql_async ?
+        "PRAGMA journal_mode = WAL" : "PRAGMA journal_mode = MEMORY";
+    if (sqlite3_exec(db, journal, NULL, NULL, NULL)) {
+        cerr << "ERROR: Problem setting '" << journal << "' to SQLite DB" << endl;
         cerr << "c " << sqlite3_errmsg(db) << endl;
         std::exit(-1);
     }
@@ -252,6 +259,8 @@ bool SQLiteStats::connectServer(const Solver* solver)
 
 void SQLiteStats::begin_transaction()
 {
+    //The writer thread batches rows into transactions itself
+    if (writer->is_async()) return;
     if (sqlite3_exec(db, "BEGIN TRANSACTION", NULL, NULL, NULL)) {
         cerr << "ERROR: Beginning SQLITE transaction" << endl;
         cerr << "c " << sqlite3_errmsg(db) << endl;
@@ -261,6 +270,7 @@ void SQLiteStats::begin_transaction()
 
 void SQLiteStats::end_transaction()
 {
+    if (writer->is_async()) return;
     if (sqlite3_exec(db, "END TRANSACTION", NULL, NULL, NULL)) {
         cerr << "ERROR: Beginning SQLITE transaction" << endl;
         cerr << "c " << sqlite3_errmsg(db) << endl;
@@ -293,6 +303,7 @@ bool SQLiteStats::add_solverrun(const Solver* solver)
 
 void SQLiteStats::add_tag(const std::pair<string, string>& tag)
 {
+    if (writer) writer->flush();
     std::stringstream ss;
     ss
     << "INSERT INTO `tags` (`name`, `val`) VALUES("
@@ -326,6 +337,15 @@ void SQLiteStats::addStartupData()
 
 void SQLiteStats::finishup(const lbool status)
 {
+    writer->flush();
+    if (writer->get_dropped() > 0) {
+        add_tag(make_pair("sql_dropped_records", std::to_string(writer->get_dropped())));
+    }
+    if (verbosity) {
+        cout << "c [sql] records written: " << writer->get_written()
+        << " dropped (queue full): " << writer->get_dropped() << endl;
+    }
+
     std::stringstream ss;
     ss
     << "INSERT INTO `finishup` (`endTime`, `status`) VALUES ("
@@ -356,40 +376,13 @@ void SQLiteStats::writeQuestionMarks(
     ss << ")";
 }
 
-void SQLiteStats::run_sqlite_step(
-    sqlite3_stmt* stmt,
-    const char* name,
-    const uint32_t bindAt)
+void SQLiteStats::add_record(sqlite3_stmt* stmt, const char* name)
 {
     if (name != NULL) {
         assert(query_to_size.find(name) != query_to_size.end());
-        //SQLite numbers them from 1, so it's off-by-one
-        assert(query_to_size[name]+1 == bindAt);
-    }
-
-    int rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) {
-        cout
-        << "ERROR: while executing '" << name << "' SQLite prepared statement"
-        << endl;
-
-        cout << "Error from sqlite: "
-        << sqlite3_errmsg(db)
-        << endl;
-        cout << "Error code from sqlite: " << rc << endl;
-        std::exit(-1);
-    }
-
-    if (sqlite3_reset(stmt)) {
-        cerr << "Error calling sqlite3_reset on cl_last_in_solver" << endl;
-        std::exit(-1);
-    }
-
-    if (sqlite3_clear_bindings(stmt)) {
-        cerr << "Error calling sqlite3_clear_bindings on '"
-        << name << "'" << endl;
-        std::exit(-1);
+        assert(query_to_size[name] == rec.num_vals);
     }
+    writer->push(stmt, rec);
 }
 
 void SQLiteStats::init(const char* name, sqlite3_stmt** stmt, uint32_t num)
@@ -431,16 +424,39 @@ void SQLiteStats::mem_used(
     , double given_time
     , uint64_t mem_used_mb
 ) {
-    int bindAt = 1;
+    rec.clear();
     //Position
-    sqlite3_bind_int64(stmtMemUsed, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmtMemUsed, bindAt++, solver->sumConflicts);
-    sqlite3_bind_double(stmtMemUsed, bindAt++, given_time);
+    rec.add_int64(solver->get_solve_stats().num_simplify);
+    rec.add_int64(solver->sumConflicts);
+    rec.add_double(given_time);
     //memory stats
-    sqlite3_bind_text(stmtMemUsed, bindAt++, name.c_str(), -1, NULL);
-    sqlite3_bind_int(stmtMemUsed, bindAt++, mem_used_mb);
+    rec.add_text(name);
+    rec.add_int64(mem_used_mb);
+
+    add_record(stmtMemUsed, "memused");
+}
 
-    run_sqlite_step(stmtMemUsed, "memused", bindAt);
+void SQLiteStats::inproc_sched(
+    const Solver* solver
+    , const string& unit
+    , const string& decision
+    , double cost
+    , double gain
+    , double utility
+    , double boost
+) {
+    rec.clear();
+    rec.add_int64(solver->get_solve_stats().num_simplify);
+    rec.add_int64(solver->sumConflicts);
+    rec.add_double(cpuTime());
+    rec.add_text(unit);
+    rec.add_text(decision);
+    rec.add_double(cost);
+    rec.add_double(gain);
+    rec.add_double(utility);
+    rec.add_double(boost);
+
+    add_record(stmtInprocSched, "inprocsched");
 }
 
 void SQLiteStats::time_passed(
@@ -451,16 +467,16 @@ void SQLiteStats::time_passed(
     , double percent_time_remain
 ) {
 
-    int bindAt = 1;
-    sqlite3_bind_int64(stmtTimePassed, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmtTimePassed, bindAt++, solver->sumConflicts);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, cpuTime());
-    sqlite3_bind_text(stmtTimePassed, bindAt++, name.c_str(), -1, NULL);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, time_passed);
-    sqlite3_bind_int(stmtTimePassed, bindAt++, time_out);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, percent_time_remain);
+    rec.clear();
+    rec.add_int64(solver->get_solve_stats().num_simplify);
+    rec.add_int64(solver->sumConflicts);
+    rec.add_double(cpuTime());
+    rec.add_text(name);
+    rec.add_double(time_passed);
+    rec.add_int64(time_out);
+    rec.add_double(percent_time_remain);
 
-    run_sqlite_step(stmtTimePassed, "timepassed", bindAt);
+    add_record(stmtTimePassed, "timepassed");
 }
 
 void SQLiteStats::time_passed_min(
@@ -468,33 +484,33 @@ void SQLiteStats::time_passed_min(
     , const string& name
     , double time_passed
 ) {
-    int bindAt = 1;
-    sqlite3_bind_int64(stmtTimePassed, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmtTimePassed, bindAt++, solver->sumConflicts);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, cpuTime());
-    sqlite3_bind_text(stmtTimePassed, bindAt++, name.c_str(), -1, NULL);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, time_passed);
-    sqlite3_bind_null(stmtTimePassed, bindAt++);
-    sqlite3_bind_null(stmtTimePassed, bindAt++);
-
-    run_sqlite_step(stmtTimePassed, "timepassed", bindAt);
+    rec.clear();
+    rec.add_int64(solver->get_solve_stats().num_simplify);
+    rec.add_int64(solver->sumConflicts);
+    rec.add_double(cpuTime());
+    rec.add_text(name);
+    rec.add_double(time_passed);
+    rec.add_null();
+    rec.add_null();
+
+    add_record(stmtTimePassed, "timepassed");
 }
 
 void SQLiteStats::dump_id_confl_cache()
 {
     if (id_conf_cache.size() == 1000) {
-        int bindAt = 1;
+        rec.clear();
         for(auto const& elem: id_conf_cache) {
-            sqlite3_bind_int64(stmt_set_id_confl_1000, bindAt++, elem.first);
-            sqlite3_bind_int64(stmt_set_id_confl_1000, bindAt++, elem.second);
+            rec.add_int64(elem.first);
+            rec.add_int64(elem.second);
         }
-        run_sqlite_step(stmt_set_id_confl_1000, NULL, 0);
+        add_record(stmt_set_id_confl_1000, NULL);
     } else {
         for(auto const& elem: id_conf_cache) {
-            int bindAt = 1;
-            sqlite3_bind_int64(stmt_set_id_confl, bindAt++, elem.first);
-            sqlite3_bind_int64(stmt_set_id_confl, bindAt++, elem.second);
-            run_sqlite_step(stmt_set_id_confl, "set_id_confl", bindAt);
+            rec.clear();
+            rec.add_int64(elem.first);
+            rec.add_int64(elem.second);
+            add_record(stmt_set_id_confl, "set_id_confl");
         }
     }
     id_conf_cache.clear();
@@ -516,90 +532,90 @@ void SQLiteStats::satzilla_features(
     , const Searcher* search
     , const SatZillaFeatures& satzilla_feat
 ) {
-    int bindAt = 1;
-    sqlite3_bind_int64(stmtFeat, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmtFeat, bindAt++, search->sumRestarts());
-    sqlite3_bind_int64(stmtFeat, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int(stmtFeat, bindAt++, solver->latest_satzilla_feature_calc);
+    rec.clear();
+    rec.add_int64(solver->get_solve_stats().num_simplify);
+    rec.add_int64(search->sumRestarts());
+    rec.add_int64(solver->sumConflicts);
+    rec.add_int64(solver->latest_satzilla_feature_calc);
 
-    sqlite3_bind_int64(stmtFeat, bindAt++, (uint64_t)satzilla_feat.numVars);
-    sqlite3_bind_int64(stmtFeat, bindAt++, (uint64_t)satzilla_feat.numClauses);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.var_cl_ratio);
+    rec.add_int64((uint64_t)satzilla_feat.numVars);
+    rec.add_int64((uint64_t)satzilla_feat.numClauses);
+    rec.add_double(satzilla_feat.var_cl_ratio);
 
     //Clause distribution
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.binary);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_spread);
-
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_spread);
-
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_spread);
-
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_spread);
-
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_spread);
+    rec.add_double(satzilla_feat.binary);
+    rec.add_double(satzilla_feat.horn);
+    rec.add_double(satzilla_feat.horn_mean);
+    rec.add_double(satzilla_feat.horn_std);
+    rec.add_double(satzilla_feat.horn_min);
+    rec.add_double(satzilla_feat.horn_max);
+    rec.add_double(satzilla_feat.horn_spread);
+
+    rec.add_double(satzilla_feat.vcg_var_mean);
+    rec.add_double(satzilla_feat.vcg_var_std);
+    rec.add_double(satzilla_feat.vcg_var_min);
+    rec.add_double(satzilla_feat.vcg_var_max);
+    rec.add_double(satzilla_feat.vcg_var_spread);
+
+    rec.add_double(satzilla_feat.vcg_cls_mean);
+    rec.add_double(satzilla_feat.vcg_cls_std);
+    rec.add_double(satzilla_feat.vcg_cls_min);
+    rec.add_double(satzilla_feat.vcg_cls_max);
+    rec.add_double(satzilla_feat.vcg_cls_spread);
+
+    rec.add_double(satzilla_feat.pnr_var_mean);
+    rec.add_double(satzilla_feat.pnr_var_std);
+    rec.add_double(satzilla_feat.pnr_var_min);
+    rec.add_double(satzilla_feat.pnr_var_max);
+    rec.add_double(satzilla_feat.pnr_var_spread);
+
+    rec.add_double(satzilla_feat.pnr_cls_mean);
+    rec.add_double(satzilla_feat.pnr_cls_std);
+    rec.add_double(satzilla_feat.pnr_cls_min);
+    rec.add_double(satzilla_feat.pnr_cls_max);
+    rec.add_double(satzilla_feat.pnr_cls_spread);
 
     //Conflict clauses
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_confl_size);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_size_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_size_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_confl_glue);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_glue_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_glue_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_num_resolutions);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.num_resolutions_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.num_resolutions_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.learnt_bins_per_confl);
+    rec.add_double(satzilla_feat.avg_confl_size);
+    rec.add_double(satzilla_feat.confl_size_min);
+    rec.add_double(satzilla_feat.confl_size_max);
+    rec.add_double(satzilla_feat.avg_confl_glue);
+    rec.add_double(satzilla_feat.confl_glue_min);
+    rec.add_double(satzilla_feat.confl_glue_max);
+    rec.add_double(satzilla_feat.avg_num_resolutions);
+    rec.add_double(satzilla_feat.num_resolutions_min);
+    rec.add_double(satzilla_feat.num_resolutions_max);
+    rec.add_double(satzilla_feat.learnt_bins_per_confl);
 
     //Search
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_branch_depth);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.branch_depth_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.branch_depth_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_trail_depth_delta);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.trail_depth_delta_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.trail_depth_delta_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_branch_depth_delta);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.props_per_confl);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_per_restart);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.decisions_per_conflict);
+    rec.add_double(satzilla_feat.avg_branch_depth);
+    rec.add_double(satzilla_feat.branch_depth_min);
+    rec.add_double(satzilla_feat.branch_depth_max);
+    rec.add_double(satzilla_feat.avg_trail_depth_delta);
+    rec.add_double(satzilla_feat.trail_depth_delta_min);
+    rec.add_double(satzilla_feat.trail_depth_delta_max);
+    rec.add_double(satzilla_feat.avg_branch_depth_delta);
+    rec.add_double(satzilla_feat.props_per_confl);
+    rec.add_double(satzilla_feat.confl_per_restart);
+    rec.add_double(satzilla_feat.decisions_per_conflict);
 
     //red stats
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.glue_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.glue_distr_var);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.size_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.size_distr_var);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.activity_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.activity_distr_var);
+    rec.add_double(satzilla_feat.red_cl_distrib.glue_distr_mean);
+    rec.add_double(satzilla_feat.red_cl_distrib.glue_distr_var);
+    rec.add_double(satzilla_feat.red_cl_distrib.size_distr_mean);
+    rec.add_double(satzilla_feat.red_cl_distrib.size_distr_var);
+    rec.add_double(satzilla_feat.red_cl_distrib.activity_distr_mean);
+    rec.add_double(satzilla_feat.red_cl_distrib.activity_distr_var);
 
     //irred stats
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.glue_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.glue_distr_var);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.size_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.size_distr_var);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.activity_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.activity_distr_var);
-
-    run_sqlite_step(stmtFeat, "satzilla_features", bindAt);
+    rec.add_double(satzilla_feat.irred_cl_distrib.glue_distr_mean);
+    rec.add_double(satzilla_feat.irred_cl_distrib.glue_distr_var);
+    rec.add_double(satzilla_feat.irred_cl_distrib.size_distr_mean);
+    rec.add_double(satzilla_feat.irred_cl_distrib.size_distr_var);
+    rec.add_double(satzilla_feat.irred_cl_distrib.activity_distr_mean);
+    rec.add_double(satzilla_feat.irred_cl_distrib.activity_distr_var);
+
+    add_record(stmtFeat, "satzilla_features");
 }
 
 void SQLiteStats::restart(
@@ -626,95 +642,95 @@ void SQLiteStats::restart(
     const SearchHist& searchHist = search->getHistory();
     const BinTriStats& binTri = solver->getBinTriStats();
 
-    int bindAt = 1;
-    sqlite3_bind_int64(stmt, bindAt++, restartID);
+    rec.clear();
+    rec.add_int64(restartID);
     if (clauseID == -1) {
-        sqlite3_bind_null(stmt, bindAt++);
+        rec.add_null();
     } else {
-        sqlite3_bind_int64(stmt, bindAt++, clauseID);
+        rec.add_int64(clauseID);
     }
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmt, bindAt++, search->sumRestarts());
-    sqlite3_bind_int64(stmt, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int  (stmt, bindAt++, searchHist.num_conflicts_this_restart);
-    sqlite3_bind_int  (stmt, bindAt++, solver->latest_satzilla_feature_calc);
-    sqlite3_bind_double(stmt, bindAt++, cpuTime());
+    rec.add_int64(solver->get_solve_stats().num_simplify);
+    rec.add_int64(search->sumRestarts());
+    rec.add_int64(solver->sumConflicts);
+    rec.add_int64(searchHist.num_conflicts_this_restart);
+    rec.add_int64(solver->latest_satzilla_feature_calc);
+    rec.add_double(cpuTime());
 
 
-    sqlite3_bind_int64(stmt, bindAt++, binTri.irredBins);
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_num_long_irred_cls());
-    sqlite3_bind_int64(stmt, bindAt++, binTri.redBins);
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_num_long_red_cls());
+    rec.add_int64(binTri.irredBins);
+    rec.add_int64(solver->get_num_long_irred_cls());
+    rec.add_int64(binTri.redBins);
+    rec.add_int64(solver->get_num_long_red_cls());
 
-    sqlite3_bind_int64(stmt, bindAt++, solver->litStats.irredLits);
-    sqlite3_bind_int64(stmt, bindAt++, solver->litStats.redLits);
+    rec.add_int64(solver->litStats.irredLits);
+    rec.add_int64(solver->litStats.redLits);
 
     //Conflict stats
-    bind_null_or_double(stmt, bindAt,   searchHist.glueHist.getLongtTerm(),avg)
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.glueHist.getLongtTerm().var()));
-    bind_null_or_double(stmt, bindAt,   searchHist.glueHist.getLongtTerm(),getMin)
-    bind_null_or_double(stmt, bindAt,   searchHist.glueHist.getLongtTerm(),getMax)
+    bind_null_or_double(rec, searchHist.glueHist.getLongtTerm(),avg)
+    rec.add_double(std:: sqrt(searchHist.glueHist.getLongtTerm().var()));
+    bind_null_or_double(rec, searchHist.glueHist.getLongtTerm(),getMin)
+    bind_null_or_double(rec, searchHist.glueHist.getLongtTerm(),getMax)
 
-    bind_null_or_double(stmt, bindAt,   searchHist.conflSizeHist, avg)
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.conflSizeHist.var()));
-    bind_null_or_double(stmt, bindAt,   searchHist.conflSizeHist,getMin)
-    bind_null_or_double(stmt, bindAt,   searchHist.conflSizeHist,getMax)
+    bind_null_or_double(rec, searchHist.conflSizeHist, avg)
+    rec.add_double(std:: sqrt(searchHist.conflSizeHist.var()));
+    bind_null_or_double(rec, searchHist.conflSizeHist,getMin)
+    bind_null_or_double(rec, searchHist.conflSizeHist,getMax)
 
-    bind_null_or_double(stmt, bindAt,   searchHist.numResolutionsHist, avg)
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.numResolutionsHist.var()));
-    bind_null_or_double(stmt, bindAt,   searchHist.numResolutionsHist,getMin)
-    bind_null_or_double(stmt, bindAt,   searchHist.numResolutionsHist,getMax)
+    bind_null_or_double(rec, searchHist.numResolutionsHist, avg)
+    rec.add_double(std:: sqrt(searchHist.numResolutionsHist.var()));
+    bind_null_or_double(rec, searchHist.numResolutionsHist,getMin)
+    bind_null_or_double(rec, searchHist.numResolutionsHist,getMax)
 
     //Search stats
-    bind_null_or_double(stmt, bindAt,   searchHist.branchDepthHist,avg)
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.branchDepthHist.var()));
-    bind_null_or_double(stmt, bindAt, searchHist.branchDepthHist,getMin)
-    bind_null_or_double(stmt, bindAt, searchHist.branchDepthHist,getMax)
-
-    bind_null_or_double(stmt, bindAt,   searchHist.branchDepthDeltaHist,avg)
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.branchDepthDeltaHist.var()));
-    bind_null_or_double(stmt, bindAt,   searchHist.branchDepthDeltaHist,getMin)
-    bind_null_or_double(stmt, bindAt,   searchHist.branchDepthDeltaHist,getMax)
-
-    bind_null_or_double(stmt, bindAt, searchHist.trailDepthHist.getLongtTerm(),avg)
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.trailDepthHist.getLongtTerm().var()));
-    bind_null_or_double(stmt, bindAt,   searchHist.trailDepthHist.getLongtTerm(),getMin)
-    bind_null_or_double(stmt, bindAt,   searchHist.trailDepthHist.getLongtTerm(),getMax)
-
-    bind_null_or_double(stmt, bindAt,   searchHist.trailDepthDeltaHist,avg)
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.trailDepthDeltaHist.var()));
-    bind_null_or_double(stmt, bindAt,   searchHist.trailDepthDeltaHist,getMin)
-    bind_null_or_double(stmt, bindAt,   searchHist.trailDepthDeltaHist,getMax)
+    bind_null_or_double(rec, searchHist.branchDepthHist,avg)
+    rec.add_double(std:: sqrt(searchHist.branchDepthHist.var()));
+    bind_null_or_double(rec, searchHist.branchDepthHist,getMin)
+    bind_null_or_double(rec, searchHist.branchDepthHist,getMax)
+
+    bind_null_or_double(rec, searchHist.branchDepthDeltaHist,avg)
+    rec.add_double(std:: sqrt(searchHist.branchDepthDeltaHist.var()));
+    bind_null_or_double(rec, searchHist.branchDepthDeltaHist,getMin)
+    bind_null_or_double(rec, searchHist.branchDepthDeltaHist,getMax)
+
+    bind_null_or_double(rec, searchHist.trailDepthHist.getLongtTerm(),avg)
+    rec.add_double(std:: sqrt(searchHist.trailDepthHist.getLongtTerm().var()));
+    bind_null_or_double(rec, searchHist.trailDepthHist.getLongtTerm(),getMin)
+    bind_null_or_double(rec, searchHist.trailDepthHist.getLongtTerm(),getMax)
+
+    bind_null_or_double(rec, searchHist.trailDepthDeltaHist,avg)
+    rec.add_double(std:: sqrt(searchHist.trailDepthDeltaHist.var()));
+    bind_null_or_double(rec, searchHist.trailDepthDeltaHist,getMin)
+    bind_null_or_double(rec, searchHist.trailDepthDeltaHist,getMax)
 
     //Red
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.learntUnits);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.learntBins);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.learntLongs);
+    rec.add_int64(thisStats.learntUnits);
+    rec.add_int64(thisStats.learntBins);
+    rec.add_int64(thisStats.learntLongs);
 
     //Resolv stats
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.resolvs.binIrred);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.resolvs.binRed);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.resolvs.longIrred);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.resolvs.longRed);
+    rec.add_int64(thisStats.resolvs.binIrred);
+    rec.add_int64(thisStats.resolvs.binRed);
+    rec.add_int64(thisStats.resolvs.longIrred);
+    rec.add_int64(thisStats.resolvs.longRed);
 
 
     //Var stats
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.propagations);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.decisions);
+    rec.add_int64(thisPropStats.propagations);
+    rec.add_int64(thisStats.decisions);
 
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.varFlipped);
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.varSetPos);
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.varSetNeg);
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_num_free_vars());
-    sqlite3_bind_int64(stmt, bindAt++, solver->varReplacer->get_num_replaced_vars());
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_num_vars_elimed());
-    sqlite3_bind_int64(stmt, bindAt++, search->getTrailSize());
+    rec.add_int64(thisPropStats.varFlipped);
+    rec.add_int64(thisPropStats.varSetPos);
+    rec.add_int64(thisPropStats.varSetNeg);
+    rec.add_int64(solver->get_num_free_vars());
+    rec.add_int64(solver->varReplacer->get_num_replaced_vars());
+    rec.add_int64(solver->get_num_vars_elimed());
+    rec.add_int64(search->getTrailSize());
 
     //strategy
-    sqlite3_bind_int(stmt, bindAt++, (int)solver->branch_strategy);
-    sqlite3_bind_int(stmt, bindAt++, (int)rest_type);
+    rec.add_int64((int)solver->branch_strategy);
+    rec.add_int64((int)rest_type);
 
-    run_sqlite_step(stmt, rst_dat_type_to_str(type), bindAt);
+    add_record(stmt, rst_dat_type_to_str(type));
 }
 
 
@@ -726,52 +742,52 @@ void SQLiteStats::reduceDB_common(
     const MedianCommonDataRDB& median_data,
     const AverageCommonDataRDB& avg_data)
 {
-    int bindAt = 1;
-
-    sqlite3_bind_int(stmtReduceDB_common, bindAt++, reduceDB_called);
-
-    sqlite3_bind_int64 (stmtReduceDB_common, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64 (stmtReduceDB_common, bindAt++, solver->sumRestarts());
-    sqlite3_bind_int64 (stmtReduceDB_common, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int64 (stmtReduceDB_common, bindAt++, solver->latest_satzilla_feature_calc);
-    sqlite3_bind_int   (stmtReduceDB_common, bindAt++, cur_rst_type);
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, cpuTime());
-    sqlite3_bind_int   (stmtReduceDB_common, bindAt++, tot_cls_in_db);
-
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, (double)median_data.median_act);
-    sqlite3_bind_int   (stmtReduceDB_common, bindAt++, median_data.median_uip1_used);
-    sqlite3_bind_int   (stmtReduceDB_common, bindAt++, median_data.median_props);
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, median_data.median_sum_uip1_per_time);
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, median_data.median_sum_props_per_time);
-
-    //sqlite3_bind_double(stmtReduceDB_common, bindAt++, avg_data.avg_glue);
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, avg_data.avg_props);
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, avg_data.avg_uip1_used);
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, avg_data.avg_sum_uip1_per_time);
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, avg_data.avg_sum_props_per_time);
-
-
-    sqlite3_bind_int   (stmtReduceDB_common, bindAt++, solver->nVars());
-    sqlite3_bind_int   (stmtReduceDB_common, bindAt++, solver->longIrredCls.size());
-    sqlite3_bind_int   (stmtReduceDB_common, bindAt++, solver->litStats.irredLits);
+    rec.clear();
+
+    rec.add_int64(reduceDB_called);
+
+    rec.add_int64(solver->get_solve_stats().num_simplify);
+    rec.add_int64(solver->sumRestarts());
+    rec.add_int64(solver->sumConflicts);
+    rec.add_int64(solver->latest_satzilla_feature_calc);
+    rec.add_int64(cur_rst_type);
+    rec.add_double(cpuTime());
+    rec.add_int64(tot_cls_in_db);
+
+    rec.add_double((double)median_data.median_act);
+    rec.add_int64(median_data.median_uip1_used);
+    rec.add_int64(median_data.median_props);
+    rec.add_double(median_data.median_sum_uip1_per_time);
+    rec.add_double(median_data.median_sum_props_per_time);
+
+    //rec.add_double(avg_data.avg_glue);
+    rec.add_double(avg_data.avg_props);
+    rec.add_double(avg_data.avg_uip1_used);
+    rec.add_double(avg_data.avg_sum_uip1_per_time);
+    rec.add_double(avg_data.avg_sum_props_per_time);
+
+
+    rec.add_int64(solver->nVars());
+    rec.add_int64(solver->longIrredCls.size());
+    rec.add_int64(solver->litStats.irredLits);
     uint32_t total_long_red_cls = 0;
     for(const auto& cls: solver->longRedCls) {
         total_long_red_cls += cls.size();
     }
-    sqlite3_bind_int(stmtReduceDB_common, bindAt++, total_long_red_cls);
-    sqlite3_bind_int(stmtReduceDB_common, bindAt++, solver->litStats.redLits);
-    sqlite3_bind_int(stmtReduceDB_common, bindAt++, solver->binTri.irredBins);
-    sqlite3_bind_int(stmtReduceDB_common, bindAt++, solver->binTri.redBins);
-
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, solver->hist.trailDepthHistLT.avg());
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, solver->hist.backtrackLevelHistLT.avg());
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, solver->hist.conflSizeHistLT.avg());
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, solver->hist.numResolutionsHistLT.avg());
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, solver->hist.glueHistLT.avg());
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, solver->hist.antec_data_sum_sizeHistLT.avg());
-    sqlite3_bind_double(stmtReduceDB_common, bindAt++, solver->hist.overlapHistLT.avg());
-
-    run_sqlite_step(stmtReduceDB_common, "reduceDB_common", bindAt);
+    rec.add_int64(total_long_red_cls);
+    rec.add_int64(solver->litStats.redLits);
+    rec.add_int64(solver->binTri.irredBins);
+    rec.add_int64(solver->binTri.redBins);
+
+    rec.add_double(solver->hist.trailDepthHistLT.avg());
+    rec.add_double(solver->hist.backtrackLevelHistLT.avg());
+    rec.add_double(solver->hist.conflSizeHistLT.avg());
+    rec.add_double(solver->hist.numResolutionsHistLT.avg());
+    rec.add_double(solver->hist.glueHistLT.avg());
+    rec.add_double(solver->hist.antec_data_sum_sizeHistLT.avg());
+    rec.add_double(solver->hist.overlapHistLT.avg());
+
+    add_record(stmtReduceDB_common, "reduceDB_common");
 }
 
 void SQLiteStats::reduceDB(
@@ -783,59 +799,59 @@ void SQLiteStats::reduceDB(
     const ClauseStatsExtra& stats_extra = solver->red_stats_extra[cl->stats.extra_pos];
     assert(stats_extra.dump_no != numeric_limits<uint16_t>::max());
 
-    int bindAt = 1;
+    rec.clear();
 
     //Global data ("conflicts" is needed because otherwise
     //       code is complicated in data sampler), even though this data
     //       is available in reduceDB_common
-    sqlite3_bind_int(stmtReduceDB, bindAt++, reduceDB_called);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, stats_extra.introduced_at_conflict);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->stats.which_red_array);
+    rec.add_int64(reduceDB_called);
+    rec.add_int64(solver->sumConflicts);
+    rec.add_int64(stats_extra.introduced_at_conflict);
+    rec.add_int64(cl->stats.which_red_array);
 
     //data
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, stats_extra.orig_ID);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, stats_extra.dump_no);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, stats_extra.conflicts_made);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, cl->stats.props_made);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, stats_extra.sum_props_made);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, cl->stats.uip1_used);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, stats_extra.sum_uip1_used);
+    rec.add_int64(stats_extra.orig_ID);
+    rec.add_int64(stats_extra.dump_no);
+    rec.add_int64(stats_extra.conflicts_made);
+    rec.add_int64(cl->stats.props_made);
+    rec.add_int64(stats_extra.sum_props_made);
+    rec.add_int64(cl->stats.uip1_used);
+    rec.add_int64(stats_extra.sum_uip1_used);
 
     assert(cl->stats.last_touched_any <= solver->sumConflicts);
     int64_t last_touched_any_diff = solver->sumConflicts - cl->stats.last_touched_any;
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, last_touched_any_diff);
-    sqlite3_bind_double(stmtReduceDB, bindAt++, (double)cl->stats.activity/(double)solver->get_cla_inc());
-    sqlite3_bind_int(stmtReduceDB, bindAt++, locked);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->used_in_xor());
+    rec.add_int64(last_touched_any_diff);
+    rec.add_double((double)cl->stats.activity/(double)solver->get_cla_inc());
+    rec.add_int64(locked);
+    rec.add_int64(cl->used_in_xor());
     if (cl->stats.is_ternary_resolvent) {
-        sqlite3_bind_null(stmtReduceDB, bindAt++);
+        rec.add_null();
     } else {
-        sqlite3_bind_int(stmtReduceDB, bindAt++, cl->stats.glue);
+        rec.add_int64(cl->stats.glue);
     }
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->size());
-    sqlite3_bind_int(stmtReduceDB, bindAt++, stats_extra.ttl_stats);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->stats.is_ternary_resolvent);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->stats.is_decision);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->distilled);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, stats_extra.connects_num_communities);
+    rec.add_int64(cl->size());
+    rec.add_int64(stats_extra.ttl_stats);
+    rec.add_int64(cl->stats.is_ternary_resolvent);
+    rec.add_int64(cl->stats.is_decision);
+    rec.add_int64(cl->distilled);
+    rec.add_int64(stats_extra.connects_num_communities);
 
     //Ranking
-    sqlite3_bind_int(stmtReduceDB, bindAt++, stats_extra.act_ranking);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, stats_extra.prop_ranking);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, stats_extra.uip1_ranking);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, stats_extra.sum_uip1_per_time_ranking);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, stats_extra.sum_props_per_time_ranking);
+    rec.add_int64(stats_extra.act_ranking);
+    rec.add_int64(stats_extra.prop_ranking);
+    rec.add_int64(stats_extra.uip1_ranking);
+    rec.add_int64(stats_extra.sum_uip1_per_time_ranking);
+    rec.add_int64(stats_extra.sum_props_per_time_ranking);
 
     //Discounted
-    sqlite3_bind_double(stmtReduceDB, bindAt++, (double)stats_extra.discounted_uip1_used);
-    sqlite3_bind_double(stmtReduceDB, bindAt++, (double)stats_extra.discounted_props_made);
-    sqlite3_bind_double(stmtReduceDB, bindAt++, (double)stats_extra.discounted_uip1_used2);
-    sqlite3_bind_double(stmtReduceDB, bindAt++, (double)stats_extra.discounted_props_made2);
-    sqlite3_bind_double(stmtReduceDB, bindAt++, (double)stats_extra.discounted_uip1_used3);
-    sqlite3_bind_double(stmtReduceDB, bindAt++, (double)stats_extra.discounted_props_made3);
-
-    run_sqlite_step(stmtReduceDB, "reduceDB", bindAt);
+    rec.add_double((double)stats_extra.discounted_uip1_used);
+    rec.add_double((double)stats_extra.discounted_props_made);
+    rec.add_double((double)stats_extra.discounted_uip1_used2);
+    rec.add_double((double)stats_extra.discounted_props_made2);
+    rec.add_double((double)stats_extra.discounted_uip1_used3);
+    rec.add_double((double)stats_extra.discounted_props_made3);
+
+    add_record(stmtReduceDB, "reduceDB");
 }
 
 void SQLiteStats::clause_stats(
@@ -858,64 +874,64 @@ void SQLiteStats::clause_stats(
 ) {
     uint32_t num_overlap_literals = antec_data.sum_size()-(antec_data.num()-1)-size;
 
-    int bindAt = 1;
-    sqlite3_bind_int64(stmt_clause_stats, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmt_clause_stats, bindAt++, solver->sumRestarts());
+    rec.clear();
+    rec.add_int64(solver->get_solve_stats().num_simplify);
+    rec.add_int64(solver->sumRestarts());
     if (solver->sumRestarts() == 0) {
-        sqlite3_bind_int64(stmt_clause_stats, bindAt++, 0);
+        rec.add_int64(0);
     } else {
-        sqlite3_bind_int64(stmt_clause_stats, bindAt++, solver->sumRestarts()-1);
+        rec.add_int64(solver->sumRestarts()-1);
     }
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, solver->latest_satzilla_feature_calc);
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, clid);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, restartID);
-
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, glue);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, glue_before_minim);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, size);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, size_before_minim);
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, conflicts_this_restart);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, num_overlap_literals);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.num());
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.sum_size());
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, is_decision);
-
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, backtrack_level);
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, decision_level);
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, hist.branchDepthHistQueue.prev(1));
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, hist.branchDepthHistQueue.prev(2));
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, trail_depth);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, restart_type);
-
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.binIrred);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.binRed);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.longIrred);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.longRed);
-
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.decisionLevelHistLT,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.backtrackLevelHistLT,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.trailDepthHistLT,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.conflSizeHistLT,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.glueHistLT,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.connects_num_communities_histLT,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.numResolutionsHistLT,avg)
-
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.antec_data_sum_sizeHistLT,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.overlapHistLT,avg)
-
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.branchDepthHistQueue,avg_nocheck)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.trailDepthHist,avg_nocheck)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.trailDepthHistLonger,avg_nocheck)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.numResolutionsHist,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.conflSizeHist,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.trailDepthDeltaHist,avg)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.backtrackLevelHist,avg_nocheck)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.glueHist,avg_nocheck)
-    bind_null_or_double(stmt_clause_stats, bindAt, hist.glueHist.getLongtTerm(),avg)
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, orig_connects_num_communities);
-
-    run_sqlite_step(stmt_clause_stats, "clause_stats", bindAt);
+    rec.add_int64(solver->sumConflicts);
+    rec.add_int64(solver->latest_satzilla_feature_calc);
+    rec.add_int64(clid);
+    rec.add_int64(restartID);
+
+    rec.add_int64(glue);
+    rec.add_int64(glue_before_minim);
+    rec.add_int64(size);
+    rec.add_int64(size_before_minim);
+    rec.add_int64(conflicts_this_restart);
+    rec.add_int64(num_overlap_literals);
+    rec.add_int64(antec_data.num());
+    rec.add_int64(antec_data.sum_size());
+    rec.add_int64(is_decision);
+
+    rec.add_int64(backtrack_level);
+    rec.add_int64(decision_level);
+    rec.add_int64(hist.branchDepthHistQueue.prev(1));
+    rec.add_int64(hist.branchDepthHistQueue.prev(2));
+    rec.add_int64(trail_depth);
+    rec.add_int64(restart_type);
+
+    rec.add_int64(antec_data.binIrred);
+    rec.add_int64(antec_data.binRed);
+    rec.add_int64(antec_data.longIrred);
+    rec.add_int64(antec_data.longRed);
+
+    bind_null_or_double(rec, hist.decisionLevelHistLT,avg)
+    bind_null_or_double(rec, hist.backtrackLevelHistLT,avg)
+    bind_null_or_double(rec, hist.trailDepthHistLT,avg)
+    bind_null_or_double(rec, hist.conflSizeHistLT,avg)
+    bind_null_or_double(rec, hist.glueHistLT,avg)
+    bind_null_or_double(rec, hist.connects_num_communities_histLT,avg)
+    bind_null_or_double(rec, hist.numResolutionsHistLT,avg)
+
+    bind_null_or_double(rec, hist.antec_data_sum_sizeHistLT,avg)
+    bind_null_or_double(rec, hist.overlapHistLT,avg)
+
+    bind_null_or_double(rec, hist.branchDepthHistQueue,avg_nocheck)
+    bind_null_or_double(rec, hist.trailDepthHist,avg_nocheck)
+    bind_null_or_double(rec, hist.trailDepthHistLonger,avg_nocheck)
+    bind_null_or_double(rec, hist.numResolutionsHist,avg)
+    bind_null_or_double(rec, hist.conflSizeHist,avg)
+    bind_null_or_double(rec, hist.trailDepthDeltaHist,avg)
+    bind_null_or_double(rec, hist.backtrackLevelHist,avg_nocheck)
+    bind_null_or_double(rec, hist.glueHist,avg_nocheck)
+    bind_null_or_double(rec, hist.glueHist.getLongtTerm(),avg)
+    rec.add_int64(orig_connects_num_communities);
+
+    add_record(stmt_clause_stats, "clause_stats");
 }
 
 #ifdef STATS_NEEDED_BRANCH
@@ -925,84 +941,85 @@ void SQLiteStats::var_data_fintime(
     , const VarData& vardata
     , const double rel_activity
 ) {
-    int bindAt = 1;
-    sqlite3_bind_int   (stmt_var_data_fintime, bindAt++, var);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, vardata.sumConflicts_at_picktime);
-
-    sqlite3_bind_double (stmt_var_data_fintime, bindAt++, rel_activity);
-
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, vardata.inside_conflict_clause);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, vardata.inside_conflict_clause_antecedents);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, vardata.inside_conflict_clause_glue);
-
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumDecisions);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumPropagations);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumAntecedents);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumAntecedentsLits);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumConflictClauseLits);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumDecisionBasedCl);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumClLBD);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumClSize);
-
-    run_sqlite_step(stmt_var_data_fintime, "var_data_fintime");
+    rec.clear();
+    rec.add_int64(var);
+    rec.add_int64(vardata.sumConflicts_at_picktime);
+
+    rec.add_double(rel_activity);
+
+    rec.add_int64(vardata.inside_conflict_clause);
+    rec.add_int64(vardata.inside_conflict_clause_antecedents);
+    rec.add_int64(vardata.inside_conflict_clause_glue);
+
+    rec.add_int64(solver->sumDecisions);
+    rec.add_int64(solver->sumConflicts);
+    rec.add_int64(solver->sumPropagations);
+    rec.add_int64(solver->sumAntecedents);
+    rec.add_int64(solver->sumAntecedentsLits);
+    rec.add_int64(solver->sumConflictClauseLits);
+    rec.add_int64(solver->sumDecisionBasedCl);
+    rec.add_int64(solver->sumClLBD);
+    rec.add_int64(solver->sumClSize);
+
+    add_record(stmt_var_data_fintime, "var_data_fintime");
 }
 
 void SQLiteStats::var_data_picktime(
     const Solver* solver
     , const uint32_t var
     , const VarData& vardata
+    , const VarHot& varhot
     , const double rel_activity
 ) {
-    int bindAt = 1;
-    sqlite3_bind_int   (stmt_var_data_picktime, bindAt++, var);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.level);
-    sqlite3_bind_double(stmt_var_data_picktime, bindAt++, rel_activity);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->latest_vardist_feature_calc);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_antecedents);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_glue);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_antecedents_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_glue_during);
-
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_decided);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_decided_pos);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_propagated);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_propagated_pos);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_seen_in_1uip);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_decided_on);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_propagated);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_canceled);
-
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumDecisions);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumPropagations);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumAntecedents);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumAntecedentsLits);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflictClauseLits);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumDecisionBasedCl);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumClLBD);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumClSize);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumConflicts_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumDecisions_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumPropagations_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumAntecedents_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumAntecedentsLits_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumConflictClauseLits_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumDecisionBasedCl_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumClLBD_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumClSize_below_during);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_flipped);
-
-    run_sqlite_step(stmt_var_data_picktime, "var_data_picktime");
+    rec.clear();
+    rec.add_int64(var);
+    rec.add_int64(varhot.level);
+    rec.add_double(rel_activity);
+    rec.add_int64(solver->latest_vardist_feature_calc);
+
+    rec.add_int64(vardata.inside_conflict_clause);
+    rec.add_int64(vardata.inside_conflict_clause_antecedents);
+    rec.add_int64(vardata.inside_conflict_clause_glue);
+
+    rec.add_int64(vardata.inside_conflict_clause_during);
+    rec.add_int64(vardata.inside_conflict_clause_antecedents_during);
+    rec.add_int64(vardata.inside_conflict_clause_glue_during);
+
+
+    rec.add_int64(vardata.num_decided);
+    rec.add_int64(vardata.num_decided_pos);
+    rec.add_int64(vardata.num_propagated);
+    rec.add_int64(vardata.num_propagated_pos);
+
+    rec.add_int64(solver->sumConflicts-vardata.last_seen_in_1uip);
+    rec.add_int64(solver->sumConflicts-vardata.last_decided_on);
+    rec.add_int64(solver->sumConflicts-vardata.last_propagated);
+    rec.add_int64(solver->sumConflicts-vardata.last_canceled);
+
+
+    rec.add_int64(solver->sumDecisions);
+    rec.add_int64(solver->sumConflicts);
+    rec.add_int64(solver->sumPropagations);
+    rec.add_int64(solver->sumAntecedents);
+    rec.add_int64(solver->sumAntecedentsLits);
+    rec.add_int64(solver->sumConflictClauseLits);
+    rec.add_int64(solver->sumDecisionBasedCl);
+    rec.add_int64(solver->sumClLBD);
+    rec.add_int64(solver->sumClSize);
+
+    rec.add_int64(vardata.sumConflicts_below_during);
+    rec.add_int64(vardata.sumDecisions_below_during);
+    rec.add_int64(vardata.sumPropagations_below_during);
+    rec.add_int64(vardata.sumAntecedents_below_during);
+    rec.add_int64(vardata.sumAntecedentsLits_below_during);
+    rec.add_int64(vardata.sumConflictClauseLits_below_during);
+    rec.add_int64(vardata.sumDecisionBasedCl_below_during);
+    rec.add_int64(vardata.sumClLBD_below_during);
+    rec.add_int64(vardata.sumClSize_below_during);
+
+    rec.add_int64(solver->sumConflicts-vardata.last_flipped);
+
+    add_record(stmt_var_data_picktime, "var_data_picktime");
 }
 
 void SQLiteStats::var_dist(
@@ -1010,40 +1027,40 @@ void SQLiteStats::var_dist(
     , const VarData2& data
     , const Solver* solver
 ) {
-    int bindAt = 1;
-    sqlite3_bind_int(stmt_var_dist, bindAt++, var);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->latest_vardist_feature_calc);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->sumConflicts);
+    rec.clear();
+    rec.add_int64(var);
+    rec.add_int64(solver->latest_vardist_feature_calc);
+    rec.add_int64(solver->sumConflicts);
 
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->longIrredCls.size());
+    rec.add_int64(solver->longIrredCls.size());
     uint32_t num = 0;
     for(auto& x: solver->longRedCls) {
         num+=x.size();
     }
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, num);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->binTri.irredBins);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->binTri.redBins);
-
-
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.num_times_in_bin_clause);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.num_times_in_long_clause);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.satisfies_cl);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.falsifies_cl);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.tot_num_lit_of_bin_it_appears_in);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.tot_num_lit_of_long_cls_it_appears_in);
-    sqlite3_bind_double(stmt_var_dist, bindAt++, data.red.sum_var_act_of_cls);
-
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.num_times_in_bin_clause);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.num_times_in_long_clause);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.satisfies_cl);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.falsifies_cl);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.tot_num_lit_of_bin_it_appears_in);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.tot_num_lit_of_long_cls_it_appears_in);
-    sqlite3_bind_double(stmt_var_dist, bindAt++, data.irred.sum_var_act_of_cls);
-
-    sqlite3_bind_double(stmt_var_dist, bindAt++, data.tot_act_long_red_cls);
-
-    run_sqlite_step(stmt_var_dist, "var_dist");
+    rec.add_int64(num);
+    rec.add_int64(solver->binTri.irredBins);
+    rec.add_int64(solver->binTri.redBins);
+
+
+    rec.add_int64(data.red.num_times_in_bin_clause);
+    rec.add_int64(data.red.num_times_in_long_clause);
+    rec.add_int64(data.red.satisfies_cl);
+    rec.add_int64(data.red.falsifies_cl);
+    rec.add_int64(data.red.tot_num_lit_of_bin_it_appears_in);
+    rec.add_int64(data.red.tot_num_lit_of_long_cls_it_appears_in);
+    rec.add_double(data.red.sum_var_act_of_cls);
+
+    rec.add_int64(data.irred.num_times_in_bin_clause);
+    rec.add_int64(data.irred.num_times_in_long_clause);
+    rec.add_int64(data.irred.satisfies_cl);
+    rec.add_int64(data.irred.falsifies_cl);
+    rec.add_int64(data.irred.tot_num_lit_of_bin_it_appears_in);
+    rec.add_int64(data.irred.tot_num_lit_of_long_cls_it_appears_in);
+    rec.add_double(data.irred.sum_var_act_of_cls);
+
+    rec.add_double(data.tot_act_long_red_cls);
+
+    add_record(stmt_var_dist, "var_dist");
 }
 
 void SQLiteStats::dec_var_clid(
@@ -1053,12 +1070,12 @@ void SQLiteStats::dec_var_clid(
 ) {
     assert(clid != 0);
 
-    int bindAt = 1;
-    sqlite3_bind_int(stmt_dec_var_clid, bindAt++, var);
-    sqlite3_bind_int64(stmt_dec_var_clid, bindAt++, sumConflicts_at_picktime);
-    sqlite3_bind_int64(stmt_dec_var_clid, bindAt++, clid);
+    rec.clear();
+    rec.add_int64(var);
+    rec.add_int64(sumConflicts_at_picktime);
+    rec.add_int64(clid);
 
-    run_sqlite_step(stmt_dec_var_clid, "dec_var_clid");
+    add_record(stmt_dec_var_clid, "dec_var_clid");
 }
 #endif
 
@@ -1068,11 +1085,11 @@ void SQLiteStats::cl_last_in_solver(
 {
     assert(clid != 0);
 
-    int bindAt = 1;
-    sqlite3_bind_int64(stmt_delete_cl, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int64(stmt_delete_cl, bindAt++, clid);
+    rec.clear();
+    rec.add_int64(solver->sumConflicts);
+    rec.add_int64(clid);
 
-    run_sqlite_step(stmt_delete_cl, "cl_last_in_solver", bindAt);
+    add_record(stmt_delete_cl, "cl_last_in_solver");
 }
 
 void SQLiteStats::update_id(
@@ -1083,11 +1100,11 @@ void SQLiteStats::update_id(
     assert(new_id != 0);
     assert((new_id == old_id || new_id > old_id) && "not neccessary, but I think we have this always");
 
-    int bindAt = 1;
-    sqlite3_bind_int64(stmt_update_id, bindAt++, old_id);
-    sqlite3_bind_int64(stmt_update_id, bindAt++, new_id);
+    rec.clear();
+    rec.add_int64(old_id);
+    rec.add_int64(new_id);
 
-    run_sqlite_step(stmt_update_id, "update_id", bindAt);
+    add_record(stmt_update_id, "update_id");
 }
 
 
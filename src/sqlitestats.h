@@ -24,6 +24,7 @@ THE SOFTWARE.
 #define SQLITESTATS_H__
 
 #include "sqlstats.h"
+#include "sqlitewriter.h"
 #include <sqlite3.h>
 #include <map>
 #include <utility>
@@ -66,6 +67,16 @@ public:
         , uint64_t mem_used_mb
     ) override;
 
+    void inproc_sched(
+        const Solver* solver
+        , const string& unit
+        , const string& decision
+        , double cost
+        , double gain
+        , double utility
+        , double boost
+    ) override;
+
     vector<pair<int32_t, uint64_t>> id_conf_cache;
     void dump_id_confl_cache();
     virtual void set_id_confl(
@@ -141,6 +152,7 @@ public:
         const Solver* solver
         , const uint32_t var
         , const VarData& vardata
+        , const VarHot& varhot
         , const double rel_activity
     ) override;
 
@@ -186,16 +198,15 @@ private:
     void init_var_data_picktime_STMT();
     void init_var_data_fintime_STMT();
     void init_dec_var_clid_STMT();
-    void run_sqlite_step(
-        sqlite3_stmt* stmt,
-        const char* name,
-        const uint32_t bindAt);
+    //Hands the row built in "rec" to the writer
+    void add_record(sqlite3_stmt* stmt, const char* name);
 
     void writeQuestionMarks(size_t num, std::stringstream& ss);
     void initReduceDBSTMT();
 
     sqlite3_stmt *stmtTimePassed = NULL;
     sqlite3_stmt *stmtMemUsed = NULL;
+    sqlite3_stmt *stmtInprocSched = NULL;
     sqlite3_stmt *stmtReduceDB = NULL;
     sqlite3_stmt *stmtReduceDB_common = NULL;
     sqlite3_stmt *stmtRst = NULL;
@@ -213,6 +224,9 @@ private:
     sqlite3_stmt *stmt_var_dist = NULL;
 
     std::map<string, uint32_t> query_to_size;
+    SQLRecord rec;
+    SQLiteWriter* writer = NULL;
+    int verbosity = 0;
 
     sqlite3 *db = NULL;
     bool setup_ok = false;
@@ -0,0 +1,233 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "sqlitewriter.h"
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+
+using namespace CMSat;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+//Rows per transaction of the writer thread
+static const uint32_t max_rows_per_transaction = 20000;
+
+//Smallest ring, so that the widest row always fits
+static const uint64_t min_ring_cells = 4096;
+
+void SQLRecord::add_int64(const int64_t v)
+{
+    SQLCell c;
+    c.i = v;
+    c.type = SQLCell::int_val;
+    c.aux = 0;
+    cells.push_back(c);
+    num_vals++;
+}
+
+void SQLRecord::add_double(const double v)
+{
+    SQLCell c;
+    c.d = v;
+    c.type = SQLCell::double_val;
+    c.aux = 0;
+    cells.push_back(c);
+    num_vals++;
+}
+
+void SQLRecord::add_null()
+{
+    SQLCell c;
+    c.i = 0;
+    c.type = SQLCell::null_val;
+    c.aux = 0;
+    cells.push_back(c);
+    num_vals++;
+}
+
+void SQLRecord::add_text(const string& v)
+{
+    SQLCell c;
+    c.i = 0;
+    c.type = SQLCell::text_val;
+    c.aux = v.size();
+    cells.push_back(c);
+    num_vals++;
+
+    const size_t at = cells.size();
+    cells.resize(at + (v.size()+sizeof(SQLCell)-1)/sizeof(SQLCell));
+    if (!v.empty()) memcpy((char*)&cells[at], v.data(), v.size());
+}
+
+SQLiteWriter::SQLiteWriter(
+    sqlite3* _db,
+    const bool _async,
+    const uint64_t queue_bytes,
+    const bool _drop_when_full) :
+    db(_db),
+    async(_async),
+    drop_when_full(_drop_when_full)
+{
+    if (!async) return;
+
+    uint64_t cells = min_ring_cells;
+    while (cells*sizeof(SQLCell) < queue_bytes) cells *= 2;
+    ring.resize(cells);
+    mask = cells-1;
+    thread = std::thread(&SQLiteWriter::run, this);
+}
+
+SQLiteWriter::~SQLiteWriter()
+{
+    if (!async) return;
+    stop = true;
+    thread.join();
+}
+
+void SQLiteWriter::exec(const char* sql)
+{
+    if (sqlite3_exec(db, sql, NULL, NULL, NULL)) {
+        cerr << "ERROR: SQLite writer cannot execute '" << sql << "'" << endl;
+        cerr << "c " << sqlite3_errmsg(db) << endl;
+        std::exit(-1);
+    }
+}
+
+void SQLiteWriter::write(
+    sqlite3_stmt* stmt,
+    const SQLCell* vals,
+    const uint32_t num_cells)
+{
+    int bindAt = 1;
+    for(uint32_t i = 0; i < num_cells; i++) {
+        const SQLCell& c = vals[i];
+        switch(c.type) {
+            case SQLCell::null_val:
+                sqlite3_bind_null(stmt, bindAt++);
+                break;
+            case SQLCell::int_val:
+                sqlite3_bind_int64(stmt, bindAt++, c.i);
+                break;
+            case SQLCell::double_val:
+                sqlite3_bind_double(stmt, bindAt++, c.d);
+                break;
+            case SQLCell::text_val:
+                sqlite3_bind_text(stmt, bindAt++, (const char*)(vals+i+1), c.aux, SQLITE_TRANSIENT);
+                i += (c.aux+sizeof(SQLCell)-1)/sizeof(SQLCell);
+                break;
+            default:
+                assert(false);
+        }
+    }
+
+    const int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE) {
+        cout << "ERROR: while executing SQLite prepared statement '"
+        << sqlite3_sql(stmt) << "'" << endl;
+        cout << "Error from sqlite: " << sqlite3_errmsg(db) << endl;
+        cout << "Error code from sqlite: " << rc << endl;
+        std::exit(-1);
+    }
+    if (sqlite3_reset(stmt) || sqlite3_clear_bindings(stmt)) {
+        cerr << "Error resetting SQLite prepared statement '"
+        << sqlite3_sql(stmt) << "'" << endl;
+        std::exit(-1);
+    }
+    written.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SQLiteWriter::push(sqlite3_stmt* stmt, const SQLRecord& rec)
+{
+    if (!async) {
+        write(stmt, rec.cells.data(), rec.cells.size());
+        return;
+    }
+
+    const uint64_t need = rec.cells.size()+1;
+    assert(need <= ring.size());
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    while (h + need - tail.load(std::memory_order_acquire) > ring.size()) {
+        if (drop_when_full) {
+            dropped++;
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    SQLCell& hdr = ring[h & mask];
+    hdr.stmt = stmt;
+    hdr.type = SQLCell::header;
+    hdr.aux = rec.cells.size();
+    for(uint64_t i = 0; i < rec.cells.size(); i++) {
+        ring[(h+1+i) & mask] = rec.cells[i];
+    }
+    head.store(h + need, std::memory_order_release);
+}
+
+void SQLiteWriter::flush()
+{
+    if (!async) return;
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    while (committed.load(std::memory_order_acquire) < h) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+void SQLiteWriter::run()
+{
+    uint64_t t = 0;
+    while(true) {
+        uint64_t h = head.load(std::memory_order_acquire);
+        if (h == t) {
+            if (stop) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        exec("BEGIN TRANSACTION");
+        uint32_t rows = 0;
+        while(t != h && rows < max_rows_per_transaction) {
+            const SQLCell& hdr = ring[t & mask];
+            assert(hdr.type == SQLCell::header);
+            const uint32_t num = hdr.aux;
+            const uint64_t first = (t+1) & mask;
+            if (first + num <= ring.size()) {
+                write(hdr.stmt, &ring[first], num);
+            } else {
+                scratch.resize(num);
+                for(uint32_t i = 0; i < num; i++) scratch[i] = ring[(t+1+i) & mask];
+                write(hdr.stmt, scratch.data(), num);
+            }
+            t += 1+num;
+            tail.store(t, std::memory_order_release);
+            rows++;
+            if (t == h) h = head.load(std::memory_order_acquire);
+        }
+        exec("END TRANSACTION");
+        committed.store(t, std::memory_order_release);
+    }
+}
@@ -0,0 +1,115 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef SQLITEWRITER_H__
+#define SQLITEWRITER_H__
+
+#include <sqlite3.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace CMSat {
+
+using std::vector;
+using std::string;
+
+// One 16-byte slot of the record queue. A record is a header cell (the
+// statement to run and the number of cells after it) followed by one cell
+// per bound value. The bytes of a text value follow its cell.
+struct SQLCell
+{
+    enum : uint32_t {null_val, int_val, double_val, text_val, header};
+
+    union {
+        int64_t i;
+        double d;
+        sqlite3_stmt* stmt;
+        char bytes[8];
+    };
+    uint32_t type;
+    uint32_t aux; //header: number of cells that follow, text: length
+};
+static_assert(sizeof(SQLCell) == 16, "SQLCell must stay 16 bytes");
+
+// The values of one row, in column order
+class SQLRecord
+{
+public:
+    void clear() { cells.clear(); num_vals = 0; }
+    void add_int64(const int64_t v);
+    void add_double(const double v);
+    void add_null();
+    void add_text(const string& v);
+
+    uint32_t num_vals = 0;
+    vector<SQLCell> cells;
+};
+
+// Runs the inserts of SQLiteStats. In async mode the solver thread only
+// copies the bound values into a single-producer single-consumer ring,
+// and a writer thread steps the statements, many rows per transaction.
+// When the ring is full the record is either dropped (and counted) or the
+// solver waits for the writer.
+class SQLiteWriter
+{
+public:
+    SQLiteWriter(sqlite3* db, bool async, uint64_t queue_bytes, bool drop_when_full);
+    ~SQLiteWriter();
+
+    void push(sqlite3_stmt* stmt, const SQLRecord& rec);
+
+    //Returns once everything pushed so far is committed. Only then may
+    //the caller use the database connection directly.
+    void flush();
+
+    bool is_async() const { return async; }
+    uint64_t get_dropped() const { return dropped; }
+    uint64_t get_written() const { return written; }
+
+private:
+    void write(sqlite3_stmt* stmt, const SQLCell* vals, uint32_t num_cells);
+    void exec(const char* sql);
+    void run();
+
+    sqlite3* db;
+    const bool async;
+    const bool drop_when_full;
+
+    vector<SQLCell> ring;
+    uint64_t mask;
+    alignas(64) std::atomic<uint64_t> head{0}; //written by the solver
+    alignas(64) std::atomic<uint64_t> tail{0}; //written by the writer
+    std::atomic<uint64_t> committed{0};
+    std::atomic<bool> stop{false};
+    std::thread thread;
+
+    vector<SQLCell> scratch; //writer-side copy of a record that wraps
+    uint64_t dropped = 0;
+    std::atomic<uint64_t> written{0};
+};
+
+}
+
+#endif //SQLITEWRITER_H__
@@ -67,6 +67,16 @@ public:
         , uint64_t mem_used_mb
     ) = 0;
 
+    virtual void inproc_sched(
+        const Solver* solver
+        , const string& unit
+        , const string& decision
+        , double cost
+        , double gain
+        , double utility
+        , double boost
+    ) = 0;
+
     virtual void set_id_confl(
         const int32_t id
         , const uint64_t sumConflicts
@@ -111,6 +121,7 @@ public:
         const Solver* solver
         , const uint32_t var
         , const VarData& vardata
+        , const VarHot& varhot
         , const double rel_activity
     ) = 0;
 
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "solver.h"
 #include "solvertypes.h"
 #include "subsumeimplicit.h"
+#include "parallel_for.h"
 #include <algorithm>
 #include <array>
 
@@ -36,6 +37,11 @@ THE SOFTWARE.
 
 using namespace CMSat;
 
+//Long-with-long sub/str is searched ahead on this many clauses per thread,
+//but only when there are enough clauses to make it worth it
+static const size_t spec_steps_per_thread = 256;
+static const size_t spec_min_cls = 20000;
+
 SubsumeStrengthen::SubsumeStrengthen(
     OccSimplifier* _simplifier
     , Solver* _solver
@@ -61,6 +67,11 @@ Sub0Ret SubsumeStrengthen::backw_sub_with_long(const ClOffset offset)
         , cl.abst
     );
 
+    return backw_sub_with_long_finish(cl, ret);
+}
+
+Sub0Ret SubsumeStrengthen::backw_sub_with_long_finish(Clause& cl, const Sub0Ret& ret)
+{
     //If irred is subsumed by redundant, make the redundant into irred
     if (cl.red() && ret.subsumedIrred) {
         STATS_DO(solver->stats_del_cl(&cl));
@@ -104,10 +115,14 @@ Sub0Ret SubsumeStrengthen::subsume_and_unlink(
     , const T& ps
     , const cl_abst_type abs
 ) {
-    Sub0Ret ret;
-
     subs.clear();
     find_subsumed(offset, ps, abs, subs);
+    return unlink_subsumed();
+}
+
+Sub0Ret SubsumeStrengthen::unlink_subsumed()
+{
+    Sub0Ret ret;
 
     //Go through each clause that can be subsumed
     for (const auto& occ_cl: subs) {
@@ -164,6 +179,13 @@ bool SubsumeStrengthen::backw_sub_str_with_long(
         , subsLits
     );
 
+    return backw_sub_str_with_long_apply(cl, ret_sub_str);
+}
+
+bool SubsumeStrengthen::backw_sub_str_with_long_apply(
+    Clause& cl,
+    Sub1Ret& ret_sub_str)
+{
     for (size_t j = 0
         ; j < subs.size() && solver->okay() && *simplifier->limit_to_decrease > -20LL*1000LL*1000LL
         ; j++
@@ -237,9 +259,34 @@ void SubsumeStrengthen::backw_sub_long_with_long()
     size_t wenThrough = 0;
     Sub0Ret sub0ret;
     const int64_t orig_limit = simplifier->subsumption_time_limit;
-    std::shuffle(simplifier->clauses.begin(), simplifier->clauses.end(), solver->mtrand);
+
+    //In the incremental fast path, clauses without a touched var have
+    //already been tried against each other
+    vector<ClOffset> dirty;
+    if (solver->inc_restrict_simp()) {
+        for(const ClOffset offs: simplifier->clauses) {
+            const Clause* cl = solver->cl_alloc.ptr(offs);
+            if (cl->freed() || cl->getRemoved()) continue;
+            for(const Lit l: *cl) {
+                if (solver->inc_var_dirty(l.var())) {
+                    dirty.push_back(offs);
+                    break;
+                }
+            }
+        }
+        *simplifier->limit_to_decrease -= simplifier->clauses.size();
+        if (dirty.empty()) return;
+    }
+    vector<ClOffset>& todo = solver->inc_restrict_simp() ? dirty : simplifier->clauses;
+
+    std::shuffle(todo.begin(), todo.end(), solver->mtrand);
     const size_t max_go_through =
-        solver->conf.subsume_gothrough_multip*(double)simplifier->clauses.size();
+        solver->conf.subsume_gothrough_multip*(double)todo.size();
+    const uint32_t threads = simplifier->occ_threads();
+    const bool par = threads > 1 && todo.size() >= spec_min_cls;
+    ThreadPool pool(par ? threads : 1);
+    size_t spec_first = 0;
+    size_t spec_num = 0;
 
     while (*simplifier->limit_to_decrease > 0
         && wenThrough < max_go_through
@@ -254,8 +301,8 @@ void SubsumeStrengthen::backw_sub_long_with_long()
             cout << "toDecrease: " << *simplifier->limit_to_decrease << endl;
         }
 
-        const size_t at = wenThrough % simplifier->clauses.size();
-        const ClOffset offset = simplifier->clauses[at];
+        const size_t at = wenThrough % todo.size();
+        const ClOffset offset = todo[at];
         Clause* cl = solver->cl_alloc.ptr(offset);
 
         //Has already been removed
@@ -264,7 +311,30 @@ void SubsumeStrengthen::backw_sub_long_with_long()
 
 
         *simplifier->limit_to_decrease -= 10;
-        sub0ret += backw_sub_with_long(offset);
+        if (!par) {
+            sub0ret += backw_sub_with_long(offset);
+            continue;
+        }
+
+        if (wenThrough >= spec_first + spec_num) {
+            spec_first = wenThrough;
+            spec_num = std::min<size_t>(
+                std::min<size_t>(threads*spec_steps_per_thread, todo.size()),
+                max_go_through - wenThrough + 1);
+            spec_window<false>(todo, spec_first, spec_num, pool);
+        }
+        const bool was_linked = cl->getOccurLinked();
+        Sub0Ret ret;
+        if (spec_valid(*cl)) {
+            spec_replay(spec_steps[wenThrough - spec_first], false);
+            ret = unlink_subsumed();
+        } else {
+            ret = subsume_and_unlink(offset, *cl, cl->abst);
+        }
+        sub0ret += backw_sub_with_long_finish(*cl, ret);
+        if (cl->getOccurLinked() != was_linked) {
+            spec_touch(*cl);
+        }
     }
 
     const double time_used = cpuTime() - myTime;
@@ -273,9 +343,9 @@ void SubsumeStrengthen::backw_sub_long_with_long()
     if (solver->conf.verbosity) {
         cout
         << "c [occ-backw-sub-long-w-long] rem cl: " << sub0ret.numSubsumed
-        << " tried: " << wenThrough << "/" << simplifier->clauses.size()
+        << " tried: " << wenThrough << "/" << todo.size()
         << " (" << std::setprecision(1) << std::fixed
-        << stats_line_percent(wenThrough, simplifier->clauses.size())
+        << stats_line_percent(wenThrough, todo.size())
         << "%)"
         << solver->conf.print_times(time_used, time_out, time_remain)
         << endl;
@@ -305,6 +375,12 @@ bool SubsumeStrengthen::backw_str_long_with_long()
     Sub1Ret ret;
 
     std::shuffle(simplifier->clauses.begin(), simplifier->clauses.end(), solver->mtrand);
+    const size_t max_go_through = 1.5*(double)2*simplifier->clauses.size();
+    const uint32_t threads = simplifier->occ_threads();
+    const bool par = threads > 1 && simplifier->clauses.size() >= spec_min_cls;
+    ThreadPool pool(par ? threads : 1);
+    size_t spec_first = 0;
+    size_t spec_num = 0;
     while(*simplifier->limit_to_decrease > 0
         && wenThrough < 1.5*(double)2*simplifier->clauses.size()
         && solver->okay()
@@ -327,10 +403,44 @@ bool SubsumeStrengthen::backw_str_long_with_long()
         if (cl->freed() || cl->getRemoved())
             continue;
 
-        if (!backw_sub_str_with_long(offset, ret)) {
-            return false;
+        if (!par) {
+            if (!backw_sub_str_with_long(offset, ret)) {
+                return false;
+            }
+            continue;
         }
 
+        if (wenThrough >= spec_first + spec_num) {
+            spec_first = wenThrough;
+            spec_num = std::min<size_t>(
+                std::min<size_t>(threads*spec_steps_per_thread, simplifier->clauses.size()),
+                max_go_through - wenThrough + 1);
+            spec_window<true>(simplifier->clauses, spec_first, spec_num, pool);
+        }
+        const bool was_linked = cl->getOccurLinked();
+        const size_t trail_size = solver->trail_size();
+        if (spec_valid(*cl)) {
+            spec_replay(spec_steps[wenThrough - spec_first], true);
+        } else {
+            subs.clear();
+            subsLits.clear();
+            find_subsumed_and_strengthened(offset, *cl, cl->abst, subs, subsLits);
+        }
+        for (size_t j = 0; j < subs.size(); j++) {
+            if (subsLits[j] != lit_Undef) {
+                spec_touch(*solver->cl_alloc.ptr(subs[j].ws.get_offset()));
+            }
+        }
+        if (!backw_sub_str_with_long_apply(*cl, ret)) {
+            return false;
+        }
+        if (cl->getOccurLinked() != was_linked) {
+            spec_touch(*cl);
+        }
+        if (solver->trail_size() != trail_size) {
+            //Propagation may have changed any watchlist, search again
+            spec_num = 0;
+        }
     }
 
     const double time_used = cpuTime() - myTime;
@@ -569,6 +679,15 @@ bool SubsumeStrengthen::handle_added_long_cl(const bool verbose)
 //A subsumes B (A <= B)
 template<class T1, class T2>
 bool SubsumeStrengthen::subset(const T1& A, const T2& B)
+{
+    int64_t cost = 0;
+    const bool ret = subset(A, B, cost);
+    *simplifier->limit_to_decrease -= cost;
+    return ret;
+}
+
+template<class T1, class T2>
+bool SubsumeStrengthen::subset(const T1& A, const T2& B, int64_t& cost)
 {
     #ifdef MORE_DEUBUG
     cout << "A:" << A << endl;
@@ -609,7 +728,7 @@ bool SubsumeStrengthen::subset(const T1& A, const T2& B)
     ret = false;
 
     end:
-    *simplifier->limit_to_decrease -= (long)i2*4 + (long)i*4;
+    cost += (long)i2*4 + (long)i*4;
     return ret;
 }
 
@@ -628,6 +747,15 @@ and returns the literal to remove if (2) is true
 */
 template<class T1, class T2>
 Lit SubsumeStrengthen::subset1(const T1& A, const T2& B)
+{
+    int64_t cost = 0;
+    const Lit ret = subset1(A, B, cost);
+    *simplifier->limit_to_decrease -= cost;
+    return ret;
+}
+
+template<class T1, class T2>
+Lit SubsumeStrengthen::subset1(const T1& A, const T2& B, int64_t& cost)
 {
     Lit retLit = lit_Undef;
 
@@ -659,7 +787,7 @@ Lit SubsumeStrengthen::subset1(const T1& A, const T2& B)
     retLit = lit_Error;
 
     end:
-    *simplifier->limit_to_decrease -= (long)i2*4 + (long)i*4;
+    cost += (long)i2*4 + (long)i*4;
     return retLit;
 }
 
@@ -764,11 +892,170 @@ template void SubsumeStrengthen::find_subsumed(
     , bool only_irred
 );
 
+/**
+@brief Read-only search of a window of long-with-long sub/str steps
+
+Mirrors find_subsumed() (str=false) and find_subsumed_and_strengthened()
+(str=true) but records every candidate with its cost instead of touching
+the limit, so it can run on many threads. spec_replay() then charges the
+costs and filters out clauses that were removed in the meantime, which
+gives exactly what the serial search would have found, as long as no
+watchlist it read changed since the window was searched. Steps where that
+may have happened are searched again serially, see spec_valid().
+*/
+template<bool str>
+void SubsumeStrengthen::spec_find(
+    const ClOffset offset
+    , const Clause& cl
+    , vector<SpecCand>& out
+    , int64_t& cost
+) const {
+    if (!str) {
+        uint32_t smallest = 0;
+        size_t min_num = solver->watches[cl[0]].size();
+        for (uint32_t i = 1; i < cl.size(); i++) {
+            const size_t this_num = solver->watches[cl[i]].size();
+            if (this_num < min_num) {
+                smallest = i;
+                min_num = this_num;
+            }
+        }
+        cost += (long)cl.size();
+
+        const Lit lit = cl[smallest];
+        watch_subarray_const occ = solver->watches[lit];
+        cost += (long)occ.size()*8 + 40;
+        for (const auto& w: occ) {
+            if (!w.isClause()) continue;
+            cost += 15;
+            if (w.get_offset() == offset
+                || !subsetAbst(cl.abst, w.getAbst())
+            ) {
+                continue;
+            }
+            const Clause& cl2 = *solver->cl_alloc.ptr(w.get_offset());
+            if (cl.size() > cl2.size()) continue;
+
+            int64_t c = 50;
+            const bool sub = subset(cl, cl2, c);
+            out.push_back(SpecCand{OccurClause(lit, w), sub ? lit_Undef : lit_Error, c});
+        }
+        return;
+    }
+
+    Lit minLit = lit_Undef;
+    uint32_t bestSize = numeric_limits<uint32_t>::max();
+    for (const Lit l: cl) {
+        const uint32_t newSize = solver->watches[l].size() + solver->watches[~l].size();
+        if (newSize < bestSize) {
+            minLit = l;
+            bestSize = newSize;
+        }
+    }
+    cost += (long)cl.size();
+
+    for (const Lit lit: {minLit, ~minLit}) {
+        watch_subarray_const cs = solver->watches[lit];
+        cost += (long)cs.size()*2 + 40;
+        for (const auto& w: cs) {
+            if (w.isBin()) continue;
+            assert(w.isClause());
+            if (w.get_offset() == offset
+                || !subsetAbst(cl.abst, w.getAbst())
+            ) {
+                continue;
+            }
+            const Clause& cl2 = *solver->cl_alloc.ptr(w.get_offset());
+            if (cl.size() > cl2.size()) continue;
+
+            int64_t c = (long)((cl.size() + cl2.size())/4);
+            const Lit litSub = subset1(cl, cl2, c);
+            out.push_back(SpecCand{OccurClause(lit, w), litSub, c});
+        }
+    }
+}
+
+template<bool str>
+void SubsumeStrengthen::spec_window(
+    const vector<ClOffset>& todo
+    , const size_t first_step
+    , const size_t num
+    , ThreadPool& pool
+) {
+    for(const uint32_t v: spec_touched_vars) spec_touched[v] = 0;
+    spec_touched_vars.clear();
+    spec_touched.resize(solver->nVars(), 0);
+
+    spec_steps.resize(num);
+    spec_cands.resize(pool.size());
+    pool.run(num, [&](uint32_t tid, uint64_t begin, uint64_t end) {
+        vector<SpecCand>& out = spec_cands[tid];
+        out.clear();
+        for (uint64_t i = begin; i < end; i++) {
+            SpecStep& step = spec_steps[i];
+            step.cost = 0;
+            step.tid = tid;
+            step.begin = out.size();
+            const ClOffset offset = todo[(first_step + i) % todo.size()];
+            const Clause& cl = *solver->cl_alloc.ptr(offset);
+            if (!cl.freed() && !cl.getRemoved()) {
+                spec_find<str>(offset, cl, out, step.cost);
+            }
+            step.end = out.size();
+        }
+    });
+}
+
+//Called before anything changes the watchlists or the contents of cl
+void SubsumeStrengthen::spec_touch(const Clause& cl)
+{
+    for(const Lit l: cl) {
+        if (spec_touched[l.var()]) continue;
+        spec_touched[l.var()] = 1;
+        spec_touched_vars.push_back(l.var());
+    }
+}
+
+//A step only read cl, and the watchlists of cl's literals and of their
+//negations, along with the clauses in them. Any of those clauses changing
+//touches one of cl's variables too, since it shares a literal with cl.
+bool SubsumeStrengthen::spec_valid(const Clause& cl) const
+{
+    for(const Lit l: cl) {
+        if (spec_touched[l.var()]) return false;
+    }
+    return true;
+}
+
+//Fills subs (and subsLits if str) the way the serial search would have
+void SubsumeStrengthen::spec_replay(const SpecStep& step, const bool str)
+{
+    *simplifier->limit_to_decrease -= step.cost;
+    subs.clear();
+    subsLits.clear();
+
+    const vector<SpecCand>& cands = spec_cands[step.tid];
+    for (uint32_t i = step.begin; i < step.end; i++) {
+        const SpecCand& c = cands[i];
+        const Clause& cl2 = *solver->cl_alloc.ptr(c.occ.ws.get_offset());
+        if (cl2.getRemoved()) continue;
+
+        *simplifier->limit_to_decrease -= c.cost;
+        if (c.lit == lit_Error) continue;
+        subs.push_back(c.occ);
+        if (str) subsLits.push_back(c.lit);
+    }
+}
+
 size_t SubsumeStrengthen::mem_used() const
 {
     size_t b = 0;
     b += subs.capacity()*sizeof(ClOffset);
     b += subsLits.capacity()*sizeof(Lit);
+    b += spec_steps.capacity()*sizeof(SpecStep);
+    b += spec_touched.capacity()*sizeof(uint8_t);
+    b += spec_touched_vars.capacity()*sizeof(uint32_t);
+    for(const auto& c: spec_cands) b += c.capacity()*sizeof(SpecCand);
 
     return b;
 }
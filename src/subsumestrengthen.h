@@ -34,6 +34,7 @@ using std::vector;
 namespace CMSat {
 
 class OccSimplifier;
+class ThreadPool;
 class GateFinder;
 class Solver;
 
@@ -130,9 +131,50 @@ private:
 
     template<class T1, class T2>
     bool subset(const T1& A, const T2& B);
+    template<class T1, class T2>
+    static bool subset(const T1& A, const T2& B, int64_t& cost);
 
     template<class T1, class T2>
     Lit subset1(const T1& A, const T2& B);
+    template<class T1, class T2>
+    static Lit subset1(const T1& A, const T2& B, int64_t& cost);
+
+    Sub0Ret unlink_subsumed();
+    Sub0Ret backw_sub_with_long_finish(Clause& cl, const Sub0Ret& ret);
+    bool backw_sub_str_with_long_apply(Clause& cl, Sub1Ret& ret_sub_str);
+
+    //Parallel backw_sub_long_with_long() and backw_str_long_with_long().
+    //A window of upcoming steps is searched in parallel against the state at
+    //its start, then the steps are committed in order, re-checking removed
+    //clauses and charging the same time limit as the serial search would.
+    //Variables of clauses that get strengthened or linked in are marked,
+    //and steps whose clause has a marked variable are searched again.
+    struct SpecCand
+    {
+        OccurClause occ;
+        Lit lit; //lit_Error: nothing, lit_Undef: subsumed, else lit to remove
+        int64_t cost; //charged only if the clause is not removed by then
+    };
+    struct SpecStep
+    {
+        int64_t cost; //always charged
+        uint32_t tid;
+        uint32_t begin;
+        uint32_t end;
+    };
+    template<bool str>
+    void spec_find(const ClOffset offset, const Clause& cl,
+        vector<SpecCand>& out, int64_t& cost) const;
+    template<bool str>
+    void spec_window(const vector<ClOffset>& todo, size_t first_step,
+        size_t num, ThreadPool& pool);
+    void spec_replay(const SpecStep& step, const bool str);
+    void spec_touch(const Clause& cl);
+    bool spec_valid(const Clause& cl) const;
+    vector<SpecStep> spec_steps;
+    vector<vector<SpecCand>> spec_cands;
+    vector<uint8_t> spec_touched; //per var, since the window was searched
+    vector<uint32_t> spec_touched_vars;
 
     vector<OccurClause> subs;
     vec<Watched> tmp;
@@ -1350,3 +1350,28 @@ bool VarReplacer::get_scc_depth_warning_triggered() const
 {
     return scc_finder->depth_warning_triggered();
 }
+
+void VarReplacer::save_state(SimpleOutFile& f) const
+{
+    f.put_vector(table);
+    f.put_uint64_t(reverseTable.size());
+    for(const auto& it: reverseTable) {
+        f.put_uint32_t(it.first);
+        f.put_vector(it.second);
+    }
+    f.put_uint64_t(replacedVars);
+}
+
+void VarReplacer::load_state(SimpleInFile& f)
+{
+    table.clear();
+    f.get_vector(table);
+    reverseTable.clear();
+    const uint64_t num = f.get_uint64_t();
+    for(uint64_t i = 0; i < num; i++) {
+        const uint32_t var = f.get_uint32_t();
+        f.get_vector(reverseTable[var]);
+    }
+    replacedVars = f.get_uint64_t();
+    lastReplacedVars = replacedVars;
+}
@@ -80,6 +80,8 @@ class VarReplacer
         template<class T> void unserialize_tables(T& ar);
         template<class T> void serialize_tables  (T& ar) const;
 #endif
+        void save_state(SimpleOutFile& f) const;
+        void load_state(SimpleInFile& f);
 
         vector<uint32_t> get_vars_replacing(uint32_t var) const;
         void updateVars(
@@ -28,13 +28,145 @@ THE SOFTWARE.
 #include "Vec.h"
 #include <cstdint>
 #include <vector>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <utility>
 
 namespace CMSat {
 using std::vector;
 
-typedef vec<Watched>& watch_subarray;
+class watch_array;
+
 typedef const vec<Watched>& watch_subarray_const;
 
+//Writable view of one literal's watchlist. Growing and freeing must go
+//through watch_array, because the elements live in its arena.
+class watch_subarray
+{
+public:
+    watch_subarray(watch_array* _arr, vec<Watched>* _ws) :
+        arr(_arr)
+        , ws(_ws)
+    {}
+
+    operator watch_subarray_const() const
+    {
+        return *ws;
+    }
+
+    uint32_t size() const
+    {
+        return ws->sz;
+    }
+
+    bool empty() const
+    {
+        return ws->sz == 0;
+    }
+
+    uint32_t capacity() const
+    {
+        return ws->cap;
+    }
+
+    //Growing may move this list, but never any other list
+    void capacity(const uint32_t min_cap);
+
+    Watched* begin() const
+    {
+        return ws->data;
+    }
+
+    Watched* end() const
+    {
+        return ws->data + ws->sz;
+    }
+
+    Watched& operator[](const uint32_t at) const
+    {
+        return ws->data[at];
+    }
+
+    Watched& last() const
+    {
+        return ws->data[ws->sz-1];
+    }
+
+    void push(const Watched& w)
+    {
+        if (unlikely(ws->sz == ws->cap)) {
+            capacity(ws->sz+1);
+        }
+        ws->data[ws->sz++] = w;
+    }
+
+    void push_(const Watched& w)
+    {
+        assert(ws->sz < ws->cap);
+        ws->data[ws->sz++] = w;
+    }
+
+    void pop()
+    {
+        assert(ws->sz > 0);
+        ws->sz--;
+    }
+
+    void shrink(const uint32_t nelems)
+    {
+        assert(nelems <= ws->sz);
+        ws->sz -= nelems;
+    }
+
+    void shrink_(const uint32_t nelems)
+    {
+        shrink(nelems);
+    }
+
+    void resize(const uint32_t s)
+    {
+        if (s > ws->sz) {
+            capacity(s);
+            std::fill(end(), begin() + s, Watched());
+        }
+        ws->sz = s;
+    }
+
+    void clear(const bool dealloc = false);
+    void shrink_to_fit();
+
+    void copyTo(vec<Watched>& copy) const
+    {
+        ws->copyTo(copy);
+    }
+
+    void moveTo(vec<Watched>& dest)
+    {
+        ws->copyTo(dest);
+        clear(true);
+    }
+
+    //Only the headers are swapped
+    void swap(watch_subarray other)
+    {
+        ws->swap(*other.ws);
+    }
+
+private:
+    watch_array* arr;
+    vec<Watched>* ws;
+};
+
+//All watchlists share one contiguous arena. Every literal has a vec<Watched>
+//header whose data points into the arena. A list that outgrows its slot is
+//extended in place if it is the last one in the arena, otherwise it moves to
+//the end and its old slot becomes garbage. The arena itself is never
+//reallocated while lists are in use, so pointers into one list stay valid
+//while another one grows, just like with one allocation per list. Once the
+//arena is full, growing lists spill over to the heap. consolidate() and
+//full_consolidate() pack everything into a fresh arena, in literal order.
 class watch_array
 {
 public:
@@ -42,6 +174,18 @@ public:
     vector<Lit> smudged_list;
     vector<char> smudged;
 
+    watch_array() = default;
+    watch_array(const watch_array&) = delete;
+    watch_array& operator=(const watch_array&) = delete;
+
+    ~watch_array()
+    {
+        for(auto& ws: watches) {
+            release(ws);
+        }
+        free(arena);
+    }
+
     void smudge(const Lit lit) {
         if (!smudged[lit.toInt()]) {
             smudged_list.push_back(lit);
@@ -53,24 +197,30 @@ public:
         return smudged_list;
     }
 
+    //Smudged lists have just been cleaned, so this is where capacity
+    //has freed up. Give it back, consolidate() will reclaim it.
     void clear_smudged()
     {
         for(const Lit lit: smudged_list) {
             assert(smudged[lit.toInt()]);
             smudged[lit.toInt()] = false;
+            vec<Watched>& ws = watches[lit.toInt()];
+            if (ws.cap > 16 && ws.sz*4 < ws.cap) {
+                trim(ws, with_slack(ws.sz));
+            }
         }
         smudged_list.clear();
     }
 
     watch_subarray operator[](Lit pos)
     {
-        return watches[pos.toInt()];
+        return watch_subarray(this, &watches[pos.toInt()]);
     }
 
     watch_subarray at(size_t pos)
     {
         assert(watches.size() > pos);
-        return watches[pos];
+        return watch_subarray(this, &watches[pos]);
     }
 
     watch_subarray_const operator[](Lit at) const
@@ -90,6 +240,9 @@ public:
         if (watches.size() < new_size) {
             watches.growTo(new_size);
         } else {
+            for(size_t i = new_size; i < watches.size(); i++) {
+                release(watches[i]);
+            }
             watches.shrink(watches.size()-new_size);
         }
         smudged.resize(new_size, false);
@@ -103,11 +256,7 @@ public:
 
     size_t mem_used() const
     {
-        double mem = watches.capacity()*sizeof(vec<Watched>);
-        for(size_t i = 0; i < watches.size(); i++) {
-            //1.2 is overhead
-            mem += (double)watches[i].capacity()*(double)sizeof(Watched)*1.2;
-        }
+        size_t mem = mem_used_alloc() + mem_used_array();
         mem += smudged.capacity()*sizeof(char);
         mem += smudged_list.capacity()*sizeof(Lit);
         return mem;
@@ -122,17 +271,60 @@ public:
     {
         cmsat_prefetch(watches[at].data);
     }
-    typedef vec<Watched>* iterator;
+
+    class iterator
+    {
+    public:
+        iterator(watch_array* _arr, vec<Watched>* _at) :
+            arr(_arr)
+            , at(_at)
+        {}
+
+        watch_subarray operator*() const
+        {
+            return watch_subarray(arr, at);
+        }
+
+        const vec<Watched>* operator->() const
+        {
+            return at;
+        }
+
+        iterator& operator++()
+        {
+            at++;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return at == other.at;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return at != other.at;
+        }
+
+        operator const vec<Watched>*() const
+        {
+            return at;
+        }
+
+    private:
+        watch_array* arr;
+        vec<Watched>* at;
+    };
     typedef const vec<Watched>* const_iterator;
 
     iterator begin()
     {
-        return watches.begin();
+        return iterator(this, watches.begin());
     }
 
     iterator end()
     {
-        return watches.end();
+        return iterator(this, watches.end());
     }
 
     const_iterator begin() const
@@ -145,45 +337,203 @@ public:
         return watches.end();
     }
 
+    //Repack only once enough of the arena is garbage, or enough has
+    //spilled over to the heap. Lists keep their capacity.
     void consolidate()
     {
-        /*for(auto& ws: watches) {
-            ws.shrink_to_fit();
-        }*/
+        if ((wasted + overflow)*4 > arena_used) {
+            repack(false);
+        }
         watches.shrink_to_fit();
     }
 
+    //Repack, leaving every list only a little room to grow
     void full_consolidate()
     {
-        for(auto& ws: watches) {
-            ws.shrink_to_fit();
-        }
+        repack(true);
         watches.shrink_to_fit();
     }
 
-    void print_stat()
+    void print_stat() const
     {
+        std::cout
+        << "c [watch-arena] used: " << arena_used*sizeof(Watched)/(1024*1024) << " MB"
+        << " reserved: " << arena_cap*sizeof(Watched)/(1024*1024) << " MB"
+        << " garbage: " << wasted*sizeof(Watched)/(1024*1024) << " MB"
+        << " on heap: " << overflow*sizeof(Watched)/(1024*1024) << " MB"
+        << std::endl;
     }
 
     size_t mem_used_alloc() const
     {
-        size_t mem = 0;
-        for(auto& ws: watches) {
-            mem += ws.capacity()*sizeof(Watched);
-        }
-
-        return mem;
+        return (arena_cap + overflow)*sizeof(Watched);
     }
 
     size_t mem_used_array() const
     {
         size_t mem = 0;
-        mem += watches.capacity()*sizeof(vector<Watched>);
+        mem += watches.capacity()*sizeof(vec<Watched>);
         mem += sizeof(watch_array);
         return mem;
     }
+
+private:
+    friend class watch_subarray;
+
+    Watched* arena = NULL;
+    size_t arena_used = 0; //in number of Watched, garbage included
+    size_t arena_cap = 0;
+    size_t wasted = 0; //slots in the arena no list uses anymore
+    size_t overflow = 0; //slots allocated on the heap
+
+    bool in_arena(const Watched* p) const
+    {
+        return p >= arena && p < arena + arena_cap;
+    }
+
+    static uint32_t with_slack(const uint32_t sz)
+    {
+        if (sz == 0) {
+            return 0;
+        }
+        return (sz + sz/8 + 2) & ~1U;
+    }
+
+    void release(vec<Watched>& ws)
+    {
+        if (in_arena(ws.data)) {
+            wasted += ws.cap;
+        } else {
+            free(ws.data);
+            overflow -= ws.cap;
+        }
+        ws.data = NULL;
+        ws.sz = 0;
+        ws.cap = 0;
+    }
+
+    void trim(vec<Watched>& ws, const uint32_t new_cap)
+    {
+        assert(ws.sz <= new_cap && new_cap <= ws.cap);
+        if (new_cap == 0) {
+            release(ws);
+            return;
+        }
+
+        if (in_arena(ws.data)) {
+            wasted += ws.cap - new_cap;
+        } else {
+            Watched* d = (Watched*)realloc(ws.data, new_cap*sizeof(Watched));
+            if (d == NULL) {
+                //We just keep the size then
+                return;
+            }
+            ws.data = d;
+            overflow -= ws.cap - new_cap;
+        }
+        ws.cap = new_cap;
+    }
+
+    //Slow path of push(), kept out of the propagation loops
+    cmsat_noinline void grow(vec<Watched>& ws, const uint32_t min_cap)
+    {
+        assert(min_cap > ws.cap);
+        //Grow by approximately 3/2, like vec
+        uint64_t new_cap = ((uint64_t)ws.cap*3/2 + 2) & ~1ULL;
+        new_cap = std::max<uint64_t>(min_cap, new_cap);
+        if (new_cap > std::numeric_limits<uint32_t>::max()) {
+            new_cap = min_cap;
+        }
+
+        //Last one in the arena, extend in place
+        if (ws.cap > 0
+            && ws.data + ws.cap == arena + arena_used
+            && arena_cap - arena_used >= new_cap - ws.cap
+        ) {
+            arena_used += new_cap - ws.cap;
+            ws.cap = new_cap;
+            return;
+        }
+
+        Watched* d;
+        if (arena_cap - arena_used >= new_cap) {
+            d = arena + arena_used;
+            arena_used += new_cap;
+        } else {
+            d = (Watched*)malloc(new_cap*sizeof(Watched));
+            if (d == NULL) {
+                throw std::bad_alloc();
+            }
+            overflow += new_cap;
+        }
+        std::copy(ws.begin(), ws.end(), d);
+
+        const uint32_t sz = ws.sz;
+        release(ws);
+        ws.data = d;
+        ws.sz = sz;
+        ws.cap = new_cap;
+    }
+
+    void repack(const bool tight)
+    {
+        size_t need = 0;
+        for(const auto& ws: watches) {
+            need += tight ? with_slack(ws.sz) : ws.cap;
+        }
+        const size_t new_cap = need + need/4 + 1024;
+        Watched* new_arena = (Watched*)malloc(new_cap*sizeof(Watched));
+        if (new_arena == NULL) {
+            //Keep the current layout then
+            return;
+        }
+
+        size_t at = 0;
+        for(auto& ws: watches) {
+            const uint32_t cap = tight ? with_slack(ws.sz) : ws.cap;
+            if (cap == 0) {
+                release(ws);
+                continue;
+            }
+            Watched* d = new_arena + at;
+            std::copy(ws.begin(), ws.end(), d);
+            if (!in_arena(ws.data)) {
+                free(ws.data);
+            }
+            ws.data = d;
+            ws.cap = cap;
+            at += cap;
+        }
+        free(arena);
+        arena = new_arena;
+        arena_used = at;
+        arena_cap = new_cap;
+        wasted = 0;
+        overflow = 0;
+    }
 };
 
+inline void watch_subarray::capacity(const uint32_t min_cap)
+{
+    if (ws->cap < min_cap) {
+        arr->grow(*ws, min_cap);
+    }
+}
+
+inline void watch_subarray::clear(const bool dealloc)
+{
+    if (dealloc) {
+        arr->release(*ws);
+    } else {
+        ws->sz = 0;
+    }
+}
+
+inline void watch_subarray::shrink_to_fit()
+{
+    arr->trim(*ws, ws->sz);
+}
+
 inline void swap(watch_subarray a, watch_subarray b)
 {
     a.swap(b);
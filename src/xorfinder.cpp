@@ -235,6 +235,43 @@ void XorFinder::find_xors()
     #endif
 }
 
+//Takes XORs found by another thread instead of searching for them. No
+//clause is marked as used in them, so no clause will be detached.
+void XorFinder::import_xors(vector<Xor>&& xors)
+{
+    assert(!solver->frat->enabled());
+    runStats.clear();
+    runStats.numCalls = 1;
+    double myTime = cpuTime();
+
+    for(auto& offs: occsimplifier->clauses) {
+        Clause* cl = solver->cl_alloc.ptr(offs);
+        if (cl->getRemoved() || cl->freed()) {
+            continue;
+        }
+
+        cl->set_used_in_xor(false);
+        cl->set_used_in_xor_full(false);
+    }
+
+    solver->xorclauses = std::move(xors);
+    solver->xorclauses_orig = solver->xorclauses;
+    solver->xorclauses_unused.clear();
+
+    runStats.foundXors = solver->xorclauses.size();
+    runStats.findTime = cpuTime() - myTime;
+    solver->sumSearchStats.num_xors_found_last = solver->xorclauses.size();
+    print_found_xors();
+    globalStats += runStats;
+    solver->xor_clauses_updated = true;
+
+    #ifdef SLOW_DEBUG
+    for(const Xor& x: solver->xorclauses)
+        for(uint32_t v: x)
+            assert(solver->varData[v].removed == Removed::none);
+    #endif
+}
+
 void XorFinder::print_found_xors()
 {
     if (solver->conf.verbosity >= 5) {
@@ -154,6 +154,7 @@ class XorFinder
 public:
     XorFinder(OccSimplifier* occsimplifier, Solver* solver);
     void find_xors();
+    void import_xors(vector<Xor>&& xors);
 
     struct Stats
     {
@@ -24,8 +24,10 @@ THE SOFTWARE.
 
 #include "cryptominisat5/cryptominisat.h"
 #include "src/solverconf.h"
+#include "test_helper.h"
 #include <vector>
 #include <algorithm>
+#include <random>
 using std::vector;
 using namespace CMSat;
 
@@ -209,6 +211,38 @@ TEST_F(assump_interf, only_assump)
 }
 
 
+//BVE first, then many solves under changing assumptions. The model is
+//extended incrementally between solves, and assuming eliminated variables
+//uneliminates them, so every model must still satisfy the original CNF.
+TEST_F(assump_interf, extend_model_after_bve)
+{
+    const uint32_t num_vars = 300;
+    std::mt19937 rnd(7);
+    std::uniform_int_distribution<uint32_t> var(0, num_vars-1);
+    const vector<vector<Lit>> cls = random_ksat(num_vars, num_vars*3, 7);
+    s->new_vars(num_vars);
+    for(const auto& cl: cls) s->add_clause(cl);
+    const std::string strategy = "occ-bve";
+    ASSERT_NE(s->simplify(NULL, &strategy), l_False);
+
+    uint32_t num_sat = 0;
+    for(uint32_t i = 0; i < 40; i++) {
+        assumps.clear();
+        if (i % 4 != 0) {
+            for(uint32_t j = 0; j < 3; j++) assumps.push_back(Lit(var(rnd), rnd() & 1));
+        }
+        if (s->solve(&assumps) != l_True) continue;
+        num_sat++;
+
+        const vector<lbool>& model = s->get_model();
+        for(const Lit l: assumps) {
+            EXPECT_EQ(model[l.var()], l.sign() ? l_False : l_True);
+        }
+        EXPECT_TRUE(model_satisfies(model, cls));
+    }
+    EXPECT_GT(num_sat, 10U);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -23,6 +23,8 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <fstream>
+#include <random>
+#include <set>
 
 #include "cryptominisat5/cryptominisat.h"
 #include "src/solverconf.h"
@@ -1393,6 +1395,196 @@ TEST(xor_recovery, DISABLED_find_xor_renumber)
 }
 
 
+TEST(incremental, fast_path_stats)
+{
+    SolverConf conf;
+    conf.simplify_at_startup = true;
+    conf.simplify_at_every_startup = true;
+    SATSolver s(&conf);
+    s.set_incremental_fast_path(true);
+    s.new_vars(10);
+    s.add_clause(str_to_cl("1, 2, 3"));
+    s.add_clause(str_to_cl("-1, 4"));
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_last_dirty_vars(), 4U);
+    EXPECT_GE(s.get_last_num_simplify(), 1U);
+    EXPECT_GE(s.get_last_simplify_time(), 0.0);
+
+    s.add_clause(str_to_cl("5, -6"));
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_last_dirty_vars(), 2U);
+
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_last_dirty_vars(), 0U);
+}
+
+TEST(incremental, fast_path_same_results)
+{
+    //BMC-like loop: few clauses added between many assumption-based calls
+    SolverConf conf;
+    conf.simplify_at_startup = true;
+    conf.simplify_at_every_startup = true;
+    SATSolver s(&conf);
+    s.set_incremental_fast_path(true);
+    SATSolver s2;
+
+    std::mt19937 mtrand(7);
+    const uint32_t num_vars = 120;
+    const vector<vector<Lit>> all_cls = random_ksat(num_vars, 400, 7);
+    vector<vector<Lit>> cls;
+    s.new_vars(num_vars);
+    s2.new_vars(num_vars);
+    for(uint32_t round = 0; round < 40; round++) {
+        for(uint32_t i = 0; i < 10; i++) {
+            const vector<Lit>& cl = all_cls[cls.size()];
+            s.add_clause(cl);
+            s2.add_clause(cl);
+            cls.push_back(cl);
+        }
+        vector<Lit> assumps;
+        assumps.push_back(Lit(mtrand() % num_vars, mtrand() & 1));
+        const lbool ret = s.solve(&assumps);
+        EXPECT_EQ(ret, s2.solve(&assumps));
+        if (ret == l_True) {
+            const vector<lbool>& model = s.get_model();
+            EXPECT_EQ(model[assumps[0].var()], assumps[0].sign() ? l_False : l_True);
+            EXPECT_TRUE(model_satisfies(model, cls));
+        }
+        if (!s.okay()) break;
+    }
+}
+
+TEST(enumerate, all_models)
+{
+    SATSolver s;
+    s.new_vars(3);
+    s.add_clause(str_to_cl("1, 2, 3"));
+
+    vector<uint32_t> found(8, 0);
+    lbool ret = s.enumerate([&](const vector<lbool>& m) {
+        uint32_t at = 0;
+        for(uint32_t i = 0; i < 3; i++) {
+            EXPECT_NE(m[i], l_Undef);
+            at |= (uint32_t)(m[i] == l_True) << i;
+        }
+        found[at]++;
+        return true;
+    });
+    EXPECT_EQ(ret, l_False);
+    EXPECT_EQ(found[0], 0U);
+    for(uint32_t i = 1; i < 8; i++) EXPECT_EQ(found[i], 1U);
+}
+
+TEST(enumerate, projection_and_batches)
+{
+    SolverConf conf;
+    conf.simplify_at_startup = true;
+    SATSolver s(&conf);
+    s.new_vars(30);
+    s.add_clause(str_to_cl("1, 2, 3, 4"));
+    s.add_clause(str_to_cl("-5, 6"));
+    s.add_clause(str_to_cl("-1, 7, 8"));
+
+    vector<uint32_t> proj = str_to_vars("1, 2, 5");
+    uint32_t num = 0;
+    lbool ret = s.enumerate([&](const vector<lbool>&) {
+        num++;
+        return true;
+    }, &proj, 3);
+    EXPECT_EQ(ret, l_True);
+    EXPECT_EQ(num, 3U);
+
+    ret = s.enumerate([&](const vector<lbool>& m) {
+        num++;
+        for(const uint32_t v: proj) EXPECT_NE(m[v], l_Undef);
+        return true;
+    }, &proj);
+    EXPECT_EQ(ret, l_False);
+    EXPECT_EQ(num, 8U);
+}
+
+TEST(enumerate, callback_stops)
+{
+    SATSolver s;
+    s.new_vars(10);
+    s.add_clause(str_to_cl("1, 2"));
+
+    uint32_t num = 0;
+    lbool ret = s.enumerate([&](const vector<lbool>&) {
+        num++;
+        return num < 5;
+    });
+    EXPECT_EQ(ret, l_True);
+    EXPECT_EQ(num, 5U);
+}
+
+//Banning the last model makes the formula UNSAT, but the limit was reached
+TEST(enumerate, limit_equals_model_count)
+{
+    for(uint32_t threads = 1; threads <= 2; threads++) {
+        SATSolver s;
+        s.set_num_threads(threads);
+        s.new_vars(3);
+        s.add_clause(str_to_cl("1, 2, 3"));
+
+        vector<uint32_t> found(8, 0);
+        lbool ret = s.enumerate([&](const vector<lbool>& m) {
+            uint32_t at = 0;
+            for(uint32_t i = 0; i < 3; i++) {
+                at |= (uint32_t)(m[i] == l_True) << i;
+            }
+            found[at]++;
+            return true;
+        }, NULL, 7);
+        EXPECT_EQ(ret, l_True);
+        for(uint32_t i = 1; i < 8; i++) EXPECT_EQ(found[i], 1U);
+
+        //The last model stays available, and there are no more
+        const vector<lbool>& m = s.get_model();
+        EXPECT_TRUE(m[0] == l_True || m[1] == l_True || m[2] == l_True);
+        ret = s.enumerate([&](const vector<lbool>&) { return true; });
+        EXPECT_EQ(ret, l_False);
+    }
+}
+
+//Replaying the log must give the same clauses, whatever the thread count
+TEST(enumerate, logfile)
+{
+    for(uint32_t threads = 1; threads <= 2; threads++) {
+        SATSolver* s = new SATSolver();
+        s->set_num_threads(threads);
+        s->log_to_file("testfile");
+        s->new_vars(2);
+        s->add_clause(str_to_cl("1, 2"));
+        uint32_t num = 0;
+        lbool ret = s->enumerate([&](const vector<lbool>&) {
+            num++;
+            return true;
+        });
+        EXPECT_EQ(ret, l_False);
+        EXPECT_EQ(num, 3U);
+        delete s;
+
+        std::ifstream infile("testfile");
+        std::string line;
+        std::getline(infile, line);
+        EXPECT_EQ(line, "c Solver::new_vars( 2 )");
+        std::getline(infile, line);
+        EXPECT_EQ(line, "1 2 0");
+        std::set<std::string> blocks;
+        for(uint32_t i = 0; i < 3; i++) {
+            std::getline(infile, line);
+            EXPECT_EQ(line, "c Solver::solve(  )");
+            std::getline(infile, line);
+            blocks.insert(line);
+        }
+        EXPECT_EQ(blocks, (std::set<std::string>{"1 -2 0", "-1 2 0", "-1 -2 0"}));
+        std::getline(infile, line);
+        EXPECT_EQ(line, "c Solver::solve(  )");
+        EXPECT_FALSE(std::getline(infile, line));
+    }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
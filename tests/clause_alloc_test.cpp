@@ -24,10 +24,14 @@ THE SOFTWARE.
 
 #include <fstream>
 #include <stdlib.h>
+#include <random>
+#include <algorithm>
+#include <sys/resource.h>
 
 #include "src/solver.h"
 #include "src/clauseallocator.h"
 #include "src/solverconf.h"
+#include "cryptominisat5/cryptominisat.h"
 using namespace CMSat;
 #include "test_helper.h"
 
@@ -48,7 +52,8 @@ struct clause_allocator : public ::testing::Test {
     std::atomic<bool> must_inter;
 };
 
-TEST_F(clause_allocator, add_1)
+//Large, only for manual runs
+TEST_F(clause_allocator, DISABLED_add_1)
 {
     vector<Lit> cl;
     srand(0);
@@ -75,6 +80,159 @@ TEST_F(clause_allocator, add_1)
     EXPECT_EQ(ret, l_True);
 }
 
+static void add_random_cls(Solver* s, const uint32_t num, const uint32_t vars)
+{
+    std::mt19937 rnd(1);
+    vector<Lit> cl;
+    for(uint32_t i = 0; i < num; i++) {
+        cl.clear();
+        const uint32_t size = 3 + rnd() % 8;
+        while(cl.size() < size) {
+            const Lit l = Lit(rnd() % vars, rnd() % 2);
+            if (std::find(cl.begin(), cl.end(), l) == cl.end()
+                && std::find(cl.begin(), cl.end(), ~l) == cl.end()
+            ) {
+                cl.push_back(l);
+            }
+        }
+        s->add_clause_outside(cl);
+    }
+}
+
+//Every clause watch must point to a clause that has the literal watched
+static void check_watches(const Solver* s)
+{
+    for(uint32_t i = 0; i < s->watches.size(); i++) {
+        const Lit lit = Lit::toLit(i);
+        for(const Watched& w: s->watches[lit]) {
+            if (!w.isClause()) continue;
+            const Clause& cl = *s->cl_alloc.ptr(w.get_offset());
+            EXPECT_FALSE(cl.freed());
+            EXPECT_TRUE(cl[0] == lit || cl[1] == lit);
+        }
+    }
+}
+
+TEST_F(clause_allocator, consolidate_keeps_clauses)
+{
+    add_random_cls(s, 5000, 300);
+
+    //Satisfy and free some of them, so there is something to compact
+    s->add_clause_outside(str_to_cl("1"));
+    s->add_clause_outside(str_to_cl("-2"));
+    s->add_clause_outside(str_to_cl("3"));
+    s->remove_and_clean_all();
+    vector<vector<Lit> > before = get_irred_cls(s);
+
+    s->cl_alloc.consolidate(s, true);
+    vector<vector<Lit> > after = get_irred_cls(s);
+    check_fuzzy_equal(before, after);
+    check_watches(s);
+
+    //Consolidating an already compact stack must not change anything either
+    s->cl_alloc.consolidate(s, true);
+    after = get_irred_cls(s);
+    check_fuzzy_equal(before, after);
+    check_watches(s);
+}
+
+//Clauses are placed in the order they are first met in the watchlists
+static void check_watch_order(const Solver* s)
+{
+    vector<char> met(s->cl_alloc.mem_used(), 0);
+    ClOffset last = 0;
+    bool first = true;
+    uint32_t num = 0;
+    for(uint32_t i = 0; i < s->watches.size(); i++) {
+        for(const Watched& w: s->watches[Lit::toLit(i)]) {
+            if (!w.isClause() || met[w.get_offset()]) continue;
+            met[w.get_offset()] = 1;
+            if (!first) {
+                EXPECT_LT(last, w.get_offset());
+            }
+            first = false;
+            last = w.get_offset();
+            num++;
+        }
+    }
+    EXPECT_EQ(num, s->longIrredCls.size());
+}
+
+TEST_F(clause_allocator, consolidate_watch_order)
+{
+    add_random_cls(s, 5000, 300);
+    s->add_clause_outside(str_to_cl("1"));
+    s->remove_and_clean_all();
+    s->cl_alloc.consolidate(s, true);
+    check_watch_order(s);
+}
+
+//Without freed space, the clauses are placed in several slabs
+TEST_F(clause_allocator, consolidate_compact_in_slabs)
+{
+    add_random_cls(s, 5000, 300);
+    s->add_clause_outside(str_to_cl("1"));
+    s->remove_and_clean_all();
+    s->cl_alloc.consolidate(s, true);
+    vector<vector<Lit> > before = get_irred_cls(s);
+
+    //Reverse the watchlists, so the watch order is not the current one
+    for(uint32_t i = 0; i < s->watches.size(); i++) {
+        watch_subarray ws = s->watches[Lit::toLit(i)];
+        std::reverse(ws.begin(), ws.end());
+    }
+    check_watches(s);
+
+    s->cl_alloc.consolidate(s, true);
+    vector<vector<Lit> > after = get_irred_cls(s);
+    check_fuzzy_equal(before, after);
+    check_watches(s);
+    check_watch_order(s);
+}
+
+TEST_F(clause_allocator, consolidate_then_solve)
+{
+    add_random_cls(s, 1000, 300);
+    s->add_clause_outside(str_to_cl("1"));
+    s->remove_and_clean_all();
+    s->cl_alloc.consolidate(s, true);
+
+    const vector<vector<Lit> > cls = get_irred_cls(s);
+
+    lbool ret = s->solve_with_assumptions(NULL);
+    ASSERT_EQ(ret, l_True);
+    for(const auto& cl: cls) {
+        bool sat = false;
+        for(const Lit l: cl) {
+            sat |= (s->get_model()[l.var()] ^ l.sign()) == l_True;
+        }
+        EXPECT_TRUE(sat);
+    }
+}
+
+//Every thread has its own allocator, together they must fit in ulimit -v.
+//Runs in a child process, so the limit does not stick to the other tests
+TEST(clause_allocator_threads, solve_under_rlimit_as)
+{
+    EXPECT_EXIT({
+        struct rlimit lim;
+        getrlimit(RLIMIT_AS, &lim);
+        lim.rlim_cur = 2ULL << 30;
+        setrlimit(RLIMIT_AS, &lim);
+
+        const uint32_t num_vars = 60000;
+        SATSolver s;
+        s.set_num_threads(8);
+        s.set_max_confl(5000);
+        s.new_vars(num_vars);
+        for(const auto& cl: random_ksat(num_vars, 4*num_vars, 1)) {
+            s.add_clause(cl);
+        }
+        s.solve();
+        exit(0);
+    }, ::testing::ExitedWithCode(0), "");
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,115 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "test_helper.h"
+#include <vector>
+
+using namespace CMSat;
+using std::vector;
+
+static void add_pigeonhole(SATSolver& s, uint32_t pigeons, uint32_t holes)
+{
+    s.new_vars(pigeons*holes);
+    for(uint32_t p = 0; p < pigeons; p++) {
+        vector<Lit> cl;
+        for(uint32_t h = 0; h < holes; h++) {
+            cl.push_back(Lit(p*holes+h, false));
+        }
+        s.add_clause(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p1 = 0; p1 < pigeons; p1++) {
+            for(uint32_t p2 = p1+1; p2 < pigeons; p2++) {
+                s.add_clause(vector<Lit>{
+                    Lit(p1*holes+h, true), Lit(p2*holes+h, true)});
+            }
+        }
+    }
+}
+
+TEST(cube, sat)
+{
+    for(uint32_t seed = 0; seed < 5; seed++) {
+        const auto cls = random_ksat(150, 600, seed);
+        SATSolver s;
+        s.set_num_threads(3);
+        s.set_cube_and_conquer(true, 6);
+        s.new_vars(150);
+        for(const auto& cl: cls) s.add_clause(cl);
+        ASSERT_EQ(s.solve(), l_True);
+        EXPECT_TRUE(model_satisfies(s.get_model(), cls));
+    }
+}
+
+TEST(cube, unsat)
+{
+    SATSolver s;
+    s.set_num_threads(3);
+    s.set_cube_and_conquer(true, 5);
+    add_pigeonhole(s, 7, 6);
+    EXPECT_EQ(s.solve(), l_False);
+    EXPECT_FALSE(s.okay());
+}
+
+TEST(cube, unsat_under_assumptions)
+{
+    //5 pigeons fit into 5 holes, but not if the last hole is taken away
+    const uint32_t holes = 5;
+    SATSolver s;
+    s.set_num_threads(3);
+    s.set_cube_and_conquer(true, 4);
+    add_pigeonhole(s, 5, holes);
+    vector<Lit> assumps;
+    for(uint32_t p = 0; p < 5; p++) {
+        assumps.push_back(Lit(p*holes+holes-1, true));
+    }
+    EXPECT_EQ(s.solve(&assumps), l_False);
+    EXPECT_TRUE(s.okay());
+    for(const Lit l: s.get_conflict()) {
+        EXPECT_NE(std::find(assumps.begin(), assumps.end(), ~l), assumps.end());
+    }
+
+    //Same solver, now satisfiable
+    EXPECT_EQ(s.solve(), l_True);
+}
+
+TEST(cube, conflict_budget_is_shared)
+{
+    //Far too hard for the budget, the threads together must stop near it
+    SATSolver s;
+    s.set_num_threads(3);
+    s.set_cube_and_conquer(true, 4);
+    add_pigeonhole(s, 11, 10);
+    s.set_max_confl(3000);
+    EXPECT_EQ(s.solve(), l_Undef);
+    EXPECT_LT(s.get_sum_conflicts(), 3000U*3/2);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
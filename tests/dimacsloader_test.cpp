@@ -0,0 +1,294 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/dimacsloader.h"
+#include "src/dimacsparser.h"
+#include "src/solver.h"
+#include <vector>
+
+using namespace CMSat;
+using std::vector;
+using std::string;
+#include "test_helper.h"
+
+static const char* fname = "dimacsloader_test.cnf";
+
+static void write_file(const string& content)
+{
+    std::ofstream f(fname);
+    f << content;
+}
+
+TEST(dimacsloader, simple_sat)
+{
+    write_file("c simple\np cnf 3 2\n1 2 0\n-1 0\n");
+    SATSolver s;
+    DimacsLoader<SATSolver> loader(&s, 0, 2);
+    EXPECT_TRUE(loader.load(fname));
+    EXPECT_EQ(s.nVars(), 3u);
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[0], l_False);
+    EXPECT_EQ(s.get_model()[1], l_True);
+}
+
+TEST(dimacsloader, simple_unsat)
+{
+    write_file("p cnf 2 4\n1 2 0\n-1 2 0\n1 -2 0\r\n  -1   -2 0\n");
+    SATSolver s;
+    DimacsLoader<SATSolver> loader(&s, 0, 2);
+    EXPECT_TRUE(loader.load(fname));
+    EXPECT_EQ(s.solve(), l_False);
+}
+
+TEST(dimacsloader, any_blank)
+{
+    write_file("p\tcnf 3  2 \n1\t\t2 \v0\n\f-1\t0\r\n");
+    SATSolver s;
+    DimacsLoader<SATSolver> loader(&s, 0, 2);
+    EXPECT_TRUE(loader.load(fname));
+    EXPECT_EQ(s.nVars(), 3u);
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[0], l_False);
+    EXPECT_EQ(s.get_model()[1], l_True);
+}
+
+TEST(dimacsloader, no_header)
+{
+    write_file("1 -5 0\n");
+    SATSolver s;
+    DimacsLoader<SATSolver> loader(&s, 0, 1);
+    EXPECT_TRUE(loader.load(fname));
+    EXPECT_EQ(s.nVars(), 5u);
+}
+
+//Like DimacsParser, the header only adds variables
+TEST(dimacsloader, header_disagrees)
+{
+    const std::pair<const char*, uint32_t> inputs[] = {
+        {"p cnf 2 1\n1 -5 0\n", 5}, //variable beyond the header
+        {"p cnf 2 2\n1 -2 0\n", 2}, //too few clauses
+        {"p cnf 2 1\n1 0\n2 0\n", 2}, //too many clauses
+        {"p cnf 2 1\np cnf 3 1\n1 0\n", 3}, //two headers
+    };
+    for(const auto& input: inputs) {
+        write_file(input.first);
+        SATSolver s;
+        DimacsLoader<SATSolver> loader(&s, 0, 2);
+        EXPECT_TRUE(loader.load(fname)) << input.first;
+        EXPECT_EQ(s.nVars(), input.second) << input.first;
+    }
+}
+
+//The loader stops at the start of the line it cannot handle, having added
+//everything before it
+TEST(dimacsloader, stops_at_extensions)
+{
+    struct Input {
+        const char* cnf;
+        uint64_t offset;
+        uint64_t line;
+    };
+    const Input inputs[] = {
+        {"p cnf 2 1\nx1 2 0\n", 10, 1},
+        {"p cnf 2 1\n1 2 0\nc ind 1 0\n", 16, 2},
+        {"p cnf 2 1\nc red 1 2 0\n", 10, 1},
+        {"p cnf 2 1\n-1 0\n1 2\n", 15, 2},
+        {"p cnf 2 1\n\n1\n2 0\n", 11, 2},
+        {"p cnf 2 1\n1 a 0\n", 10, 1},
+        {"p wcnf 2 1\n1 2 0\n", 0, 0},
+    };
+    for(const Input& input: inputs) {
+        write_file(input.cnf);
+        SATSolver s;
+        DimacsLoader<SATSolver> loader(&s, 0, 2);
+        EXPECT_FALSE(loader.load(fname)) << input.cnf;
+        EXPECT_EQ(loader.resume_offset(), input.offset) << input.cnf;
+        EXPECT_EQ(loader.resume_line(), input.line) << input.cnf;
+    }
+}
+
+//What main() does: the regular parser takes over where the loader stopped
+TEST(dimacsloader, resume_with_parser)
+{
+    write_file("p cnf 3 3\n1 2 0\nx1 3 0\n-1 0\n");
+    SATSolver s;
+    DimacsLoader<SATSolver> loader(&s, 0, 2);
+    EXPECT_FALSE(loader.load(fname));
+    EXPECT_EQ(s.nVars(), 3u);
+
+    FILE* in = fopen(fname, "rb");
+    ASSERT_EQ(fseek(in, loader.resume_offset(), SEEK_SET), 0);
+    DimacsParser<StreamBuffer<FILE*, FN>, SATSolver> parser(
+        &s, NULL, 0, loader.resume_line());
+    EXPECT_TRUE(parser.parse_DIMACS(in, false));
+    fclose(in);
+
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[0], l_False);
+    EXPECT_EQ(s.get_model()[1], l_True);
+    EXPECT_EQ(s.get_model()[2], l_True);
+}
+
+//Implication chain 1 -> 2 -> ... -> N with 1 set, large enough for the file
+//to be parsed by several threads in several pieces
+static string chain_cnf(const uint32_t n)
+{
+    std::stringstream ss;
+    ss << "p cnf " << n << " " << n << "\n1 0\n";
+    for(uint32_t i = 1; i < n; i++) {
+        ss << "-" << i << " " << i+1 << " 0\n";
+    }
+    return ss.str();
+}
+
+TEST(dimacsloader, many_pieces)
+{
+    const uint32_t n = 1500000;
+    write_file(chain_cnf(n));
+
+    SATSolver s;
+    DimacsLoader<SATSolver> loader(&s, 0, 4);
+    EXPECT_TRUE(loader.load(fname));
+    EXPECT_EQ(s.nVars(), n);
+    EXPECT_EQ(s.solve(), l_True);
+    for(uint32_t i = 0; i < n; i++) {
+        EXPECT_EQ(s.get_model()[i], l_True);
+    }
+}
+
+TEST(dimacsloader, many_pieces_stops_at_end)
+{
+    const uint32_t n = 1500000;
+    const string cnf = chain_cnf(n);
+    write_file(cnf + "x1 2 0\n");
+
+    SATSolver s;
+    DimacsLoader<SATSolver> loader(&s, 0, 4);
+    EXPECT_FALSE(loader.load(fname));
+    EXPECT_EQ(loader.resume_offset(), cnf.size());
+    EXPECT_EQ(loader.resume_line(), n+1);
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[n-1], l_True);
+}
+
+#ifdef USE_ZLIB
+TEST(dimacsloader, gzipped)
+{
+    const char* gzname = "dimacsloader_test.cnf.gz";
+    gzFile f = gzopen(gzname, "wb");
+    const string content = "p cnf 3 3\n1 2 0\n-1 0\n-2 3 0";
+    gzwrite(f, content.data(), content.size());
+    gzclose(f);
+
+    SATSolver s;
+    DimacsLoader<SATSolver> loader(&s, 0, 2);
+    EXPECT_TRUE(loader.load(gzname));
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[2], l_True);
+    std::remove(gzname);
+}
+
+TEST(dimacsloader, gzipped_stops_at_extensions)
+{
+    const char* gzname = "dimacsloader_test.cnf.gz";
+    gzFile f = gzopen(gzname, "wb");
+    const string content = "p cnf 3 3\n1 2 0\nc ind 1 0\n-1 0\n";
+    gzwrite(f, content.data(), content.size());
+    gzclose(f);
+
+    SATSolver s;
+    DimacsLoader<SATSolver> loader(&s, 0, 2);
+    EXPECT_FALSE(loader.load(gzname));
+    EXPECT_EQ(loader.resume_offset(), 16u);
+    EXPECT_EQ(loader.resume_line(), 2u);
+    std::remove(gzname);
+}
+#endif
+
+TEST(add_clauses, matches_add_clause)
+{
+    for(unsigned threads = 1; threads <= 2; threads++) {
+        SATSolver s;
+        s.set_num_threads(threads);
+        s.new_vars(3);
+        const vector<Lit> lits = {
+            Lit(0, false), Lit(1, false),
+            Lit(0, true),
+            Lit(1, true), Lit(2, false)
+        };
+        const vector<uint32_t> offs = {0, 2, 3, 5};
+        EXPECT_TRUE(s.add_clauses(lits.data(), offs.data(), 3));
+        EXPECT_EQ(s.solve(), l_True);
+        EXPECT_EQ(s.get_model()[2], l_True);
+
+        const vector<Lit> lits2 = {Lit(2, true)};
+        const vector<uint32_t> offs2 = {0, 1};
+        s.add_clauses(lits2.data(), offs2.data(), 1);
+        EXPECT_EQ(s.solve(), l_False);
+    }
+}
+
+//Units in the middle of a batch are only propagated at its end
+TEST(add_clauses, batch_with_units)
+{
+    const uint32_t num_vars = 60;
+    for(uint32_t seed = 0; seed < 20; seed++) {
+        vector<vector<Lit>> cls = random_ksat(num_vars, 220, seed);
+        for(uint32_t i = 0; i < 4; i++) {
+            cls.insert(cls.begin() + i*50, vector<Lit>{Lit(seed+i*7, i&1)});
+        }
+        vector<Lit> lits;
+        vector<uint32_t> offs = {0};
+        for(const auto& cl: cls) {
+            lits.insert(lits.end(), cl.begin(), cl.end());
+            offs.push_back(lits.size());
+        }
+
+        SATSolver one_by_one;
+        one_by_one.new_vars(num_vars);
+        for(const auto& cl: cls) one_by_one.add_clause(cl);
+
+        SATSolver batch;
+        batch.new_vars(num_vars);
+        batch.add_clauses(lits.data(), offs.data(), cls.size());
+
+        const lbool ret = batch.solve();
+        EXPECT_EQ(ret, one_by_one.solve());
+        if (ret == l_True) {
+            EXPECT_TRUE(model_satisfies(batch.get_model(), cls));
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  const int ret = RUN_ALL_TESTS();
+  std::remove(fname);
+  return ret;
+}
@@ -0,0 +1,212 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <cstdio>
+
+#include "src/flat_forest.h"
+
+using namespace CMSat;
+using std::vector;
+using std::string;
+
+static const float nan_val = std::numeric_limits<float>::quiet_NaN();
+
+//Tree 0: x0 < 0.5 ? 1 : 2, NaN is missing and goes left
+//Tree 1: x1 < 3 ? 10 : 20, NaN is taken as 0
+//Tree 2: x2 < -0.5 ? 100 : 200, zero (and so NaN) is missing and goes right
+//Tree 3: a single leaf, 0.5
+static const int32_t roots[] = {0, 1, 2, ~6};
+static const int32_t left[] = {~0, ~2, ~4};
+static const int32_t right[] = {~1, ~3, ~5};
+static const float thr[] = {0.5f, 3.0f, -0.5f};
+static const uint16_t feat[] = {0, 1, 2};
+static const uint8_t flags[] = {
+    FlatForest::default_left | FlatForest::nan_missing,
+    0,
+    FlatForest::zero_missing
+};
+static const double leaf[] = {1, 2, 10, 20, 100, 200, 0.5};
+
+static FlatForest tiny_forest()
+{
+    FlatForest f;
+    f.num_trees = 4;
+    f.roots = roots;
+    f.left = left;
+    f.right = right;
+    f.thr = thr;
+    f.feat = feat;
+    f.flags = flags;
+    f.leaf = leaf;
+    f.base = 0;
+    f.sigmoid = 0;
+    f.average = false;
+    return f;
+}
+
+struct Row {
+    float x[3];
+    double expected;
+};
+
+static const Row rows[] = {
+    {{0.2f, 1.0f, -1.0f}, 1 + 10 + 100 + 0.5},
+    {{0.7f, 5.0f, 1.0f}, 2 + 20 + 200 + 0.5},
+    //Ties at the threshold go right
+    {{0.5f, 3.0f, -0.5f}, 2 + 20 + 200 + 0.5},
+    //NaN: missing and left, taken as 0 then left, taken as 0 and missing
+    {{nan_val, nan_val, nan_val}, 1 + 10 + 200 + 0.5},
+    //Zero is only missing where zero_missing is set
+    {{0.0f, 0.0f, 0.0f}, 1 + 10 + 200 + 0.5},
+};
+
+TEST(flat_forest, predict)
+{
+    const FlatForest f = tiny_forest();
+    const uint32_t n = sizeof(rows)/sizeof(rows[0]);
+    vector<float> data;
+    for(const Row& r: rows) {
+        data.insert(data.end(), r.x, r.x+3);
+    }
+    vector<double> out(n);
+    f.predict(data.data(), n, 3, out.data());
+    for(uint32_t i = 0; i < n; i++) {
+        EXPECT_DOUBLE_EQ(out[i], rows[i].expected) << "row " << i;
+    }
+}
+
+TEST(flat_forest, predict_many_rows_with_stride)
+{
+    //More rows than one block, and padding between the rows
+    const FlatForest f = tiny_forest();
+    const uint32_t nrows = sizeof(rows)/sizeof(rows[0]);
+    const uint32_t n = 300;
+    const uint32_t stride = 4;
+    vector<float> data(n*stride, -7.0f);
+    for(uint32_t i = 0; i < n; i++) {
+        for(uint32_t k = 0; k < 3; k++) {
+            data[i*stride+k] = rows[i % nrows].x[k];
+        }
+    }
+    vector<double> out(n);
+    f.predict(data.data(), n, stride, out.data());
+    for(uint32_t i = 0; i < n; i++) {
+        EXPECT_DOUBLE_EQ(out[i], rows[i % nrows].expected) << "row " << i;
+    }
+}
+
+TEST(flat_forest, average_base_sigmoid)
+{
+    FlatForest f = tiny_forest();
+    f.average = true;
+    f.base = -50;
+    double out;
+    f.predict(rows[0].x, 1, 3, &out);
+    EXPECT_DOUBLE_EQ(out, rows[0].expected/4 - 50);
+
+    f.average = false;
+    f.base = -rows[0].expected;
+    f.sigmoid = 2;
+    f.predict(rows[0].x, 1, 3, &out);
+    EXPECT_DOUBLE_EQ(out, 0.5);
+}
+
+//LightGBM splits with "x <= t", with missing type and default direction in
+//decision_type: 2 = default left, (1<<2) = zero missing, (2<<2) = NaN missing
+static const char* lgbm_model =
+"tree\n"
+"version=v3\n"
+"num_class=1\n"
+"num_tree_per_iteration=1\n"
+"label_index=0\n"
+"max_feature_idx=1\n"
+"objective=binary sigmoid:1\n"
+"feature_names=a b\n"
+"\n"
+"Tree=0\n"
+"num_leaves=3\n"
+"num_cat=0\n"
+"split_feature=0 1\n"
+"threshold=0.5 1.0000000000000002\n"
+"decision_type=10 0\n"
+"left_child=-1 -2\n"
+"right_child=1 -3\n"
+"leaf_value=-1 0.25 2\n"
+"shrinkage=1\n"
+"\n"
+"end of trees\n";
+
+TEST(flat_forest, load_lgbm)
+{
+    const string fname = "flat_forest_test_model.txt";
+    {
+        std::ofstream out(fname);
+        out << lgbm_model;
+    }
+    FlatForestStore store;
+    string err;
+    ASSERT_TRUE(store.load_lgbm(fname, err)) << err;
+    std::remove(fname.c_str());
+    const FlatForest& f = store.get();
+    EXPECT_EQ(f.num_trees, 1U);
+
+    auto score = [](const double raw) { return 1.0/(1.0+std::exp(-raw)); };
+    const float data[][2] = {
+        {0.5f, 0.0f}, //tie, "<=" goes left
+        {0.50001f, 1.0f}, //right, then 1.0 <= 1.0000000000000002 goes left
+        {0.6f, 1.1f},
+        {nan_val, 5.0f}, //NaN is missing, default left
+    };
+    const double expected[] = {score(-1), score(0.25), score(2), score(-1)};
+    double out[4];
+    f.predict(&data[0][0], 4, 2, out);
+    for(uint32_t i = 0; i < 4; i++) {
+        EXPECT_DOUBLE_EQ(out[i], expected[i]) << "row " << i;
+    }
+}
+
+TEST(flat_forest, load_lgbm_rejects_categorical)
+{
+    const string fname = "flat_forest_test_cat.txt";
+    {
+        std::ofstream out(fname);
+        string m = lgbm_model;
+        m.replace(m.find("decision_type=10 0"), 18, "decision_type=1 0");
+        out << m;
+    }
+    FlatForestStore store;
+    string err;
+    EXPECT_FALSE(store.load_lgbm(fname, err));
+    EXPECT_FALSE(err.empty());
+    std::remove(fname.c_str());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
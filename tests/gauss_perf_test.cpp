@@ -0,0 +1,129 @@
+/******************************************
+Copyright (c) 2020, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Gauss-Jordan elimination benchmark: builds random XOR matrices of varying
+// width and density, and times EGaussian::full_init() (elimination plus
+// watch setup) with every PackedRow kernel set the CPU supports.
+// Usage: gauss_perf_test [repetitions]
+
+#include "src/solver.h"
+#include "src/solverconf.h"
+#include "src/gaussian.h"
+#include "src/packedrow.h"
+#include "src/time_mem.h"
+
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using namespace CMSat;
+
+static vector<Xor> gen_xors(
+    const uint32_t num_vars,
+    const uint32_t num_rows,
+    const double density,
+    std::mt19937& mtrand)
+{
+    std::uniform_real_distribution<double> dist(0, 1);
+    vector<Xor> xors;
+    vector<uint32_t> vars;
+    for(uint32_t r = 0; r < num_rows; r++) {
+        vars.clear();
+        for(uint32_t v = 0; v < num_vars; v++) {
+            if (dist(mtrand) < density) vars.push_back(v);
+        }
+        while (vars.size() < 2) {
+            const uint32_t v = mtrand() % num_vars;
+            if (std::find(vars.begin(), vars.end(), v) == vars.end()) vars.push_back(v);
+        }
+        xors.push_back(Xor(vars, mtrand() & 1, vector<uint32_t>()));
+    }
+    return xors;
+}
+
+static double time_full_init(
+    const uint32_t num_vars,
+    const vector<Xor>& xors,
+    const uint32_t reps)
+{
+    double total = 0;
+    for(uint32_t i = 0; i < reps; i++) {
+        std::atomic<bool> must_inter(false);
+        SolverConf conf;
+        conf.verbosity = 0;
+        Solver s(&conf, &must_inter);
+        s.new_vars(num_vars);
+
+        EGaussian* g = new EGaussian(&s, 0, xors);
+        bool created;
+        const double start = cpuTime();
+        g->full_init(created);
+        total += cpuTime() - start;
+        delete g;
+    }
+    return total;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t reps = 3;
+    if (argc > 1) {
+        char* end = NULL;
+        const unsigned long val = std::strtoul(argv[1], &end, 10);
+        if (*end != '\0' || val == 0) {
+            cout << "Usage: " << argv[0] << " [repetitions]" << endl;
+            return -1;
+        }
+        reps = val;
+    }
+
+    const char* kernels[] = {"scalar", "popcnt", "avx2", "avx512"};
+    const uint32_t widths[] = {256, 1024, 4096};
+    const double densities[] = {0.01, 0.05, 0.2, 0.5};
+    for(const uint32_t width: widths) {
+        for(const double density: densities) {
+            std::mt19937 mtrand(width + (uint32_t)(density*1000));
+            const vector<Xor> xors = gen_xors(width, width/2, density, mtrand);
+            cout << "cols: " << std::setw(5) << width
+            << " rows: " << std::setw(5) << width/2
+            << " density: " << std::setw(4) << density;
+            for(const char* k: kernels) {
+                if (!select_packedrow_kernels(k)) continue;
+                const double t = time_full_init(width, xors, reps);
+                cout << " " << k << ": " << std::fixed << std::setprecision(4)
+                << t/reps << "s";
+                cout.unsetf(std::ios_base::floatfield);
+            }
+            cout << endl;
+        }
+    }
+    select_packedrow_kernels("auto");
+    return 0;
+}
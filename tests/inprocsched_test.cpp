@@ -0,0 +1,112 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include "src/solver.h"
+#include "src/inprocsched.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+struct inprocsched : public ::testing::Test {
+    inprocsched()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+        SolverConf conf;
+        conf.inproc_sched = InprocSchedMode::deterministic;
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(30);
+        sched = s->inproc_sched;
+    }
+    ~inprocsched()
+    {
+        delete s;
+    }
+
+    Solver* s;
+    InprocSched* sched;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(inprocsched, occ_tokens_form_one_unit)
+{
+    vector<string> plan = sched->plan("scc-vrepl, occ-bve,OCC-xor, renumber,");
+    ASSERT_EQ(plan.size(), 3U);
+    EXPECT_EQ(plan[0], "scc-vrepl");
+    EXPECT_EQ(plan[1], "occ-bve, occ-xor");
+    EXPECT_EQ(plan[2], "renumber");
+}
+
+TEST_F(inprocsched, fruitless_unit_backs_off)
+{
+    sched->begin("sub-impl");
+    sched->end("sub-impl");
+    EXPECT_EQ(sched->plan("sub-impl, renumber"), vector<string>{"renumber"});
+    EXPECT_EQ(sched->plan("sub-impl, renumber"), (vector<string>{"sub-impl", "renumber"}));
+
+    //Second fruitless run in a row, skipped twice
+    sched->begin("sub-impl");
+    sched->end("sub-impl");
+    EXPECT_EQ(sched->plan("sub-impl"), vector<string>{});
+    EXPECT_EQ(sched->plan("sub-impl"), vector<string>{});
+    EXPECT_EQ(sched->plan("sub-impl"), vector<string>{"sub-impl"});
+}
+
+TEST_F(inprocsched, productive_unit_goes_first)
+{
+    sched->begin("sub-impl");
+    sched->end("sub-impl");
+
+    sched->begin("scc-vrepl");
+    s->add_clause_outside(str_to_cl("1"));
+    sched->end("scc-vrepl");
+
+    //sub-impl is still backing off
+    EXPECT_EQ(sched->plan("sub-impl, scc-vrepl"), vector<string>{"scc-vrepl"});
+    EXPECT_EQ(sched->plan("sub-impl, scc-vrepl"),
+        (vector<string>{"scc-vrepl", "sub-impl"}));
+}
+
+TEST_F(inprocsched, pinned_units_never_skipped)
+{
+    sched->begin("renumber");
+    sched->end("renumber");
+    EXPECT_EQ(sched->plan("renumber, must-scc-vrepl"),
+        (vector<string>{"renumber", "must-scc-vrepl"}));
+}
+
+TEST_F(inprocsched, model_search_units_never_backed_off)
+{
+    for(int i = 0; i < 3; i++) {
+        sched->begin("sls");
+        sched->end("sls");
+        sched->begin("lucky");
+        sched->end("lucky");
+        EXPECT_EQ(sched->plan("sls, lucky"), (vector<string>{"sls", "lucky"}));
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
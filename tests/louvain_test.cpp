@@ -0,0 +1,110 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <set>
+
+#include "src/louvain.h"
+
+using namespace CMSat;
+using std::vector;
+
+//Clauses of size 3 inside groups of 'group' variables, with a few
+//clauses connecting neighbouring groups
+static vector<vector<uint32_t>> planted(
+    uint32_t groups, uint32_t group, uint32_t cls_per_group, uint32_t seed)
+{
+    std::mt19937 mtrand(seed);
+    vector<vector<uint32_t>> cls;
+    for(uint32_t g = 0; g < groups; g++) {
+        for(uint32_t i = 0; i < cls_per_group; i++) {
+            vector<uint32_t> cl;
+            for(uint32_t j = 0; j < 3; j++) cl.push_back((uint32_t)(g*group + mtrand() % group));
+            cls.push_back(cl);
+        }
+        const uint32_t next = (g+1) % groups;
+        cls.push_back({(uint32_t)(g*group + mtrand() % group),
+            (uint32_t)(next*group + mtrand() % group)});
+    }
+    return cls;
+}
+
+static void build(Louvain& louvain, const vector<vector<uint32_t>>& cls)
+{
+    louvain.build([&](uint32_t tid, uint32_t num_threads, auto& emit) {
+        for(size_t at = tid; at < cls.size(); at += num_threads) {
+            const auto& cl = cls[at];
+            const float w = 1.0f/(cl.size()*(cl.size()-1)/2);
+            for(uint32_t i = 0; i < cl.size(); i++) {
+                for(uint32_t i2 = i+1; i2 < cl.size(); i2++) {
+                    emit(cl[i], cl[i2], w);
+                }
+            }
+        }
+    });
+}
+
+TEST(louvain, empty)
+{
+    Louvain louvain(10, 2);
+    build(louvain, {});
+    louvain.calculate();
+    ASSERT_EQ(louvain.get_mapping().size(), 10U);
+    EXPECT_EQ(louvain.modularity(), 0);
+}
+
+TEST(louvain, merges_parallel_edges)
+{
+    Louvain louvain(3, 2);
+    build(louvain, {{0, 1}, {1, 0}, {1, 2}});
+    EXPECT_EQ(louvain.get_stats().edges, 2U);
+}
+
+TEST(louvain, planted_communities)
+{
+    for(const uint32_t threads: {1U, 4U}) {
+        const uint32_t groups = 50;
+        const uint32_t group = 40;
+        Louvain louvain(groups*group, threads);
+        build(louvain, planted(groups, group, 150, 1));
+        louvain.calculate();
+        const auto& mapping = louvain.get_mapping();
+
+        //Every group ends up in one community, groups are rarely merged
+        std::set<uint32_t> comms;
+        for(uint32_t g = 0; g < groups; g++) {
+            for(uint32_t i = 1; i < group; i++) {
+                EXPECT_EQ(mapping[g*group], mapping[g*group+i]);
+            }
+            comms.insert(mapping[g*group]);
+        }
+        EXPECT_GE(comms.size(), groups/2);
+        EXPECT_GT(louvain.modularity(), 0.8);
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
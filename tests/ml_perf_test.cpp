@@ -20,172 +20,181 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ***********************************************/
 
-#include "src/cl_predictors_abs.h"
-#include "src/cl_predictors_xgb.h"
+// Predictor benchmark: loads the same LightGBM models into the LightGBM
+// backend and the native tree evaluator, scores the same feature rows with
+// both, and reports rows/s and the largest difference between the two.
+// Rows are read from a file (PRED_COLS values per line, "nan" for missing),
+// otherwise they are drawn around the split thresholds of the models.
+// Usage: ml_perf_test short.txt long.txt forever.txt [rows.txt] [repetitions]
+
+#include "src/cl_predictors_lgbm.h"
+#include "src/cl_predictors_tree.h"
+#include "src/flat_forest.h"
 #include "src/clause.h"
-#include "cryptominisat5/solvertypesmini.h"
-#include <vector>
-#include <string>
+#include "src/time_mem.h"
+#include <iostream>
+#include <iomanip>
 #include <fstream>
-#include <complex>
-using std::vector;
+#include <sstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+using std::cout;
+using std::endl;
 using std::string;
+using std::vector;
 using namespace CMSat;
-ClPredictorsAbst* pred;
-
-//TODO read in
-struct Dat {
-    uint32_t props_made;
-    uint32_t orig_glue;
-    uint32_t glue;
-    uint32_t glue_before_minim;
-    uint32_t sum_uip1_used;
-    uint32_t num_antecedents;
-    uint32_t num_total_lits_antecedents;
-    uint32_t uip1_used;
-    float    numResolutionsHistLT_avg;
-    float    glueHist_longterm_avg;
-    float    conflSizeHistLT_avg;
-    float    branchDepthHistQueue_avg;
-    double   act_ranking_rel;
-    uint32_t size;
-    uint64_t sumConflicts; //time_inside_the_solver
-    float    correct_val;
-
-    void print()
-    {
-        cout << "props_made: "  << props_made << endl;
-        cout << "orig_glue: " << orig_glue << endl;
-        cout << "glue: " << glue << endl;
-        cout << "glue_before_minim: " << glue_before_minim << endl;
-        cout << "sum_uip1_used: "  << sum_uip1_used << endl;
-        cout << "num_antecedents: " << num_antecedents << endl;
-        cout << "num_total_lits_antecedents: " << num_total_lits_antecedents << endl;
-        cout << "uip1_used: " << uip1_used << endl;
-        cout << "numResolutionsHistLT_avg: " << numResolutionsHistLT_avg << endl;
-        cout << "glueHist_longterm_avg: " << glueHist_longterm_avg << endl;
-        cout << "conflSizeHistLT_avg: " << conflSizeHistLT_avg << endl;
-        cout << "branchDepthHistQueue_avg: "  << branchDepthHistQueue_avg << endl;
-        cout << "act_ranking_rel: "  << act_ranking_rel << endl;
-        cout << "size: "  << size << endl;
-        cout << "sumConflicts: " << sumConflicts << endl;
-        cout << "correct_val: "  << correct_val << endl;
-    }
-};
 
-std::ifstream infile;
+static const uint32_t num_random_rows = 100000;
 
-bool get_val(Dat& dat)
+static bool read_rows(const string& fname, vector<float>& data)
 {
-    std::string line;
-    std::getline(infile, line);
-    if (!infile) {
-        return false;
-    }
-    std::istringstream iss(line);
-
-    if (!(
-        iss
-        >> dat.props_made
-        >> dat.orig_glue
-        >> dat.glue
-        >> dat.glue_before_minim
-        >> dat.sum_uip1_used
-        >> dat.num_antecedents
-        >> dat.num_total_lits_antecedents
-        >> dat.uip1_used
-        >> dat.numResolutionsHistLT_avg
-        >> dat.glueHist_longterm_avg
-        >> dat.conflSizeHistLT_avg
-        >> dat.branchDepthHistQueue_avg
-        >> dat.act_ranking_rel
-        >> dat.size
-        >> dat.sumConflicts
-        >> dat.correct_val
-    )) {
-        assert(false);
+    std::ifstream in(fname);
+    if (!in) return false;
+    string line;
+    while(std::getline(in, line)) {
+        std::istringstream ss(line);
+        string tok;
+        uint32_t cols = 0;
+        while(ss >> tok) {
+            data.push_back(tok == "nan" ? nanf("") : std::stof(tok));
+            cols++;
+        }
+        if (cols != 0 && cols != PRED_COLS) {
+            cout << "ERROR: line with " << cols << " columns in " << fname << endl;
+            exit(-1);
+        }
     }
     return true;
 }
 
-float get_predict(Clause* cl, const Dat& dat, predict_type pred_type)
+//Values between two thresholds of the same feature exercise both sides of
+//the splits, unlike uniform noise
+static void random_rows(const FlatForest& f, vector<float>& data)
 {
-    cl->stats.props_made = dat.props_made;
-    cl->stats.orig_glue  = dat.orig_glue;
-    cl->stats.numResolutionsHistLT_avg = dat.numResolutionsHistLT_avg;
-    cl->stats.glue_before_minim = dat.glue_before_minim;
-    cl->stats.sum_uip1_used = dat.sum_uip1_used;
-    cl->stats.glue = dat.glue;
-    cl->stats.num_antecedents = dat.num_antecedents;
-    cl->stats.num_total_lits_antecedents = dat.num_total_lits_antecedents;
-    cl->stats.glueHist_longterm_avg = dat.glueHist_longterm_avg;
-//     cl->stats.conflSizeHistLT_avg = dat.conflSizeHistLT_avg;
-//     cl->stats.branchDepthHistQueue_avg = dat.branchDepthHistQueue_avg;
-    cl->stats.uip1_used = dat.uip1_used;
-    cl->resize(dat.size);
-
-
-    ReduceCommonData commondata(0, 0, 0, 0, 0);
-    float val = pred->predict(
-        pred_type,
-        cl,
-        dat.sumConflicts, //this is the age
-        dat.act_ranking_rel,
-        0,
-        0,
-        commondata
-    );
-    return val;
+    vector<vector<float>> thr(PRED_COLS);
+    for(uint32_t t = 0; t < f.num_trees; t++) {
+        vector<int32_t> todo;
+        if (f.roots[t] >= 0) todo.push_back(f.roots[t]);
+        while(!todo.empty()) {
+            const int32_t n = todo.back();
+            todo.pop_back();
+            if (f.feat[n] < PRED_COLS) thr[f.feat[n]].push_back(f.thr[n]);
+            if (f.left[n] >= 0) todo.push_back(f.left[n]);
+            if (f.right[n] >= 0) todo.push_back(f.right[n]);
+        }
+    }
+
+    std::mt19937 mtrand(1);
+    std::uniform_real_distribution<float> dist(0, 1);
+    data.resize((uint64_t)num_random_rows*PRED_COLS);
+    for(uint32_t r = 0; r < num_random_rows; r++) {
+        for(uint32_t c = 0; c < PRED_COLS; c++) {
+            float& x = data[(uint64_t)r*PRED_COLS + c];
+            const vector<float>& t = thr[c];
+            if (dist(mtrand) < 0.02f) {
+                x = nanf("");
+            } else if (t.empty()) {
+                x = dist(mtrand);
+            } else {
+                const float a = t[mtrand() % t.size()];
+                const float b = t[mtrand() % t.size()];
+                x = std::isinf(a) || std::isinf(b) ? a : a + (b-a)*dist(mtrand);
+            }
+        }
+    }
 }
 
-void run_one(string fname, predict_type pred_type)
+static double time_predict(
+    ClPredictorsAbst& pred,
+    vector<float>& data,
+    const uint32_t num,
+    const uint32_t reps,
+    vector<ClauseStatsExtra>& out)
 {
-    vector<Lit> lits;
-    lits.resize(5000);
-    Clause* cl;
-
-    infile.open(fname.c_str());
-    if (!infile) {
-        cout << "ERROR: couldn't open file " << fname << endl;
-        exit(-1);
+    const double start = cpuTime();
+    for(uint32_t i = 0; i < reps; i++) {
+        pred.predict_all(data.data(), num);
+        pred.finish_all_predict();
     }
-    BASE_DATA_TYPE* mem = (BASE_DATA_TYPE*) malloc((5000+1000)*sizeof(BASE_DATA_TYPE));
-
-    double error = 0;
-    uint32_t num_done = 0;
-    while(true) {
-        Dat dat;
-        cl = new (mem) Clause(lits, 0);
-        bool ok = get_val(dat);
-        if (!ok) {
-            break;
-        }
-        num_done++;
-//         dat.print();
-        float pred = get_predict(cl, dat, pred_type);
-//         cout << "predicted: " << pred << endl;
-//         cout << " --- " << endl;
-        error += std::pow(pred-dat.correct_val,2);
+    const double t = cpuTime() - start;
 
-    }
-    free(mem);
-    cout << "For file " << fname << " error is: " << error/(double)num_done << " done: " << num_done << endl;
-    infile.close();
+    out.resize(num);
+    pred.predict_all(data.data(), num);
+    for(uint32_t i = 0; i < num; i++) pred.get_prediction_at(out[i], i);
+    pred.finish_all_predict();
+    return t;
 }
 
-int main()
+int main(int argc, char** argv)
 {
-    pred = new ClPredictors;
-    string base = "../src/predict/";
-    string s = "predictor_short.json";
-    string l = "predictor_long.json";
-    string f = "predictor_forever.json";
-    pred->load_models(base+s, base+l, base+f);
-
-    run_one("ml_perf_test.txt-short", predict_type::short_pred);
-    run_one("ml_perf_test.txt-long", predict_type::long_pred);
-    run_one("ml_perf_test.txt-forever", predict_type::forever_pred);
-
-    delete pred;
-    return 0;
+    if (argc < 4 || argc > 6) {
+        cout << "Usage: " << argv[0]
+        << " short.txt long.txt forever.txt [rows.txt] [repetitions]" << endl;
+        return -1;
+    }
+    uint32_t reps = 10;
+    if (argc > 5) {
+        char* end = NULL;
+        const unsigned long val = std::strtoul(argv[5], &end, 10);
+        if (*end != '\0' || val == 0) {
+            cout << "ERROR: bad repetitions '" << argv[5] << "'" << endl;
+            return -1;
+        }
+        reps = val;
+    }
+
+    ClPredictorsLGBM lgbm;
+    ClPredictorsTree tree;
+    if (lgbm.load_models(argv[1], argv[2], argv[3], "") == 0
+        || tree.load_models(argv[1], argv[2], argv[3], "") == 0
+    ) {
+        cout << "ERROR: cannot load models" << endl;
+        return -1;
+    }
+
+    vector<float> data;
+    if (argc > 4) {
+        if (!read_rows(argv[4], data)) {
+            cout << "ERROR: cannot open " << argv[4] << endl;
+            return -1;
+        }
+    } else {
+        FlatForestStore store;
+        string err;
+        if (!store.load_lgbm(argv[1], err)) {
+            cout << "ERROR: " << err << endl;
+            return -1;
+        }
+        random_rows(store.get(), data);
+    }
+    const uint32_t num = data.size()/PRED_COLS;
+    cout << "rows: " << num << " repetitions: " << reps << endl;
+
+    vector<ClauseStatsExtra> out_lgbm;
+    vector<ClauseStatsExtra> out_tree;
+    const double t_lgbm = time_predict(lgbm, data, num, reps, out_lgbm);
+    const double t_tree = time_predict(tree, data, num, reps, out_tree);
+
+    double diff[3] = {0, 0, 0};
+    for(uint32_t i = 0; i < num; i++) {
+        diff[0] = std::max(diff[0], std::fabs(out_lgbm[i].pred_short_use - out_tree[i].pred_short_use));
+        diff[1] = std::max(diff[1], std::fabs(out_lgbm[i].pred_long_use - out_tree[i].pred_long_use));
+        diff[2] = std::max(diff[2], std::fabs(out_lgbm[i].pred_forever_use - out_tree[i].pred_forever_use));
+    }
+
+    const double rows = (double)num*reps;
+    cout << std::fixed << std::setprecision(0)
+    << "lgbm: " << std::setw(12) << rows/std::max(t_lgbm, 1e-9) << " rows/s" << endl
+    << "tree: " << std::setw(12) << rows/std::max(t_tree, 1e-9) << " rows/s"
+    << std::setprecision(2) << " (" << t_lgbm/std::max(t_tree, 1e-9) << "x)" << endl;
+    cout.unsetf(std::ios_base::floatfield);
+    cout << "max abs diff short: " << diff[0]
+    << " long: " << diff[1]
+    << " forever: " << diff[2] << endl;
+
+    return (diff[0] > 1e-6 || diff[1] > 1e-6 || diff[2] > 1e-6);
 }
@@ -0,0 +1,182 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <algorithm>
+
+#include "src/solver.h"
+#include "src/occsimplifier.h"
+#include "src/subsumestrengthen.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+//The parallel occurrence code (conf.occ_threads > 1) must do exactly what
+//the serial code does. Every test runs the same thing with 1 and 4 threads
+//and compares. The parallel paths only kick in above 20000 clauses, or
+//1000 variables to eliminate for BVE.
+struct occ_parallel : public ::testing::Test {
+    occ_parallel()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+    }
+    ~occ_parallel()
+    {
+        for(Solver* s: solvers) delete s;
+    }
+
+    Solver* new_solver(const uint32_t threads)
+    {
+        SolverConf conf;
+        conf.occ_threads = threads;
+        solvers.push_back(new Solver(&conf, &must_inter));
+        return solvers.back();
+    }
+
+    //Short base clauses, plus clauses they subsume, plus clauses they
+    //strengthen (one literal of the base flipped)
+    vector<vector<Lit>> gen_sub_str_cnf(const uint32_t seed)
+    {
+        std::mt19937 rnd(seed);
+        std::uniform_int_distribution<uint32_t> var(0, num_vars-1);
+        vector<vector<Lit>> cls;
+        auto extend = [&](vector<Lit> cl, const uint32_t extra) {
+            while(cl.size() < extra) {
+                const Lit l = Lit(var(rnd), rnd() & 1);
+                bool dup = false;
+                for(const Lit l2: cl) dup |= (l2.var() == l.var());
+                if (!dup) cl.push_back(l);
+            }
+            return cl;
+        };
+        for(uint32_t i = 0; i < 8000; i++) {
+            const vector<Lit> base = extend({}, 3);
+            cls.push_back(base);
+            cls.push_back(extend(base, 4 + rnd()%3));
+            vector<Lit> flipped = base;
+            flipped[rnd()%3] ^= true;
+            cls.push_back(extend(flipped, 4 + rnd()%3));
+            cls.push_back(extend({}, 4));
+        }
+        return cls;
+    }
+
+    static vector<uint32_t> elimed_vars(const Solver* s)
+    {
+        vector<uint32_t> ret;
+        for(uint32_t v = 0; v < s->nVars(); v++) {
+            if (s->varData[v].removed == Removed::elimed) ret.push_back(v);
+        }
+        return ret;
+    }
+
+    static vector<vector<Lit>> sorted_irred(const Solver* s)
+    {
+        vector<vector<Lit>> cls = get_irred_cls(s);
+        for(auto& cl: cls) std::sort(cl.begin(), cl.end());
+        std::sort(cls.begin(), cls.end());
+        return cls;
+    }
+
+    const uint32_t num_vars = 3000;
+    vector<Solver*> solvers;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(occ_parallel, link_in_same_watchlists)
+{
+    const vector<vector<Lit>> cls = gen_sub_str_cnf(1);
+    vector<Solver*> s = {new_solver(1), new_solver(4)};
+    for(Solver* x: s) {
+        x->new_vars(num_vars);
+        for(const auto& cl: cls) x->add_clause_outside(cl);
+        x->occsimplifier->setup();
+    }
+
+    for(uint32_t i = 0; i < num_vars*2; i++) {
+        const Lit l = Lit::toLit(i);
+        const auto& ws1 = s[0]->watches[l];
+        const auto& ws2 = s[1]->watches[l];
+        ASSERT_EQ(ws1.size(), ws2.size());
+        for(uint32_t j = 0; j < ws1.size(); j++) {
+            EXPECT_EQ(ws1[j].isClause(), ws2[j].isClause());
+            if (ws1[j].isClause()) {
+                EXPECT_EQ(ws1[j].get_offset(), ws2[j].get_offset());
+                EXPECT_EQ(ws1[j].getAbst(), ws2[j].getAbst());
+            }
+        }
+        EXPECT_EQ(s[0]->occsimplifier->n_occurs[i], s[1]->occsimplifier->n_occurs[i]);
+    }
+    for(Solver* x: s) x->occsimplifier->finishUp(0);
+}
+
+TEST_F(occ_parallel, sub_str_same_result)
+{
+    const vector<vector<Lit>> cls = gen_sub_str_cnf(2);
+    vector<Solver*> s = {new_solver(1), new_solver(4)};
+    for(Solver* x: s) {
+        x->new_vars(num_vars);
+        for(const auto& cl: cls) x->add_clause_outside(cl);
+        x->occsimplifier->simplify(false, "occ-backw-sub, occ-backw-sub-str");
+    }
+
+    const auto& st1 = s[0]->occsimplifier->get_sub_str()->get_stats();
+    const auto& st2 = s[1]->occsimplifier->get_sub_str()->get_stats();
+    EXPECT_GT(st1.sub0.numSubsumed, 0U);
+    EXPECT_GT(st1.sub1.str, 0U);
+    EXPECT_EQ(st1.sub0.numSubsumed, st2.sub0.numSubsumed);
+    EXPECT_EQ(st1.sub1.sub, st2.sub1.sub);
+    EXPECT_EQ(st1.sub1.str, st2.sub1.str);
+    EXPECT_EQ(s[0]->trail_size(), s[1]->trail_size());
+    EXPECT_TRUE(sorted_irred(s[0]) == sorted_irred(s[1]));
+}
+
+TEST_F(occ_parallel, bve_same_result_and_model)
+{
+    const vector<vector<Lit>> cls = random_ksat(num_vars, num_vars*2, 3);
+    const string strategy = "occ-bve";
+    vector<Solver*> s = {new_solver(1), new_solver(4)};
+    for(Solver* x: s) {
+        x->new_vars(num_vars);
+        for(const auto& cl: cls) x->add_clause_outside(cl);
+        x->simplify_with_assumptions(NULL, &strategy);
+    }
+
+    const vector<uint32_t> elimed = elimed_vars(s[0]);
+    EXPECT_GT(elimed.size(), 1000U);
+    EXPECT_TRUE(elimed == elimed_vars(s[1]));
+    EXPECT_TRUE(sorted_irred(s[0]) == sorted_irred(s[1]));
+
+    //The model is extended over the eliminated variables
+    for(Solver* x: s) {
+        must_inter.store(false, std::memory_order_relaxed);
+        ASSERT_EQ(x->solve_with_assumptions(), l_True);
+        EXPECT_TRUE(model_satisfies(x->get_model(), cls));
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
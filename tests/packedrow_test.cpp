@@ -0,0 +1,116 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+#include "src/packedmatrix.h"
+
+using namespace CMSat;
+using std::vector;
+
+//Every kernel set the CPU supports must give the same results as the
+//plain loops, for all row lengths, including the SIMD tails
+static const char* kernels[] = {"scalar", "popcnt", "avx2", "avx512"};
+
+struct packedrow : public ::testing::Test {
+    packedrow() : mtrand(42) {}
+    ~packedrow() {
+        select_packedrow_kernels("auto");
+    }
+
+    //Sparse enough that the early-exit popcounts are exercised too
+    void fill(PackedRow row, uint32_t cols, uint32_t num_set) {
+        row.setZero();
+        for(uint32_t i = 0; i < num_set; i++) row.setBit(mtrand() % cols);
+        row.rhs() = mtrand() & 1;
+    }
+
+    static uint32_t naive_popcnt(const PackedRow& row, uint32_t cols) {
+        uint32_t ret = 0;
+        for(uint32_t i = 0; i < cols; i++) ret += row[i];
+        return ret;
+    }
+
+    std::mt19937 mtrand;
+};
+
+TEST_F(packedrow, kernels_match_naive)
+{
+    for(const char* k: kernels) {
+        if (!select_packedrow_kernels(k)) continue;
+        for(uint32_t words = 1; words <= 21; words++) {
+            const uint32_t cols = words*64;
+            PackedMatrix mat;
+            mat.resize(4, cols);
+            for(uint32_t iter = 0; iter < 50; iter++) {
+                const uint32_t num_set = mtrand() % 5;
+                fill(mat[0], cols, num_set);
+                fill(mat[1], cols, mtrand() % (cols/2+1));
+                fill(mat[2], cols, mtrand() % 3);
+
+                //popcnt, popcnt_at_least_2
+                const uint32_t pop0 = naive_popcnt(mat[0], cols);
+                EXPECT_EQ(mat[0].popcnt(), pop0) << k;
+                EXPECT_EQ(std::min(mat[0].popcnt_at_least_2(), 2U), std::min(pop0, 2U)) << k;
+
+                //xor_in
+                vector<bool> expect(cols);
+                for(uint32_t i = 0; i < cols; i++) expect[i] = mat[0][i] ^ mat[1][i];
+                const bool expect_rhs = mat[0].rhs() ^ mat[1].rhs();
+                mat[0].xor_in(mat[1]);
+                for(uint32_t i = 0; i < cols; i++) EXPECT_EQ(mat[0][i], expect[i]) << k;
+                EXPECT_EQ(mat[0].rhs(), expect_rhs) << k;
+
+                //set_and_until_popcnt_atleast2: the count must be right up to
+                //2, and the words it stopped at must be filled in
+                uint32_t expect_pop = 0;
+                uint32_t words_needed = 0;
+                for(uint32_t w = 0; w < words && expect_pop < 2; w++) {
+                    for(uint32_t i = w*64; i < (w+1)*64; i++) {
+                        expect_pop += mat[0][i] & mat[2][i];
+                    }
+                    words_needed++;
+                }
+                const uint32_t pop = mat[3].set_and_until_popcnt_atleast2(mat[0], mat[2]);
+                EXPECT_EQ(std::min(pop, 2U), std::min(expect_pop, 2U)) << k;
+                for(uint32_t i = 0; i < words_needed*64; i++) {
+                    EXPECT_EQ(mat[3][i], mat[0][i] & mat[2][i]) << k;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(packedrow, unknown_kernels)
+{
+    EXPECT_FALSE(select_packedrow_kernels("foo"));
+    EXPECT_TRUE(select_packedrow_kernels("scalar"));
+    EXPECT_TRUE(select_packedrow_kernels("auto"));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
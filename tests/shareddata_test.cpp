@@ -0,0 +1,323 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/shareddata.h"
+#include "test_helper.h"
+
+#include <thread>
+#include <random>
+#include <algorithm>
+
+using namespace CMSat;
+using std::vector;
+
+TEST(long_cl_ring, empty)
+{
+    LongClRing ring(4, 5);
+    EXPECT_EQ(ring.get_written(), 0U);
+    EXPECT_EQ(ring.get_oldest(ring.get_written()), 0U);
+}
+
+TEST(long_cl_ring, push_read)
+{
+    LongClRing ring(4, 5);
+    ring.push(str_to_cl("1, -2, 3"), 2);
+    ring.push(str_to_cl("4, 5, -6, 7"), 3);
+    EXPECT_EQ(ring.get_written(), 2U);
+
+    vector<Lit> cl;
+    uint32_t glue;
+    EXPECT_TRUE(ring.read(0, cl, glue));
+    EXPECT_EQ(cl, str_to_cl("1, -2, 3"));
+    EXPECT_EQ(glue, 2U);
+    EXPECT_TRUE(ring.read(1, cl, glue));
+    EXPECT_EQ(cl, str_to_cl("4, 5, -6, 7"));
+    EXPECT_EQ(glue, 3U);
+}
+
+TEST(long_cl_ring, not_yet_written)
+{
+    LongClRing ring(4, 5);
+    ring.push(str_to_cl("1, -2, 3"), 2);
+
+    vector<Lit> cl;
+    uint32_t glue;
+    EXPECT_FALSE(ring.read(1, cl, glue));
+}
+
+TEST(long_cl_ring, overwritten)
+{
+    LongClRing ring(2, 5);
+    ring.push(str_to_cl("1, 2, 3"), 2);
+    ring.push(str_to_cl("4, 5, 6"), 2);
+    ring.push(str_to_cl("7, 8, 9"), 2);
+    EXPECT_EQ(ring.get_oldest(ring.get_written()), 1U);
+
+    vector<Lit> cl;
+    uint32_t glue;
+    EXPECT_FALSE(ring.read(0, cl, glue));
+    EXPECT_TRUE(ring.read(2, cl, glue));
+    EXPECT_EQ(cl, str_to_cl("7, 8, 9"));
+}
+
+TEST(long_cl_ring, concurrent_read)
+{
+    LongClRing ring(8, 3);
+    const uint32_t num = 100000;
+    std::thread writer([&]() {
+        for(uint32_t i = 0; i < num; i++) {
+            vector<Lit> cl = {Lit(i, false), Lit(i+1, false), Lit(i+2, false)};
+            ring.push(cl, i % 7);
+        }
+    });
+
+    //Whatever is read successfully must be consistent
+    vector<Lit> cl;
+    uint32_t glue;
+    uint64_t at = 0;
+    while(at < num) {
+        const uint64_t upto = ring.get_written();
+        for(at = std::max(at, ring.get_oldest(upto)); at < upto; at++) {
+            if (ring.read(at, cl, glue)) {
+                ASSERT_EQ(cl.size(), 3U);
+                EXPECT_EQ(cl[0].var(), at);
+                EXPECT_EQ(cl[2].var(), at+2);
+                EXPECT_EQ(glue, at % 7);
+            }
+        }
+    }
+    writer.join();
+}
+
+TEST(bin_store, push_read)
+{
+    BinStore store(1);
+    store.add_reader(0);
+    EXPECT_EQ(store.get_num(), 0U);
+    EXPECT_TRUE(store.push(Lit(0, false), Lit(1, true)));
+    EXPECT_TRUE(store.push(Lit(2, true), Lit(5, false)));
+    EXPECT_EQ(store.get_num(), 2U);
+    EXPECT_EQ(store.at(0), std::make_pair(Lit(0, false), Lit(1, true)));
+    EXPECT_EQ(store.at(1), std::make_pair(Lit(2, true), Lit(5, false)));
+}
+
+TEST(bin_store, many_chunks)
+{
+    BinStore store(1);
+    store.add_reader(0);
+    const uint32_t num = 20000;
+    for(uint32_t i = 0; i < num; i++) {
+        EXPECT_TRUE(store.push(Lit(i, false), Lit(i+1, false)));
+    }
+    EXPECT_EQ(store.get_num(), num);
+    for(uint32_t i = 0; i < num; i++) {
+        EXPECT_EQ(store.at(i).first.var(), i);
+        EXPECT_EQ(store.at(i).second.var(), i+1);
+    }
+}
+
+TEST(bin_store, frees_read_chunks)
+{
+    BinStore store(2);
+    store.add_reader(0);
+    store.add_reader(1);
+    const uint64_t chunk = BinStore::chunk_size;
+    for(uint32_t i = 0; i < 4*chunk; i++) {
+        EXPECT_TRUE(store.push(Lit(i, false), Lit(i+1, false)));
+    }
+    const size_t mem_all = store.mem_used();
+
+    //Only one reader is done, nothing can be freed
+    store.done_reading(0, 4*chunk);
+    EXPECT_TRUE(store.push(Lit(0, true), Lit(1, true)));
+    EXPECT_EQ(store.mem_used(), mem_all + chunk*sizeof(std::pair<Lit, Lit>));
+
+    //Both are past the first 3 chunks, they are freed when the writer
+    //starts its 6th chunk
+    store.done_reading(1, 3*chunk + 10);
+    for(uint32_t i = 1; i < chunk+1; i++) {
+        EXPECT_TRUE(store.push(Lit(i, true), Lit(i+1, true)));
+    }
+    EXPECT_EQ(store.mem_used(), mem_all - chunk*sizeof(std::pair<Lit, Lit>));
+    for(uint64_t i = 3*chunk + 10; i < store.get_num(); i++) {
+        EXPECT_EQ(store.at(i).first.var(), (i < 4*chunk) ? i : i-4*chunk);
+    }
+}
+
+TEST(bin_store, drops_while_readers_lag)
+{
+    BinStore store(1, 2);
+    store.add_reader(0);
+    const uint64_t chunk = BinStore::chunk_size;
+    for(uint32_t i = 0; i < 2*chunk; i++) {
+        EXPECT_TRUE(store.push(Lit(i, false), Lit(i+1, false)));
+    }
+    EXPECT_TRUE(store.full());
+    EXPECT_FALSE(store.push(Lit(0, true), Lit(1, true)));
+    EXPECT_EQ(store.get_num(), 2*chunk);
+
+    //Sharing resumes once the reader catches up
+    store.done_reading(0, chunk);
+    EXPECT_TRUE(store.push(Lit(0, true), Lit(1, true)));
+    EXPECT_FALSE(store.full());
+    EXPECT_EQ(store.get_num(), 2*chunk+1);
+    EXPECT_EQ(store.at(2*chunk), std::make_pair(Lit(0, true), Lit(1, true)));
+}
+
+TEST(bin_store, no_readers)
+{
+    BinStore store(2, 2);
+    for(uint32_t i = 0; i < 10*BinStore::chunk_size; i++) {
+        EXPECT_TRUE(store.push(Lit(i, false), Lit(i+1, false)));
+    }
+    EXPECT_FALSE(store.full());
+}
+
+TEST(bin_store, concurrent_read)
+{
+    //Few chunks, so the writer has to free and reuse them while the
+    //reader is reading
+    BinStore store(1, 4);
+    store.add_reader(0);
+    const uint32_t num = 100000;
+    std::thread writer([&]() {
+        for(uint32_t i = 0; i < num;) {
+            i += store.push(Lit(i, false), Lit(i+1, true));
+        }
+    });
+
+    //Everything published must be readable, in order
+    uint64_t at = 0;
+    while(at < num) {
+        const uint64_t upto = store.get_num();
+        for(; at < upto; at++) {
+            ASSERT_EQ(store.at(at).first.var(), at);
+            ASSERT_EQ(store.at(at).second, Lit(at+1, true));
+        }
+        store.done_reading(0, upto);
+    }
+    writer.join();
+}
+
+TEST(shared_long_cls, multi_thread_solve)
+{
+    //Pigeon-hole, 7 pigeons in 6 holes
+    const uint32_t pigeons = 7;
+    const uint32_t holes = 6;
+    SATSolver s;
+    s.set_num_threads(3);
+    s.set_sync_long_cls(true, 10, 10);
+    s.new_vars(pigeons*holes);
+    for(uint32_t p = 0; p < pigeons; p++) {
+        vector<Lit> cl;
+        for(uint32_t h = 0; h < holes; h++) {
+            cl.push_back(Lit(p*holes+h, false));
+        }
+        s.add_clause(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p1 = 0; p1 < pigeons; p1++) {
+            for(uint32_t p2 = p1+1; p2 < pigeons; p2++) {
+                s.add_clause(vector<Lit>{
+                    Lit(p1*holes+h, true), Lit(p2*holes+h, true)});
+            }
+        }
+    }
+    lbool ret = s.solve();
+    EXPECT_EQ(ret, l_False);
+}
+
+//Random XOR system over 'nvars' variables, satisfied by 'planted'
+static vector<std::pair<vector<unsigned>, bool>> planted_xors(
+    const uint32_t nvars, const uint32_t nxors, const vector<bool>& planted)
+{
+    std::mt19937 mtrand(7);
+    vector<std::pair<vector<unsigned>, bool>> xors;
+    for(uint32_t i = 0; i < nxors; i++) {
+        vector<unsigned> vars;
+        bool rhs = false;
+        while(vars.size() < 4) {
+            const unsigned v = mtrand() % nvars;
+            if (std::find(vars.begin(), vars.end(), v) != vars.end()) continue;
+            vars.push_back(v);
+            rhs ^= planted[v];
+        }
+        xors.push_back(std::make_pair(vars, rhs));
+    }
+    return xors;
+}
+
+TEST(shared_xors, multi_thread_solve_sat)
+{
+    const uint32_t nvars = 80;
+    vector<bool> planted;
+    std::mt19937 mtrand(3);
+    for(uint32_t i = 0; i < nvars; i++) planted.push_back(mtrand() & 1);
+    const auto xors = planted_xors(nvars, 70, planted);
+
+    for(const bool share: {false, true}) {
+        SATSolver s;
+        s.set_num_threads(3);
+        s.set_sync_xors(share);
+        s.new_vars(nvars);
+        for(const auto& x: xors) s.add_xor_clause(x.first, x.second);
+        lbool ret = s.solve();
+        ASSERT_EQ(ret, l_True);
+        for(const auto& x: xors) {
+            bool val = false;
+            for(const unsigned v: x.first) val ^= (s.get_model()[v] == l_True);
+            EXPECT_EQ(val, x.second);
+        }
+    }
+}
+
+TEST(shared_xors, multi_thread_solve_unsat)
+{
+    const uint32_t nvars = 80;
+    vector<bool> planted(nvars, false);
+    auto xors = planted_xors(nvars, 70, planted);
+
+    //XOR of the first two, with the wrong right hand side
+    vector<unsigned> vars = xors[0].first;
+    for(const unsigned v: xors[1].first) {
+        auto it = std::find(vars.begin(), vars.end(), v);
+        if (it == vars.end()) vars.push_back(v);
+        else vars.erase(it);
+    }
+    xors.push_back(std::make_pair(vars, !(xors[0].second ^ xors[1].second)));
+
+    SATSolver s;
+    s.set_num_threads(3);
+    s.set_sync_xors(true);
+    s.new_vars(nvars);
+    for(const auto& x: xors) s.add_xor_clause(x.first, x.second);
+    EXPECT_EQ(s.solve(), l_False);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,104 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+#include "src/solver.h"
+#include "src/sls.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+//CCNR on a satisfiable 5-SAT instance with a planted solution. When CCNR
+//finds a solution, it ends up in the best_polarity of the variables.
+struct sls : public ::testing::Test {
+    sls()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+    }
+    ~sls()
+    {
+        delete s;
+    }
+
+    void setup(const uint32_t sls_memoutMB, const uint32_t walkers)
+    {
+        SolverConf conf;
+        conf.sls_memoutMB = sls_memoutMB;
+        conf.sls_walkers = walkers;
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(num_vars);
+
+        std::mt19937 rnd(11);
+        vector<bool> planted(num_vars);
+        for(uint32_t i = 0; i < num_vars; i++) planted[i] = rnd() & 1;
+        cls = random_ksat(num_vars, num_cls, 11, 5, &planted);
+        for(const auto& cl: cls) s->add_clause_outside(cl);
+    }
+
+    bool best_polarity_satisfies() const
+    {
+        vector<lbool> model(num_vars);
+        for(uint32_t i = 0; i < num_vars; i++) {
+            model[i] = boolToLBool(s->varData[i].best_polarity);
+        }
+        return model_satisfies(model, cls);
+    }
+
+    const uint32_t num_vars = 400;
+    const uint32_t num_cls = 7000;
+    Solver* s = NULL;
+    vector<vector<Lit>> cls;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(sls, ccnr_neighbor_lists)
+{
+    setup(500, 1);
+    SLS(s).run(1);
+    EXPECT_TRUE(best_polarity_satisfies());
+}
+
+//The neighbour lists need up to 20 entries per clause, over the quarter
+//of --slsmaxmem they may use, so neighbours are found on the fly
+TEST_F(sls, ccnr_neighbors_on_the_fly)
+{
+    setup(1, 1);
+    EXPECT_GT(num_cls*20, 1000ULL*1000ULL/(4*sizeof(int)));
+    SLS(s).run(1);
+    EXPECT_TRUE(best_polarity_satisfies());
+}
+
+TEST_F(sls, ccnr_neighbors_on_the_fly_walkers)
+{
+    setup(2, 3);
+    EXPECT_GT(num_cls*20, 2ULL*1000ULL*1000ULL/(4*sizeof(int)));
+    SLS(s).run(1);
+    EXPECT_TRUE(best_polarity_satisfies());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
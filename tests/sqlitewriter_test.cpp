@@ -0,0 +1,155 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include "src/sqlitewriter.h"
+
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+
+using namespace CMSat;
+using std::string;
+using std::vector;
+
+struct sqlite_writer : public ::testing::Test {
+    sqlite_writer()
+    {
+        EXPECT_EQ(sqlite3_open(":memory:", &db), SQLITE_OK);
+        EXPECT_EQ(sqlite3_exec(db,
+            "CREATE TABLE t (a INTEGER, b REAL, c TEXT, d INTEGER);",
+            NULL, NULL, NULL), SQLITE_OK);
+        EXPECT_EQ(sqlite3_prepare_v2(db,
+            "INSERT INTO t VALUES (?,?,?,?);", -1, &stmt, NULL), SQLITE_OK);
+    }
+    ~sqlite_writer()
+    {
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+    }
+
+    //Text of 0..60 bytes, so records span a varying number of cells
+    static string text_of(const int64_t i)
+    {
+        return string(i % 61, 'a' + i % 26);
+    }
+
+    void push(SQLiteWriter& w, const int64_t i)
+    {
+        rec.clear();
+        rec.add_int64(i);
+        rec.add_double((double)i*0.5);
+        rec.add_text(text_of(i));
+        if (i % 3 == 0) rec.add_null();
+        else rec.add_int64(-i);
+        w.push(stmt, rec);
+    }
+
+    //Checks that every row present round-tripped, returns their number
+    uint64_t check_rows()
+    {
+        sqlite3_stmt* sel;
+        EXPECT_EQ(sqlite3_prepare_v2(db,
+            "SELECT a, b, c, d FROM t ORDER BY a;", -1, &sel, NULL), SQLITE_OK);
+        uint64_t num = 0;
+        int64_t last = -1;
+        while(sqlite3_step(sel) == SQLITE_ROW) {
+            const int64_t i = sqlite3_column_int64(sel, 0);
+            EXPECT_GT(i, last);
+            last = i;
+            EXPECT_EQ(sqlite3_column_double(sel, 1), (double)i*0.5);
+            const char* c = (const char*)sqlite3_column_text(sel, 2);
+            EXPECT_EQ(string(c ? c : "", sqlite3_column_bytes(sel, 2)), text_of(i));
+            if (i % 3 == 0) {
+                EXPECT_EQ(sqlite3_column_type(sel, 3), SQLITE_NULL);
+            } else {
+                EXPECT_EQ(sqlite3_column_int64(sel, 3), -i);
+            }
+            num++;
+        }
+        sqlite3_finalize(sel);
+        return num;
+    }
+
+    sqlite3* db = NULL;
+    sqlite3_stmt* stmt = NULL;
+    SQLRecord rec;
+};
+
+TEST_F(sqlite_writer, sync)
+{
+    SQLiteWriter w(db, false, 0, false);
+    for(int64_t i = 0; i < 2000; i++) push(w, i);
+    w.flush();
+    EXPECT_EQ(w.get_written(), 2000U);
+    EXPECT_EQ(check_rows(), 2000U);
+}
+
+//The smallest ring wraps many times, and records straddle its end
+TEST_F(sqlite_writer, async_blocking_wraps)
+{
+    const int64_t num = 50000;
+    {
+        SQLiteWriter w(db, true, 0, false);
+        for(int64_t i = 0; i < num; i++) push(w, i);
+        w.flush();
+        EXPECT_EQ(w.get_written(), (uint64_t)num);
+        EXPECT_EQ(w.get_dropped(), 0U);
+    }
+    EXPECT_EQ(check_rows(), (uint64_t)num);
+}
+
+TEST_F(sqlite_writer, async_dropping_counts)
+{
+    const int64_t num = 50000;
+    uint64_t written;
+    {
+        SQLiteWriter w(db, true, 0, true);
+        for(int64_t i = 0; i < num; i++) push(w, i);
+        w.flush();
+        written = w.get_written();
+        EXPECT_EQ(written + w.get_dropped(), (uint64_t)num);
+    }
+    EXPECT_EQ(check_rows(), written);
+}
+
+//After flush() the caller may use the connection itself
+TEST_F(sqlite_writer, flush_then_direct_use)
+{
+    {
+        SQLiteWriter w(db, true, 0, false);
+        for(int64_t i = 0; i < 1000; i++) push(w, i);
+        w.flush();
+        EXPECT_EQ(check_rows(), 1000U);
+        const string ins =
+            "INSERT INTO t VALUES (1000, 500.0, '" + text_of(1000) + "', -1000);";
+        EXPECT_EQ(sqlite3_exec(db, ins.c_str(), NULL, NULL, NULL), SQLITE_OK);
+        for(int64_t i = 1001; i < 2000; i++) push(w, i);
+    }
+    EXPECT_EQ(check_rows(), 2000U);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "test_helper.h"
+#include <vector>
+
+using namespace CMSat;
+using std::vector;
+using std::string;
+
+static const char* fname = "state_test.state";
+
+static void add_cls(SATSolver& s, uint32_t nvars, const vector<vector<Lit>>& cls)
+{
+    s.new_vars(nvars);
+    for(const auto& cl: cls) s.add_clause(cl);
+}
+
+TEST(state_test, roundtrip_sat)
+{
+    const auto cls = random_ksat(300, 1050, 1);
+    SATSolver s;
+    add_cls(s, 300, cls);
+    EXPECT_EQ(s.simplify(), l_Undef);
+    s.save_state(fname);
+
+    SATSolver s2;
+    s2.load_state(fname);
+    EXPECT_EQ(s2.nVars(), 300u);
+    EXPECT_EQ(s2.solve(), l_True);
+    EXPECT_TRUE(model_satisfies(s2.get_model(), cls));
+    std::remove(fname);
+}
+
+TEST(state_test, roundtrip_unsat)
+{
+    const auto cls = random_ksat(60, 400, 2);
+    SATSolver s;
+    add_cls(s, 60, cls);
+    s.simplify();
+    s.save_state(fname);
+
+    SATSolver s2;
+    s2.load_state(fname);
+    EXPECT_EQ(s2.solve(), l_False);
+    std::remove(fname);
+}
+
+TEST(state_test, roundtrip_replaced_and_elimed)
+{
+    //Equivalent variables get replaced and the chain gets eliminated
+    vector<vector<Lit>> cls = random_ksat(100, 300, 3);
+    for(uint32_t i = 100; i < 120; i++) {
+        cls.push_back({Lit(i, false), Lit(i+1, true)});
+        cls.push_back({Lit(i, true), Lit(i+1, false)});
+    }
+    cls.push_back({Lit(0, false), Lit(120, false)});
+    SATSolver s;
+    add_cls(s, 121, cls);
+    s.simplify();
+    s.save_state(fname);
+
+    SATSolver s2;
+    s2.load_state(fname);
+    EXPECT_EQ(s2.solve(), l_True);
+    EXPECT_TRUE(model_satisfies(s2.get_model(), cls));
+
+    //Clauses can still be added on top of the loaded state
+    s2.add_clause({Lit(100, false)});
+    s2.add_clause({Lit(0, true)});
+    const lbool ret = s2.solve();
+    if (ret == l_True) {
+        EXPECT_TRUE(model_satisfies(s2.get_model(), cls));
+        EXPECT_EQ(s2.get_model()[120], l_True);
+    }
+    std::remove(fname);
+}
+
+TEST(state_test, unsat_state)
+{
+    SATSolver s;
+    s.new_vars(2);
+    s.add_clause({Lit(0, false)});
+    s.add_clause({Lit(0, true)});
+    s.save_state(fname);
+
+    SATSolver s2;
+    s2.load_state(fname);
+    EXPECT_FALSE(s2.okay());
+    EXPECT_EQ(s2.solve(), l_False);
+    std::remove(fname);
+}
+
+TEST(state_test, load_errors)
+{
+    SATSolver s;
+    EXPECT_THROW(s.load_state("state_test_nonexistent.state"), std::runtime_error);
+
+    SATSolver s2;
+    s2.new_vars(2);
+    s2.save_state(fname);
+    s2.add_clause({Lit(0, false)});
+    EXPECT_THROW(s2.load_state(fname), std::runtime_error);
+    std::remove(fname);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
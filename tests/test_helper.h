@@ -40,6 +40,7 @@ THE SOFTWARE.
 #include <cctype>
 #include <cassert>
 #include <algorithm>
+#include <random>
 #include "src/solver.h"
 #include "src/xor.h"
 #include "cryptominisat5/cryptominisat.h"
@@ -546,6 +547,51 @@ bool clause_satisfied(const string& data, vector<lbool>& solution)
     return false;
 }
 
+//Random k-SAT clauses, each over k different variables. If planted is
+//given, only clauses satisfied by it are kept
+vector<vector<Lit> > random_ksat(
+    const uint32_t num_vars,
+    const uint32_t num_cls,
+    const uint32_t seed,
+    const uint32_t k = 3,
+    const vector<bool>* planted = NULL)
+{
+    assert(k <= num_vars);
+    std::mt19937 mtrand(seed);
+    vector<vector<Lit> > cls;
+    vector<Lit> cl;
+    while(cls.size() < num_cls) {
+        cl.clear();
+        bool sat = false;
+        while(cl.size() < k) {
+            const uint32_t v = mtrand() % num_vars;
+            bool dup = false;
+            for(const Lit l: cl) dup |= (l.var() == v);
+            if (dup) continue;
+            cl.push_back(Lit(v, mtrand() & 1));
+            if (planted) sat |= ((*planted)[v] != cl.back().sign());
+        }
+        if (planted && !sat) continue;
+        cls.push_back(cl);
+    }
+    return cls;
+}
+
+bool model_satisfies(const vector<lbool>& model, const vector<vector<Lit> >& cls)
+{
+    for(const auto& cl: cls) {
+        bool sat = false;
+        for(const Lit l: cl) {
+            if ((model[l.var()] ^ l.sign()) == l_True) {
+                sat = true;
+                break;
+            }
+        }
+        if (!sat) return false;
+    }
+    return true;
+}
+
 uint32_t count_num_undef_in_solution(const Solver* s)
 {
     uint32_t num = 0;
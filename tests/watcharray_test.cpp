@@ -0,0 +1,160 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "src/watcharray.h"
+
+using namespace CMSat;
+
+static Watched w_for(uint32_t i)
+{
+    return Watched(i, WatchType::watch_idx_t);
+}
+
+static void fill(watch_array& ws, uint32_t lit, uint32_t num)
+{
+    for(uint32_t i = 0; i < num; i++) {
+        ws[Lit::toLit(lit)].push(w_for(lit*1000+i));
+    }
+}
+
+static bool check(const watch_array& ws, uint32_t lit, uint32_t num)
+{
+    watch_subarray_const w = ws[Lit::toLit(lit)];
+    if (w.size() != num) return false;
+    for(uint32_t i = 0; i < num; i++) {
+        if (w[i].get_idx() != lit*1000+i) return false;
+    }
+    return true;
+}
+
+TEST(watch_array_test, push_and_read)
+{
+    watch_array ws;
+    ws.insert(10);
+    for(uint32_t l = 0; l < 10; l++) {
+        fill(ws, l, l*7);
+    }
+    for(uint32_t l = 0; l < 10; l++) {
+        EXPECT_TRUE(check(ws, l, l*7));
+    }
+}
+
+TEST(watch_array_test, consolidate_keeps_contents)
+{
+    watch_array ws;
+    ws.insert(20);
+    for(uint32_t l = 0; l < 20; l++) {
+        fill(ws, l, l*3);
+    }
+    ws.full_consolidate();
+    for(uint32_t l = 0; l < 20; l++) {
+        EXPECT_TRUE(check(ws, l, l*3));
+    }
+
+    //Grow everything past the arena's spare room
+    for(uint32_t l = 0; l < 20; l++) {
+        for(uint32_t i = l*3; i < 200; i++) {
+            ws[Lit::toLit(l)].push(w_for(l*1000+i));
+        }
+    }
+    for(uint32_t l = 0; l < 20; l++) {
+        EXPECT_TRUE(check(ws, l, 200));
+    }
+    ws.consolidate();
+    for(uint32_t l = 0; l < 20; l++) {
+        EXPECT_TRUE(check(ws, l, 200));
+    }
+    ws.full_consolidate();
+    for(uint32_t l = 0; l < 20; l++) {
+        EXPECT_TRUE(check(ws, l, 200));
+    }
+}
+
+TEST(watch_array_test, other_lists_do_not_move)
+{
+    watch_array ws;
+    ws.insert(4);
+    fill(ws, 0, 10);
+    fill(ws, 1, 10);
+    ws.full_consolidate();
+
+    const Watched* at = ws[Lit::toLit(0)].begin();
+    for(uint32_t i = 0; i < 5000; i++) {
+        ws[Lit::toLit(1)].push(w_for(1000+10+i));
+        ws[Lit::toLit(2)].push(w_for(2000+i));
+    }
+    EXPECT_EQ(at, ws[Lit::toLit(0)].begin());
+    EXPECT_TRUE(check(ws, 0, 10));
+    EXPECT_TRUE(check(ws, 1, 5010));
+    EXPECT_TRUE(check(ws, 2, 5000));
+}
+
+TEST(watch_array_test, smudged_lists_shrink)
+{
+    watch_array ws;
+    ws.insert(2);
+    fill(ws, 0, 100);
+    fill(ws, 1, 100);
+    ws.full_consolidate();
+
+    ws[Lit::toLit(0)].shrink(98);
+    ws.smudge(Lit::toLit(0));
+    ws.clear_smudged();
+    EXPECT_LT(ws[Lit::toLit(0)].capacity(), 100u);
+    EXPECT_TRUE(check(ws, 0, 2));
+    EXPECT_TRUE(check(ws, 1, 100));
+    ws.consolidate();
+    EXPECT_TRUE(check(ws, 0, 2));
+    EXPECT_TRUE(check(ws, 1, 100));
+}
+
+TEST(watch_array_test, swap_and_resize)
+{
+    watch_array ws;
+    ws.insert(6);
+    for(uint32_t l = 0; l < 6; l++) {
+        fill(ws, l, l+1);
+    }
+    ws.full_consolidate();
+    swap(ws[Lit::toLit(0)], ws[Lit::toLit(5)]);
+    EXPECT_TRUE(check(ws, 1, 2));
+    EXPECT_EQ(ws[Lit::toLit(0)].size(), 6u);
+    EXPECT_EQ(ws[Lit::toLit(5)].size(), 1u);
+
+    ws.resize(2);
+    EXPECT_EQ(ws.size(), 2u);
+    ws.insert(2);
+    EXPECT_TRUE(ws[Lit::toLit(3)].empty());
+    fill(ws, 3, 50);
+    EXPECT_TRUE(check(ws, 3, 50));
+    ws.full_consolidate();
+    EXPECT_TRUE(check(ws, 1, 2));
+    EXPECT_TRUE(check(ws, 3, 50));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}